@@ -31,7 +31,9 @@
 // If we are using VS and its test framework, don't define this.
 #define NONVSTESTING
 
+#include <atomic>
 #include <cstdint>
+#include <thread>
 #include <shared_mutex>
 #include <opendatacon/DataPort.h>
 #include <opendatacon/util.h>
@@ -187,15 +189,15 @@ class CBPoint // Abstract Class
 public:
 	CBPoint() {}
 
-	// We need these as we DO NOT want to copy the mutex!
+	// We need these as we DO NOT want to copy the atomics directly
 	CBPoint(const CBPoint &src):
 		Index(src.Index),
 		Group(src.Group),
 		Channel(src.Channel),
-		PayloadLocation(src.PayloadLocation),
-		ChangedTime(src.ChangedTime),
-		HasBeenSet(src.HasBeenSet)
-	{}
+		PayloadLocation(src.PayloadLocation)
+	{
+		CopyStateFrom(src);
+	}
 	virtual ~CBPoint(); // Make the base class pure virtual
 
 	CBPoint& operator=(const CBPoint& src)
@@ -204,8 +206,7 @@ public:
 		Group = src.Group;
 		Channel = src.Channel;
 		PayloadLocation = src.PayloadLocation;
-		ChangedTime = src.ChangedTime;
-		HasBeenSet = src.HasBeenSet;
+		CopyStateFrom(src);
 		return *this;
 	}
 
@@ -218,23 +219,82 @@ public:
 	{}
 
 	// These first 4 never change, so no protection
-	uint32_t GetIndex() { return Index; }
-	uint8_t GetGroup() { return Group; }
-	uint8_t GetChannel() { return Channel; } // The bit position in the payload.
-	PayloadLocationType GetPayloadLocation() { return PayloadLocation; }
-
-	CBTime GetChangedTime() { std::unique_lock<std::mutex> lck(PointMutex); return ChangedTime; }
-	bool GetHasBeenSet() { std::unique_lock<std::mutex> lck(PointMutex); return HasBeenSet; }
-	//	void SetChangedTime(const CBTime &ct) { std::unique_lock<std::mutex> lck(PointMutex); ChangedTime = ct; }; // Not needed...
+	uint32_t GetIndex() const { return Index; }
+	uint8_t GetGroup() const { return Group; }
+	uint8_t GetChannel() const { return Channel; } // The bit position in the payload.
+	PayloadLocationType GetPayloadLocation() const { return PayloadLocation; }
+
+	CBTime GetChangedTime() const { return ChangedTime; }
+	// State and the ChangedTime that went with it - use this when the value and time have to match
+	uint64_t GetStateAndTime(CBTime &ctime) const
+	{
+		while (true)
+		{
+			const uint32_t seq = Seq.load(std::memory_order_acquire);
+			if (seq & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			const uint64_t state = State.load(std::memory_order_relaxed);
+			ctime = ChangedTime.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Seq.load(std::memory_order_relaxed) == seq)
+				return state;
+		}
+	}
+	bool GetHasBeenSet() const { return (State & HASBEENSET) != 0; }
 
 protected:
-	std::mutex PointMutex;
+	// The flags and values are packed into State (layout below HASBEENSET is up to the point type), so they can be
+	// read and updated from any thread without a lock. ChangedTime doesn't fit in the same word, so a value and its time
+	// are written together under the per point seqlock Seq (UpdateStateAndTime) and read together with GetStateAndTime.
+	// Flag only updates just CAS State.
+	static constexpr uint64_t HASBEENSET = uint64_t(1) << 63;
+
+	// Atomically replaces State with fn(State), returning the value it replaced
+	template <typename Fn>
+	uint64_t UpdateState(Fn&& fn)
+	{
+		uint64_t old = State.load();
+		while (!State.compare_exchange_weak(old, fn(old))) {}
+		return old;
+	}
+
+	// As UpdateState, and sets ChangedTime in the same update. Writers claim the point by CASing Seq from even to odd.
+	template <typename Fn>
+	uint64_t UpdateStateAndTime(const CBTime ctime, Fn&& fn)
+	{
+		uint32_t seq = Seq.load(std::memory_order_relaxed);
+		do
+		{
+			while (seq & 1)
+			{
+				std::this_thread::yield();
+				seq = Seq.load(std::memory_order_relaxed);
+			}
+		} while (!Seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+		std::atomic_thread_fence(std::memory_order_release);
+		ChangedTime.store(ctime, std::memory_order_relaxed);
+		const uint64_t old = UpdateState(std::forward<Fn>(fn));
+		Seq.store(seq + 2, std::memory_order_release);
+		return old;
+	}
+
+	void CopyStateFrom(const CBPoint &src)
+	{
+		CBTime ctime;
+		const uint64_t state = src.GetStateAndTime(ctime);
+		UpdateStateAndTime(ctime, [state](uint64_t) { return state; });
+	}
+
 	uint32_t Index = 0;
 	uint8_t Group = 0;
 	uint8_t Channel = 0;
-	PayloadLocationType PayloadLocation;         // Defaults to error value
-	CBTime ChangedTime = static_cast<CBTime>(0); // msec since epoch. 1970,1,1 Only used for Fn9 and 11 queued data. TimeStamp is Uint48_t, CB is uint64_t but does not overflow.
-	bool HasBeenSet = false;                     // To determine if we have been set since startup
+	PayloadLocationType PayloadLocation;                 // Defaults to error value
+	std::atomic<CBTime> ChangedTime{static_cast<CBTime>(0)}; // msec since epoch. 1970,1,1 Only used for Fn9 and 11 queued data. TimeStamp is Uint48_t, CB is uint64_t but does not overflow.
+	std::atomic<uint64_t> State{0};                          // HASBEENSET - to determine if we have been set since startup
+	std::atomic<uint32_t> Seq{0};                            // Odd while a value and its ChangedTime are being updated
 	//TODO: Point quality to RESTART instead of HasBeenSet = false.
 	//TODO: Integrate ODC quality instead of HasBeenSet flag and Module failed flag.
 };
@@ -243,11 +303,11 @@ protected:
 class CBBinaryPoint: public CBPoint
 {
 public:
-	CBBinaryPoint() {}
+	CBBinaryPoint()
+	{
+		State = MakeState(0x01, true, false);
+	}
 	CBBinaryPoint(const CBBinaryPoint &src): CBPoint(src),
-		Binary(src.Binary),
-		Changed(src.Changed),
-		MomentaryChangeStatus(src.MomentaryChangeStatus),
 		PointType(src.PointType),
 		SOEPoint(src.SOEPoint),
 		SOEIndex(src.SOEIndex)
@@ -261,17 +321,19 @@ public:
 		PointType(pointtype),
 		SOEPoint(soepoint),
 		SOEIndex(soeindex)
-	{}
+	{
+		State = MakeState(0x01, true, false);
+	}
 
 	CBBinaryPoint(uint32_t index, uint8_t group, uint8_t channel, PayloadLocationType payloadlocation, BinaryPointType pointtype,
 		uint8_t binval, bool changed, CBTime changedtime, bool soepoint, uint8_t soeindex):
 		CBPoint(index, group, channel, changedtime, payloadlocation),
-		Binary(binval),
-		Changed(changed),
 		PointType(pointtype),
 		SOEPoint(soepoint),
 		SOEIndex(soeindex)
-	{}
+	{
+		State = MakeState(binval, changed, false);
+	}
 
 
 	~CBBinaryPoint();
@@ -290,36 +352,55 @@ public:
 		return "UNKNOWN";
 	}
 
-	uint8_t GetBinary() { std::unique_lock<std::mutex> lck(PointMutex); return Binary; }
+	uint8_t GetBinary() const { return State & BINARY; }
+	uint8_t GetBinary(CBTime &ctime) const { return GetStateAndTime(ctime) & BINARY; }
 
-	bool GetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); return Changed; }
-	void SetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); Changed = true; }
-	bool GetAndResetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); bool res = Changed; Changed = false; return res; }
+	bool GetChangedFlag() const { return (State & CHANGED) != 0; }
+	void SetChangedFlag() { State |= CHANGED; }
+	bool GetAndResetChangedFlag() { return (State.fetch_and(~CHANGED) & CHANGED) != 0; }
 
-	void GetBinaryAndMCFlagWithFlagReset(uint8_t &result, bool &MCS) { std::unique_lock<std::mutex> lck(PointMutex); result = Binary; MCS = MomentaryChangeStatus; Changed = false; MomentaryChangeStatus = false; }
+	void GetBinaryAndMCFlagWithFlagReset(uint8_t &result, bool &MCS)
+	{
+		const uint64_t old = State.fetch_and(~(CHANGED | MOMENTARYCHANGE));
+		result = old & BINARY;
+		MCS = (old & MOMENTARYCHANGE) != 0;
+	}
 	bool GetIsSOE() const { return SOEPoint;  }
 	uint8_t GetSOEIndex() const { return SOEIndex; }
 
 	void SetBinary(const uint8_t &b, const CBTime &ctime)
 	{
-		std::unique_lock<std::mutex> lck(PointMutex);
-		HasBeenSet = true;
-		ChangedTime = ctime;
-
-		if ((PointType == MCA) && (Binary == 1) && (b == 0)) MomentaryChangeStatus = true;  // Only set on 1-->0 transition
-		if ((PointType == MCB) && (Binary == 0) && (b == 1)) MomentaryChangeStatus = true;  // Only set on 0-->1 transition
-		if ((PointType == MCC) && (Changed) && (Binary != b)) MomentaryChangeStatus = true; // The normal changed flag was already set, and then we got another change.
-
-		Changed = (Binary != b);
-		Binary = b;
+		const auto pointtype = PointType;
+		UpdateStateAndTime(ctime, [b,pointtype](uint64_t old)
+			{
+				const uint8_t binary = old & BINARY;
+				uint64_t momentary = old & MOMENTARYCHANGE;
+				if ((pointtype == MCA) && (binary == 1) && (b == 0)) momentary = MOMENTARYCHANGE;                   // Only set on 1-->0 transition
+				if ((pointtype == MCB) && (binary == 0) && (b == 1)) momentary = MOMENTARYCHANGE;                   // Only set on 0-->1 transition
+				if ((pointtype == MCC) && (old & CHANGED) && (binary != b)) momentary = MOMENTARYCHANGE; // The normal changed flag was already set, and then we got another change.
+
+				const uint64_t changed = (binary != b) ? CHANGED : 0;
+				return (old & ~(BINARY | CHANGED | MOMENTARYCHANGE)) | b | changed | momentary | HASBEENSET;
+			});
+	}
+	void SetChanged(const bool &c)
+	{
+		if (c)
+			State |= CHANGED;
+		else
+			State &= ~CHANGED;
 	}
-	void SetChanged(const bool &c) { std::unique_lock<std::mutex> lck(PointMutex); Changed = c; }
 
 protected:
-	// Only the values below will be changed in two places
-	uint8_t Binary = 0x01;
-	bool Changed = true;
-	bool MomentaryChangeStatus = false; // Used only for MCA, MCB and MCC types. Not valid for other types.
+	// The value, its changed flag, and the momentary change status (used only for MCA, MCB and MCC types. Not valid for other types.)
+	static constexpr uint64_t BINARY = 0xFF;
+	static constexpr uint64_t CHANGED = 0x100;
+	static constexpr uint64_t MOMENTARYCHANGE = 0x200;
+	static uint64_t MakeState(uint8_t binary, bool changed, bool momentary)
+	{
+		return binary | (changed ? CHANGED : 0) | (momentary ? MOMENTARYCHANGE : 0);
+	}
+
 	BinaryPointType PointType = DIG;
 	bool SOEPoint = false;
 	uint8_t SOEIndex = 0; // From 0 to 120 (7 bits), per group. The Bottom 3 bits of the group
@@ -328,33 +409,62 @@ protected:
 class CBAnalogCounterPoint: public CBPoint
 {
 public:
-	CBAnalogCounterPoint() {}
+	CBAnalogCounterPoint()
+	{
+		State = MakeState(MISSINGVALUE, MISSINGVALUE);
+	}
 
 	CBAnalogCounterPoint(uint32_t index, uint8_t group, uint8_t channel, PayloadLocationType payloadlocation, AnalogCounterPointType pointtype): CBPoint(index, group, channel, static_cast<CBTime>(0), payloadlocation),
 		PointType(pointtype)
-	{}
+	{
+		State = MakeState(MISSINGVALUE, MISSINGVALUE);
+	}
 	~CBAnalogCounterPoint();
 
 	AnalogCounterPointType GetPointType() const { return PointType; }
 
-	uint16_t GetAnalog() { std::unique_lock<std::mutex> lck(PointMutex); return Analog; }
-	uint16_t GetAnalogAndHasBeenSet(bool &hasbeenset) { std::unique_lock<std::mutex> lck(PointMutex); hasbeenset = HasBeenSet; return Analog;}
-	uint16_t GetAnalogAndDeltaAndHasBeenSet(int &delta, bool &hasbeenset) { std::unique_lock<std::mutex> lck(PointMutex); delta = static_cast<int>(Analog) - static_cast<int>(LastReadAnalog); LastReadAnalog = Analog; hasbeenset = HasBeenSet; return Analog; }
+	uint16_t GetAnalog() const { return State & ANALOG; }
+	uint16_t GetAnalog(CBTime &ctime) const { return GetStateAndTime(ctime) & ANALOG; }
+	uint16_t GetAnalogAndHasBeenSet(bool &hasbeenset) const
+	{
+		const uint64_t state = State;
+		hasbeenset = (state & HASBEENSET) != 0;
+		return state & ANALOG;
+	}
+	uint16_t GetAnalogAndDeltaAndHasBeenSet(int &delta, bool &hasbeenset)
+	{
+		// The value read becomes the last read value
+		const uint64_t old = UpdateState([](uint64_t old) { return (old & ~LASTREAD) | ((old & ANALOG) << 16); });
+		const auto analog = static_cast<uint16_t>(old & ANALOG);
+		delta = static_cast<int>(analog) - static_cast<int>((old & LASTREAD) >> 16);
+		hasbeenset = (old & HASBEENSET) != 0;
+		return analog;
+	}
 
-	void SetAnalog(const uint16_t & a, const CBTime &ctime) { std::unique_lock<std::mutex> lck(PointMutex); HasBeenSet = true; Analog = a; ChangedTime = ctime; }
-	void ResetAnalog() { std::unique_lock<std::mutex> lck(PointMutex); HasBeenSet = false; Analog = MISSINGVALUE; ChangedTime = 0; }
-	void SetLastReadAnalog(const uint16_t & a) { std::unique_lock<std::mutex> lck(PointMutex); LastReadAnalog = a; }
+	void SetAnalog(const uint16_t & a, const CBTime &ctime)
+	{
+		UpdateStateAndTime(ctime, [a](uint64_t old) { return (old & ~ANALOG) | a | HASBEENSET; });
+	}
+	void ResetAnalog()
+	{
+		UpdateStateAndTime(0, [](uint64_t old) { return (old & LASTREAD) | MISSINGVALUE; });
+	}
+	void SetLastReadAnalog(const uint16_t & a)
+	{
+		UpdateState([a](uint64_t old) { return (old & ~LASTREAD) | (static_cast<uint64_t>(a) << 16); });
+	}
 
 protected:
-	uint16_t Analog = MISSINGVALUE;
-	uint16_t LastReadAnalog = MISSINGVALUE;
+	static constexpr uint64_t ANALOG = 0xFFFF;
+	static constexpr uint64_t LASTREAD = 0xFFFF0000;
+	static uint64_t MakeState(uint16_t analog, uint16_t lastread)
+	{
+		return analog | (static_cast<uint64_t>(lastread) << 16);
+	}
+
 	AnalogCounterPointType PointType = ANA;
 };
 
-typedef std::map<size_t, std::shared_ptr<CBBinaryPoint>>::iterator ODCBinaryPointMapIterType;
-typedef std::map<uint16_t, std::shared_ptr<CBBinaryPoint>>::iterator CBBinaryPointMapIterType;
-typedef std::map<size_t, std::shared_ptr<CBAnalogCounterPoint>>::iterator ODCAnalogCounterPointMapIterType;
-typedef std::map<uint16_t, std::shared_ptr<CBAnalogCounterPoint>>::iterator CBAnalogCounterPointMapIterType;
 typedef std::map<uint8_t, uint16_t> ModuleMapType;
 
 
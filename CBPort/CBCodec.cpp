@@ -0,0 +1,107 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* CBCodec.cpp
+*
+*  Created on: 19/10/2026
+*/
+
+#include "CBCodec.h"
+
+namespace
+{
+inline uint8_t* PutBlock(uint8_t* out, const uint32_t data)
+{
+	out[0] = static_cast<uint8_t>(data >> 24);
+	out[1] = static_cast<uint8_t>(data >> 16);
+	out[2] = static_cast<uint8_t>(data >> 8);
+	out[3] = static_cast<uint8_t>(data);
+	return out + CONITEL_BLOCK_LENGTH;
+}
+inline uint32_t AddressBlockData(CBBlockData blk, const bool BakerDevice)
+{
+	if (BakerDevice)
+		blk.DoBakerConitelSwap();
+	return blk.GetData();
+}
+}
+
+size_t CBEncodeMessage(const CBBlockData* blocks, size_t blockcount, uint8_t* out, size_t outsize, bool BakerDevice)
+{
+	if ((blockcount == 0) || (outsize < CBMessageBytes(blockcount)))
+		return 0;
+
+	uint8_t* p = PutBlock(out, AddressBlockData(blocks[0], BakerDevice));
+	for (size_t i = 1; i < blockcount; i++)
+		p = PutBlock(p, blocks[i].GetData());
+	return static_cast<size_t>(p - out);
+}
+
+size_t CBEncodeScanResponse(const CBBlockData& header, const uint16_t* payloads, size_t count, uint8_t* out, size_t outsize, bool BakerDevice)
+{
+	// 1B in the address block, then two payloads to a block
+	const size_t datablocks = count > 1 ? (count - 1) / 2 + (count - 1) % 2 : 0;
+	if (outsize < CBMessageBytes(1 + datablocks))
+		return 0;
+
+	// The first block is mostly an echo of the request, except that the B field contains data.
+	const uint16_t FirstBlockBValue = count > 0 ? payloads[0] : 0x000;
+	uint8_t* p = PutBlock(out, AddressBlockData(CBBlockData(header.GetStationAddress(), header.GetGroup(), header.GetFunctionCode(), FirstBlockBValue, count < 2), BakerDevice));
+
+	for (size_t i = 0; i < datablocks; i++)
+	{
+		const size_t idx = 1 + 2 * i;
+		const uint16_t A = payloads[idx];
+		const uint16_t B = idx + 1 < count ? payloads[idx + 1] : 0x00;
+		p = PutBlock(p, CBBlockData(A, B, i + 1 == datablocks).GetData());
+	}
+	return static_cast<size_t>(p - out);
+}
+
+CBDecodeResult CBDecodeMessage(const uint8_t* in, size_t insize, CBBlockData* out, size_t outcapacity, size_t& blockcount, size_t& consumed, bool BakerDevice)
+{
+	blockcount = 0;
+	consumed = 0;
+
+	while (insize - consumed >= CONITEL_BLOCK_LENGTH)
+	{
+		CBBlockArray raw;
+		std::copy(in + consumed, in + consumed + CONITEL_BLOCK_LENGTH, raw.begin());
+		CBBlockData block(raw);
+
+		if (!block.IsValidBlock())
+			return CBDecodeResult::BadBlock;
+		// Only the first block can be (and must be) an address block
+		if (block.IsAddressBlock() != (blockcount == 0))
+			return CBDecodeResult::BadBlock;
+		if (blockcount >= outcapacity)
+			return CBDecodeResult::Overflow;
+
+		if (BakerDevice && block.IsAddressBlock())
+			block.DoBakerConitelSwap();
+
+		out[blockcount++] = block;
+		consumed += CONITEL_BLOCK_LENGTH;
+
+		if (block.IsEndOfMessageBlock())
+			return CBDecodeResult::Complete;
+	}
+	return CBDecodeResult::Incomplete;
+}
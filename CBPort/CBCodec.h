@@ -0,0 +1,112 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* CBCodec.h
+*
+*  Created on: 19/10/2026
+*/
+
+#ifndef CBCODEC_H_
+#define CBCODEC_H_
+
+#include "CBUtility.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Whole message encode/decode into caller provided, fixed size buffers.
+// Nothing here allocates - the scan response path builds straight into bytes, computing the BCH for each block in the one pass.
+
+// A scan response is at most MAX_BLOCK_COUNT blocks - 1B, then A and B in each following block
+const size_t CBMaxScanPayloads = 2 * MAX_BLOCK_COUNT - 1;
+
+// A vector with fixed capacity, backed by a std::array. push_back fails (returns false) rather than allocating.
+template <class T, size_t N>
+class CBSmallVector
+{
+public:
+	bool push_back(const T& val)
+	{
+		if (count >= N)
+			return false;
+		items[count++] = val;
+		return true;
+	}
+	void clear() { count = 0; }
+	void resize(size_t n) { count = n < N ? n : N; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	static constexpr size_t capacity() { return N; }
+
+	T& operator[](size_t i) { return items[i]; }
+	const T& operator[](size_t i) const { return items[i]; }
+	T* data() { return items.data(); }
+	const T* data() const { return items.data(); }
+	T* begin() { return items.data(); }
+	T* end() { return items.data() + count; }
+	const T* begin() const { return items.data(); }
+	const T* end() const { return items.data() + count; }
+
+private:
+	std::array<T, N> items{};
+	size_t count = 0;
+};
+
+typedef CBSmallVector<uint16_t, CBMaxScanPayloads> CBScanPayloads_t;
+typedef CBSmallVector<CBBlockData, MAX_BLOCK_COUNT> CBFixedMessage_t;
+
+// Bytes needed on the wire for a message of blockcount blocks
+constexpr size_t CBMessageBytes(const size_t blockcount)
+{
+	return blockcount * CONITEL_BLOCK_LENGTH;
+}
+
+// Encode already built blocks. Returns the number of bytes written, 0 if out is too small.
+// For a Baker device the station and group are swapped in the address (first) block as it is written.
+size_t CBEncodeMessage(const CBBlockData* blocks, size_t blockcount, uint8_t* out, size_t outsize, bool BakerDevice = false);
+inline size_t CBEncodeMessage(const CBMessage_t& msg, uint8_t* out, size_t outsize, bool BakerDevice = false)
+{
+	return CBEncodeMessage(msg.data(), msg.size(), out, outsize, BakerDevice);
+}
+
+// Encode a Fn0 scan response - the echoed address block carrying payload 1B, then the A/B payload pairs.
+size_t CBEncodeScanResponse(const CBBlockData& header, const uint16_t* payloads, size_t count, uint8_t* out, size_t outsize, bool BakerDevice = false);
+
+enum class CBDecodeResult
+{
+	Complete,   // Found the end of message block
+	Incomplete, // Ran out of input before the end of message block
+	BadBlock,   // A block failed its BCH/B bit check, or the message did not start with an address block
+	Overflow    // More blocks than the output can hold
+};
+
+// Decode a block aligned buffer holding one message. consumed is set to the bytes used, blockcount to the blocks written to out.
+CBDecodeResult CBDecodeMessage(const uint8_t* in, size_t insize, CBBlockData* out, size_t outcapacity, size_t& blockcount, size_t& consumed, bool BakerDevice = false);
+
+template <size_t N>
+CBDecodeResult CBDecodeMessage(const uint8_t* in, size_t insize, CBSmallVector<CBBlockData, N>& out, size_t& consumed, bool BakerDevice = false)
+{
+	size_t blockcount = 0;
+	auto res = CBDecodeMessage(in, insize, out.data(), N, blockcount, consumed, BakerDevice);
+	out.resize(blockcount);
+	return res;
+}
+
+#endif
@@ -25,6 +25,7 @@
  */
 
 #include "CB.h"
+#include "CBCodec.h"
 #include "CBConnection.h"
 #include "CBUtility.h"
 #include <functional>
@@ -298,32 +299,47 @@ void CBConnection::Write(const ConnectionTokenType &ConnectionTok,const CBMessag
 
 	if (auto pConnection = ConnectionTok.pConnection) // Dont do if connection not valid
 	{
-		std::string CBMessageString;
+		// Encode the whole message in one pass, straight into the string.
+		// If Is a Baker device, Station and Group values are swapped in the first block
+		std::string CBMessageString(CBMessageBytes(CompleteCBMessage.size()), '\0');
+		CBEncodeMessage(CompleteCBMessage, reinterpret_cast<uint8_t*>(&CBMessageString[0]), CBMessageString.size(), pConnection->IsBakerDevice);
 
-		CBBlockData blk = CompleteCBMessage[0];
-
-		if (pConnection->IsBakerDevice)
+		// This is a pointer to a function, so that we can hook it for testing. Otherwise calls the pSockMan Write templated function
+		// Small overhead to allow for testing - Is there a better way? - could not hook the pSockMan->Write function and/or another passed in function due to differences between a method and a lambda
+		if (pConnection->SendTCPDataFn != nullptr)
 		{
-			// If Is a Baker device, swap Station and Group values before sending...
-			blk.DoBakerConitelSwap();
+			pConnection->SendTCPDataFn(CBMessageString);
 		}
-		CBMessageString += blk.ToBinaryString();
-
-		// Done the first block, now do the rest
-		for (uint8_t i = 1; i < CompleteCBMessage.size(); i++)
+		else
 		{
-			CBMessageString += CompleteCBMessage[i].ToBinaryString();
+			pConnection->Write(std::move(CBMessageString));
 		}
+	}
+	else
+	{
+		LOGERROR("Tried to write to a connection when the connection was no longer valid");
+	}
+}
+//Static method
+void CBConnection::Write(const ConnectionTokenType &ConnectionTok, const uint8_t* data, size_t len)
+{
+	if (len == 0)
+	{
+		LOGERROR("Tried to send an empty message to the TCP Port");
+		return;
+	}
+	if (auto pConnection = ConnectionTok.pConnection) // Dont do if connection not valid
+	{
+		// The socket owns its buffer until the write completes, so this is the one copy
+		std::string CBMessageString(reinterpret_cast<const char*>(data), len);
 
-		// This is a pointer to a function, so that we can hook it for testing. Otherwise calls the pSockMan Write templated function
-		// Small overhead to allow for testing - Is there a better way? - could not hook the pSockMan->Write function and/or another passed in function due to differences between a method and a lambda
 		if (pConnection->SendTCPDataFn != nullptr)
 		{
 			pConnection->SendTCPDataFn(CBMessageString);
 		}
 		else
 		{
-			pConnection->Write(CBMessageString);
+			pConnection->Write(std::move(CBMessageString));
 		}
 	}
 	else
@@ -345,11 +361,11 @@ void CBConnection::SetSendTCPDataFn(const ConnectionTokenType &ConnectionTok, st
 }
 
 // We don't need to know who is doing the writing. Just pass to the socket
-void CBConnection::Write(std::string &msg)
+void CBConnection::Write(std::string &&msg)
 {
 	if (pSockMan)
 	{
-		pSockMan->Write(std::string(msg)); // Strange, it requires the std::string() constructor to be passed otherwise the templating fails.
+		pSockMan->Write(std::move(msg)); // Has to be an rvalue, otherwise the templating fails.
 	}
 }
 //Static method
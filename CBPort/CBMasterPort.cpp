@@ -81,6 +81,8 @@ void CBMasterPort::SocketStateHandler(bool state)
 	std::string msg;
 	if (state)
 	{
+		// The old round trip estimate may not apply to the new connection
+		MasterCommandStrand->dispatch([this]() { CommandRTT.Reset(); });
 		PollScheduler->Start();
 		PublishEvent(std::move(ConnectState::CONNECTED));
 		msg = Name + ": Connection established.";
@@ -108,7 +110,10 @@ void CBMasterPort::Build()
 	MasterCommandStrand = pIOS->make_strand();
 
 	// Need a couple of things passed to the point table. SOEQueue not actually used.
-	MyPointConf->PointTable.Build(Name, IsOutStation, *pIOS, 5, SOEBufferOverflowFlag);
+	MyPointConf->PointTable.Build(Name, IsOutStation, 5, SOEBufferOverflowFlag);
+
+	CommandRTT.Configure(MyPointConf->CBCommandTimeoutmsec, MyPointConf->CBCommandTimeoutMinmsec,
+		MyPointConf->CBCommandTimeoutMaxmsec ? MyPointConf->CBCommandTimeoutMaxmsec : RTTEstimator::DefaultMaxMultiple * MyPointConf->CBCommandTimeoutmsec);
 
 	// Creates internally if necessary, returns a token for the connection
 	pConnection = CBConnection::AddConnection(pIOS, IsServer(), MyConf->mAddrConf.IP, MyConf->mAddrConf.Port, MyPointConf->IsBakerDevice, MyConf->mAddrConf.TCPConnectRetryPeriodms); //Static method
@@ -128,10 +133,31 @@ void CBMasterPort::Build()
 					  this->DoPoll(id);
 				  };
 		PollScheduler->Add(pg.second.pollrate, action);
+		if (id != 0) // 0 is the pollgroup of commands that are not polls
+			PollGroupQueued[id] = 0;
 	}
 	//	PollScheduler->Start(); // This is started and stopped in the socket state handler
 }
 
+const Json::Value CBMasterPort::GetStatistics() const
+{
+	Json::Value stats;
+	stats["AdaptiveTimeout"] = MyPointConf->CBAdaptiveTimeout;
+	stats["RTT"]["SRTTmsec"] = CommandRTT.GetSRTTmsec();
+	stats["RTT"]["RTTVARmsec"] = CommandRTT.GetRTTVARmsec();
+	stats["RTT"]["Timeoutmsec"] = Json::UInt64(CommandRTT.GetTimeout().count());
+	stats["RTT"]["Samples"] = Json::UInt64(CommandRTT.GetSamples());
+	stats["CommandTimeouts"] = Json::UInt64(NumCommandTimeouts);
+	stats["CommandRetries"] = Json::UInt64(NumCommandRetries);
+	auto& queue = MasterCommandProtectedData.MasterCommandQueue;
+	stats["CommandQueue"]["Control"] = Json::UInt64(queue.Size(CommandPriority::Control));
+	stats["CommandQueue"]["TimeSync"] = Json::UInt64(queue.Size(CommandPriority::TimeSync));
+	stats["CommandQueue"]["EventScan"] = Json::UInt64(queue.Size(CommandPriority::EventScan));
+	stats["CommandQueue"]["IntegrityScan"] = Json::UInt64(queue.Size(CommandPriority::IntegrityScan));
+	stats["CommandQueue"]["PollsCoalesced"] = Json::UInt64(NumPollsCoalesced);
+	return stats;
+}
+
 void CBMasterPort::SendCBMessage(const CBMessage_t& CompleteCBMessage)
 {
 	if (CompleteCBMessage.size() == 0)
@@ -155,30 +181,39 @@ void CBMasterPort::SendCBMessage(const CBMessage_t& CompleteCBMessage)
 // If the callback gets an error it will be ignored which will result in a timeout and the next command being sent.
 // This is necessary if somehow we get an old command sent to us, or a left over broadcast message.
 // Only issue is if we do a broadcast message and can get information back from multiple sources... These commands are probably not used, and we will ignore them anyway.
-void CBMasterPort::QueueCBCommand(const CBMessage_t& CompleteCBMessage, const SharedStatusCallback_t& pStatusCallback)
+void CBMasterPort::QueueCBCommand(const CBMessage_t& CompleteCBMessage, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
-	MasterCommandStrand->dispatch([=]() // Tries to execute, if not able to will post.
-		{
-			if (MasterCommandProtectedData.MasterCommandQueue.size() < MasterCommandProtectedData.MaxCommandQueueSize)
-			{
-			      MasterCommandProtectedData.MasterCommandQueue.push(MasterCommandQueueItem(CompleteCBMessage, pStatusCallback)); // async
-			}
-			else
-			{
-			      LOGDEBUG("{} Tried to queue another CB Master PendingCommand when the command queue is full",Name);
-			      PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED); // Failed...
-			}
+	if (CompleteCBMessage.size() == 0)
+	{
+		LOGERROR("{} Tried to queue an empty CB Master Command", Name);
+		PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED);
+		return;
+	}
+	auto priority = GetCommandPriority(CompleteCBMessage[0]);
 
-			// Will only send if we can - blockindex.e. not currently processing a command
-			UnprotectedSendNextMasterCommand(false);
-		});
+	// Count it before the push - the strand could pop it straight away
+	auto pollqueued = PollGroupQueued.find(pollgroup);
+	if (pollqueued != PollGroupQueued.end())
+		pollqueued->second++;
+
+	// Lock-free, so no need to get onto the strand just to queue the command
+	if (!MasterCommandProtectedData.MasterCommandQueue.Push(MasterCommandQueueItem(CompleteCBMessage, pStatusCallback, pollgroup), priority))
+	{
+		if (pollqueued != PollGroupQueued.end())
+			pollqueued->second--;
+		LOGDEBUG("{} Tried to queue another CB Master PendingCommand when the command queue is full",Name);
+		PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED); // Failed...
+	}
+
+	// Will only send if we can - blockindex.e. not currently processing a command
+	SendNextMasterCommand();
 }
 // Handle the many single block command messages better
-void CBMasterPort::QueueCBCommand(const CBBlockData& SingleBlockCBMessage, const SharedStatusCallback_t& pStatusCallback)
+void CBMasterPort::QueueCBCommand(const CBBlockData& SingleBlockCBMessage, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
 	CBMessage_t CommandCBMessage;
 	CommandCBMessage.push_back(SingleBlockCBMessage);
-	QueueCBCommand(CommandCBMessage, pStatusCallback);
+	QueueCBCommand(CommandCBMessage, pStatusCallback, pollgroup);
 }
 
 
@@ -234,6 +269,7 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 			if (MasterCommandProtectedData.RetriesLeft-- > 0)
 			{
 				MasterCommandProtectedData.ProcessingCBCommand = true;
+				NumCommandRetries++;
 
 				//TODO: Do we resend the original command, or do we ask the RTU to send us the last response again???
 				// It depends if you think that the outbound message got there - if so ask for the response again. If not, send the command again....
@@ -248,7 +284,7 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 				// Have had multiple retries fail,
 
 				// Execute the callback with a fail code.
-				PostCallbackCall(MasterCommandProtectedData.CurrentCommand.second, CommandStatus::UNDEFINED);
+				PostCallbackCall(MasterCommandProtectedData.CurrentCommand.pStatusCallback, CommandStatus::UNDEFINED);
 
 				// so mark everything as if we have lost comms!
 				pIOS->post([this]()
@@ -260,21 +296,19 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 			}
 		}
 
-		if (!MasterCommandProtectedData.MasterCommandQueue.empty() && (MasterCommandProtectedData.ProcessingCBCommand != true))
+		if ((MasterCommandProtectedData.ProcessingCBCommand != true) && MasterCommandProtectedData.MasterCommandQueue.Pop(MasterCommandProtectedData.CurrentCommand))
 		{
 			// Send the next command if there is one and we are not retrying.
+			CommandDequeued(MasterCommandProtectedData.CurrentCommand);
 
 			MasterCommandProtectedData.ProcessingCBCommand = true;
 			MasterCommandProtectedData.RetriesLeft = MyPointConf->CBCommandRetries;
 
-			MasterCommandProtectedData.CurrentCommand = MasterCommandProtectedData.MasterCommandQueue.front();
-			MasterCommandProtectedData.MasterCommandQueue.pop();
-
-			MasterCommandProtectedData.CurrentFunctionCode = MasterCommandProtectedData.CurrentCommand.first[0].GetFunctionCode();
+			MasterCommandProtectedData.CurrentFunctionCode = MasterCommandProtectedData.CurrentCommand.Message[0].GetFunctionCode();
 			LOGDEBUG("{} Sending next command : Fn {}, St {}, Gr {}, 1B {}", Name, GetFunctionCodeName(MasterCommandProtectedData.CurrentFunctionCode),
-				std::to_string(MasterCommandProtectedData.CurrentCommand.first[0].GetStationAddress()),
-				std::to_string(MasterCommandProtectedData.CurrentCommand.first[0].GetGroup()),
-				to_binstring(MasterCommandProtectedData.CurrentCommand.first[0].GetB()));
+				std::to_string(MasterCommandProtectedData.CurrentCommand.Message[0].GetStationAddress()),
+				std::to_string(MasterCommandProtectedData.CurrentCommand.Message[0].GetGroup()),
+				to_binstring(MasterCommandProtectedData.CurrentCommand.Message[0].GetB()));
 		}
 
 		// If either of the above situations need us to send a command, do so.
@@ -283,10 +317,11 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 			if (DoResendCommand)
 				SendCBMessage(GetResendMessage());
 			else
-				SendCBMessage(MasterCommandProtectedData.CurrentCommand.first); // This should be the only place this is called for the CBMaster...
+				SendCBMessage(MasterCommandProtectedData.CurrentCommand.Message); // This should be the only place this is called for the CBMaster...
 
 			// Start an async timed callback for a timeout - cancelled if we receive a good response.
-			MasterCommandProtectedData.TimerExpireTime = std::chrono::milliseconds(MyPointConf->CBCommandTimeoutmsec);
+			MasterCommandProtectedData.CommandSentTime = std::chrono::steady_clock::now();
+			MasterCommandProtectedData.TimerExpireTime = GetCommandTimeout(MyPointConf->CBCommandRetries - MasterCommandProtectedData.RetriesLeft);
 			MasterCommandProtectedData.CurrentCommandTimeoutTimer->expires_from_now(MasterCommandProtectedData.TimerExpireTime);
 
 			std::chrono::milliseconds endtime = MasterCommandProtectedData.TimerExpireTime;
@@ -306,6 +341,7 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 								      LOGDEBUG("{} Master Timeout valid - CB Function {}", Name, GetFunctionCodeName(MasterCommandProtectedData.CurrentFunctionCode));
 
 								      MasterCommandProtectedData.ProcessingCBCommand = false; // Only gets reset on success or timeout.
+								      NumCommandTimeouts++;
 
 								      UnprotectedSendNextMasterCommand(true); // We already have the strand, so don't need the wrapper here
 								}
@@ -325,16 +361,57 @@ void CBMasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 		}
 	}
 }
+// The fixed timeout, or if adaptive, the one from the Station's round trip time - doubled for each retry.
+std::chrono::milliseconds CBMasterPort::GetCommandTimeout(uint32_t attempt) const
+{
+	if (MyPointConf->CBAdaptiveTimeout)
+		return CommandRTT.GetTimeout(attempt);
+	return std::chrono::milliseconds(MyPointConf->CBCommandTimeoutmsec);
+}
+// Controls first, then time sync, then the SOE (event) scans and last the data scans.
+CommandPriority CBMasterPort::GetCommandPriority(const CBBlockData& FirstBlock)
+{
+	switch (FirstBlock.GetFunctionCode())
+	{
+		case FUNC_MASTER_STATION_REQUEST:
+			// The sub function is in the group field
+			if (FirstBlock.GetGroup() == MASTER_SUB_FUNC_SEND_TIME_UPDATES)
+				return CommandPriority::TimeSync;
+			return CommandPriority::Control;
+
+		case FUNC_SEND_NEW_SOE:
+		case FUNC_REPEAT_SOE:
+			return CommandPriority::EventScan;
+
+		case FUNC_SCAN_DATA:
+		case FUNC_FREEZE_AND_SCAN_ACC:
+		case FUNC_FREEZE_SCAN_AND_RESET_ACC:
+			return CommandPriority::IntegrityScan;
+
+		default:
+			return CommandPriority::Control;
+	}
+}
+bool CBMasterPort::IsPollQueued(uint32_t pollgroup) const
+{
+	auto pollqueued = PollGroupQueued.find(pollgroup);
+	return (pollqueued != PollGroupQueued.end()) && (pollqueued->second.load() != 0);
+}
+// Must be called for every command popped from the queue
+void CBMasterPort::CommandDequeued(const MasterCommandQueueItem& item)
+{
+	auto pollqueued = PollGroupQueued.find(item.PollGroup);
+	if (pollqueued != PollGroupQueued.end())
+		pollqueued->second--;
+}
 // Strand protected clear the command queue.
 void CBMasterPort::ClearCBCommandQueue()
 {
 	MasterCommandStrand->dispatch([this]()
 		{
-			CBMessage_t NextCommand;
-			while (!MasterCommandProtectedData.MasterCommandQueue.empty())
-			{
-			      MasterCommandProtectedData.MasterCommandQueue.pop();
-			}
+			MasterCommandQueueItem item;
+			while (MasterCommandProtectedData.MasterCommandQueue.Pop(item))
+				CommandDequeued(item);
 			MasterCommandProtectedData.CurrentFunctionCode = 0;
 			MasterCommandProtectedData.ProcessingCBCommand = false;
 		});
@@ -398,19 +475,19 @@ void CBMasterPort::ProcessCBMessage(CBMessage_t& CompleteCBMessage)
 					success = ProcessScanRequestReturn(CompleteCBMessage); // Fn - 0
 					break;
 				case FUNC_EXECUTE_COMMAND:
-					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.first[0]);
+					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.Message[0]);
 					break;
 				case FUNC_TRIP:
-					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.first[0]);
+					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.Message[0]);
 					break;
 				case FUNC_SETPOINT_A:
-					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.first[0]);
+					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.Message[0]);
 					break;
 				case FUNC_CLOSE:
-					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.first[0]);
+					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.Message[0]);
 					break;
 				case FUNC_SETPOINT_B:
-					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.first[0]);
+					success = CheckResponseHeaderMatch(Header, MasterCommandProtectedData.CurrentCommand.Message[0]);
 					break;
 				case FUNC_RESET:
 					NotImplemented = true;
@@ -447,10 +524,15 @@ void CBMasterPort::ProcessCBMessage(CBMessage_t& CompleteCBMessage)
 			if (success) // Move to the next command. Only other place we do this is in the timeout.
 			{
 			      MasterCommandProtectedData.CurrentCommandTimeoutTimer->cancel(); // Have to be careful the handler still might do something?
+
+			      // Only a command answered first time gives a usable round trip time - for a retry we can't tell which send was answered.
+			      if (MasterCommandProtectedData.RetriesLeft == MyPointConf->CBCommandRetries)
+			            CommandRTT.Sample(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - MasterCommandProtectedData.CommandSentTime));
+
 			      MasterCommandProtectedData.ProcessingCBCommand = false;          // Only gets reset on success or timeout.
 
 			      // Execute the callback with a success code.
-			      PostCallbackCall(MasterCommandProtectedData.CurrentCommand.second, CommandStatus::SUCCESS); // Does null check
+			      PostCallbackCall(MasterCommandProtectedData.CurrentCommand.pStatusCallback, CommandStatus::SUCCESS); // Does null check
 			      UnprotectedSendNextMasterCommand(false);                                                    // We already have the strand, so don't need the wrapper here. Pass in that this is not a retry.
 			}
 			else
@@ -521,7 +603,7 @@ void CBMasterPort::ProccessScanPayload(uint16_t data, uint8_t group, PayloadLoca
 
 			LOGDEBUG("{} - Published Event - Analog - Index {} Value 0x{}",Name,ODCIndex, to_hexstring(data));
 
-			auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from CB, so add it as soon as possible);
+			auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from CB, so add it as soon as possible);
 			event->SetPayload<EventType::Analog>(std::move(data));
 			PublishEvent(event);
 
@@ -540,7 +622,7 @@ void CBMasterPort::ProccessScanPayload(uint16_t data, uint8_t group, PayloadLoca
 
 				LOGDEBUG("{} - Published Event - Counter - Index {} Value 0x{}", Name, ODCIndex, to_hexstring(data));
 
-				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from CB, so add it as soon as possible);
+				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from CB, so add it as soon as possible);
 				event->SetPayload<EventType::Counter>(std::move(data));
 				PublishEvent(event);
 
@@ -632,7 +714,7 @@ void CBMasterPort::SendBinaryEvent(CBBinaryPoint& pt, uint8_t& bitvalue, const C
 
 		QualityFlags qual = QualityFlags::ONLINE; // CalculateBinaryQuality(enabled, now); //TODO: Handle quality better?
 		LOGDEBUG("{} Published Event - Binary Index {} Value {}", Name, ODCIndex, bitvalue);
-		auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now));
+		auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now));
 		event->SetPayload<EventType::Binary>(bitvalue == 1);
 		PublishEvent(event);
 	}
@@ -648,14 +730,13 @@ bool CBMasterPort::ProcessSOEScanRequestReturn(const CBBlockData& ReceivedHeader
 
 	LOGDEBUG("{} SOE Scan Data processing - Blocks {}", Name, CompleteCBMessage.size());
 
-	uint32_t UsedBits = 0;
-	std::array<bool, MaxSOEBits> BitArray{};
+	CBSOEBitStream Bits;
 
-	if (!ConvertSOEMessageToBitArray(CompleteCBMessage, BitArray, UsedBits))
+	if (!ConvertSOEMessageToBitStream(CompleteCBMessage, Bits))
 		return false;
 
-	// Convert the BitArray to SOE events, and call our lambda for each
-	ForEachSOEEventInBitArray(BitArray, UsedBits, [this](SOEEventFormat& soeevnt)
+	// Convert the bit stream to SOE events, and call our lambda for each
+	ForEachSOEEventInBitStream(Bits, [this](SOEEventFormat& soeevnt)
 		{
 			// Now use the data in the SOE Event to fire off an ODC event..
 			// Find the Point in our database...using SOE Group and Number
@@ -696,7 +777,7 @@ bool CBMasterPort::ProcessSOEScanRequestReturn(const CBBlockData& ReceivedHeader
 			      {
 			            QualityFlags qual = QualityFlags::ONLINE; // CalculateBinaryQuality(enabled, now); //TODO: Handle quality better?
 			            LOGDEBUG("{} Published Binary SOE Event -  SOE Index {} ODC Index {} Bit Value {}",Name, SOEIndex, ODCIndex, bitvalue);
-			            auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(changedtime));
+			            auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			            event->SetPayload<EventType::Binary>(bitvalue == 1);
 			            PublishEvent(event);
 				}
@@ -710,7 +791,7 @@ bool CBMasterPort::ProcessSOEScanRequestReturn(const CBBlockData& ReceivedHeader
 	return true;
 }
 
-bool CBMasterPort::ConvertSOEMessageToBitArray(const CBMessage_t& CompleteCBMessage, std::array<bool, MaxSOEBits>& BitArray, uint32_t& UsedBits)
+bool CBMasterPort::ConvertSOEMessageToBitStream(const CBMessage_t& CompleteCBMessage, CBSOEBitStream& Bits)
 {
 	auto NumberOfBlocks = numeric_cast<uint8_t>(CompleteCBMessage.size());
 
@@ -730,32 +811,29 @@ bool CBMasterPort::ConvertSOEMessageToBitArray(const CBMessage_t& CompleteCBMess
 
 	// The maximum number of bits we can send is 12 * 31 = 372.
 
-	// Take each of the payload 12 bit blocks, and combine them into a bit array. Block 0 Payload A is group address and other data. Start at block B
-	UsedBits = 0;
+	// Take each of the payload 12 bit blocks, and combine them into a bit stream. Block 0 Payload A is group address and other data. Start at block B
+	Bits.Clear();
 
 	for (uint8_t blocknum = 0; blocknum < NumberOfBlocks; blocknum++)
 	{
-		if (blocknum != 0)
+		if ((blocknum != 0) && !Bits.Put(CompleteCBMessage[blocknum].GetA(), 12))
 		{
-			uint16_t payloadA = CompleteCBMessage[blocknum].GetA();
-			for (int i = 11; i >= 0; i--)
-			{
-				BitArray[UsedBits++] = TestBit(payloadA, i);
-			}
+			LOGERROR("{} SOE Message has more than {} bits of data",Name, MaxSOEBits);
+			return false;
 		}
-
-		uint16_t payloadB = CompleteCBMessage[blocknum].GetB();
-		for (int i = 11; i >= 0; i--)
+		if (!Bits.Put(CompleteCBMessage[blocknum].GetB(), 12))
 		{
-			BitArray[UsedBits++] = TestBit(payloadB, i);
+			LOGERROR("{} SOE Message has more than {} bits of data",Name, MaxSOEBits);
+			return false;
 		}
 	}
 	return true;
 }
 
-void CBMasterPort::ForEachSOEEventInBitArray(std::array<bool, MaxSOEBits>& BitArray, uint32_t& UsedBits, const std::function<void(SOEEventFormat& soeevnt)>& fn)
+void CBMasterPort::ForEachSOEEventInBitStream(const CBSOEBitStream& Bits, const std::function<void(SOEEventFormat& soeevnt)>& fn)
 {
-	// We now have the data in the bit array, now we have to decode into the SOE blocks - 30 or 41 bits long.
+	// We now have the data in the bit stream, now we have to decode into the SOE blocks - 30 or 41 bits long.
+	uint32_t UsedBits = Bits.Size();
 	uint32_t startbit = 0;
 	uint32_t newstartbit = 0;
 	CBTime LastEventTime = 0; // msec representing the last hour/min/sec/msec value received from an event.
@@ -767,7 +845,7 @@ void CBMasterPort::ForEachSOEEventInBitArray(std::array<bool, MaxSOEBits>& BitAr
 
 		// Returns IsLastRecord flag, also if  we sucessfully got an Event from the bit stream.
 		bool Success = false;
-		SOEEventFormat Event(BitArray, startbit, UsedBits, newstartbit, LastEventTime, Success); // Will always expand to a full time (h:M:S:ms) for every record.
+		SOEEventFormat Event(Bits, startbit, newstartbit, LastEventTime, Success); // Will always expand to a full time (h:M:S:ms) for every record.
 		LastEventTime = Event.GetTotalMsecTime();
 
 		if (Success)
@@ -776,7 +854,7 @@ void CBMasterPort::ForEachSOEEventInBitArray(std::array<bool, MaxSOEBits>& BitAr
 		}
 		else
 		{
-			LOGERROR("{} The SOEEventFormat bitarray parser failed.. StartBit {}, NewStartBit {}", Name, startbit, newstartbit);
+			LOGERROR("{} The SOEEventFormat bit stream parser failed.. StartBit {}, NewStartBit {}", Name, startbit, newstartbit);
 			return;
 		}
 		if (Event.LastEventFlag)
@@ -817,6 +895,13 @@ bool CBMasterPort::CheckResponseHeaderMatch(const CBBlockData& ReceivedHeader, c
 void CBMasterPort::DoPoll(uint32_t PollID)
 {
 	if (!enabled) return;
+	if (IsPollQueued(PollID))
+	{
+		// The last one of these is still waiting behind other commands, no point queueing another the same
+		NumPollsCoalesced++;
+		LOGDEBUG("{} DoPoll : {} still queued, not queueing again", Name, PollID);
+		return;
+	}
 	LOGDEBUG("{} DoPoll : {}",Name,PollID);
 
 	switch (MyPointConf->PollGroups[PollID].polltype)
@@ -825,14 +910,14 @@ void CBMasterPort::DoPoll(uint32_t PollID)
 		{
 			// We will scan a single Group. Payload can be up to 31 payload blocks.
 			uint8_t Group = MyPointConf->PollGroups[PollID].group;
-			SendF0ScanCommand(Group, nullptr);
+			SendF0ScanCommand(Group, nullptr, PollID);
 		}
 		break;
 
 		case  TimeSetCommand:
 		{
 			// Send a time set command to the OutStation
-			SendFn9TimeUpdate(nullptr);
+			SendFn9TimeUpdate(nullptr, 0, PollID);
 			LOGDEBUG("{} Poll Issued a TimeDate Update Command",Name);
 		}
 		break;
@@ -840,7 +925,7 @@ void CBMasterPort::DoPoll(uint32_t PollID)
 		{
 			// Send a time set command to the OutStation
 			uint8_t Group = MyPointConf->PollGroups[PollID].group;
-			SendFn10SOEScanCommand(Group, nullptr);
+			SendFn10SOEScanCommand(Group, nullptr, PollID);
 			LOGDEBUG("{} Poll Issued a SOE Scan Command",Name);
 		}
 		break;
@@ -882,19 +967,19 @@ void CBMasterPort::EnablePolling(bool on)
 		PollScheduler->Stop();
 }
 
-void CBMasterPort::SendF0ScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback)
+void CBMasterPort::SendF0ScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback, uint32_t pollgroup)
 {
 	CBBlockData sendcommandblock(MyConf->mAddrConf.OutstationAddr, group, FUNC_SCAN_DATA, 0, true);
-	QueueCBCommand(sendcommandblock, std::move(pStatusCallback));
+	QueueCBCommand(sendcommandblock, std::move(pStatusCallback), pollgroup);
 }
 // The timeoffset minutes setting is purely for testing
-void CBMasterPort::SendFn9TimeUpdate(const SharedStatusCallback_t& pStatusCallback, int TimeOffsetMinutes)
+void CBMasterPort::SendFn9TimeUpdate(const SharedStatusCallback_t& pStatusCallback, int TimeOffsetMinutes, uint32_t pollgroup)
 {
 	CBMessage_t CompleteCBMessage;
 
 	BuildUpdateTimeMessage(MyConf->mAddrConf.OutstationAddr, (uint64_t)((int64_t)CBNowUTC()+(int64_t)(TimeOffsetMinutes*60*1000)), CompleteCBMessage);
 
-	QueueCBCommand(CompleteCBMessage, pStatusCallback);
+	QueueCBCommand(CompleteCBMessage, pStatusCallback, pollgroup);
 }
 // This message is constructed by the Master to send the time to the RTU
 void CBMasterPort::BuildUpdateTimeMessage(uint8_t StationAddress, CBTime cbtime, CBMessage_t& CompleteCBMessage)
@@ -916,17 +1001,17 @@ void CBMasterPort::BuildUpdateTimeMessage(uint8_t StationAddress, CBTime cbtime,
 	CompleteCBMessage.push_back(firstblock);
 	CompleteCBMessage.push_back(secondblock);
 }
-void CBMasterPort::SendFn10SOEScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback)
+void CBMasterPort::SendFn10SOEScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback, uint32_t pollgroup)
 {
 	// Any retries of this command must be FUNC_REPEAT_SOE so the SOE buffer is not lost!
 	CBBlockData sendcommandblock(MyConf->mAddrConf.OutstationAddr, group, FUNC_SEND_NEW_SOE, 0, true);
-	QueueCBCommand(sendcommandblock, std::move(pStatusCallback));
+	QueueCBCommand(sendcommandblock, std::move(pStatusCallback), pollgroup);
 }
 void CBMasterPort::SetAllPointsQualityToCommsLost()
 {
 	LOGDEBUG("{} CB Master setting quality to comms lost",Name);
 
-	auto eventbinary = std::make_shared<EventInfo>(EventType::BinaryQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventbinary = std::make_shared<EventInfo>(EventType::BinaryQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventbinary->SetPayload<EventType::BinaryQuality>(QualityFlags::COMM_LOST);
 
 	// Loop through all Binary points.
@@ -940,7 +1025,7 @@ void CBMasterPort::SetAllPointsQualityToCommsLost()
 
 	// Analogs
 
-	auto eventanalog = std::make_shared<EventInfo>(EventType::AnalogQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventanalog = std::make_shared<EventInfo>(EventType::AnalogQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventanalog->SetPayload<EventType::AnalogQuality>(QualityFlags::COMM_LOST);
 	MyPointConf->PointTable.ForEachAnalogPoint([this,eventanalog](CBAnalogCounterPoint& Point)
 		{
@@ -952,7 +1037,7 @@ void CBMasterPort::SetAllPointsQualityToCommsLost()
 			PublishEvent(eventanalog);
 		});
 	// Counters
-	auto eventcounter = std::make_shared<EventInfo>(EventType::CounterQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventcounter = std::make_shared<EventInfo>(EventType::CounterQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventcounter->SetPayload<EventType::CounterQuality>(QualityFlags::COMM_LOST);
 
 	MyPointConf->PointTable.ForEachCounterPoint([this,eventcounter](CBAnalogCounterPoint& Point)
@@ -973,10 +1058,11 @@ void CBMasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachBinaryPoint([this](CBBinaryPoint& Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint8_t meas = Point.GetBinary();
-			QualityFlags qual = CalculateBinaryQuality(enabled, Point.GetChangedTime());
+			CBTime changedtime;
+			uint8_t meas = Point.GetBinary(changedtime); // Value and time from the same update
+			QualityFlags qual = CalculateBinaryQuality(enabled, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Binary, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Binary, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Binary>(meas == 1);
 			PublishEvent(event);
 		});
@@ -985,12 +1071,13 @@ void CBMasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachAnalogPoint([this](CBAnalogCounterPoint& Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint16_t meas = Point.GetAnalog();
+			CBTime changedtime;
+			uint16_t meas = Point.GetAnalog(changedtime);
 
 			// If the measurement is MISSINGVALUE - there is a problem in the CB OutStation for that point.
-			QualityFlags qual = CalculateAnalogQuality(enabled, meas, Point.GetChangedTime());
+			QualityFlags qual = CalculateAnalogQuality(enabled, meas, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Analog, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Analog, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Analog>(std::move(meas));
 			PublishEvent(event);
 		});
@@ -999,11 +1086,12 @@ void CBMasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachCounterPoint([this](CBAnalogCounterPoint& Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint16_t meas = Point.GetAnalog();
+			CBTime changedtime;
+			uint16_t meas = Point.GetAnalog(changedtime);
 			// If the measurement is MISSINGVALUE - there is a problem in the CB OutStation for that point.
-			QualityFlags qual = CalculateAnalogQuality(enabled, meas, Point.GetChangedTime());
+			QualityFlags qual = CalculateAnalogQuality(enabled, meas, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Counter, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Counter, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Counter>(std::move(meas));
 			PublishEvent(event);
 		});
@@ -30,27 +30,83 @@
 #include "CBUtility.h"
 #include "CBPort.h"
 #include "CBPointTableAccess.h"
-#include <queue>
+#include "ProducerConsumerQueue.h"
+#include "RTTEstimator.h"
+#include <array>
+#include <map>
+#include <memory>
 #include <utility>
 #include <opendatacon/ASIOScheduler.h>
 
+// Commands are sent highest priority first, and in order within a priority. So controls don't wait behind a queue of polls.
+enum class CommandPriority : uint8_t
+{
+	Control = 0,
+	TimeSync,
+	EventScan,
+	IntegrityScan,
+	Count
+};
+
 // The command, and an ODC callback pointer - may be nullptr. We check for that
-typedef std::pair <CBMessage_t, SharedStatusCallback_t> MasterCommandQueueItem;
+// If the command came from a poll, the poll group, so we know when that poll is no longer waiting in the queue. 0 if not a poll.
+struct MasterCommandQueueItem
+{
+	MasterCommandQueueItem() = default;
+	MasterCommandQueueItem(const CBMessage_t& message, const SharedStatusCallback_t& pstatuscallback, uint32_t pollgroup = 0):
+		Message(message),
+		pStatusCallback(pstatuscallback),
+		PollGroup(pollgroup)
+	{}
+	CBMessage_t Message;
+	SharedStatusCallback_t pStatusCallback = nullptr;
+	uint32_t PollGroup = 0;
+};
+
+// One lock-free queue per priority. Any thread can Push, only the MasterCommandStrand can Pop.
+class PriorityCommandQueue
+{
+public:
+	explicit PriorityCommandQueue(const size_t capacity)
+	{
+		for (auto& q : Queues)
+			q = std::make_unique<ProducerConsumerQueue<MasterCommandQueueItem>>(capacity);
+	}
+	bool Push(const MasterCommandQueueItem& item, CommandPriority priority)
+	{
+		return Queues[static_cast<size_t>(priority)]->Push(item);
+	}
+	// Pop the highest priority command waiting
+	bool Pop(MasterCommandQueueItem& item)
+	{
+		for (auto& q : Queues)
+			if (q->Pop(item))
+				return true;
+		return false;
+	}
+	size_t Size(CommandPriority priority) const
+	{
+		return Queues[static_cast<size_t>(priority)]->Size();
+	}
+
+private:
+	std::array<std::unique_ptr<ProducerConsumerQueue<MasterCommandQueueItem>>, static_cast<size_t>(CommandPriority::Count)> Queues;
+};
 
 // This class contains the MasterCommandQueue and management variables that all need to be protected using the MasterCommandStrand strand.
 // It has a queue of commands to be processed, as well as variables to manage where we are up to in processing the current command.
-// As everything is only accessed in strand protected code, we don't need to use a thread safe queue.
+// The queue itself is lock-free, so commands can be pushed from any thread - it is only ever popped in strand protected code.
 class MasterCommandData
 {
 public:
-	unsigned int MaxCommandQueueSize = 20; //TODO: The maximum number of CB commands that can be in the master queue? Somewhat arbitrary??
-	std::queue<MasterCommandQueueItem> MasterCommandQueue;
+	PriorityCommandQueue MasterCommandQueue{20}; //TODO: The maximum number of CB commands of each priority that can be in the master queue? Somewhat arbitrary??
 	MasterCommandQueueItem CurrentCommand; // Keep a copy of what has been sent to make retries easier.
 	uint8_t CurrentFunctionCode = 0;       // When we send a command, make sure the response we get is one we are waiting for.
 	bool ProcessingCBCommand = false;
 	std::chrono::milliseconds TimerExpireTime = std::chrono::milliseconds(0);
 	pTimer_t CurrentCommandTimeoutTimer = nullptr;
 	uint32_t RetriesLeft = 0; // Decrementing counter for retries, if we get to zero move on to the next command.
+	std::chrono::steady_clock::time_point CommandSentTime; // For the round trip time of the current command
 };
 
 class CBMasterPort: public CBPort
@@ -62,6 +118,7 @@ public:
 	void Enable() override;
 	void Disable() override final;
 	void Build() override;
+	const Json::Value GetStatistics() const override;
 	void SendCBMessage(const CBMessage_t & CompleteCBMessage) override;
 
 	void SocketStateHandler(bool state);
@@ -82,8 +139,9 @@ public:
 	// If the callback gets an error it will be ignored which will result in a timeout and the next command (or retry) being sent.
 	// This is necessary if somehow we get an old command sent to us, or a left over broadcast message.
 	// Only issue is if we do a broadcast message and can get information back from multiple sources... These commands are probably not used, and we will ignore them anyway.
-	void QueueCBCommand(const CBMessage_t &CompleteCBMessage, const SharedStatusCallback_t& pStatusCallback);
-	void QueueCBCommand(const CBBlockData & SingleBlockCBMessage, const SharedStatusCallback_t& pStatusCallback); // Handle the many single block command messages better
+	// The pollgroup is only set for commands queued by DoPoll.
+	void QueueCBCommand(const CBMessage_t &CompleteCBMessage, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0);
+	void QueueCBCommand(const CBBlockData & SingleBlockCBMessage, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0); // Handle the many single block command messages better
 	void PostCallbackCall(const odc::SharedStatusCallback_t &pStatusCallback, CommandStatus c);
 
 	void ResetDigitalCommandSequenceNumber();
@@ -96,14 +154,15 @@ public:
 
 	//*** PUBLIC for unit tests only
 	void DoPoll(uint32_t payloadlocation);
-	void SendF0ScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback);
-	void SendFn9TimeUpdate(const SharedStatusCallback_t& pStatusCallback, int TimeOffsetMinutes = 0);
+	void SendF0ScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback, uint32_t pollgroup = 0);
+	void SendFn9TimeUpdate(const SharedStatusCallback_t& pStatusCallback, int TimeOffsetMinutes = 0, uint32_t pollgroup = 0);
 
 	static void BuildUpdateTimeMessage(uint8_t StationAddress, CBTime cbtime, CBMessage_t& CompleteCBMessage);
-	void SendFn10SOEScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback);
+	void SendFn10SOEScanCommand(uint8_t group, SharedStatusCallback_t pStatusCallback, uint32_t pollgroup = 0);
 
 	// Testing use only
 	CBPointTableAccess *GetPointTable() { return &(MyPointConf->PointTable); }
+	RTTEstimator &GetCommandRTT() { return CommandRTT; }
 	bool GetOutStationSOEBufferOverflowFlag() { return OutStationSOEBufferOverflow.getandset(false); };
 private:
 
@@ -116,15 +175,28 @@ private:
 	void SendNextMasterCommand();
 	CBMessage_t GetResendMessage();
 	void UnprotectedSendNextMasterCommand(bool timeoutoccured);
+	std::chrono::milliseconds GetCommandTimeout(uint32_t attempt) const;
 	void ClearCBCommandQueue();
+
+	RTTEstimator CommandRTT; // Updated only in MasterCommandStrand
+	std::atomic<uint64_t> NumCommandTimeouts{ 0 };
+	std::atomic<uint64_t> NumCommandRetries{ 0 };
+
+	static CommandPriority GetCommandPriority(const CBBlockData& FirstBlock);
+	bool IsPollQueued(uint32_t pollgroup) const;
+	void CommandDequeued(const MasterCommandQueueItem& item);
+	// How many commands from each poll group are waiting in the queue. A poll that is still waiting is not queued again.
+	// Only the atomics change after Build, so no lock needed.
+	std::map<uint32_t, std::atomic<uint32_t>> PollGroupQueued;
+	std::atomic<uint64_t> NumPollsCoalesced{ 0 };
 	void ProcessCBMessage(CBMessage_t& CompleteCBMessage);
 
 	bool ProcessScanRequestReturn(const CBMessage_t & CompleteCBMessage);
 	void ProccessScanPayload(uint16_t data, uint8_t group, PayloadLocationType payloadlocation);
 	void SendBinaryEvent(CBBinaryPoint & pt, uint8_t &bitvalue, const CBTime &now);
 	bool ProcessSOEScanRequestReturn(const CBBlockData & ReceivedHeader, const CBMessage_t & CompleteCBMessage);
-	bool ConvertSOEMessageToBitArray(const CBMessage_t & CompleteCBMessage, std::array<bool, MaxSOEBits>& BitArray, uint32_t & UsedBits);
-	void ForEachSOEEventInBitArray(std::array<bool, MaxSOEBits>& BitArray, uint32_t &UsedBits, const std::function<void(SOEEventFormat&soeevt)>& fn);
+	bool ConvertSOEMessageToBitStream(const CBMessage_t & CompleteCBMessage, CBSOEBitStream& Bits);
+	void ForEachSOEEventInBitStream(const CBSOEBitStream& Bits, const std::function<void(SOEEventFormat&soeevt)>& fn);
 	bool CheckResponseHeaderMatch(const CBBlockData & ReceivedHeader, const CBBlockData & SentHeader);
 
 	std::unique_ptr<ASIOScheduler> PollScheduler;
@@ -142,7 +142,7 @@ void CBOutstationPort::Build()
 	this->CBOutstationCollection->Add(shared_this, this->Name);
 
 	// Need a couple of things passed to the point table.
-	MyPointConf->PointTable.Build(Name, IsOutStation, *pIOS, MyPointConf->SOEQueueSize, SOEBufferOverflowFlag);
+	MyPointConf->PointTable.Build(Name, IsOutStation, MyPointConf->SOEQueueSize, SOEBufferOverflowFlag);
 
 	// Creates internally if necessary
 	pConnection = CBConnection::AddConnection(pIOS, IsServer(), MyConf->mAddrConf.IP, MyConf->mAddrConf.Port, MyPointConf->IsBakerDevice, MyConf->mAddrConf.TCPConnectRetryPeriodms); //Static method
@@ -161,25 +161,23 @@ void CBOutstationPort::SendCBMessage(const CBMessage_t &CompleteCBMessage)
 		LOGERROR("{} - Tried to send an empty message to the TCP Port",Name);
 		return;
 	}
-	if (BitFlipProbability != 0.0)
-	{
-		auto msg = CorruptCBMessage(CompleteCBMessage);
-		LOGDEBUG("{} - Sending Corrupted Message - Correct {}, Corrupted {}", Name, CBMessageAsString(CompleteCBMessage), CBMessageAsString(msg));
-		CBPort::SendCBMessage(msg);
-	}
-	else
-	{
-		LOGDEBUG("{} - Sending Message - {}", Name, CBMessageAsString(CompleteCBMessage));
-
-		// Done this way just to get context into log messages.
-		CBPort::SendCBMessage(CompleteCBMessage);
-	}
-	LastSentCBMessage = CompleteCBMessage; // Take a copy of last message
+	// Encode into the last message buffer, so a repeat request can send the same bytes again
+	LastSentCBMessage.resize(CBMessageBytes(CompleteCBMessage.size()));
+	CBEncodeMessage(CompleteCBMessage, LastSentCBMessage.data(), LastSentCBMessage.size(), MyPointConf->IsBakerDevice);
+	SendLastCBMessage();
 }
-CBMessage_t CBOutstationPort::CorruptCBMessage(const CBMessage_t& CompleteCBMessage)
+void CBOutstationPort::SendLastCBMessage()
 {
+	if (LastSentCBMessage.empty())
+	{
+		LOGERROR("{} - Tried to send an empty message to the TCP Port",Name);
+		return;
+	}
 	if (BitFlipProbability != 0.0)
 	{
+		// Corrupt a copy - the last message has to stay as it was for a repeat request
+		std::vector<uint8_t> msg = LastSentCBMessage;
+
 		// Setup a random generator
 		std::random_device rd;
 		std::mt19937 e2(rd());
@@ -187,15 +185,20 @@ CBMessage_t CBOutstationPort::CorruptCBMessage(const CBMessage_t& CompleteCBMess
 
 		if (dist(e2) > BitFlipProbability)
 		{
-			CBMessage_t ResMsg = CompleteCBMessage;
-			size_t messagelen = CompleteCBMessage.size();
-			std::uniform_real_distribution<> bitdist(0, messagelen * 32 - 1);
+			std::uniform_real_distribution<> bitdist(0, msg.size() * 8 - 1);
 			int bitnum = round(bitdist(e2));
-			ResMsg[bitnum / 32].XORBit(bitnum % 32);
-			return ResMsg;
+			msg[bitnum / 8] ^= static_cast<uint8_t>(1 << (7 - bitnum % 8));
 		}
+		LOGDEBUG("{} - Sending Corrupted Message - Correct {}, Corrupted {}", Name, CBMessageAsString(LastSentCBMessage.data(), LastSentCBMessage.size()), CBMessageAsString(msg.data(), msg.size()));
+		CBPort::SendEncodedCBMessage(msg.data(), msg.size());
+	}
+	else
+	{
+		LOGDEBUG("{} - Sending Message - {}", Name, CBMessageAsString(LastSentCBMessage.data(), LastSentCBMessage.size()));
+
+		// Done this way just to get context into log messages.
+		CBPort::SendEncodedCBMessage(LastSentCBMessage.data(), LastSentCBMessage.size());
 	}
-	return CompleteCBMessage;
 }
 #ifdef _MCS_VER
 #pragma region OpenDataConInteraction
@@ -29,6 +29,7 @@
 #include "CB.h"
 #include "CBPort.h"
 #include "CBUtility.h"
+#include "CBCodec.h"
 #include "CBConnection.h"
 #include "CBPointTableAccess.h"
 #include <unordered_map>
@@ -118,11 +119,8 @@ public:
 	CommandStatus Perform(const std::shared_ptr<EventInfo>& event, bool waitforresult);
 
 	void SendCBMessage(const CBMessage_t & CompleteCBMessage) override;
-	CBMessage_t CorruptCBMessage(const CBMessage_t& CompleteCBMessage);
-	void ResendLastCBMessage()
-	{
-		SendCBMessage(LastSentCBMessage);
-	}
+	// Sends (or resends) the encoded message in LastSentCBMessage
+	void SendLastCBMessage();
 	void ProcessCBMessage(CBMessage_t &CompleteCBMessage);
 
 	// Response to PendingCommand Methods
@@ -139,14 +137,14 @@ public:
 
 	void ConvertPayloadWordsToCBMessage(CBBlockData & Header, std::vector<uint16_t> &PayloadWords, CBMessage_t &ResponseCBMessage);
 
-	void ConvertBitArrayToPayloadWords(const uint32_t UsedBits, std::array<bool, MaxSOEBits> &BitArray, std::vector<uint16_t> &PayloadWords);
+	void ConvertBitStreamToPayloadWords(const CBSOEBitStream& Bits, std::vector<uint16_t> &PayloadWords);
 
-	void BuildPackedEventBitArray(std::array<bool, MaxSOEBits> &BitArray, uint32_t &UsedBits);
+	void BuildPackedEventBitStream(CBSOEBitStream& Bits);
 
 	void ProcessUpdateTimeRequest(CBMessage_t & CompleteCBMessage);
 	void EchoReceivedHeaderToMaster(CBBlockData & Header);
 
-	void BuildScanRequestResponseData(uint8_t Group, std::vector<uint16_t>& BlockValues);
+	void BuildScanRequestResponseData(uint8_t Group, CBScanPayloads_t& BlockValues);
 	uint16_t GetPayload(uint8_t &Group, PayloadLocationType &payloadlocation);
 
 	void MarkAllBinaryPointsAsChanged();
@@ -176,7 +174,7 @@ private:
 
 	void SocketStateHandler(bool state);
 
-	CBMessage_t LastSentCBMessage;
+	std::vector<uint8_t> LastSentCBMessage; // Encoded, Baker/Conitel swap done. Keeps its capacity, so no allocation per message
 	CBMessage_t LastSentSOEMessage; // For SOE specific resend commands.
 
 	PendingCommandType PendingCommands[16+1]; // Store a potential pending command for each group.
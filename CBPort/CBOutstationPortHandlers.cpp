@@ -137,44 +137,20 @@ void CBOutstationPort::ScanRequest(CBBlockData &Header)
 	LOGDEBUG("{} - ScanRequest - Fn0 - Group {}",Name, Header.GetGroup());
 
 	// Assemble the block values A and B in order ready to be placed into the response message.
-	std::vector<uint16_t> BlockValues;
+	CBScanPayloads_t BlockValues;
 
 	// Use the group definition to assemble the scan data
 	BuildScanRequestResponseData(Header.GetGroup(), BlockValues);
 
-	// Now assemble and return the required response..
-	CBMessage_t ResponseCBMessage;
-	uint32_t index = 0;
-	uint16_t FirstBlockBValue = 0x000; // Default
-
-	if (BlockValues.size() > 0)
-	{
-		FirstBlockBValue = BlockValues[index++];
-	}
-
-	// The first block is mostly an echo of the request, except that the B field contains data.
-	auto firstblock = CBBlockData(Header.GetStationAddress(), Header.GetGroup(), Header.GetFunctionCode(), FirstBlockBValue, BlockValues.size() < 2);
-	ResponseCBMessage.push_back(firstblock);
-
-	// index will be 1 when we get to here..
-	while (index < BlockValues.size())
-	{
-		uint16_t A = BlockValues[index++];
-
-		// If there is no B value, default to zero.
-		uint16_t B = 0x00;
-		if (index < BlockValues.size())
-		{
-			B = BlockValues[index++]; // This should always be triggered as our BuildScanResponseData should give us a full message. We handle the missing case anyway!
-		}
-		auto block = CBBlockData(A, B, index >= BlockValues.size()); // Just some data, end of message is true if we have no more data.
-		ResponseCBMessage.push_back(block);
-	}
-
-	SendCBMessage(ResponseCBMessage);
+	// Now encode the response straight into the last message buffer - the first block is mostly an echo of the request,
+	// except that the B field contains data, then the A and B values in order.
+	LastSentCBMessage.resize(CBMessageBytes(MAX_BLOCK_COUNT));
+	const size_t len = CBEncodeScanResponse(Header, BlockValues.data(), BlockValues.size(), LastSentCBMessage.data(), LastSentCBMessage.size(), MyPointConf->IsBakerDevice);
+	LastSentCBMessage.resize(len);
+	SendLastCBMessage();
 }
 
-void CBOutstationPort::BuildScanRequestResponseData(uint8_t Group, std::vector<uint16_t>& BlockValues)
+void CBOutstationPort::BuildScanRequestResponseData(uint8_t Group, CBScanPayloads_t& BlockValues)
 {
 	// We now have to collect all the current values for this group.
 	// Search for the group and payload location, and if we have data process it. We have to search 3 lists and the RST table to get what we need
@@ -533,7 +509,7 @@ bool CBOutstationPort::ExecuteBinaryControl(uint8_t group, uint8_t channel, bool
 	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
 	val.functionCode = point_on ? ControlCode::LATCH_ON : ControlCode::LATCH_OFF;
 
-	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name);
+	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, GetID());
 	event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
 
 	bool waitforresult = !MyPointConf->StandAloneOutstation;
@@ -558,7 +534,7 @@ bool CBOutstationPort::ExecuteAnalogControl(uint8_t group, uint8_t channel, uint
 	EventTypePayload<EventType::AnalogOutputInt16>::type val;
 	val.first = numeric_cast<short>(data);
 
-	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, Name);
+	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, GetID());
 	event->SetPayload<EventType::AnalogOutputInt16>(std::move(val));
 
 	bool waitforresult = !MyPointConf->StandAloneOutstation;
@@ -623,8 +599,8 @@ void CBOutstationPort::FuncMasterStationRequest(CBBlockData & Header, CBMessage_
 			break;
 
 		case MASTER_SUB_FUNC_REPEAT_PREVIOUS_TRANSMISSION:
-			LOGDEBUG("{} Resending Last Message as a Repeat Last Transmission - {}", CBMessageAsString(LastSentCBMessage));
-			ResendLastCBMessage();
+			LOGDEBUG("{} Resending Last Message as a Repeat Last Transmission - {}", Name, CBMessageAsString(LastSentCBMessage.data(), LastSentCBMessage.size()));
+			SendLastCBMessage();
 			break;
 
 		case MASTER_SUB_FUNC_SET_LOOPBACKS:
@@ -668,17 +644,16 @@ void CBOutstationPort::FuncSendSOEResponse(CBBlockData & Header)
 	else
 	{
 		// The maximum number of bits we can send is 12 * 31 = 372.
-		uint32_t UsedBits = 0;
-		std::array<bool, MaxSOEBits> BitArray{};
+		CBSOEBitStream Bits;
 
-		BuildPackedEventBitArray(BitArray, UsedBits);
+		BuildPackedEventBitStream(Bits);
 
 		// Using an vector of uint16_t to store up to 31 x 12 bit blocks of data.
 		// Store the data in the bottom 12 bits of the 16 bit word.
 		std::vector<uint16_t> PayloadWords;
 		PayloadWords.reserve(32); // To stop reallocations when we know max size.
 
-		ConvertBitArrayToPayloadWords(UsedBits, BitArray, PayloadWords);
+		ConvertBitStreamToPayloadWords(Bits, PayloadWords);
 
 		// We now have the payloads ready to load into Conitel packets.
 		ConvertPayloadWordsToCBMessage(Header, PayloadWords, ResponseCBMessage);
@@ -717,31 +692,16 @@ void CBOutstationPort::ConvertPayloadWordsToCBMessage(CBBlockData & Header, std:
 	}
 	ResponseCBMessage.back().MarkAsEndOfMessageBlock();
 }
-void CBOutstationPort::ConvertBitArrayToPayloadWords(const uint32_t UsedBits, std::array<bool, MaxSOEBits> &BitArray, std::vector<uint16_t> &PayloadWords)
+void CBOutstationPort::ConvertBitStreamToPayloadWords(const CBSOEBitStream& Bits, std::vector<uint16_t> &PayloadWords)
 {
-	uint8_t BlockCount = UsedBits / 12 + ((UsedBits % 12 == 0) ? 0 : 1);
-	if (BlockCount > 31)
+	// The bit stream can never hold more than 31 payloads, and is zero past the last bit used, so the last payload is zero padded.
+	uint32_t BlockCount = Bits.PayloadCount();
+	for (uint32_t block = 0; block < BlockCount; block++)
 	{
-		LOGERROR("{} ConvertBitArrayToPayloadWords - blockcount exceeded 31!! {}",Name, BlockCount);
-		BlockCount = 31;
-	}
-	for (uint8_t block = 0; block < BlockCount; block++)
-	{
-		uint16_t payload = 0;
-		for (size_t i = 0; i < 12; i++)
-		{
-			size_t bitindex = (size_t)block * 12 + i;
-			if (bitindex >= MaxSOEBits)
-			{
-				LOGERROR("{} ConvertBitArrayToPayloadWords - bit index exceeded {}!! {}", Name, MaxSOEBits, bitindex);
-				break; // Dont do any more bits!
-			}
-			payload |= ShiftLeftResult16Bits(BitArray[bitindex] ? 1 : 0, 11 - i);
-		}
-		PayloadWords.push_back(payload);
+		PayloadWords.push_back(Bits.GetPayload(block));
 	}
 }
-void CBOutstationPort::BuildPackedEventBitArray(std::array<bool, MaxSOEBits> &BitArray, uint32_t &UsedBits)
+void CBOutstationPort::BuildPackedEventBitStream(CBSOEBitStream& Bits)
 {
 	// The SOE data is built into a stream of bits (that may not be block aligned) and then it is stuffed 12 bits at a time into the available Payload locations - up to 31.
 	// First section format:
@@ -762,10 +722,10 @@ void CBOutstationPort::BuildPackedEventBitArray(std::array<bool, MaxSOEBits> &Bi
 		{
 			// We have run out of data, so break out of the loop, but first we need to set the last event flag in the previous packet--this is the last bit in the vector
 			// SET LAST EVENT FLAG
-			if (UsedBits <= MaxSOEBits)
-				BitArray[UsedBits - 1] = true; // This index is safe as to get to here there must have been at least one SOE processed.
+			if (Bits.Size() != 0)
+				Bits.SetBit(Bits.Size() - 1, true); // To get to here there must have been at least one SOE processed.
 			else
-				LOGERROR("{} BuildPackedEventBitArray UsedBits Exceeded MaxSOEBits",Name);
+				LOGERROR("{} BuildPackedEventBitStream No SOE events added",Name);
 			break;
 		}
 
@@ -793,8 +753,8 @@ void CBOutstationPort::BuildPackedEventBitArray(std::array<bool, MaxSOEBits> &Bi
 
 		PackedEvent.LastEventFlag = false; // Might be changed on the loop exit, if there is nothing left in the SOE queue.
 
-		// Now stuff the bits (41 or 30) into our bit array, at the end of the current data.
-		if (PackedEvent.AddDataToBitArray(BitArray,UsedBits))
+		// Now stuff the bits (41 or 30) into our bit stream, at the end of the current data.
+		if (PackedEvent.AddDataToBitStream(Bits))
 		{
 			// Pop the event so we can move onto the next one
 			MyPointConf->PointTable.PopNextTaggedEventPoint();
@@ -805,10 +765,6 @@ void CBOutstationPort::BuildPackedEventBitArray(std::array<bool, MaxSOEBits> &Bi
 			break; // Exit the while loop.
 		}
 	}
-
-	// We must zero any remaining bits in the array. The payload packing later makes an assumption about this!
-	for (uint32_t i = UsedBits; i < MaxSOEBits; i++)
-		BitArray[i] = false;
 }
 // We use this to calculate an offset, which is then used when packaging up the SOE time stamps (added or subtracted)
 // just echo message - normally it is UTC time of day in milliseconds since 1970 (CBTime()). Could be any time zone in practice.
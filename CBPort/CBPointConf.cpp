@@ -132,6 +132,21 @@ void CBPointConf::ProcessElements(const Json::Value& JSONRoot)
 			CBCommandRetries = JSONRoot["CBCommandRetries"].asUInt();
 			LOGDEBUG("Conf processed - CBCommandRetries - {}", std::to_string(CBCommandRetries));
 		}
+		if (JSONRoot.isMember("CBAdaptiveTimeout"))
+		{
+			CBAdaptiveTimeout = JSONRoot["CBAdaptiveTimeout"].asBool();
+			LOGDEBUG("Conf processed - CBAdaptiveTimeout - {}", CBAdaptiveTimeout);
+		}
+		if (JSONRoot.isMember("CBCommandTimeoutMinmsec"))
+		{
+			CBCommandTimeoutMinmsec = JSONRoot["CBCommandTimeoutMinmsec"].asUInt();
+			LOGDEBUG("Conf processed - CBCommandTimeoutMinmsec - {}", std::to_string(CBCommandTimeoutMinmsec));
+		}
+		if (JSONRoot.isMember("CBCommandTimeoutMaxmsec"))
+		{
+			CBCommandTimeoutMaxmsec = JSONRoot["CBCommandTimeoutMaxmsec"].asUInt();
+			LOGDEBUG("Conf processed - CBCommandTimeoutMaxmsec - {}", std::to_string(CBCommandTimeoutMaxmsec));
+		}
 	}
 	catch (const std::exception& e)
 	{
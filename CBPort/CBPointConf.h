@@ -95,6 +95,11 @@ public:
 	uint32_t CBCommandTimeoutmsec = 5000;
 	// How many times do we retry a command, before we give up and move onto the next one?
 	uint32_t CBCommandRetries = 3;
+	// If true, the Master timeout follows the measured round trip time of the Station, starting at CBCommandTimeoutmsec.
+	// Kept between the min and max, and doubled on each retry. A max of 0 means 4 x CBCommandTimeoutmsec.
+	bool CBAdaptiveTimeout = false;
+	uint32_t CBCommandTimeoutMinmsec = 100;
+	uint32_t CBCommandTimeoutMaxmsec = 0;
 	std::string FileName;
 };
 #endif
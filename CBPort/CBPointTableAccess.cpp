@@ -29,15 +29,26 @@
 #include "CBPortConf.h"
 
 CBPointTableAccess::CBPointTableAccess()
-{}
+{
+	SOEODCIndex.fill(NOSOEPOINT);
+}
 
-void CBPointTableAccess::Build(const std::string& _Name, const bool isoutstation, odc::asio_service &IOS, unsigned int SOEQueueSize, std::shared_ptr<protected_bool> SOEBufferOverflowFlag)
+void CBPointTableAccess::Build(const std::string& _Name, const bool isoutstation, unsigned int SOEQueueSize, std::shared_ptr<protected_bool> _SOEBufferOverflowFlag)
 {
 	Name = _Name;
 	IsOutstation = isoutstation;
 	// Setup TimeTagged event queue.
 	// The size (default 500) does not consume memory, just sets an upper limit to the number of items in the queue.
-	pBinaryTimeTaggedEventQueue = std::make_shared<StrandProtectedQueue<CBBinaryPoint>>(IOS, SOEQueueSize, SOEBufferOverflowFlag);
+	pBinaryTimeTaggedEventQueue = std::make_shared<ProducerConsumerQueue<CBBinaryPoint>>(SOEQueueSize);
+	SOEBufferOverflowFlag = _SOEBufferOverflowFlag;
+	SOEBufferOverflowFlag->set(false);
+
+	// All the points are loaded now - lay each table out in Group/Payload/Channel order
+	BinaryPoints.Compact();
+	AnalogPoints.Compact();
+	CounterPoints.Compact();
+	BinaryControlPoints.Compact();
+	AnalogControlPoints.Compact();
 }
 
 #ifdef _MSC_VER
@@ -46,8 +57,8 @@ void CBPointTableAccess::Build(const std::string& _Name, const bool isoutstation
 
 bool CBPointTableAccess::AddCounterPointToPointTable(const size_t &index, const uint8_t &group, const uint8_t &channel, const PayloadLocationType &payloadlocation, const AnalogCounterPointType &pointtype)
 {
-	uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
-	if (CounterCBPointMap.find(CBIndex) != CounterCBPointMap.end())
+	const size_t slot = CBSlot(group, channel, payloadlocation);
+	if (CounterPoints.HasSlot(slot))
 	{
 		LOGERROR("{} Error Duplicate Counter CB Index {} - {} - {}",Name,group,channel, payloadlocation.to_string());
 		return false;
@@ -55,25 +66,19 @@ bool CBPointTableAccess::AddCounterPointToPointTable(const size_t &index, const
 
 	UpdateMaxPayload(group, payloadlocation);
 
-	if (CounterODCPointMap.find(index) != CounterODCPointMap.end())
+	if (CounterPoints.HasODCIndex(index))
 	{
 		LOGWARN("{} Warning Duplicate Counter ODC Index : {}",Name,index);
 		//Find the point and add to the CB table again
-		CounterCBPointMap[CBIndex] = CounterODCPointMap[index]; //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
+		return CounterPoints.AddAlias(slot, index); //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
 	}
-	else
-	{
-		auto pt = std::make_shared<CBAnalogCounterPoint>(index, group, channel, payloadlocation,pointtype);
-		CounterCBPointMap[CBIndex] = pt;
-		CounterODCPointMap[index] = pt;
-	}
-	return true;
+	return CounterPoints.Add(slot, CBAnalogCounterPoint(index, group, channel, payloadlocation, pointtype));
 }
 
 bool CBPointTableAccess::AddAnalogPointToPointTable(const size_t &index, const uint8_t &group, const uint8_t &channel, const PayloadLocationType &payloadlocation, const AnalogCounterPointType &pointtype)
 {
-	uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
-	if (AnalogCBPointMap.find(CBIndex) != AnalogCBPointMap.end())
+	const size_t slot = CBSlot(group, channel, payloadlocation);
+	if (AnalogPoints.HasSlot(slot))
 	{
 		LOGERROR("{} Error Duplicate Analog CB Index {} - {} - {}",Name,group,channel,payloadlocation.to_string());
 		return false;
@@ -81,18 +86,12 @@ bool CBPointTableAccess::AddAnalogPointToPointTable(const size_t &index, const u
 
 	UpdateMaxPayload(group, payloadlocation);
 
-	if (AnalogODCPointMap.find(index) != AnalogODCPointMap.end())
+	if (AnalogPoints.HasODCIndex(index))
 	{
 		LOGWARN("{} Warning Duplicate Analog ODC Index : {}",Name,index);
-		AnalogCBPointMap[CBIndex] = AnalogODCPointMap[index]; //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
+		return AnalogPoints.AddAlias(slot, index); //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
 	}
-	else
-	{
-		auto pt = std::make_shared<CBAnalogCounterPoint>(index, group, channel, payloadlocation, pointtype);
-		AnalogCBPointMap[CBIndex] = pt;
-		AnalogODCPointMap[index] = pt;
-	}
-	return true;
+	return AnalogPoints.Add(slot, CBAnalogCounterPoint(index, group, channel, payloadlocation, pointtype));
 }
 
 bool CBPointTableAccess::CheckForBinaryBitClash(const uint8_t group, uint8_t channel, const PayloadLocationType& payloadlocation, const BinaryPointType& pointtype)
@@ -138,9 +137,9 @@ bool CBPointTableAccess::AddBinaryPointToPointTable(const size_t &index, const u
 	//TODO: We dont allow double bit points and single bit DIG's to occupy the same payload - it is hard to detect collisions if we do...
 	// how to check for this???
 
-	uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
+	const size_t slot = CBSlot(group, channel, payloadlocation);
 
-	if (BinaryCBPointMap.find(CBIndex) != BinaryCBPointMap.end())
+	if (BinaryPoints.HasSlot(slot))
 	{
 		LOGERROR("{} Error Duplicate Binary CB Index {} - {} - {}",Name,group,channel,payloadlocation.to_string());
 		return false;
@@ -151,51 +150,44 @@ bool CBPointTableAccess::AddBinaryPointToPointTable(const size_t &index, const u
 
 	UpdateMaxPayload(group, payloadlocation);
 
-	if (BinaryODCPointMap.find(index) != BinaryODCPointMap.end())
+	if (BinaryPoints.HasODCIndex(index))
 	{
 		LOGWARN("{} Warning Duplicate Binary ODC Index : {}",Name,index);
-		BinaryCBPointMap[CBIndex] = BinaryODCPointMap[index]; //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
+		return BinaryPoints.AddAlias(slot, index); //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
 	}
-	else
-	{
-		LOGDEBUG("{} Adding Binary Point at CBIndex - {}",Name,to_hexstring(CBIndex));
-		auto pt = std::make_shared<CBBinaryPoint>(index, group, channel, payloadlocation, pointtype, issoe, soeindex);
-		BinaryCBPointMap[CBIndex] = pt;
-		BinaryODCPointMap[index] = pt;
 
-		if (issoe)
-		{
-			assert(soeindex <= 120);
-			BinarySOEPointMap[soeindex] = pt;
-		}
+	LOGDEBUG("{} Adding Binary Point at CBIndex - {}",Name,to_hexstring(GetCBPointMapIndex(group, channel, payloadlocation)));
+	if (!BinaryPoints.Add(slot, CBBinaryPoint(index, group, channel, payloadlocation, pointtype, issoe, soeindex)))
+		return false;
+
+	if (issoe)
+	{
+		assert(soeindex <= 120);
+		SOEODCIndex[soeindex] = index;
 	}
 	return true;
 }
 
 bool CBPointTableAccess::AddStatusByteToCBMap(const uint8_t & group, const uint8_t & channel, const PayloadLocationType & payloadlocation)
 {
-	uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
-	if (StatusByteMap.find(CBIndex) != StatusByteMap.end())
+	const size_t slot = CBSlot(group, channel, payloadlocation);
+	if (slot >= CBSlots || StatusBytes[slot])
 	{
 		LOGERROR("{} Error Duplicate Status Byte CB Index {} - {} - {}",Name,group,channel, payloadlocation.to_string());
 		return false;
 	}
 
 	UpdateMaxPayload(group, payloadlocation);
-	StatusByteMap[CBIndex] = 0; // Creates the map entry
+	StatusBytes[slot] = true;
 	return true;
 }
 
 void CBPointTableAccess::UpdateMaxPayload(const uint8_t & group, const PayloadLocationType & payloadlocation)
 {
 	// Keep track of the max payload so we know when we have processed them all.
-	if (MaxiumPayloadPerGroupMap.count(group) == 0)
+	if ((group < MaxiumPayloadPerGroup.size()) && (MaxiumPayloadPerGroup[group] < payloadlocation.Packet))
 	{
-		MaxiumPayloadPerGroupMap[group] = payloadlocation.Packet;
-	}
-	else if (MaxiumPayloadPerGroupMap[group] < payloadlocation.Packet)
-	{
-		MaxiumPayloadPerGroupMap[group] = payloadlocation.Packet;
+		MaxiumPayloadPerGroup[group] = payloadlocation.Packet;
 	}
 }
 #ifdef _MSC_VER
@@ -207,46 +199,37 @@ bool CBPointTableAccess::AddAnalogControlPointToPointTable(const size_t &index,
 {
 	// TODO: We do not detect collisions that could be caused by mixing analog types in the one payload (any mix 12 bit and 6 bit)
 	// will be a problem in any situaton at they will not fit..
-	uint16_t CBIndex = GetCBControlPointMapIndex(group, channel);
-	if (AnalogControlCBPointMap.find(CBIndex) != AnalogControlCBPointMap.end())
+	const size_t slot = CBControlSlot(group, channel);
+	if (AnalogControlPoints.HasSlot(slot))
 	{
 		LOGERROR("{} Error Duplicate Analog CB Index {} - {}",Name,group,channel);
 		return false;
 	}
 
-	if (AnalogControlODCPointMap.find(index) != AnalogControlODCPointMap.end())
+	if (AnalogControlPoints.HasODCIndex(index))
 	{
 		LOGERROR("{} Duplicate Analog ODC Index : {}",Name,index);
-		AnalogControlCBPointMap[CBIndex] = AnalogControlODCPointMap[index]; //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
+		return AnalogControlPoints.AddAlias(slot, index); //TODO: This will cause problems as the point has a group variable that will not be correct...do we need a group list?
 	}
-	else
-	{
-		auto pt = std::make_shared<CBAnalogCounterPoint>(index, group, channel, PayloadLocationType(1, PayloadABType::PositionB), pointtype);
-		AnalogControlCBPointMap[CBIndex] = pt;
-		AnalogControlODCPointMap[index] = pt;
-	}
-	return true;
+	return AnalogControlPoints.Add(slot, CBAnalogCounterPoint(index, group, channel, PayloadLocationType(1, PayloadABType::PositionB), pointtype));
 }
 bool CBPointTableAccess::AddBinaryControlPointToPointTable(const size_t &index, const uint8_t &group, const uint8_t &channel, const BinaryPointType &pointtype)
 {
-	uint16_t CBIndex = GetCBControlPointMapIndex(group, channel);
+	const size_t slot = CBControlSlot(group, channel);
 
-	if (BinaryControlCBPointMap.find(CBIndex) != BinaryControlCBPointMap.end())
+	if (BinaryControlPoints.HasSlot(slot))
 	{
 		LOGERROR("{} Duplicate BinaryControl CB Index {} - {}",Name,group,channel);
 		return false;
 	}
 
-	if (BinaryControlODCPointMap.find(index) != BinaryControlODCPointMap.end())
+	if (BinaryControlPoints.HasODCIndex(index))
 	{
 		LOGERROR("{} Duplicate BinaryControl ODC Index : {}",Name,index);
 		return false;
 	}
 
-	auto pt = std::make_shared<CBBinaryPoint>(index, group, channel, PayloadLocationType(1,PayloadABType::PositionB), pointtype, false,0);
-	BinaryControlCBPointMap[CBIndex] = pt;
-	BinaryControlODCPointMap[index] = pt;
-	return true;
+	return BinaryControlPoints.Add(slot, CBBinaryPoint(index, group, channel, PayloadLocationType(1,PayloadABType::PositionB), pointtype, false,0));
 }
 #ifdef _MSC_VER
 #pragma endregion
@@ -254,31 +237,28 @@ bool CBPointTableAccess::AddBinaryControlPointToPointTable(const size_t &index,
 
 bool CBPointTableAccess::GetCounterValueUsingODCIndex(const size_t index, uint16_t &res, bool &hasbeenset)
 {
-	auto ODCPointMapIter = CounterODCPointMap.find(index);
-	if (ODCPointMapIter != CounterODCPointMap.end())
+	if (auto pt = CounterPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetAnalog();
-		hasbeenset = ODCPointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalog();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::SetCounterValueUsingODCIndex(const size_t index, const uint16_t meas)
 {
-	auto ODCPointMapIter = CounterODCPointMap.find(index);
-	if (ODCPointMapIter != CounterODCPointMap.end())
+	if (auto pt = CounterPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetAnalog(meas, CBNowUTC());
+		pt->SetAnalog(meas, CBNowUTC());
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::ResetCounterValueUsingODCIndex(const size_t index)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = CounterPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->ResetAnalog(); // Sets to MISSINGVALUE, time = 0, HasBeenSet to false
+		pt->ResetAnalog(); // Sets to MISSINGVALUE, time = 0, HasBeenSet to false
 		return true;
 	}
 	return false;
@@ -286,30 +266,27 @@ bool CBPointTableAccess::ResetCounterValueUsingODCIndex(const size_t index)
 
 bool CBPointTableAccess::GetAnalogValueUsingODCIndex(const size_t index, uint16_t &res, bool &hasbeenset)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetAnalogAndHasBeenSet( hasbeenset);
+		res = pt->GetAnalogAndHasBeenSet( hasbeenset);
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::SetAnalogValueUsingODCIndex(const size_t index, const uint16_t meas)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetAnalog(meas, CBNowUTC());
+		pt->SetAnalog(meas, CBNowUTC());
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::ResetAnalogValueUsingODCIndex(const size_t index)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->ResetAnalog(); // Sets to MISSINGVALUE, time = 0, HasBeenSet to false
+		pt->ResetAnalog(); // Sets to MISSINGVALUE, time = 0, HasBeenSet to false
 		return true;
 	}
 	return false;
@@ -322,32 +299,30 @@ bool CBPointTableAccess::ResetAnalogValueUsingODCIndex(const size_t index)
 // Get value and reset changed flag..
 bool CBPointTableAccess::GetBinaryValueUsingODCIndexAndResetChangedFlag(const size_t index, uint8_t &res, bool &changed, bool &hasbeenset)
 {
-	auto ODCPointMapIter = BinaryODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryODCPointMap.end())
+	if (auto pt = BinaryPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetBinary();
-		changed = ODCPointMapIter->second->GetAndResetChangedFlag();
-		hasbeenset = ODCPointMapIter->second->GetHasBeenSet();
+		res = pt->GetBinary();
+		changed = pt->GetAndResetChangedFlag();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::SetBinaryValueUsingODCIndex(const size_t index, const uint8_t meas, const CBTime eventtime)
 {
-	auto ODCPointMapIter = BinaryODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryODCPointMap.end())
+	if (auto pt = BinaryPoints.AtODCIndex(index))
 	{
 		// Store SOE event to the SOE queue. If we receive a binary event that is older than the last one, it only goes in the SOE queue.
-		if (ODCPointMapIter->second->GetIsSOE() && IsOutstation)
-			AddToDigitalEvents(*ODCPointMapIter->second, meas, eventtime); // Don't store if master - we just fire off ODC events.
+		if (pt->GetIsSOE() && IsOutstation)
+			AddToDigitalEvents(*pt, meas, eventtime); // Don't store if master - we just fire off ODC events.
 
 		// Now check that the data we want to set is actually newer than (or equal to) the current point information. i.e. dont go backwards!
-		if (eventtime > ODCPointMapIter->second->GetChangedTime())
+		if (eventtime > pt->GetChangedTime())
 		{
-			ODCPointMapIter->second->SetBinary(meas, eventtime);
+			pt->SetBinary(meas, eventtime);
 		}
 		//	else
-		//		LOGDEBUG("Received a SetBinaryValue command that is older than the current binary data {}, {}", ODCPointMapIter->second->GetChangedTime(), eventtime);
+		//		LOGDEBUG("Received a SetBinaryValue command that is older than the current binary data {}, {}", pt->GetChangedTime(), eventtime);
 		return true;
 	}
 	return false;
@@ -356,10 +331,9 @@ bool CBPointTableAccess::GetBinaryODCIndexUsingSOE( const uint8_t soeindex, size
 {
 	if (soeindex > 120) return false;
 
-	auto SOEPointMapIter = BinarySOEPointMap.find(soeindex);
-	if (SOEPointMapIter != BinarySOEPointMap.end())
+	if (SOEODCIndex[soeindex] != NOSOEPOINT)
 	{
-		index = SOEPointMapIter->second->GetIndex();
+		index = SOEODCIndex[soeindex];
 		return true;
 	}
 	return false;
@@ -373,24 +347,40 @@ void CBPointTableAccess::AddToDigitalEvents(const CBBinaryPoint &inpt, const uin
 		CBBinaryPoint pt = inpt;
 		pt.SetBinary(meas, eventtime);
 
+		// Keep the last space in the queue for the overflow point
+		if (pBinaryTimeTaggedEventQueue->Push(pt, 1))
+		{
+			LOGDEBUG("{} Outstation Added Binary Event to SOE Queue - ODCIndex {}, Value {}",Name, pt.GetIndex(),pt.GetBinary());
+			return;
+		}
+
 		// Set the queue point value, just so we can set the time. The value does not matter.
-		queuefullpt.SetBinary(1, CBNowUTC());
+		CBBinaryPoint fullpt = queuefullpt;
+		fullpt.SetBinary(1, CBNowUTC());
 
-		pBinaryTimeTaggedEventQueue->async_push(pt, queuefullpt, odc::spdlog_get("CBPort"));
-		LOGDEBUG("{} Outstation Added Binary Event to SOE Queue - ODCIndex {}, Value {}",Name, pt.GetIndex(),pt.GetBinary());
+		if (pBinaryTimeTaggedEventQueue->Push(fullpt))
+		{
+			SOEBufferOverflowFlag->set(true);
+			LOGDEBUG("{} Outstation SOE Queue Overflow - Overflow pont (127) added to the queue",Name);
+		}
+		else
+		{
+			// No space - dump
+			LOGDEBUG("{} Outstation SOE Queue Overflow - Point dumped",Name);
+		}
 	}
 }
 bool CBPointTableAccess::PeekNextTaggedEventPoint(CBBinaryPoint &pt)
 {
-	return pBinaryTimeTaggedEventQueue->sync_front(pt);
+	return pBinaryTimeTaggedEventQueue->Peek(pt);
 }
 bool CBPointTableAccess::PopNextTaggedEventPoint( )
 {
-	return pBinaryTimeTaggedEventQueue->sync_pop();
+	return pBinaryTimeTaggedEventQueue->Pop();
 }
 bool CBPointTableAccess::TimeTaggedDataAvailable()
 {
-	return !pBinaryTimeTaggedEventQueue->sync_empty();
+	return !pBinaryTimeTaggedEventQueue->IsEmpty();
 }
 // Dumps the points out in a list, only used for UnitTests
 std::vector<CBBinaryPoint> CBPointTableAccess::DumpTimeTaggedPointList( )
@@ -399,10 +389,10 @@ std::vector<CBBinaryPoint> CBPointTableAccess::DumpTimeTaggedPointList( )
 	std::vector<CBBinaryPoint> PointList;
 	PointList.reserve(50);
 
-	while (pBinaryTimeTaggedEventQueue->sync_front(CurrentPoint))
+	while (pBinaryTimeTaggedEventQueue->Peek(CurrentPoint))
 	{
 		PointList.emplace_back(CurrentPoint);
-		pBinaryTimeTaggedEventQueue->sync_pop();
+		pBinaryTimeTaggedEventQueue->Pop();
 	}
 
 	return PointList;
@@ -415,87 +405,75 @@ std::vector<CBBinaryPoint> CBPointTableAccess::DumpTimeTaggedPointList( )
 
 bool CBPointTableAccess::GetBinaryControlODCIndexUsingCBIndex(const uint8_t group, const uint8_t channel, size_t &index)
 {
-	uint16_t CBIndex = GetCBControlPointMapIndex(group, channel);
-
-	auto CBPointMapIter = BinaryControlCBPointMap.find(CBIndex);
-	if (CBPointMapIter != BinaryControlCBPointMap.end())
+	if (auto pt = BinaryControlPoints.AtSlot(CBControlSlot(group, channel)))
 	{
-		index = CBPointMapIter->second->GetIndex();
+		index = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::GetBinaryControlCBIndexUsingODCIndex(const size_t index, uint8_t &group, uint8_t &channel)
 {
-	auto ODCPointMapIter = BinaryControlODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryControlODCPointMap.end())
+	if (auto pt = BinaryControlPoints.AtODCIndex(index))
 	{
-		group = ODCPointMapIter->second->GetGroup();
-		channel = ODCPointMapIter->second->GetChannel();
+		group = pt->GetGroup();
+		channel = pt->GetChannel();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::GetBinaryControlValueUsingODCIndex(const size_t index, uint8_t &res, bool &hasbeenset)
 {
-	auto ODCPointMapIter = BinaryControlODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryControlODCPointMap.end())
+	if (auto pt = BinaryControlPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetBinary();
-		hasbeenset = ODCPointMapIter->second->GetHasBeenSet();
+		res = pt->GetBinary();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::SetBinaryControlValueUsingODCIndex(const size_t index, const uint8_t meas, CBTime eventtime)
 {
-	auto ODCPointMapIter = BinaryControlODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryControlODCPointMap.end())
+	if (auto pt = BinaryControlPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetBinary(meas, eventtime);
+		pt->SetBinary(meas, eventtime);
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::GetAnalogControlODCIndexUsingCBIndex(const uint8_t group, const uint8_t channel, size_t &index)
 {
-	uint16_t CBIndex = GetCBControlPointMapIndex(group, channel);
-
-	auto CBPointMapIter = AnalogControlCBPointMap.find(CBIndex);
-	if (CBPointMapIter != AnalogControlCBPointMap.end())
+	if (auto pt = AnalogControlPoints.AtSlot(CBControlSlot(group, channel)))
 	{
-		index = CBPointMapIter->second->GetIndex();
+		index = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::GetAnalogControlCBIndexUsingODCIndex(const size_t index, uint8_t &group, uint8_t &channel)
 {
-	auto ODCPointMapIter = AnalogControlODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogControlODCPointMap.end())
+	if (auto pt = AnalogControlPoints.AtODCIndex(index))
 	{
-		group = ODCPointMapIter->second->GetGroup();
-		channel = ODCPointMapIter->second->GetChannel();
+		group = pt->GetGroup();
+		channel = pt->GetChannel();
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::GetAnalogControlValueUsingODCIndex(const size_t index, uint16_t &res, bool &hasbeenset)
 {
-	auto ODCPointMapIter = AnalogControlODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogControlODCPointMap.end())
+	if (auto pt = AnalogControlPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetAnalogAndHasBeenSet(hasbeenset);
+		res = pt->GetAnalogAndHasBeenSet(hasbeenset);
 		return true;
 	}
 	return false;
 }
 bool CBPointTableAccess::SetAnalogControlValueUsingODCIndex(const size_t index, const uint16_t meas, CBTime eventtime)
 {
-	auto ODCPointMapIter = AnalogControlODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogControlODCPointMap.end())
+	if (auto pt = AnalogControlPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetAnalog(meas, eventtime);
+		pt->SetAnalog(meas, eventtime);
 		return true;
 	}
 	return false;
@@ -530,44 +508,23 @@ uint16_t CBPointTableAccess::GetCBControlPointMapIndex(const uint8_t & group, co
 }
 void CBPointTableAccess::ForEachMatchingBinaryPoint(const uint8_t & group, const PayloadLocationType & payloadlocation, const std::function<void(CBBinaryPoint &pt)>& fn)
 {
-	// Need to do a search for channels 1 to 12 in the group and payloadlocation
-	for (uint8_t channel = 1; channel <= 12; channel++)
-	{
-		uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
-		if (BinaryCBPointMap.count(CBIndex) != 0)
-		{
-			// We have a match - call our function with the point as a parameter.
-			fn(*BinaryCBPointMap[CBIndex]);
-		}
-	}
+	// Channels 1 to 12 in the group and payloadlocation - adjacent slots
+	BinaryPoints.ForEachInSlots(CBSlot(group, 1, payloadlocation), 12, fn);
 }
 
 void CBPointTableAccess::ForEachMatchingAnalogPoint(const uint8_t & group, const PayloadLocationType & payloadlocation, const std::function<void(CBAnalogCounterPoint &pt)>& fn)
 {
 	// Max of two channels for analogs
-	for (uint8_t channel = 1; channel <= 2; channel++)
-	{
-		uint16_t CBIndex = GetCBPointMapIndex(group, channel, payloadlocation);
-		if (AnalogCBPointMap.count(CBIndex) != 0)
-		{
-			// We have a match - call our function with the point as a parameter.
-			fn(*AnalogCBPointMap[CBIndex]);
-		}
-	}
+	AnalogPoints.ForEachInSlots(CBSlot(group, 1, payloadlocation), 2, fn);
 }
 void CBPointTableAccess::ForEachMatchingCounterPoint(const uint8_t & group, const PayloadLocationType & payloadlocation, const std::function<void(CBAnalogCounterPoint &pt)>& fn)
 {
-	uint16_t CBIndex = GetCBPointMapIndex(group, 1, payloadlocation);
-	if (CounterCBPointMap.count(CBIndex) != 0)
-	{
-		// We have a match - call our function with the point as a parameter.
-		fn(*CounterCBPointMap[CBIndex]);
-	}
+	CounterPoints.ForEachInSlots(CBSlot(group, 1, payloadlocation), 1, fn);
 }
 void CBPointTableAccess::ForEachMatchingStatusByte(const uint8_t & group, const PayloadLocationType & payloadlocation, const std::function<void(void)>& fn)
 {
-	uint16_t CBIndex = GetCBPointMapIndex(group, 1, payloadlocation); // Use the same index as the points
-	if (StatusByteMap.count(CBIndex) != 0)
+	const size_t slot = CBSlot(group, 1, payloadlocation); // Use the same index as the points
+	if ((slot < CBSlots) && StatusBytes[slot])
 	{
 		// We have a match - call our function
 		fn();
@@ -576,34 +533,25 @@ void CBPointTableAccess::ForEachMatchingStatusByte(const uint8_t & group, const
 
 bool CBPointTableAccess::GetMaxPayload(uint8_t group, uint8_t & blockcount)
 {
-	if (MaxiumPayloadPerGroupMap.count(group) == 0)
+	if ((group >= MaxiumPayloadPerGroup.size()) || (MaxiumPayloadPerGroup[group] == 0))
 	{
 		return false;
 	}
-	blockcount = MaxiumPayloadPerGroupMap[group];
+	blockcount = MaxiumPayloadPerGroup[group];
 	return true;
 }
 
 void CBPointTableAccess::ForEachBinaryPoint(const std::function<void(CBBinaryPoint &pt)>& fn)
 {
-	for (const auto& CBpt : BinaryODCPointMap) // We always use the CB map - its order is the only one we care about.
-	{
-		fn(*CBpt.second);
-	}
+	BinaryPoints.ForEachByODCIndex(fn); // Always in ODC index order
 }
 void CBPointTableAccess::ForEachAnalogPoint(const std::function<void(CBAnalogCounterPoint &pt)>& fn)
 {
-	for (const auto& CBpt : AnalogODCPointMap) // We always use the CB map - its order is the only one we care about.
-	{
-		fn(*CBpt.second);
-	}
+	AnalogPoints.ForEachByODCIndex(fn); // Always in ODC index order
 }
 void CBPointTableAccess::ForEachCounterPoint(const std::function<void(CBAnalogCounterPoint &pt)>& fn)
 {
-	for (const auto& CBpt : CounterODCPointMap) // We always use the CB map - its order is the only one we care about.
-	{
-		fn(*CBpt.second);
-	}
+	CounterPoints.ForEachByODCIndex(fn); // Always in ODC index order
 }
 #ifdef _MSC_VER
 #pragma endregion
@@ -27,8 +27,11 @@
 #ifndef CBPOINTTABLEACCESS_H_
 #define CBPOINTTABLEACCESS_H_
 #include "CB.h"
+#include "CBPointArray.h"
 #include "CBUtility.h"
-#include "StrandProtectedQueue.h"
+#include "ProducerConsumerQueue.h"
+#include <array>
+#include <limits>
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -41,7 +44,7 @@ class CBPointTableAccess
 public:
 	CBPointTableAccess();
 	void SetName(std::string _Name) { Name = _Name; };
-	void Build(const std::string& _Name, bool isoutstation, odc::asio_service & IOS, unsigned int SOEQueueSize, std::shared_ptr<protected_bool> SOEBufferOverflowFlag);
+	void Build(const std::string& _Name, bool isoutstation, unsigned int SOEQueueSize, std::shared_ptr<protected_bool> SOEBufferOverflowFlag);
 
 	// The add to point table functions add to both the ODC and MD3 Map.
 	// The Conitel Baker methods require that a
@@ -102,34 +105,44 @@ public:
 	static uint16_t GetCBBitMapIndex(const uint8_t& group, uint8_t bit, const PayloadLocationType& payloadlocation, const BinaryPointType& pointtype);
 	static uint16_t GetCBControlPointMapIndex(const uint8_t & group, const uint8_t & channel);
 protected:
-
-	// We access the map using a Module:Channel combination, so that they will always be in order. Makes searching the next item easier.
-	std::map<uint16_t, std::shared_ptr<CBBinaryPoint>> BinaryCBPointMap;  // Group/Payload/Channel, CBPoin
-	std::map<uint16_t, bool> BinaryCBBitMap;                              // Group/Payload/Bitl, bool
-	std::map<uint16_t, std::shared_ptr<CBBinaryPoint>> BinarySOEPointMap; // Group/SoeIndexl, CBPoint
-	std::map<size_t, std::shared_ptr<CBBinaryPoint>> BinaryODCPointMap;   // Index OpenDataCon, CBPoint
-
-	std::map<uint16_t, std::shared_ptr<CBAnalogCounterPoint>> AnalogCBPointMap; // Group/Payload/Channel, CBPoint
-	std::map<size_t, std::shared_ptr<CBAnalogCounterPoint>> AnalogODCPointMap;  // Index OpenDataCon, CBPoint
-
-	std::map<uint16_t, std::shared_ptr<CBAnalogCounterPoint>> CounterCBPointMap; // Group/Payload/Channel, CBPoint
-	std::map<size_t, std::shared_ptr<CBAnalogCounterPoint>> CounterODCPointMap;  // Index OpenDataCon, CBPoint
+	// Slots are Group/Payload/Channel, so all the channels in a group payload sit together - a payload scan is a linear read.
+	static size_t CBSlot(const uint8_t group, const uint8_t channel, const PayloadLocationType& payloadlocation)
+	{
+		if ((group > 0x0F) || (channel > 0x0F) || (payloadlocation.Packet < 1) || (payloadlocation.Packet > 16) || (payloadlocation.Position == PayloadABType::Error))
+			return CBSlots;
+		const size_t payload = (static_cast<size_t>(payloadlocation.Packet - 1) << 1) | (payloadlocation.Position == PayloadABType::PositionA ? 0 : 1);
+		return (static_cast<size_t>(group) << 9) | (payload << 4) | channel;
+	}
+	static constexpr size_t CBSlots = 16 * 32 * 16;
+	// Control points are only Group/Channel
+	static size_t CBControlSlot(const uint8_t group, const uint8_t channel)
+	{
+		return ((group > 0x0F) || (channel > 0x0F)) ? CBControlSlots : (static_cast<size_t>(group) << 4) | channel;
+	}
+	static constexpr size_t CBControlSlots = 16 * 16;
+
+	CBPointArray<CBBinaryPoint> BinaryPoints{CBSlots};
+	std::map<uint16_t, bool> BinaryCBBitMap;              // Group/Payload/Bitl, bool - only used to check the configuration
+	std::array<size_t, 121> SOEODCIndex;                  // SoeIndex, ODC index (or NOSOEPOINT)
+	static constexpr size_t NOSOEPOINT = std::numeric_limits<size_t>::max();
+
+	CBPointArray<CBAnalogCounterPoint> AnalogPoints{CBSlots};
+	CBPointArray<CBAnalogCounterPoint> CounterPoints{CBSlots};
 
 	// Binary Control Points are not readable
-	std::map<uint16_t, std::shared_ptr<CBBinaryPoint>> BinaryControlCBPointMap; //Group/Payload/Channel, CBPoint
-	std::map<size_t, std::shared_ptr<CBBinaryPoint>> BinaryControlODCPointMap;  // Index OpenDataCon, CBPoint
+	CBPointArray<CBBinaryPoint> BinaryControlPoints{CBControlSlots};
 
 	// Analog Control Points are not readable
-	std::map<uint16_t, std::shared_ptr<CBAnalogCounterPoint>> AnalogControlCBPointMap; // Group/Payload/Channel, CBPoint
-	std::map<size_t, std::shared_ptr<CBAnalogCounterPoint>> AnalogControlODCPointMap;  // Index OpenDataCon, CBPoint
+	CBPointArray<CBAnalogCounterPoint> AnalogControlPoints{CBControlSlots};
 
-	std::map<uint16_t, uint8_t> StatusByteMap; // Group/Payload/Channel, second parameter empty.
+	std::vector<bool> StatusBytes = std::vector<bool>(CBSlots, false); // Group/Payload/Channel
 
-	std::map<uint8_t, uint8_t> MaxiumPayloadPerGroupMap; // Group 0 to 15, Max payload - a count of 1 to 16.
+	std::array<uint8_t, 16> MaxiumPayloadPerGroup{}; // Group 0 to 15, Max payload - a count of 1 to 16. 0 if the group has nothing.
 
 	bool IsOutstation = true;
 	std::string Name;
-	std::shared_ptr<StrandProtectedQueue<CBBinaryPoint>> pBinaryTimeTaggedEventQueue; // Separate queue for time tagged binary events.
+	std::shared_ptr<ProducerConsumerQueue<CBBinaryPoint>> pBinaryTimeTaggedEventQueue; // Separate queue for time tagged binary events.
+	std::shared_ptr<protected_bool> SOEBufferOverflowFlag;
 	// Define the special SOE buffer overflow point, so that it can be added to the SOE queue if the buffer overflows. The only thing that gets changed is the time.
 	CBBinaryPoint queuefullpt = CBBinaryPoint(0, 0, 1, PayloadLocationType(), BinaryPointType::DIG, true, 127);
 };
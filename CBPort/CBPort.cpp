@@ -130,5 +130,11 @@ void CBPort::SendCBMessage(const CBMessage_t &CompleteCBMessage)
 
 	CBConnection::Write(pConnection,CompleteCBMessage);
 }
+void CBPort::SendEncodedCBMessage(const uint8_t* data, size_t len)
+{
+	if (!enabled.load()) return; // Port Disabled so dont process
+
+	CBConnection::Write(pConnection, data, len);
+}
 
 
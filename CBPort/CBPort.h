@@ -52,6 +52,7 @@ public:
 
 	// Public only for UnitTesting
 	virtual void SendCBMessage(const CBMessage_t& CompleteCBMessage);
+	void SendEncodedCBMessage(const uint8_t* data, size_t len); // Already encoded to bytes (CBCodec.h)
 	void SetSendTCPDataFn(std::function<void(std::string)> Send);
 	void InjectSimulatedTCPMessage(buf_t & readbuf); // Equivalent of the callback handler in the CBConnection.
 
@@ -37,15 +37,24 @@
 #include "CBMasterPort.h"
 #include "CBOutstationPort.h"
 #include "CBUtility.h"
+#include "CBCodec.h"
 #include <opendatacon/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
 #include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <random>
 #include <thread>
 #include <utility>
+#include <vector>
 
 
 #if defined(NONVSTESTING)
@@ -67,6 +76,7 @@ extern const char *conffilename1;
 extern const char *conffilename2;
 extern const char *conffile1;
 extern const char *conffile2;
+extern uint64_t (*AllocationCount)(); // main.cpp
 
 const char *conffilename1 = "CBConfig.conf";
 const char *conffilename2 = "CBConfig2.conf";
@@ -584,6 +594,167 @@ TEST_CASE("Util - SOEEventFormat")
 	STANDARD_TEST_TEARDOWN();
 }
 
+// Fill an SOE response with random events, packed both the original bit array way and the bit stream way, as the outstation does.
+size_t PackRandomSOEEvents(std::mt19937& rng, std::array<bool, MaxSOEBits>& BitArray, uint32_t& UsedBits, CBSOEBitStream& Bits)
+{
+	size_t count = 0;
+	while (true)
+	{
+		SOEEventFormat evt;
+		evt.Group = rng() % 8;
+		evt.Number = rng() % 121;
+		evt.ValueBit = (rng() % 2) == 1;
+		evt.QualityBit = false;
+		evt.TimeFormatBit = (count == 0) || (rng() % 4 == 0);
+		evt.Hour = rng() % 24;
+		evt.Minute = rng() % 60;
+		evt.Second = rng() % 60;
+		evt.Millisecond = rng() % 1000;
+		evt.LastEventFlag = false;
+
+		bool added = evt.AddDataToBitArray(BitArray, UsedBits);
+		REQUIRE(added == evt.AddDataToBitStream(Bits));
+		if (!added)
+			break;
+		count++;
+	}
+	BitArray[UsedBits - 1] = true;
+	Bits.SetBit(Bits.Size() - 1, true);
+	return count;
+}
+CBMessage_t SOEPayloadsToMessage(const std::vector<uint16_t>& PayloadWords)
+{
+	CBMessage_t msg;
+	msg.push_back(CBBlockData(9, 3, FUNC_SEND_NEW_SOE, PayloadWords[0]));
+	for (size_t i = 1; i < PayloadWords.size(); i += 2)
+		msg.push_back(CBBlockData(PayloadWords[i], (i + 1 < PayloadWords.size()) ? PayloadWords[i + 1] : uint16_t(0)));
+	msg.back().MarkAsEndOfMessageBlock();
+	return msg;
+}
+// The original bool per bit master decode
+std::vector<SOEEventFormat> DecodeSOEUsingBitArray(const CBMessage_t& msg)
+{
+	std::array<bool, MaxSOEBits> BitArray{};
+	uint32_t UsedBits = 0;
+	for (size_t blocknum = 0; blocknum < msg.size(); blocknum++)
+	{
+		if (blocknum != 0)
+			for (int i = 11; i >= 0; i--)
+				BitArray[UsedBits++] = TestBit(msg[blocknum].GetA(), i);
+		for (int i = 11; i >= 0; i--)
+			BitArray[UsedBits++] = TestBit(msg[blocknum].GetB(), i);
+	}
+	std::vector<SOEEventFormat> events;
+	uint32_t newstartbit = 0;
+	CBTime LastEventTime = 0;
+	do
+	{
+		bool Success = false;
+		SOEEventFormat Event(BitArray, newstartbit, UsedBits, newstartbit, LastEventTime, Success);
+		LastEventTime = Event.GetTotalMsecTime();
+		if (!Success)
+			break;
+		events.push_back(Event);
+		if (Event.LastEventFlag)
+			break;
+	} while ((newstartbit + 30) < UsedBits);
+	return events;
+}
+std::vector<SOEEventFormat> DecodeSOEUsingBitStream(const CBMessage_t& msg)
+{
+	CBSOEBitStream Bits;
+	for (size_t blocknum = 0; blocknum < msg.size(); blocknum++)
+	{
+		if (blocknum != 0)
+			Bits.Put(msg[blocknum].GetA(), 12);
+		Bits.Put(msg[blocknum].GetB(), 12);
+	}
+	std::vector<SOEEventFormat> events;
+	uint32_t newstartbit = 0;
+	CBTime LastEventTime = 0;
+	do
+	{
+		bool Success = false;
+		SOEEventFormat Event(Bits, newstartbit, newstartbit, LastEventTime, Success);
+		LastEventTime = Event.GetTotalMsecTime();
+		if (!Success)
+			break;
+		events.push_back(Event);
+		if (Event.LastEventFlag)
+			break;
+	} while ((newstartbit + 30) < Bits.Size());
+	return events;
+}
+TEST_CASE("Util - SOE Bit Stream")
+{
+	SIMPLE_TEST_SETUP();
+
+	// Fields crossing the 64 bit word boundaries
+	CBSOEBitStream Bits;
+	REQUIRE(Bits.Put(0x5, 3));
+	REQUIRE(Bits.Put(0x0FFFFFFFFFFFFFFF, 60));
+	REQUIRE(Bits.Put(0xABC, 12));
+	REQUIRE(Bits.Size() == 75);
+	REQUIRE(Bits.Get(0, 3) == 0x5);
+	REQUIRE(Bits.Get(3, 60) == 0x0FFFFFFFFFFFFFFF);
+	REQUIRE(Bits.Get(63, 12) == 0xABC);
+	REQUIRE(Bits.Get(60, 6) == 0x3D);
+	REQUIRE(Bits.GetPayload(0) == 0xBFF);
+	REQUIRE(Bits.GetPayload(6) == 0x800); // Zero padded
+	REQUIRE(Bits.GetPayload(7) == 0x000); // Past the end reads as zero
+	Bits.SetBit(74, true);
+	REQUIRE(Bits.Get(63, 12) == 0xABD);
+
+	// Full, and fails rather than overrun
+	Bits.Clear();
+	for (int i = 0; i < 31; i++)
+		REQUIRE(Bits.Put(i, 12));
+	REQUIRE(Bits.Size() == MaxSOEBits);
+	REQUIRE_FALSE(Bits.Put(1, 1));
+	for (uint16_t i = 0; i < 31; i++)
+		REQUIRE(Bits.GetPayload(i) == i);
+
+	// Pack and unpack full responses both ways, the payloads on the wire and the decoded events must be identical
+	std::mt19937 rng(1234);
+	for (int run = 0; run < 100; run++)
+	{
+		std::array<bool, MaxSOEBits> BitArray{};
+		uint32_t UsedBits = 0;
+		CBSOEBitStream Stream;
+		size_t count = PackRandomSOEEvents(rng, BitArray, UsedBits, Stream);
+		REQUIRE(count > 0);
+		REQUIRE(Stream.Size() == UsedBits);
+
+		std::vector<uint16_t> ArrayPayloads;
+		for (uint32_t block = 0; block < (UsedBits + 11) / 12; block++)
+		{
+			uint16_t payload = 0;
+			for (uint32_t i = 0; i < 12; i++)
+				payload |= ShiftLeftResult16Bits(BitArray[block * 12 + i] ? 1 : 0, 11 - i);
+			ArrayPayloads.push_back(payload);
+		}
+		std::vector<uint16_t> StreamPayloads;
+		for (uint32_t block = 0; block < Stream.PayloadCount(); block++)
+			StreamPayloads.push_back(Stream.GetPayload(block));
+		REQUIRE(StreamPayloads == ArrayPayloads);
+
+		CBMessage_t msg = SOEPayloadsToMessage(StreamPayloads);
+		auto ArrayEvents = DecodeSOEUsingBitArray(msg);
+		auto StreamEvents = DecodeSOEUsingBitStream(msg);
+		REQUIRE(ArrayEvents.size() == count);
+		REQUIRE(StreamEvents.size() == count);
+		for (size_t i = 0; i < count; i++)
+		{
+			REQUIRE(StreamEvents[i].GetFormattedData() == ArrayEvents[i].GetFormattedData());
+			REQUIRE(StreamEvents[i].TimeFormatBit == ArrayEvents[i].TimeFormatBit);
+			REQUIRE(StreamEvents[i].LastEventFlag == ArrayEvents[i].LastEventFlag);
+		}
+		REQUIRE(StreamEvents.back().LastEventFlag);
+	}
+
+	STANDARD_TEST_TEARDOWN();
+}
+
 TEST_CASE("Util - ConfigFileLoadTest")
 {
 	//This is a test to load the autogenerated config file from the Mosaic database output.
@@ -597,6 +768,210 @@ TEST_CASE("Util - ConfigFileLoadTest")
       */
 }
 
+TEST_CASE("Util - CBCodec")
+{
+	// The codec output must match what the block classes produce - this is how ScanRequest builds its response
+	CBBlockData header(9, 3, FUNC_SCAN_DATA, 0, true);
+	CBScanPayloads_t payloads;
+	for (uint16_t v : {0x123, 0xFFF, 0x000, 0x555, 0xAAA})
+		payloads.push_back(v);
+
+	CBMessage_t msg;
+	msg.push_back(CBBlockData(header.GetStationAddress(), header.GetGroup(), header.GetFunctionCode(), payloads[0], false));
+	msg.push_back(CBBlockData(payloads[1], payloads[2]));
+	msg.push_back(CBBlockData(payloads[3], payloads[4], true));
+	std::string expected;
+	for (const auto& blk : msg)
+		expected += blk.ToBinaryString();
+
+	std::array<uint8_t, CBMessageBytes(MAX_BLOCK_COUNT)> buf;
+	size_t len = CBEncodeScanResponse(header, payloads.data(), payloads.size(), buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == expected);
+
+	len = CBEncodeMessage(msg, buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == expected);
+	REQUIRE(CBMessageAsString(buf.data(), len) == CBMessageAsString(msg)); // Logged the same either way
+	REQUIRE(CBEncodeMessage(msg, buf.data(), CBMessageBytes(2)) == 0);
+
+	CBFixedMessage_t decoded;
+	size_t consumed = 0;
+	REQUIRE(CBDecodeMessage(buf.data(), len, decoded, consumed) == CBDecodeResult::Complete);
+	REQUIRE(consumed == len);
+	REQUIRE(decoded.size() == msg.size());
+	for (size_t i = 0; i < msg.size(); i++)
+		REQUIRE(decoded[i].GetData() == msg[i].GetData());
+
+	// Baker devices have station and group swapped in the address block, both ways
+	len = CBEncodeMessage(msg, buf.data(), buf.size(), true);
+	CBBlockData swapped = msg[0];
+	swapped.DoBakerConitelSwap();
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), CONITEL_BLOCK_LENGTH) == swapped.ToBinaryString());
+	REQUIRE(CBDecodeMessage(buf.data(), len, decoded, consumed, true) == CBDecodeResult::Complete);
+	REQUIRE(decoded[0].GetData() == msg[0].GetData());
+
+	REQUIRE(CBDecodeMessage(buf.data(), len - CONITEL_BLOCK_LENGTH, decoded, consumed) == CBDecodeResult::Incomplete);
+	buf[5] ^= 0x10; // Corrupt the first data block
+	REQUIRE(CBDecodeMessage(buf.data(), len, decoded, consumed) == CBDecodeResult::BadBlock);
+
+	// A scan of a group with only 1B is the single address block
+	len = CBEncodeScanResponse(header, payloads.data(), 1, buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == CBBlockData(9, 3, FUNC_SCAN_DATA, payloads[0], true).ToBinaryString());
+}
+
+TEST_CASE("Master - Adaptive Timeout Simulated Link")
+{
+	// A simulated link, with a pseudo random (but repeatable) round trip time of base +- jitter msec
+	uint32_t seed = 12345;
+	auto LinkRTT = [&seed](int base, int jitter)
+			   {
+				   seed = seed * 1103515245 + 12345;
+				   return std::chrono::microseconds((base - jitter + int((seed >> 16) % (2 * jitter + 1))) * 1000);
+			   };
+
+	STANDARD_TEST_SETUP();
+
+	// No max set, so the default has to leave the timeout room to grow
+	Json::Value MAportoverride;
+	MAportoverride["CBAdaptiveTimeout"] = true;
+	MAportoverride["CBCommandTimeoutmsec"] = 700;
+	MAportoverride["CBCommandTimeoutMinmsec"] = 100;
+	TEST_CBMAPort(MAportoverride);
+
+	auto& rtt = CBMAPort->GetCommandRTT();
+	REQUIRE(rtt.GetTimeout() == std::chrono::milliseconds(700)); // No samples yet
+	REQUIRE(rtt.GetTimeout(1) == std::chrono::milliseconds(1400));
+	REQUIRE(rtt.GetTimeout(10) == std::chrono::milliseconds(700 * RTTEstimator::DefaultMaxMultiple)); // Backoff stops at the max
+
+	// Slow radio link, 600msec +- 200. A fixed 700msec timeout (fine on a wire) retries about a quarter of the time.
+	// The adaptive one learns the link. A command that times out doesn't give a sample.
+	const int Commands = 1000;
+	int fixedspurious = 0;
+	int adaptivespurious = 0;
+	for (int i = 0; i < Commands; i++)
+	{
+		auto r = LinkRTT(600, 200);
+		if (r > std::chrono::milliseconds(700))
+			fixedspurious++;
+		if (r > rtt.GetTimeout())
+			adaptivespurious++;
+		else
+			rtt.Sample(r);
+	}
+	REQUIRE(fixedspurious > Commands / 5);
+	REQUIRE(adaptivespurious < fixedspurious / 10);
+	REQUIRE(rtt.GetSRTTmsec() > 450);
+	REQUIRE(rtt.GetSRTTmsec() < 750);
+	REQUIRE(rtt.GetTimeout() > std::chrono::milliseconds(700)); // Has grown past the fixed timeout
+
+	// Fast link, 20msec +- 5. With the fixed 700msec timeout and one retry, a dead Station takes 1.4 seconds to find.
+	// Adaptive finds it at the min timeout plus the backed off retry.
+	for (int i = 0; i < 100; i++)
+		rtt.Sample(LinkRTT(20, 5));
+	const auto fixeddetect = std::chrono::milliseconds(700 * 2);
+	const auto adaptivedetect = rtt.GetTimeout(0) + rtt.GetTimeout(1);
+	REQUIRE(adaptivedetect == std::chrono::milliseconds(100 + 200));
+	REQUIRE(adaptivedetect * 4 < fixeddetect);
+
+	// A reconnect starts the estimate again
+	START_IOS(1);
+	CBMAPort->Enable();
+	CBMAPort->SocketStateHandler(true);
+	for (int i = 0; (i < 100) && (rtt.GetSamples() != 0); i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	REQUIRE(rtt.GetSamples() == 0);
+	REQUIRE(rtt.GetTimeout() == std::chrono::milliseconds(700));
+
+	CBMAPort->Disable();
+	STOP_IOS();
+	TestTearDown();
+}
+
+// Not run by default - run with the [.benchmark] tag
+TEST_CASE("Util - CBCodec Benchmark", "[.benchmark]")
+{
+	const size_t Iterations = 1000000;
+	CBBlockData header(9, 3, FUNC_SCAN_DATA, 0, true);
+	CBScanPayloads_t payloads;
+	for (uint16_t i = 0; i < CBMaxScanPayloads; i++)
+		payloads.push_back(static_cast<uint16_t>(i * 100));
+
+	std::array<uint8_t, CBMessageBytes(MAX_BLOCK_COUNT)> buf;
+	size_t bytes = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations; i++)
+	{
+		payloads[0] = static_cast<uint16_t>(i & 0xFFF);
+		bytes += CBEncodeScanResponse(header, payloads.data(), payloads.size(), buf.data(), buf.size());
+	}
+	auto encodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// The block by block way - vector of blocks, then a string per block
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations / 10; i++)
+	{
+		payloads[0] = static_cast<uint16_t>(i & 0xFFF);
+		CBMessage_t msg;
+		msg.push_back(CBBlockData(header.GetStationAddress(), header.GetGroup(), header.GetFunctionCode(), payloads[0], false));
+		for (size_t idx = 1; idx < payloads.size(); idx += 2)
+			msg.push_back(CBBlockData(payloads[idx], payloads[idx + 1], idx + 2 >= payloads.size()));
+		std::string str;
+		for (const auto& blk : msg)
+			str += blk.ToBinaryString();
+		bytes += str.size();
+	}
+	auto oldencodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 10;
+
+	CBFixedMessage_t decoded;
+	size_t consumed = 0;
+	size_t blocks = 0;
+	const size_t len = CBEncodeScanResponse(header, payloads.data(), payloads.size(), buf.data(), buf.size());
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations; i++)
+	{
+		CBDecodeMessage(buf.data(), len, decoded, consumed);
+		blocks += decoded.size();
+	}
+	auto decodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	REQUIRE(bytes > 0);
+	REQUIRE(blocks == Iterations * MAX_BLOCK_COUNT);
+	std::cout << "CB 16 block scan response (" << len << " bytes)" << std::endl
+	          << "  codec encode:       " << Iterations / encodetime << " msg/s" << std::endl
+	          << "  block/string encode: " << Iterations / oldencodetime << " msg/s" << std::endl
+	          << "  codec decode:       " << Iterations / decodetime << " msg/s" << std::endl;
+}
+TEST_CASE("Util - SOE Bit Stream Benchmark", "[.benchmark]")
+{
+	const size_t Iterations = 100000;
+	std::mt19937 rng(5678);
+	std::array<bool, MaxSOEBits> BitArray{};
+	uint32_t UsedBits = 0;
+	CBSOEBitStream Stream;
+	const size_t count = PackRandomSOEEvents(rng, BitArray, UsedBits, Stream);
+
+	std::vector<uint16_t> PayloadWords;
+	for (uint32_t block = 0; block < Stream.PayloadCount(); block++)
+		PayloadWords.push_back(Stream.GetPayload(block));
+	CBMessage_t msg = SOEPayloadsToMessage(PayloadWords);
+
+	size_t events = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations; i++)
+		events += DecodeSOEUsingBitStream(msg).size();
+	auto streamtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations / 10; i++)
+		events += DecodeSOEUsingBitArray(msg).size();
+	auto arraytime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 10;
+
+	REQUIRE(events == (Iterations + Iterations / 10) * count);
+	std::cout << "CB SOE response, " << msg.size() << " blocks, " << count << " events" << std::endl
+	          << "  bit stream decode: " << Iterations * count / streamtime << " events/s" << std::endl
+	          << "  bit array decode:  " << Iterations * count / arraytime << " events/s" << std::endl;
+}
+
 #ifdef _MSC_VER
 #pragma region Block Tests
 #endif
@@ -2114,6 +2489,338 @@ TEST_CASE("Master - Cause a Command Resend on Timeout Using subscribed Master an
 	STOP_IOS();
 	STANDARD_TEST_TEARDOWN();
 }
+TEST_CASE("Master - Multi-drop Stations Are Independent Using TCP")
+{
+	// Each Master port is one Station, and keeps its own outstanding command, retry and timeout state.
+	// So a Station that is not answering must not hold up the other Stations sharing the connection - the poll cycle
+	// on a multi-drop link should be set by the slowest Station, not the sum of all of them.
+	STANDARD_TEST_SETUP();
+	// Outstations are as for the conf files
+	TEST_CBOSPort(Json::nullValue);
+	TEST_CBOSPort2(Json::nullValue);
+
+	// The masters need to be TCP Clients - should be only change necessary.
+	Json::Value MAportoverride;
+	MAportoverride["TCPClientServer"] = "CLIENT";
+	TEST_CBMAPort(MAportoverride);
+
+	Json::Value MAportoverride2;
+	MAportoverride2["TCPClientServer"] = "CLIENT";
+	TEST_CBMAPort2(MAportoverride2);
+
+	START_IOS(1);
+
+	CBOSPort->Enable();
+	CBOSPort2->Enable();
+	CBMAPort->Enable();
+	CBMAPort2->Enable();
+
+	// Allow everything to get setup.
+	WaitIOS(*IOS, 2);
+
+	// Stop polling, so the only commands in the queues are ours. Let any polls already sent be answered.
+	CBMAPort->EnablePolling(false);
+	CBMAPort2->EnablePolling(false);
+	WaitIOS(*IOS, 1);
+
+	// The second Station stops answering, its Master will have to time out and retry (4 seconds, 1 retry in the conf file).
+	CBOSPort2->Disable();
+
+	CommandStatus res = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([=, &res](CommandStatus command_stat)
+		{
+			LOGDEBUG("Callback on CONTROL command result : {}", std::to_string(static_cast<int>(command_stat)));
+			res = command_stat;
+		});
+	CommandStatus res2 = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback2 = std::make_shared<std::function<void(CommandStatus)>>([=, &res2](CommandStatus command_stat)
+		{
+			LOGDEBUG("Callback on CONTROL command result : {}", std::to_string(static_cast<int>(command_stat)));
+			res2 = command_stat;
+		});
+
+	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
+	val.functionCode = ControlCode::LATCH_ON;
+
+	// Command to the silent Station first, then straight away to the good one.
+	auto event2 = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 20, "TestHarness");
+	event2->SetPayload<EventType::ControlRelayOutputBlock>(EventTypePayload<EventType::ControlRelayOutputBlock>::type(val));
+	CBMAPort2->Event(event2, "TestHarness2", pStatusCallback2);
+
+	auto event1 = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 1, "TestHarness");
+	event1->SetPayload<EventType::ControlRelayOutputBlock>(EventTypePayload<EventType::ControlRelayOutputBlock>::type(val));
+	CBMAPort->Event(event1, "TestHarness", pStatusCallback);
+
+	// Well inside the first timeout of the silent Station, the good one has already answered.
+	WaitIOS(*IOS, 2);
+
+	REQUIRE(res == CommandStatus::SUCCESS);
+	REQUIRE(res2 == CommandStatus::NOT_AUTHORIZED);
+
+	// After the timeout and retry on both the select and the execute, the silent Station command fails
+	WaitIOS(*IOS, 16);
+
+	REQUIRE(res2 == CommandStatus::UNDEFINED);
+
+	CBOSPort->Disable();
+	CBMAPort->Disable();
+	CBMAPort2->Disable();
+
+	STOP_IOS();
+	STANDARD_TEST_TEARDOWN();
+}
+TEST_CASE("Master - Control Latency With Saturated Poll Queue")
+{
+	// Poll faster than the Outstation can answer, and make sure the poll commands do not pile up in the queue,
+	// and that a control does not have to wait behind all of them.
+	STANDARD_TEST_SETUP();
+
+	Json::Value MAportoverride;
+	MAportoverride["CBCommandTimeoutmsec"] = 200;
+	MAportoverride["CBCommandRetries"] = 0;
+	TEST_CBMAPort(MAportoverride);
+
+	START_IOS(1);
+
+	// Hook the output function, nothing ever answers.
+	std::mutex SentMutex;
+	std::vector<uint8_t> SentFunctionCodes;
+	CBMAPort->SetSendTCPDataFn([&](std::string CBMessage)
+		{
+			std::lock_guard<std::mutex> lck(SentMutex);
+			CBBlockData FirstBlock(CBMessage[0], CBMessage[1], CBMessage[2], CBMessage[3]);
+			SentFunctionCodes.push_back(FirstBlock.GetFunctionCode());
+		});
+
+	CBMAPort->Enable();
+	CBMAPort->EnablePolling(false); // We will call DoPoll ourselves
+
+	// A second's worth of polls on a badly saturated link
+	for (int i = 0; i < 100; i++)
+	{
+		CBMAPort->DoPoll(1);
+		CBMAPort->DoPoll(2);
+	}
+
+	CommandStatus res = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&res](CommandStatus command_stat)
+		{
+			res = command_stat;
+		});
+
+	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
+	val.functionCode = ControlCode::LATCH_ON;
+	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 1, "TestHarness");
+	event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
+	CBMAPort->Event(event, "TestHarness", pStatusCallback);
+
+	WaitIOS(*IOS, 1);
+
+	{
+		std::lock_guard<std::mutex> lck(SentMutex);
+		// The first poll command went straight out, the control select is next - ahead of the queued polls
+		REQUIRE(SentFunctionCodes.size() >= 2);
+		REQUIRE(SentFunctionCodes[0] != FUNC_CLOSE);
+		REQUIRE(SentFunctionCodes[1] == FUNC_CLOSE);
+	}
+	REQUIRE(res == CommandStatus::UNDEFINED); // Timed out, nothing answering
+
+	// Only one of each poll is ever waiting, the rest are coalesced
+	auto stats = CBMAPort->GetStatistics();
+	REQUIRE(stats["CommandQueue"]["PollsCoalesced"].asUInt64() >= 190);
+
+	CBMAPort->Disable();
+
+	STOP_IOS();
+	STANDARD_TEST_TEARDOWN();
+}
+
+// Counts the events a port publishes
+class EventCountingPort: public IOHandler
+{
+public:
+	explicit EventCountingPort(const std::string& aName): IOHandler(aName) {}
+	void Event(ConnectState state, const std::string& SenderName) override {}
+	void Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback) override
+	{
+		Count++;
+		(*pStatusCallback)(CommandStatus::SUCCESS);
+	}
+	void Enable() override {}
+	void Disable() override {}
+
+	std::atomic<uint64_t> Count{0};
+};
+
+// Split a captured byte stream into messages, skipping over anything that is not a valid block.
+std::vector<std::string> SplitCBStream(const std::string& Stream)
+{
+	std::vector<std::string> Frames;
+	CBFixedMessage_t blocks;
+	size_t pos = 0;
+	while (pos < Stream.size())
+	{
+		size_t consumed = 0;
+		auto res = CBDecodeMessage(reinterpret_cast<const uint8_t*>(Stream.data()) + pos, Stream.size() - pos, blocks, consumed);
+		if (res == CBDecodeResult::Incomplete)
+			break;
+		if (res != CBDecodeResult::Complete)
+		{
+			pos++;
+			continue;
+		}
+		Frames.push_back(Stream.substr(pos, consumed));
+		pos += consumed;
+	}
+	return Frames;
+}
+
+// Not run by default - run with the [.benchmark] tag
+// Replays a byte stream through the connection framing into an Outstation, then the command/response pairs through a Master (framing, decode and point table),
+// as fast as they will go. Set CB_REPLAY_FILE to a raw capture of the link to replay that, otherwise a synthetic scan stream is used.
+// There is no direction in a CB block, so the capture must start with a command - even frames are commands, odd frames their responses.
+TEST_CASE("Master - Replay Benchmark", "[.benchmark]")
+{
+	STANDARD_TEST_SETUP();
+
+	Json::Value OSportoverride;
+	OSportoverride["Port"] = static_cast<Json::UInt64>(10001);
+	TEST_CBOSPort(OSportoverride);
+
+	Json::Value MAportoverride;
+	MAportoverride["CBCommandTimeoutmsec"] = 100;
+	MAportoverride["CBCommandRetries"] = 0; // A retry would put the responses out of step
+	TEST_CBMAPort(MAportoverride);
+
+	START_IOS(1);
+
+	std::string Stream;
+	std::vector<std::string> Commands;
+	std::vector<std::string> Responses;
+
+	const char* ReplayFile = std::getenv("CB_REPLAY_FILE");
+	if (ReplayFile != nullptr)
+	{
+		std::ifstream f(ReplayFile, std::ios::binary);
+		REQUIRE(f.is_open());
+		Stream.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+
+		auto Frames = SplitCBStream(Stream);
+		for (size_t i = 0; i + 1 < Frames.size(); i += 2)
+		{
+			Commands.push_back(Frames[i]);
+			Responses.push_back(Frames[i + 1]);
+		}
+	}
+	else
+	{
+		// The responses will be whatever the Outstation sends back
+		for (size_t i = 0; i < 20000; i++)
+		{
+			CBBlockData commandblock(9, 3, (i % 2 == 0) ? FUNC_SCAN_DATA : FUNC_SEND_NEW_SOE, 0, true);
+			Commands.push_back(commandblock.ToBinaryString());
+			Stream += Commands.back();
+		}
+	}
+	const size_t StreamFrames = SplitCBStream(Stream).size();
+	REQUIRE(StreamFrames > 0);
+
+	auto Allocations = [] { return AllocationCount ? AllocationCount() : 0; };
+
+	// Outstation - the whole stream, in TCP sized chunks. Processing is synchronous, so everything is done when the last inject returns.
+	std::vector<std::string> StationResponses;
+	StationResponses.reserve(StreamFrames);
+	CBOSPort->SetSendTCPDataFn([&StationResponses](std::string CBMessage) { StationResponses.push_back(std::move(CBMessage)); });
+	CBOSPort->Enable();
+
+	const size_t ChunkSize = 1460;
+	buf_t readbuf;
+	std::ostream input(&readbuf);
+	auto StationAllocations = Allocations();
+	auto start = std::chrono::steady_clock::now();
+	for (size_t pos = 0; pos < Stream.size(); pos += ChunkSize)
+	{
+		input.write(Stream.data() + pos, static_cast<std::streamsize>(std::min(ChunkSize, Stream.size() - pos)));
+		CBOSPort->InjectSimulatedTCPMessage(readbuf);
+	}
+	auto stationtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	StationAllocations = Allocations() - StationAllocations;
+	CBOSPort->Disable();
+
+	if (ReplayFile == nullptr)
+	{
+		REQUIRE(StationResponses.size() == Commands.size());
+		Responses = StationResponses;
+	}
+
+	// Master - each command is answered with its response as soon as it is sent, and the next command queued.
+	std::vector<CBMessage_t> CommandMessages;
+	for (const auto& cmd : Commands)
+	{
+		CBFixedMessage_t blocks;
+		size_t consumed = 0;
+		CBDecodeMessage(reinterpret_cast<const uint8_t*>(cmd.data()), cmd.size(), blocks, consumed);
+		CommandMessages.emplace_back(blocks.begin(), blocks.end());
+	}
+
+	EventCountingPort EventCounter("ReplayEventCounter");
+	CBMAPort->Subscribe(&EventCounter, "ReplayEventCounter");
+	CBMAPort->Enable();
+	CBMAPort->EnablePolling(false);
+	WaitIOS(*IOS, 2); // Let anything queued on enable time out
+
+	std::atomic<size_t> Completed(0);
+	std::atomic<size_t> Succeeded(0);
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&Completed, &Succeeded](CommandStatus command_stat)
+		{
+			if (command_stat == CommandStatus::SUCCESS)
+				Succeeded++;
+			Completed++;
+		});
+
+	size_t NextCommand = 0;
+	size_t Sent = 0;
+	buf_t responsebuf;
+	std::ostream responseinput(&responsebuf);
+	CBMAPort->SetSendTCPDataFn([&](std::string CBMessage)
+		{
+			// On the master strand
+			size_t i = Sent++;
+			IOS->post([&, i]()
+				{
+					responseinput << Responses[i];
+					CBMAPort->InjectSimulatedTCPMessage(responsebuf);
+				});
+			if (NextCommand < CommandMessages.size())
+				CBMAPort->QueueCBCommand(CommandMessages[NextCommand++], pStatusCallback);
+		});
+
+	auto MasterAllocations = Allocations();
+	auto MasterEvents = EventCounter.Count.load();
+	start = std::chrono::steady_clock::now();
+	CBMAPort->QueueCBCommand(CommandMessages[NextCommand++], pStatusCallback);
+	while ((Completed < CommandMessages.size()) && (std::chrono::steady_clock::now() - start < std::chrono::seconds(120)))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	auto mastertime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	MasterAllocations = Allocations() - MasterAllocations;
+	MasterEvents = EventCounter.Count.load() - MasterEvents;
+
+	REQUIRE(Completed == CommandMessages.size());
+	if (ReplayFile == nullptr)
+		REQUIRE(Succeeded == CommandMessages.size());
+
+	std::cout << "CB replay of " << (ReplayFile ? ReplayFile : "synthetic scans") << ", " << Stream.size() << " bytes, " << StreamFrames << " frames" << std::endl
+	          << "  outstation: " << StreamFrames / stationtime << " frames/s, " << static_cast<double>(StationAllocations) / StreamFrames << " allocs/frame" << std::endl
+	          << "  master:     " << Completed / mastertime << " frames/s, " << MasterEvents / mastertime << " events/s, "
+	          << static_cast<double>(MasterAllocations) / Completed << " allocs/frame, " << Succeeded << " of " << Completed << " responses accepted" << std::endl;
+	if (AllocationCount == nullptr)
+		std::cout << "  (allocations are not counted by this test runner)" << std::endl;
+
+	CBMAPort->Disable();
+
+	STOP_IOS();
+	STANDARD_TEST_TEARDOWN();
+}
 }
 
 
@@ -64,11 +64,7 @@ CBBinaryPoint& CBBinaryPoint::operator=(const CBBinaryPoint& src)
 		Group = src.Group;
 		Channel = src.Channel;
 		PayloadLocation = src.PayloadLocation;
-		ChangedTime = src.ChangedTime;
-		HasBeenSet = src.HasBeenSet;
-		Binary = src.Binary;
-		MomentaryChangeStatus = src.MomentaryChangeStatus;
-		Changed = src.Changed;
+		CopyStateFrom(src);
 		PointType = src.PointType;
 		SOEPoint = src.SOEPoint;
 		SOEIndex = src.SOEIndex;
@@ -257,6 +253,20 @@ std::string CBMessageAsString(const CBMessage_t& CompleteCBMessage)
 	}
 	return res;
 }
+std::string CBMessageAsString(const uint8_t* data, size_t len)
+{
+	// Same layout as the block version, a space after every block
+	std::ostringstream oss;
+	oss.fill('0');
+	oss << std::hex;
+	for (size_t i = 0; i < len; i++)
+	{
+		oss << std::setw(2) << static_cast<uint32_t>(data[i]);
+		if ((i + 1) % CONITEL_BLOCK_LENGTH == 0)
+			oss << " ";
+	}
+	return oss.str();
+}
 
 std::string GetFunctionCodeName(uint8_t functioncode)
 {
@@ -435,6 +435,7 @@ std::string BuildASCIIHexStringfromBinaryString(const std::string &bs);
 
 std::string BuildASCIIHexStringfromCBMessage(const CBMessage_t & CBMessage);
 std::string CBMessageAsString(const CBMessage_t& CompleteCBMessage);
+std::string CBMessageAsString(const uint8_t* data, size_t len); // An encoded message
 
 // SOE Data Packet Definitions.
 const uint8_t SOELongBitLength = 44;
@@ -449,6 +450,81 @@ inline bool TestBit(const uint64_t &data, const uint8_t bitindex)
 // The maximum number of bits we can send is 12 * 31 = 372.
 const uint32_t MaxSOEBits = 12 * 31;
 
+// The SOE bit stream, packed MSB first into 64 bit words. Fields of up to 64 bits are read and written with a shift and mask
+// (at most two words each), rather than a bit at a time. Bits past Size() are always zero.
+// Used both ways - the master appends the 12 bit payloads and reads the events out, the outstation appends events and reads the payloads out.
+class CBSOEBitStream
+{
+public:
+	void Clear()
+	{
+		Words.fill(0);
+		UsedBits = 0;
+	}
+	uint32_t Size() const { return UsedBits; }
+
+	// Append the bottom numberofbits of value. Returns false (and adds nothing) if it will not fit.
+	bool Put(uint64_t value, const uint32_t numberofbits)
+	{
+		assert(numberofbits <= 64);
+		if (numberofbits == 0)
+			return true;
+		if (UsedBits + numberofbits > MaxSOEBits)
+			return false;
+
+		uint64_t aligned = value << (64 - numberofbits); // Top bit of the field in bit 63, drops anything above the field
+		uint32_t word = UsedBits / 64;
+		uint32_t offset = UsedBits % 64;
+
+		Words[word] |= aligned >> offset;
+		if (offset + numberofbits > 64) // Spills into the next word
+			Words[word + 1] |= aligned << (64 - offset);
+
+		UsedBits += numberofbits;
+		return true;
+	}
+	// Read numberofbits starting at startbit, returned in the bottom bits.
+	uint64_t Get(const uint32_t startbit, const uint32_t numberofbits) const
+	{
+		assert(numberofbits <= 64);
+		uint32_t word = startbit / 64;
+		uint32_t offset = startbit % 64;
+		if ((numberofbits == 0) || (word >= NumWords))
+			return 0;
+
+		uint64_t res = Words[word] << offset;
+		if ((offset != 0) && (offset + numberofbits > 64) && (word + 1 < NumWords))
+			res |= Words[word + 1] >> (64 - offset);
+
+		return res >> (64 - numberofbits);
+	}
+	bool GetBit(const uint32_t bit) const
+	{
+		return Get(bit, 1) == 1;
+	}
+	void SetBit(const uint32_t bit, const bool val)
+	{
+		assert(bit < MaxSOEBits);
+		uint64_t mask = uint64_t(1) << (63 - bit % 64);
+		if (val)
+			Words[bit / 64] |= mask;
+		else
+			Words[bit / 64] &= ~mask;
+	}
+
+	// The stream as 12 bit payloads, the last one zero padded.
+	uint32_t PayloadCount() const { return (UsedBits + 11) / 12; }
+	uint16_t GetPayload(const uint32_t payload) const
+	{
+		return static_cast<uint16_t>(Get(payload * 12, 12));
+	}
+
+private:
+	static const uint32_t NumWords = (MaxSOEBits + 63) / 64;
+	std::array<uint64_t, NumWords> Words{};
+	uint32_t UsedBits = 0;
+};
+
 class SOEEventFormat // Use the Bits uint64_t to get at the resulting packed bits. - bit order???
 {
 public:
@@ -462,7 +538,7 @@ public:
 	// Use the bitarray to construct an event, return the start of the next event in the bitarray.
 	// The bitarray data may give us a short timed event (only sec and msec received) in this case add the passed in LastEventTime to the seconds/msec value
 	// And change the TimeFormatBit to indicate that the Hours/Minutes are valid.
-	SOEEventFormat(std::array<bool, MaxSOEBits> BitArray, uint32_t startbit, uint32_t usedbits, uint32_t &newstartbit, CBTime LastEventTime, bool &success)
+	SOEEventFormat(const std::array<bool, MaxSOEBits>& BitArray, uint32_t startbit, uint32_t usedbits, uint32_t &newstartbit, CBTime LastEventTime, bool &success)
 	{
 		success = false;
 
@@ -486,8 +562,8 @@ public:
 
 			if (TimeFormatBit) // Long format
 			{
-				// Check there is enough data for the long version of the packet.
-				if ((startbit + 41) > usedbits)
+				// Check there is enough data for the rest of the long version of the packet (27 bits of time and the last event flag).
+				if ((startbit + 28) > usedbits)
 				{
 					LOGDEBUG("SOEEventFormat constructor failed in long version, only {} bits of data available", usedbits - startbit);
 					return;
@@ -520,6 +596,59 @@ public:
 		}
 	}
 
+	// As above, but using the packed bit stream. Each field is a single shift and mask.
+	SOEEventFormat(const CBSOEBitStream& Bits, uint32_t startbit, uint32_t &newstartbit, CBTime LastEventTime, bool &success)
+	{
+		success = false;
+		uint32_t usedbits = Bits.Size();
+
+		// Check there is enough data for at least the short version of the packet.
+		if ((startbit + 30) > usedbits)
+		{
+			LOGDEBUG("SOEEventFormat constructor failed, only {} bits of data available", usedbits - startbit);
+			return;
+		}
+
+		// Group(3), Number(7), Value, Quality, TimeFormat
+		auto head = Bits.Get(startbit, 13);
+		startbit += 13;
+		Group = static_cast<uint8_t>(head >> 10);
+		Number = static_cast<uint8_t>((head >> 3) & 0x7F);
+		ValueBit = ((head >> 2) & 0x01) == 0x01;
+		QualityBit = ((head >> 1) & 0x01) == 0x01;
+		TimeFormatBit = (head & 0x01) == 0x01;
+
+		if (TimeFormatBit) // Long format
+		{
+			// Check there is enough data for the rest of the long version of the packet (27 bits of time and the last event flag).
+			if ((startbit + 28) > usedbits)
+			{
+				LOGDEBUG("SOEEventFormat constructor failed in long version, only {} bits of data available", usedbits - startbit);
+				return;
+			}
+			auto hhmm = Bits.Get(startbit, 11);
+			startbit += 11;
+			Hour = static_cast<uint8_t>(hhmm >> 6);
+			Minute = static_cast<uint8_t>(hhmm & 0x3F);
+		}
+		// Second(6), Millisecond(10), LastEvent
+		auto tail = Bits.Get(startbit, 17);
+		startbit += 17;
+		Second = static_cast<uint8_t>(tail >> 11);
+		Millisecond = static_cast<uint16_t>((tail >> 1) & 0x3FF);
+
+		if (!TimeFormatBit) // Short Format, so add the LastEventTime to the delta we have (seconds+mseconds)
+		{
+			bool FirstEvent = (LastEventTime == 0); // Can only be zero for our first event...
+			LastEventTime += (Millisecond + Second * 1000);
+			SetTimeFields(LastEventTime, FirstEvent);
+		}
+		LastEventFlag = (tail & 0x01) == 0x01;
+
+		newstartbit = startbit;
+		success = true;
+	}
+
 	uint8_t Group = 0;  // 3 bits - 0 - 7
 	uint8_t Number = 0; // 7 bits - 0 - 120
 	bool ValueBit = false;
@@ -566,7 +695,7 @@ public:
 		return (((numeric_cast<CBTime>(Hour) * 60ul + numeric_cast<CBTime>(Minute)) * 60ul + numeric_cast<CBTime>(Second)) * 1000ul + numeric_cast<CBTime>(Millisecond));
 	}
 
-	uint8_t GetBits8(std::array<bool, MaxSOEBits> BitArray, uint32_t startbit, uint32_t numberofbits)
+	uint8_t GetBits8(const std::array<bool, MaxSOEBits>& BitArray, uint32_t startbit, uint32_t numberofbits)
 	{
 		assert(numberofbits <= 8);
 		assert(numberofbits != 0);
@@ -581,7 +710,7 @@ public:
 		}
 		return res;
 	}
-	uint16_t GetBits16(std::array<bool, MaxSOEBits> BitArray, uint32_t startbit, uint32_t numberofbits)
+	uint16_t GetBits16(const std::array<bool, MaxSOEBits>& BitArray, uint32_t startbit, uint32_t numberofbits)
 	{
 		assert(numberofbits <= 16);
 		assert(numberofbits != 0);
@@ -647,6 +776,17 @@ public:
 		}
 		return true;
 	}
+	bool AddDataToBitStream(CBSOEBitStream& Bits)
+	{
+		uint8_t numberofbits = GetResultBitLength();
+
+		// Same limit as the bit array version - never fill the last bit
+		if (Bits.Size() + numberofbits >= MaxSOEBits)
+			return false;
+
+		// The formatted data is MSB aligned
+		return Bits.Put(GetFormattedData() >> (64 - numberofbits), numberofbits);
+	}
 };
 
 #endif
@@ -0,0 +1,163 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* ProducerConsumerQueue.h
+*
+*  Created on: 19/10/2026
+*/
+
+#ifndef PRODUCERCONSUMERQUEUE_H_
+#define PRODUCERCONSUMERQUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Bounded, lock-free, multi producer / single consumer queue.
+// A fixed ring of cells, each with a sequence number that says whose turn it is (Vyukov's bounded queue).
+// Producers claim a cell with a CAS on the tail, so any number of threads can Push concurrently.
+// Peek/Pop must only be called by one consumer at a time (e.g. from a strand, or the one thread draining the queue).
+// Nothing blocks or allocates after construction - a full queue just refuses the Push.
+template <class T>
+class ProducerConsumerQueue
+{
+public:
+	explicit ProducerConsumerQueue(const size_t capacity):
+		Capacity(capacity ? capacity : 1),
+		Cells(new Cell[Capacity])
+	{
+		for (size_t i = 0; i < Capacity; i++)
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	ProducerConsumerQueue(const ProducerConsumerQueue&) = delete;
+	ProducerConsumerQueue& operator=(const ProducerConsumerQueue&) = delete;
+
+	// Returns false if the queue is full. If reserve is non-zero, that many cells are held back,
+	// so a producer can keep space for a final "queue full" marker.
+	bool Push(const T& item, const size_t reserve = 0)
+	{
+		size_t pos = Tail.load(std::memory_order_relaxed);
+		for (;;)
+		{
+			Cell& cell = Cells[pos % Capacity];
+			const size_t seq = cell.Sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+			if (diff == 0)
+			{
+				if (reserve && (pos - Head.load(std::memory_order_acquire) + reserve >= Capacity))
+					return false;
+				if (Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.Item = item;
+					cell.Sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The consumer hasn't freed this cell yet - full
+				return false;
+			}
+			else
+			{
+				// Another producer beat us to it
+				pos = Tail.load(std::memory_order_relaxed);
+			}
+		}
+	}
+
+	bool Peek(T& item)
+	{
+		Cell* cell = Front();
+		if (!cell)
+			return false;
+		item = cell->Item;
+		return true;
+	}
+	bool Pop(T& item)
+	{
+		Cell* cell = Front();
+		if (!cell)
+			return false;
+		item = std::move(cell->Item);
+		Release(*cell);
+		return true;
+	}
+	bool Pop()
+	{
+		Cell* cell = Front();
+		if (!cell)
+			return false;
+		Release(*cell);
+		return true;
+	}
+
+	bool IsEmpty() const
+	{
+		return Size() == 0;
+	}
+	// Approximate if producers are active
+	size_t Size() const
+	{
+		const size_t head = Head.load(std::memory_order_acquire);
+		const size_t tail = Tail.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+	bool IsFull() const
+	{
+		return Size() >= Capacity;
+	}
+	size_t GetCapacity() const
+	{
+		return Capacity;
+	}
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> Sequence{0};
+		T Item{};
+	};
+
+	// The cell at the head, if its producer has finished writing it
+	Cell* Front()
+	{
+		const size_t pos = Head.load(std::memory_order_relaxed);
+		Cell& cell = Cells[pos % Capacity];
+		if (cell.Sequence.load(std::memory_order_acquire) != pos + 1)
+			return nullptr;
+		return &cell;
+	}
+	void Release(Cell& cell)
+	{
+		const size_t pos = Head.load(std::memory_order_relaxed);
+		cell.Item = T(); // Don't hang on to anything the item owns
+		Head.store(pos + 1, std::memory_order_release);
+		cell.Sequence.store(pos + Capacity, std::memory_order_release);
+	}
+
+	const size_t Capacity;
+	std::unique_ptr<Cell[]> Cells;
+	alignas(64) std::atomic<size_t> Head{0};
+	alignas(64) std::atomic<size_t> Tail{0};
+};
+#endif
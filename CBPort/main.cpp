@@ -64,6 +64,13 @@ extern "C" void delete_CBOutstationPort(CBOutstationPort* aCBOutstationPort_ptr)
 	return;
 }
 
+// Set by the test runner if it counts heap allocations, so the benchmarks can report allocations per frame.
+uint64_t (*AllocationCount)() = nullptr;
+extern "C" void set_allocation_counter(uint64_t (*Counter)())
+{
+	AllocationCount = Counter;
+}
+
 //
 // Should be turned on for "normal" builds, and off if you want to use Visual Studio Test Integration.
 //
@@ -114,7 +114,7 @@ void DNP3MasterPort::SetCommsGood()
 		if(auto log = odc::spdlog_get("DNP3Port"))
 			log->debug("{}: Updating comms point (good).", Name);
 
-		auto commsUpEvent = std::make_shared<EventInfo>(EventType::Binary, pConf->pPointConf->mCommsPoint.second, Name);
+		auto commsUpEvent = std::make_shared<EventInfo>(EventType::Binary, pConf->pPointConf->mCommsPoint.second, GetID());
 		auto failed_val = pConf->pPointConf->mCommsPoint.first.value;
 		commsUpEvent->SetPayload<EventType::Binary>(!failed_val);
 		PublishEvent(commsUpEvent);
@@ -132,13 +132,13 @@ void DNP3MasterPort::SetCommsFailed()
 
 		for (auto index : pConf->pPointConf->BinaryIndicies)
 		{
-			auto event = std::make_shared<EventInfo>(EventType::BinaryQuality,index,Name);
+			auto event = std::make_shared<EventInfo>(EventType::BinaryQuality,index,GetID());
 			event->SetPayload<EventType::BinaryQuality>(QualityFlags::COMM_LOST);
 			PublishEvent(event);
 		}
 		for (auto index : pConf->pPointConf->AnalogIndicies)
 		{
-			auto event = std::make_shared<EventInfo>(EventType::AnalogQuality,index,Name);
+			auto event = std::make_shared<EventInfo>(EventType::AnalogQuality,index,GetID());
 			event->SetPayload<EventType::AnalogQuality>(QualityFlags::COMM_LOST);
 			PublishEvent(event);
 		}
@@ -150,7 +150,7 @@ void DNP3MasterPort::SetCommsFailed()
 		if(auto log = odc::spdlog_get("DNP3Port"))
 			log->debug("{}: Updating comms point (failed).", Name);
 
-		auto commsDownEvent = std::make_shared<EventInfo>(EventType::Binary, pConf->pPointConf->mCommsPoint.second, Name);
+		auto commsDownEvent = std::make_shared<EventInfo>(EventType::Binary, pConf->pPointConf->mCommsPoint.second, GetID());
 		auto failed_val = pConf->pPointConf->mCommsPoint.first.value;
 		commsDownEvent->SetPayload<EventType::Binary>(std::move(failed_val));
 		PublishEvent(commsDownEvent);
@@ -322,7 +322,7 @@ inline void DNP3MasterPort::LoadT(const opendnp3::ICollection<opendnp3::Indexed<
 	auto pConf = static_cast<DNP3PortConf*>(this->pConf.get());
 	meas.ForeachItem([this,pConf](const opendnp3::Indexed<T>&pair)
 		{
-			auto event = ToODC(pair.value, pair.index, Name);
+			auto event = ToODC(pair.value, pair.index, GetID());
 			if ((pConf->pPointConf->TimestampOverride == DNP3PointConf::TimestampOverride_t::ALWAYS) ||
 			    ((pConf->pPointConf->TimestampOverride == DNP3PointConf::TimestampOverride_t::ZERO) && (pair.value.time == 0)))
 			{
@@ -308,7 +308,7 @@ inline opendnp3::CommandStatus DNP3OutstationPort::PerformT(T& arCommand, uint16
 	if(!enabled)
 		return opendnp3::CommandStatus::UNDEFINED;
 
-	auto event = ToODC(arCommand, aIndex, Name);
+	auto event = ToODC(arCommand, aIndex, GetID());
 
 	auto pConf = static_cast<DNP3PortConf*>(this->pConf.get());
 	if (!pConf->pPointConf->WaitForCommandResponses)
@@ -178,7 +178,7 @@ opendnp3::CommandStatus FromODC(const CommandStatus stat)
 	return dnp3;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Binary& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Binary& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::Binary, ind, source);
 
@@ -205,7 +205,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::Binary& dnp3, const size_t ind,
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinary& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinary& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::DoubleBitBinary, ind, source);
 
@@ -244,7 +244,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinary& dnp3, const si
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Analog& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Analog& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::Analog, ind, source);
 
@@ -273,7 +273,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::Analog& dnp3, const size_t ind,
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Counter& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Counter& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::Counter, ind, source);
 
@@ -302,7 +302,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::Counter& dnp3, const size_t ind
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::FrozenCounter& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::FrozenCounter& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::FrozenCounter, ind, source);
 
@@ -331,7 +331,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::FrozenCounter& dnp3, const size
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatus& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatus& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::BinaryOutputStatus, ind, source);
 
@@ -356,7 +356,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatus& dnp3, const
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputStatus& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputStatus& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputStatus, ind, source);
 
@@ -385,7 +385,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputStatus& dnp3, const
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryQuality& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryQuality& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::BinaryQuality, ind, source);
 
@@ -410,7 +410,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryQuality& dnp3, const size
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinaryQuality& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinaryQuality& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::DoubleBitBinaryQuality, ind, source);
 
@@ -435,7 +435,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinaryQuality& dnp3, c
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogQuality& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogQuality& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogQuality, ind, source);
 
@@ -462,7 +462,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogQuality& dnp3, const size
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::CounterQuality& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::CounterQuality& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::CounterQuality, ind, source);
 
@@ -489,7 +489,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::CounterQuality& dnp3, const siz
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatusQuality& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatusQuality& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::BinaryOutputStatusQuality, ind, source);
 
@@ -512,7 +512,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatusQuality& dnp3
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::ControlRelayOutputBlock& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::ControlRelayOutputBlock& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ind, source);
 
@@ -579,7 +579,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::ControlRelayOutputBlock& dnp3,
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt16& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt16& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ind, source);
 
@@ -595,7 +595,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt16& dnp3, const
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt32& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt32& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt32, ind, source);
 
@@ -611,7 +611,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt32& dnp3, const
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputFloat32& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputFloat32& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputFloat32, ind, source);
 
@@ -627,7 +627,7 @@ std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputFloat32& dnp3, cons
 	return event;
 }
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputDouble64& dnp3, const size_t ind, const std::string& source)
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputDouble64& dnp3, const size_t ind, const NameID_t source)
 {
 	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputDouble64, ind, source);
 
@@ -43,23 +43,23 @@ namespace odc
 CommandStatus ToODC(const opendnp3::CommandStatus dnp3);
 opendnp3::CommandStatus FromODC(const CommandStatus stat);
 
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Binary& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinary& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Analog& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::Counter& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::FrozenCounter& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatus& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputStatus& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryQuality& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinaryQuality& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogQuality& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::CounterQuality& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatusQuality& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::ControlRelayOutputBlock& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt16& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt32& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputFloat32& dnp3, const size_t ind = 0, const std::string& source = "");
-std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputDouble64& dnp3, const size_t ind = 0, const std::string& source = "");
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Binary& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinary& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Analog& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::Counter& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::FrozenCounter& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatus& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputStatus& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryQuality& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::DoubleBitBinaryQuality& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogQuality& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::CounterQuality& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::BinaryOutputStatusQuality& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::ControlRelayOutputBlock& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt16& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputInt32& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputFloat32& dnp3, const size_t ind = 0, const NameID_t source = 0);
+std::shared_ptr<EventInfo> ToODC(const opendnp3::AnalogOutputDouble64& dnp3, const size_t ind = 0, const NameID_t source = 0);
 
 //Map EventTypes to opendnp3 types
 template<EventType t> struct EventTypeDNP3 { typedef void type; };
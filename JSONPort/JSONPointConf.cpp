@@ -51,6 +51,8 @@ void JSONPointConf::ProcessElements(const Json::Value& JSONRoot)
 		return;
 
 	this->TimestampPath = JSONRoot["TimestampPath"];
+	//optional path to an array of objects, each processed as if it were received separately
+	this->BatchPath = JSONRoot["BatchPath"];
 
 	auto ind_marker = JSONRoot["TemplateIndex"].isString() ? JSONRoot["TemplateIndex"].asString() : "<INDEX>";
 	auto val_marker = JSONRoot["TemplateValue"].isString() ? JSONRoot["TemplateValue"].asString() : "<VALUE>";
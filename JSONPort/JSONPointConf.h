@@ -47,6 +47,7 @@ public:
 	std::map<uint16_t, Json::Value> Controls;
 	std::map<uint16_t, Json::Value> AnalogControls;
 	Json::Value TimestampPath;
+	Json::Value BatchPath;
 	std::unique_ptr<JSONOutputTemplate> pJOT;
 };
 
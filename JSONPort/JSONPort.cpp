@@ -26,6 +26,7 @@
 
 #include "JSONPort.h"
 #include <chrono>
+#include <future>
 #include <memory>
 #include <opendatacon/IOTypes.h>
 #include <opendatacon/util.h>
@@ -68,6 +69,24 @@ void JSONPort::Disable()
 	enabled = false;
 	if(!pSockMan)
 		return;
+	//don't hold on to a partial batch - hand it to the socket manager before it's closed
+	if(pBatchStrand)
+	{
+		auto promise = std::make_shared<std::promise<void>>();
+		auto future = promise->get_future();
+		pBatchStrand->dispatch([this,promise]()
+			{
+				FlushOutput();
+				promise->set_value();
+			});
+		//Synchronously wait for the flush - let ASIO run handlers in the meantime, in case we're on a pool thread
+		while(future.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready)
+		{
+			if(pIOS->stopped())
+				break;
+			pIOS->poll_one();
+		}
+	}
 	pSockMan->Close();
 }
 
@@ -112,6 +131,27 @@ void JSONPort::ProcessElements(const Json::Value& JSONRoot)
 	//TODO: document this
 	if(JSONRoot.isMember("PrintAllEvents"))
 		static_cast<JSONPortConf*>(pConf.get())->print_all = JSONRoot["PrintAllEvents"].asBool();
+	//"Single" (default), "Array" or "NDJSON"
+	//	batched modes pack up to BatchMaxEvents, or BatchTimems worth of events, into one write
+	if(JSONRoot.isMember("OutputMode"))
+	{
+		auto mode = JSONRoot["OutputMode"].asString();
+		if(mode == "Single")
+			static_cast<JSONPortConf*>(pConf.get())->output_mode = JSONOutputMode::SINGLE;
+		else if(mode == "Array")
+			static_cast<JSONPortConf*>(pConf.get())->output_mode = JSONOutputMode::ARRAY;
+		else if(mode == "NDJSON")
+			static_cast<JSONPortConf*>(pConf.get())->output_mode = JSONOutputMode::NDJSON;
+		else if(auto log = odc::spdlog_get("JSONPort"))
+			log->error("{}: Unrecognised OutputMode '{}', using 'Single'", Name, mode);
+	}
+	if(JSONRoot.isMember("BatchMaxEvents"))
+	{
+		auto max_events = JSONRoot["BatchMaxEvents"].asUInt();
+		static_cast<JSONPortConf*>(pConf.get())->batch_max_events = max_events ? max_events : 1;
+	}
+	if(JSONRoot.isMember("BatchTimems"))
+		static_cast<JSONPortConf*>(pConf.get())->batch_time_ms = JSONRoot["BatchTimems"].asUInt();
 }
 
 void JSONPort::Build()
@@ -125,6 +165,9 @@ void JSONPort::Build()
 		           1000,
 		           true,
 		           pConf->retry_time_ms);
+
+	pBatchStrand = pIOS->make_strand();
+	pBatchTimer = pIOS->make_steady_timer();
 }
 
 void JSONPort::ReadCompletionHandler(buf_t& readbuf)
@@ -187,323 +230,346 @@ void JSONPort::ProcessBraced(const std::string& braced)
 	{
 		auto pConf = static_cast<JSONPortConf*>(this->pConf.get());
 
-		//little functor to traverse any paths, starting at the root
-		//pass a JSON array of nodes representing the path (that's how we store our point config after all)
-		auto TraversePath = [&JSONRoot](const Json::Value& nodes)
-					  {
-						  //val will traverse any paths, starting at the root
-						  auto val = JSONRoot;
-						  //traverse
-						  for(unsigned int n = 0; n < nodes.size(); ++n)
-							  if((val = val[nodes[n].asCString()]).isNull())
-								  break;
-						  return val;
-					  };
-
-		msSinceEpoch_t timestamp = 0;
-		if(!pConf->pPointConf->TimestampPath.isNull())
+		//Check for a batch of point updates in one object
+		if(!pConf->pPointConf->BatchPath.isNull())
 		{
-			try
+			const Json::Value& batch = TraversePath(JSONRoot,pConf->pPointConf->BatchPath);
+			if(batch.isArray())
 			{
-				timestamp = TraversePath(pConf->pPointConf->TimestampPath).asUInt64();
-				if(timestamp == 0)
-					throw std::runtime_error("Null timestamp");
-			}
-			catch(std::runtime_error& e)
-			{
-				if(auto log = odc::spdlog_get("JSONPort"))
-					log->error("Error decoding timestamp as Uint64: '{}'",e.what());
+				for(const auto& element : batch)
+					ProcessJSONRoot(element);
+				return;
 			}
 		}
+		ProcessJSONRoot(JSONRoot);
+	}
+	else
+	{
+		if(auto log = odc::spdlog_get("JSONPort"))
+			log->warn("Error parsing JSON string: '{}' : '{}'", braced, err_str);
+	}
+}
+
+//Traverse a path, starting at the root
+//pass a JSON array of nodes representing the path (that's how we store our point config after all)
+const Json::Value& JSONPort::TraversePath(const Json::Value& JSONRoot, const Json::Value& nodes)
+{
+	//only walk references, so the whole tree isn't copied at every step
+	const Json::Value* val = &JSONRoot;
+	for(unsigned int n = 0; n < nodes.size(); ++n)
+	{
+		if(!val->isObject())
+			return Json::Value::nullSingleton();
+		val = &(*val)[nodes[n].asCString()];
+		if(val->isNull())
+			break;
+	}
+	return *val;
+}
+
+//Extract any paths that match our point config from a parsed JSON object
+void JSONPort::ProcessJSONRoot(const Json::Value& JSONRoot)
+{
+	auto pConf = static_cast<JSONPortConf*>(this->pConf.get());
 
-		//vector to store any events we find contained in this Json object
-		std::vector<std::shared_ptr<EventInfo>> events;
+	msSinceEpoch_t timestamp = 0;
+	if(!pConf->pPointConf->TimestampPath.isNull())
+	{
+		try
+		{
+			timestamp = TraversePath(JSONRoot,pConf->pPointConf->TimestampPath).asUInt64();
+			if(timestamp == 0)
+				throw std::runtime_error("Null timestamp");
+		}
+		catch(std::runtime_error& e)
+		{
+			if(auto log = odc::spdlog_get("JSONPort"))
+				log->error("Error decoding timestamp as Uint64: '{}'",e.what());
+		}
+	}
 
-		for(auto& point_pair : pConf->pPointConf->Analogs)
+	//vector to store any events we find contained in this Json object
+	std::vector<std::shared_ptr<EventInfo>> events;
+
+	for(auto& point_pair : pConf->pPointConf->Analogs)
+	{
+		if(!point_pair.second.isMember("JSONPath"))
+			continue;
+		const Json::Value& val = TraversePath(JSONRoot,point_pair.second["JSONPath"]);
+		//if the path existed, load up the point
+		if(!val.isNull())
 		{
-			if(!point_pair.second.isMember("JSONPath"))
-				continue;
-			Json::Value val = TraversePath(point_pair.second["JSONPath"]);
-			//if the path existed, load up the point
-			if(!val.isNull())
+			auto event = std::make_shared<EventInfo>(EventType::Analog,point_pair.first,GetID(),QualityFlags::ONLINE,timestamp);
+			if(val.isNumeric())
+				event->SetPayload<EventType::Analog>(val.asDouble());
+			else if(val.isString())
 			{
-				auto event = std::make_shared<EventInfo>(EventType::Analog,point_pair.first,Name,QualityFlags::ONLINE,timestamp);
-				if(val.isNumeric())
-					event->SetPayload<EventType::Analog>(val.asDouble());
-				else if(val.isString())
+				double value;
+				try
 				{
-					double value;
-					try
-					{
-						value = std::stod(val.asString());
-						event->SetPayload<EventType::Analog>(std::move(value));
-					}
-					catch(std::exception&)
-					{
-						if(auto log = odc::spdlog_get("JSONPort"))
-							log->error("Error decoding Analog from string '{}', for index {}",val.asString(),point_pair.first);
-						event->SetPayload<EventType::Analog>(0);
-						event->SetQuality(QualityFlags::OVERRANGE);
-					}
+					value = std::stod(val.asString());
+					event->SetPayload<EventType::Analog>(std::move(value));
 				}
-				else
+				catch(std::exception&)
 				{
 					if(auto log = odc::spdlog_get("JSONPort"))
-						log->error("Error decoding Analog for index {}",point_pair.first);
+						log->error("Error decoding Analog from string '{}', for index {}",val.asString(),point_pair.first);
 					event->SetPayload<EventType::Analog>(0);
 					event->SetQuality(QualityFlags::OVERRANGE);
 				}
-				events.push_back(event);
 			}
+			else
+			{
+				if(auto log = odc::spdlog_get("JSONPort"))
+					log->error("Error decoding Analog for index {}",point_pair.first);
+				event->SetPayload<EventType::Analog>(0);
+				event->SetQuality(QualityFlags::OVERRANGE);
+			}
+			events.push_back(event);
 		}
+	}
 
-		for(auto& point_pair : pConf->pPointConf->Binaries)
+	for(auto& point_pair : pConf->pPointConf->Binaries)
+	{
+		if(!point_pair.second.isMember("JSONPath"))
+			continue;
+		const Json::Value& val = TraversePath(JSONRoot,point_pair.second["JSONPath"]);
+		//if the path existed, load up the point
+		if(!val.isNull())
 		{
-			if(!point_pair.second.isMember("JSONPath"))
-				continue;
-			Json::Value val = TraversePath(point_pair.second["JSONPath"]);
-			//if the path existed, load up the point
-			if(!val.isNull())
+			auto event = std::make_shared<EventInfo>(EventType::Binary,point_pair.first,GetID(),QualityFlags::ONLINE,timestamp);
+			bool true_val = false;
+			if(point_pair.second.isMember("TrueVal"))
 			{
-				auto event = std::make_shared<EventInfo>(EventType::Binary,point_pair.first,Name,QualityFlags::ONLINE,timestamp);
-				bool true_val = false;
-				if(point_pair.second.isMember("TrueVal"))
-				{
-					true_val = (val == point_pair.second["TrueVal"]);
-					if(point_pair.second.isMember("FalseVal"))
-						if (!true_val && (val != point_pair.second["FalseVal"]))
-							event->SetQuality(QualityFlags::COMM_LOST);
-				}
-				else if(point_pair.second.isMember("FalseVal"))
-					true_val = !(val == point_pair.second["FalseVal"]);
-				else if(val.isNumeric() || val.isBool())
-					true_val = val.asBool();
-				else if(val.isString())
-				{
-					true_val = (val.asString() == "true");
-					if(!true_val && (val.asString() != "false"))
+				true_val = (val == point_pair.second["TrueVal"]);
+				if(point_pair.second.isMember("FalseVal"))
+					if (!true_val && (val != point_pair.second["FalseVal"]))
 						event->SetQuality(QualityFlags::COMM_LOST);
-				}
-				else
+			}
+			else if(point_pair.second.isMember("FalseVal"))
+				true_val = !(val == point_pair.second["FalseVal"]);
+			else if(val.isNumeric() || val.isBool())
+				true_val = val.asBool();
+			else if(val.isString())
+			{
+				true_val = (val.asString() == "true");
+				if(!true_val && (val.asString() != "false"))
 					event->SetQuality(QualityFlags::COMM_LOST);
-
-				event->SetPayload<EventType::Binary>(std::move(true_val));
-				events.push_back(event);
 			}
-		}
+			else
+				event->SetQuality(QualityFlags::COMM_LOST);
 
-		//Publish any analog and binary events from above
-		for(auto& event : events)
-		{
-			PublishEvent(event);
+			event->SetPayload<EventType::Binary>(std::move(true_val));
+			events.push_back(event);
 		}
-		//We'll publish any controls separately below, because they each have a callback
+	}
 
-		for(auto& point_pair : pConf->pPointConf->Controls)
+	//Publish any analog and binary events from above
+	for(auto& event : events)
+	{
+		PublishEvent(event);
+	}
+	//We'll publish any controls separately below, because they each have a callback
+
+	for(auto& point_pair : pConf->pPointConf->Controls)
+	{
+		if(!point_pair.second.isMember("JSONPath"))
+			continue;
+		const Json::Value& val = TraversePath(JSONRoot,point_pair.second["JSONPath"]);
+		//if the path existed, get the value and send the control
+		if(!val.isNull())
 		{
-			if(!point_pair.second.isMember("JSONPath"))
-				continue;
-			Json::Value val = TraversePath(point_pair.second["JSONPath"]);
-			//if the path existed, get the value and send the control
-			if(!val.isNull())
-			{
-				auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock,point_pair.first,Name,QualityFlags::NONE,timestamp);
+			auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock,point_pair.first,GetID(),QualityFlags::NONE,timestamp);
 
-				ControlRelayOutputBlock command;
-				command.functionCode = ControlCode::PULSE_ON; //default pulse if nothing else specified
+			ControlRelayOutputBlock command;
+			command.functionCode = ControlCode::PULSE_ON; //default pulse if nothing else specified
 
-				//work out control code to send
-				if(point_pair.second.isMember("ControlMode") && point_pair.second["ControlMode"].isString())
-				{
-					auto check_val = [&point_pair,&val](const std::string& truename, const std::string& falsename) -> bool
+			//work out control code to send
+			if(point_pair.second.isMember("ControlMode") && point_pair.second["ControlMode"].isString())
+			{
+				auto check_val = [&point_pair,&val](const std::string& truename, const std::string& falsename) -> bool
+						     {
+							     bool ret = true;
+							     if(point_pair.second.isMember(truename))
 							     {
-								     bool ret = true;
-								     if(point_pair.second.isMember(truename))
-								     {
-									     ret = (val == point_pair.second[truename]);
-									     if(point_pair.second.isMember(falsename))
-										     if (!ret && (val != point_pair.second[falsename]))
-											     throw std::runtime_error("Unexpected control value");
-								     }
-								     else if(point_pair.second.isMember(falsename))
-									     ret = !(val == point_pair.second[falsename]);
-								     else if(val.isNumeric() || val.isBool())
-									     ret = val.asBool();
-								     else if(val.isString()) //Guess some sensible default on/off/trip/close values
-								     {
-									     //TODO: replace with regex?
-									     ret = (val.asString() == "true" ||
-									            val.asString() == "True" ||
-									            val.asString() == "TRUE" ||
-									            val.asString() == "on" ||
-									            val.asString() == "On" ||
-									            val.asString() == "ON" ||
-									            val.asString() == "close" ||
-									            val.asString() == "Close" ||
-									            val.asString() == "CLOSE");
-									     if(!ret && (val.asString() != "false" &&
-									                 val.asString() != "False" &&
-									                 val.asString() != "FALSE" &&
-									                 val.asString() != "off" &&
-									                 val.asString() != "Off" &&
-									                 val.asString() != "OFF" &&
-									                 val.asString() != "trip" &&
-									                 val.asString() != "Trip" &&
-									                 val.asString() != "TRIP"))
+								     ret = (val == point_pair.second[truename]);
+								     if(point_pair.second.isMember(falsename))
+									     if (!ret && (val != point_pair.second[falsename]))
 										     throw std::runtime_error("Unexpected control value");
-								     }
-								     return ret;
-							     };
-
-					auto cm = point_pair.second["ControlMode"].asString();
-					if(cm == "LATCH")
+							     }
+							     else if(point_pair.second.isMember(falsename))
+								     ret = !(val == point_pair.second[falsename]);
+							     else if(val.isNumeric() || val.isBool())
+								     ret = val.asBool();
+							     else if(val.isString()) //Guess some sensible default on/off/trip/close values
+							     {
+								     //TODO: replace with regex?
+								     ret = (val.asString() == "true" ||
+								            val.asString() == "True" ||
+								            val.asString() == "TRUE" ||
+								            val.asString() == "on" ||
+								            val.asString() == "On" ||
+								            val.asString() == "ON" ||
+								            val.asString() == "close" ||
+								            val.asString() == "Close" ||
+								            val.asString() == "CLOSE");
+								     if(!ret && (val.asString() != "false" &&
+								                 val.asString() != "False" &&
+								                 val.asString() != "FALSE" &&
+								                 val.asString() != "off" &&
+								                 val.asString() != "Off" &&
+								                 val.asString() != "OFF" &&
+								                 val.asString() != "trip" &&
+								                 val.asString() != "Trip" &&
+								                 val.asString() != "TRIP"))
+									     throw std::runtime_error("Unexpected control value");
+							     }
+							     return ret;
+						     };
+
+				auto cm = point_pair.second["ControlMode"].asString();
+				if(cm == "LATCH")
+				{
+					bool on;
+					try
 					{
-						bool on;
-						try
-						{
-							on = check_val("OnVal","OffVal");
-						}
-						catch(std::runtime_error& e)
-						{
-							if(auto log = odc::spdlog_get("JSONPort"))
-								log->error("'{}', for index {}",e.what(),point_pair.first);
-							continue;
-						}
-						if(on)
-							command.functionCode = ControlCode::LATCH_ON;
-						else
-							command.functionCode = ControlCode::LATCH_OFF;
+						on = check_val("OnVal","OffVal");
 					}
-					else if(cm == "TRIPCLOSE")
+					catch(std::runtime_error& e)
 					{
-						bool trip;
-						try
-						{
-							trip = check_val("TripVal","CloseVal");
-						}
-						catch(std::runtime_error& e)
-						{
-							if(auto log = odc::spdlog_get("JSONPort"))
-								log->error("'{}', for index {}",e.what(),point_pair.first);
-							continue;
-						}
-						if(trip)
-							command.functionCode = ControlCode::TRIP_PULSE_ON;
-						else
-							command.functionCode = ControlCode::CLOSE_PULSE_ON;
+						if(auto log = odc::spdlog_get("JSONPort"))
+							log->error("'{}', for index {}",e.what(),point_pair.first);
+						continue;
 					}
-					else if(cm != "PULSE")
+					if(on)
+						command.functionCode = ControlCode::LATCH_ON;
+					else
+						command.functionCode = ControlCode::LATCH_OFF;
+				}
+				else if(cm == "TRIPCLOSE")
+				{
+					bool trip;
+					try
+					{
+						trip = check_val("TripVal","CloseVal");
+					}
+					catch(std::runtime_error& e)
 					{
 						if(auto log = odc::spdlog_get("JSONPort"))
-							log->error("Unrecongnised ControlMode '{}', recieved for index {}",cm,point_pair.first);
+							log->error("'{}', for index {}",e.what(),point_pair.first);
 						continue;
 					}
+					if(trip)
+						command.functionCode = ControlCode::TRIP_PULSE_ON;
+					else
+						command.functionCode = ControlCode::CLOSE_PULSE_ON;
+				}
+				else if(cm != "PULSE")
+				{
+					if(auto log = odc::spdlog_get("JSONPort"))
+						log->error("Unrecongnised ControlMode '{}', recieved for index {}",cm,point_pair.first);
+					continue;
 				}
-				if(point_pair.second.isMember("PulseCount"))
-					command.count = point_pair.second["PulseCount"].asUInt();
-				if(point_pair.second.isMember("OnTimems"))
-					command.onTimeMS = point_pair.second["OnTimems"].asUInt();
-				if(point_pair.second.isMember("OffTimems"))
-					command.offTimeMS = point_pair.second["OffTimems"].asUInt();
-
-				auto pStatusCallback =
-					std::make_shared<std::function<void(CommandStatus)>>([=](CommandStatus command_stat)
-						{
-							Json::Value result;
-							result["Command"]["Index"] = point_pair.first;
-
-							if(command_stat == CommandStatus::SUCCESS)
-								result["Command"]["Status"] = "SUCCESS";
-							else
-								result["Command"]["Status"] = "UNDEFINED";
-
-							//TODO: make this writer reusable (class member)
-							//WARNING: Json::StreamWriter isn't threadsafe - maybe just share the StreamWriterBuilder for now...
-							Json::StreamWriterBuilder wbuilder;
-							if(!pConf->style_output)
-								wbuilder["indentation"] = "";
-							std::unique_ptr<Json::StreamWriter> const pWriter(wbuilder.newStreamWriter());
-
-							std::ostringstream oss;
-							pWriter->write(result, &oss); oss<<std::endl;
-							pSockMan->Write(oss.str());
-						});
-				event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(command));
-				PublishEvent(event,pStatusCallback);
 			}
+			if(point_pair.second.isMember("PulseCount"))
+				command.count = point_pair.second["PulseCount"].asUInt();
+			if(point_pair.second.isMember("OnTimems"))
+				command.onTimeMS = point_pair.second["OnTimems"].asUInt();
+			if(point_pair.second.isMember("OffTimems"))
+				command.offTimeMS = point_pair.second["OffTimems"].asUInt();
+
+			auto pStatusCallback =
+				std::make_shared<std::function<void(CommandStatus)>>([=](CommandStatus command_stat)
+					{
+						Json::Value result;
+						result["Command"]["Index"] = point_pair.first;
+
+						if(command_stat == CommandStatus::SUCCESS)
+							result["Command"]["Status"] = "SUCCESS";
+						else
+							result["Command"]["Status"] = "UNDEFINED";
+
+						//TODO: make this writer reusable (class member)
+						//WARNING: Json::StreamWriter isn't threadsafe - maybe just share the StreamWriterBuilder for now...
+						Json::StreamWriterBuilder wbuilder;
+						if(!pConf->style_output)
+							wbuilder["indentation"] = "";
+						std::unique_ptr<Json::StreamWriter> const pWriter(wbuilder.newStreamWriter());
+
+						std::ostringstream oss;
+						pWriter->write(result, &oss); oss<<std::endl;
+						pSockMan->Write(oss.str());
+					});
+			event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(command));
+			PublishEvent(event,pStatusCallback);
 		}
+	}
 
-		for (auto& point_pair : pConf->pPointConf->AnalogControls)
-		{
-			if (!point_pair.second.isMember("JSONPath"))
-				continue;
-			Json::Value val = TraversePath(point_pair.second["JSONPath"]);
-			//if the path existed, get the value and send the control
+	for (auto& point_pair : pConf->pPointConf->AnalogControls)
+	{
+		if (!point_pair.second.isMember("JSONPath"))
+			continue;
+		const Json::Value& val = TraversePath(JSONRoot,point_pair.second["JSONPath"]);
+		//if the path existed, get the value and send the control
 
-			// Now decode the val JSON string to get the index and value and process that
-			if (!val.isNull())
-			{
-				auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, point_pair.first, Name, QualityFlags::ONLINE, timestamp);
-				AO16 analogpayload;
-				analogpayload.second = CommandStatus::SUCCESS;
+		// Now decode the val JSON string to get the index and value and process that
+		if (!val.isNull())
+		{
+			auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, point_pair.first, GetID(), QualityFlags::ONLINE, timestamp);
+			AO16 analogpayload;
+			analogpayload.second = CommandStatus::SUCCESS;
 
-				if (auto log = odc::spdlog_get("JSONPort"))
-					log->debug("JSNOn AnalogControl Command - {}", val.asString());
+			if (auto log = odc::spdlog_get("JSONPort"))
+				log->debug("JSNOn AnalogControl Command - {}", val.asString());
 
-				if (val.isNumeric())
-					analogpayload.first = val.asUInt();
-				else if (val.isString())
+			if (val.isNumeric())
+				analogpayload.first = val.asUInt();
+			else if (val.isString())
+			{
+				try
 				{
-					try
-					{
-						analogpayload.first = std::stoul(val.asString());
-					}
-					catch (std::exception&)
-					{
-						if (auto log = odc::spdlog_get("JSONPort"))
-							log->error("Error decoding AnalogControl from string '{}', for index {}", val.asString(), point_pair.first);
-					}
+					analogpayload.first = std::stoul(val.asString());
 				}
-				else
+				catch (std::exception&)
 				{
 					if (auto log = odc::spdlog_get("JSONPort"))
-						log->error("Error decoding AnalogControl value for index {}", point_pair.first);
-					return;
+						log->error("Error decoding AnalogControl from string '{}', for index {}", val.asString(), point_pair.first);
 				}
-				event->SetPayload<EventType::AnalogOutputInt16>(move(analogpayload));
-
-				auto pStatusCallback =
-					std::make_shared<std::function<void(CommandStatus)>>([=](CommandStatus command_stat)
-						{
-							Json::Value result;
-							result["Command"]["Index"] = point_pair.first;
-
-							if (command_stat == CommandStatus::SUCCESS)
-								result["Command"]["Status"] = "SUCCESS";
-							else
-								result["Command"]["Status"] = "UNDEFINED";
-
-							//TODO: make this writer reusable (class member)
-							//WARNING: Json::StreamWriter isn't threadsafe - maybe just share the StreamWriterBuilder for now...
-							Json::StreamWriterBuilder wbuilder;
-							if (!pConf->style_output)
-								wbuilder["indentation"] = "";
-							std::unique_ptr<Json::StreamWriter> const pWriter(wbuilder.newStreamWriter());
-
-							std::ostringstream oss;
-							pWriter->write(result, &oss); oss << std::endl;
-							pSockMan->Write(oss.str());
-						});
-
-				PublishEvent(event, pStatusCallback);
 			}
+			else
+			{
+				if (auto log = odc::spdlog_get("JSONPort"))
+					log->error("Error decoding AnalogControl value for index {}", point_pair.first);
+				return;
+			}
+			event->SetPayload<EventType::AnalogOutputInt16>(move(analogpayload));
+
+			auto pStatusCallback =
+				std::make_shared<std::function<void(CommandStatus)>>([=](CommandStatus command_stat)
+					{
+						Json::Value result;
+						result["Command"]["Index"] = point_pair.first;
+
+						if (command_stat == CommandStatus::SUCCESS)
+							result["Command"]["Status"] = "SUCCESS";
+						else
+							result["Command"]["Status"] = "UNDEFINED";
+
+						//TODO: make this writer reusable (class member)
+						//WARNING: Json::StreamWriter isn't threadsafe - maybe just share the StreamWriterBuilder for now...
+						Json::StreamWriterBuilder wbuilder;
+						if (!pConf->style_output)
+							wbuilder["indentation"] = "";
+						std::unique_ptr<Json::StreamWriter> const pWriter(wbuilder.newStreamWriter());
+
+						std::ostringstream oss;
+						pWriter->write(result, &oss); oss << std::endl;
+						pSockMan->Write(oss.str());
+					});
+
+			PublishEvent(event, pStatusCallback);
 		}
 	}
-	else
-	{
-		if(auto log = odc::spdlog_get("JSONPort"))
-			log->warn("Error parsing JSON string: '{}' : '{}'", braced, err_str);
-	}
 }
 
 void JSONPort::Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback)
@@ -561,6 +627,13 @@ void JSONPort::Event(std::shared_ptr<const EventInfo> event, const std::string&
 		return;
 	}
 
+	if(pConf->output_mode != JSONOutputMode::SINGLE)
+	{
+		QueueOutput(std::move(output));
+		(*pStatusCallback)(CommandStatus::SUCCESS);
+		return;
+	}
+
 	//TODO: make this writer reusable (class member)
 	//WARNING: Json::StreamWriter isn't threadsafe - maybe just share the StreamWriterBuilder for now...
 	Json::StreamWriterBuilder wbuilder;
@@ -574,3 +647,72 @@ void JSONPort::Event(std::shared_ptr<const EventInfo> event, const std::string&
 
 	(*pStatusCallback)(CommandStatus::SUCCESS);
 }
+
+void JSONPort::QueueOutput(Json::Value&& output)
+{
+	pBatchStrand->post([this,weak_self{weak_from_this()},output{std::move(output)}]() mutable
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+
+			auto pConf = static_cast<JSONPortConf*>(this->pConf.get());
+			OutputBatch.push_back(std::move(output));
+
+			if(OutputBatch.size() >= pConf->batch_max_events)
+			{
+				FlushOutput();
+				return;
+			}
+			//first event in the batch starts the clock
+			if(OutputBatch.size() == 1)
+			{
+				pBatchTimer->expires_from_now(std::chrono::milliseconds(pConf->batch_time_ms));
+				//the generation stops a late timer (the batch it was for already flushed) flushing this batch early
+				auto generation = BatchGeneration;
+				pBatchTimer->async_wait(pBatchStrand->wrap([this,weak_self,generation](asio::error_code err_code)
+					{
+						if(err_code)
+							return;
+						auto self = weak_self.lock();
+						if(self && generation == BatchGeneration)
+							FlushOutput();
+					}));
+			}
+		});
+}
+
+//Only call on pBatchStrand
+void JSONPort::FlushOutput()
+{
+	if(OutputBatch.empty())
+		return;
+	BatchGeneration++;
+	pBatchTimer->cancel();
+
+	auto pConf = static_cast<JSONPortConf*>(this->pConf.get());
+
+	Json::StreamWriterBuilder wbuilder;
+	//NDJSON needs one object per line, so no indentation regardless of style
+	if(!pConf->style_output || pConf->output_mode == JSONOutputMode::NDJSON)
+		wbuilder["indentation"] = "";
+	std::unique_ptr<Json::StreamWriter> const pWriter(wbuilder.newStreamWriter());
+
+	std::ostringstream oss;
+	if(pConf->output_mode == JSONOutputMode::ARRAY)
+	{
+		Json::Value array(Json::arrayValue);
+		for(auto& output : OutputBatch)
+			array.append(std::move(output));
+		pWriter->write(array, &oss); oss<<"\n";
+	}
+	else
+	{
+		for(const auto& output : OutputBatch)
+		{
+			pWriter->write(output, &oss); oss<<"\n";
+		}
+	}
+	OutputBatch.clear();
+	pSockMan->Write(oss.str());
+}
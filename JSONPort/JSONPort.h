@@ -54,6 +54,16 @@ private:
 	void ReadCompletionHandler(buf_t& readbuf);
 	typedef asio::basic_waitable_timer<std::chrono::steady_clock> Timer_t;
 	void ProcessBraced(const std::string& braced);
+	void ProcessJSONRoot(const Json::Value& JSONRoot);
+	static const Json::Value& TraversePath(const Json::Value& JSONRoot, const Json::Value& nodes);
+
+	//Output batching (for OutputMode ARRAY or NDJSON)
+	void QueueOutput(Json::Value&& output);
+	void FlushOutput();
+	std::unique_ptr<asio::io_service::strand> pBatchStrand;
+	std::unique_ptr<Timer_t> pBatchTimer;
+	std::vector<Json::Value> OutputBatch;
+	uint64_t BatchGeneration = 0;
 };
 
 #endif /* JSONDATAPORT_H_ */
@@ -30,6 +30,13 @@
 #include <memory>
 #include <opendatacon/DataPortConf.h>
 
+enum class JSONOutputMode
+{
+	SINGLE, //one JSON object per write, newline terminated
+	ARRAY,  //batches written as a single JSON array
+	NDJSON  //batches written as newline delimited JSON objects in a single write
+};
+
 struct JSONAddrConf
 {
 	std::string IP = "127.0.0.1";
@@ -43,7 +50,10 @@ public:
 		retry_time_ms(3000),
 		evt_buffer_size(1000),
 		style_output(false),
-		print_all(false)
+		print_all(false),
+		output_mode(JSONOutputMode::SINGLE),
+		batch_max_events(100),
+		batch_time_ms(100)
 	{
 		pPointConf = std::make_unique<JSONPointConf>(FileName, ConfOverrides);
 	}
@@ -54,6 +64,9 @@ public:
 	unsigned int evt_buffer_size;
 	bool style_output;
 	bool print_all;
+	JSONOutputMode output_mode;
+	unsigned int batch_max_events;
+	unsigned int batch_time_ms;
 };
 
 #endif /* JSONPORTCONF_H_ */
@@ -33,7 +33,9 @@
 
 // regex to find long winded LOG commands \{a[1-5]\}
 
+#include <atomic>
 #include <cstdint>
+#include <thread>
 #include <opendatacon/DataPort.h>
 #include <opendatacon/util.h>
 
@@ -215,15 +217,15 @@ class MD3Point // Abstract Class
 public:
 	MD3Point() {}
 
-	// We need these as we DO NOT want to copy the mutex!
+	// We need these as we DO NOT want to copy the atomics directly
 	MD3Point(const MD3Point &src):
 		Index(src.Index),
 		ModuleAddress(src.ModuleAddress),
 		Channel(src.Channel),
-		PollGroup(src.PollGroup),
-		ChangedTime(src.ChangedTime),
-		HasBeenSet(src.HasBeenSet)
-	{}
+		PollGroup(src.PollGroup)
+	{
+		CopyStateFrom(src);
+	}
 	virtual ~MD3Point() = 0; // Make the base class pure virtual
 
 	MD3Point& operator=(const MD3Point& src)
@@ -232,8 +234,7 @@ public:
 		ModuleAddress = src.ModuleAddress;
 		Channel = src.Channel;
 		PollGroup = src.PollGroup;
-		ChangedTime = src.ChangedTime;
-		HasBeenSet = src.HasBeenSet;
+		CopyStateFrom(src);
 		return *this;
 	}
 
@@ -246,23 +247,82 @@ public:
 	{}
 
 	// These first 4 never change, so no protection
-	uint32_t GetIndex() { return Index; }
-	uint8_t GetModuleAddress() { return ModuleAddress; }
-	uint8_t GetChannel() { return Channel; }
-	uint8_t GetPollGroup() { return PollGroup; }
-
-	MD3Time GetChangedTime() { std::unique_lock<std::mutex> lck(PointMutex); return ChangedTime; }
-	bool GetHasBeenSet() { std::unique_lock<std::mutex> lck(PointMutex); return HasBeenSet; }
-	//	void SetChangedTime(const MD3Time &ct) { std::unique_lock<std::mutex> lck(PointMutex); ChangedTime = ct; }; // Not needed...
+	uint32_t GetIndex() const { return Index; }
+	uint8_t GetModuleAddress() const { return ModuleAddress; }
+	uint8_t GetChannel() const { return Channel; }
+	uint8_t GetPollGroup() const { return PollGroup; }
+
+	MD3Time GetChangedTime() const { return ChangedTime; }
+	// State and the ChangedTime that went with it - use this when the value and time have to match
+	uint64_t GetStateAndTime(MD3Time &ctime) const
+	{
+		while (true)
+		{
+			const uint32_t seq = Seq.load(std::memory_order_acquire);
+			if (seq & 1)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			const uint64_t state = State.load(std::memory_order_relaxed);
+			ctime = ChangedTime.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (Seq.load(std::memory_order_relaxed) == seq)
+				return state;
+		}
+	}
+	bool GetHasBeenSet() const { return (State & HASBEENSET) != 0; }
 
 protected:
-	std::mutex PointMutex;
+	// The flags and values are packed into State (layout below HASBEENSET is up to the point type), so they can be
+	// read and updated from any thread without a lock. ChangedTime doesn't fit in the same word, so a value and its time
+	// are written together under the per point seqlock Seq (UpdateStateAndTime) and read together with GetStateAndTime.
+	// Flag only updates just CAS State.
+	static constexpr uint64_t HASBEENSET = uint64_t(1) << 63;
+
+	// Atomically replaces State with fn(State), returning the value it replaced
+	template <typename Fn>
+	uint64_t UpdateState(Fn&& fn)
+	{
+		uint64_t old = State.load();
+		while (!State.compare_exchange_weak(old, fn(old))) {}
+		return old;
+	}
+
+	// As UpdateState, and sets ChangedTime in the same update. Writers claim the point by CASing Seq from even to odd.
+	template <typename Fn>
+	uint64_t UpdateStateAndTime(const MD3Time ctime, Fn&& fn)
+	{
+		uint32_t seq = Seq.load(std::memory_order_relaxed);
+		do
+		{
+			while (seq & 1)
+			{
+				std::this_thread::yield();
+				seq = Seq.load(std::memory_order_relaxed);
+			}
+		} while (!Seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed));
+		std::atomic_thread_fence(std::memory_order_release);
+		ChangedTime.store(ctime, std::memory_order_relaxed);
+		const uint64_t old = UpdateState(std::forward<Fn>(fn));
+		Seq.store(seq + 2, std::memory_order_release);
+		return old;
+	}
+
+	void CopyStateFrom(const MD3Point &src)
+	{
+		MD3Time ctime;
+		const uint64_t state = src.GetStateAndTime(ctime);
+		UpdateStateAndTime(ctime, [state](uint64_t) { return state; });
+	}
+
 	uint32_t Index = 0;
 	uint8_t ModuleAddress = 0;
 	uint8_t Channel = 0;
 	uint8_t PollGroup = 0;
-	MD3Time ChangedTime = static_cast<MD3Time>(0); // msec since epoch. 1970,1,1 Only used for Fn9 and 11 queued data. TimeStamp is Uint48_t, MD3 is uint64_t but does not overflow.
-	bool HasBeenSet = false;                       // To determine if we have been set since startup
+	std::atomic<MD3Time> ChangedTime{static_cast<MD3Time>(0)}; // msec since epoch. 1970,1,1 Only used for Fn9 and 11 queued data. TimeStamp is Uint48_t, MD3 is uint64_t but does not overflow.
+	std::atomic<uint64_t> State{0};                              // HASBEENSET - to determine if we have been set since startup
+	std::atomic<uint32_t> Seq{0};                                // Odd while a value and its ChangedTime are being updated
 	//TODO: Point quality to RESTART instead of HasBeenSet = false.
 	//TODO: Integrate ODC quality instead of HasBeenSet flag and Module failed flag.
 };
@@ -271,23 +331,25 @@ protected:
 class MD3BinaryPoint: public MD3Point
 {
 public:
-	MD3BinaryPoint() {}
+	MD3BinaryPoint()
+	{
+		State = MakeState(0x01, 0, true);
+	}
 	MD3BinaryPoint(const MD3BinaryPoint &src): MD3Point(src),
-		Binary(src.Binary),
-		ModuleBinarySnapShot(src.ModuleBinarySnapShot),
-		Changed(src.Changed),
 		PointType(src.PointType)
 	{}
 	MD3BinaryPoint(uint32_t index, uint8_t moduleaddress, uint8_t channel, uint8_t pollgroup, BinaryPointType pointtype): MD3Point(index, moduleaddress, channel, static_cast<MD3Time>(0), pollgroup),
 		PointType(pointtype)
-	{}
+	{
+		State = MakeState(0x01, 0, true);
+	}
 
 	MD3BinaryPoint(uint32_t index, uint8_t moduleaddress, uint8_t channel, uint8_t pollgroup, BinaryPointType pointtype, uint8_t binval, bool changed, MD3Time changedtime):
 		MD3Point(index, moduleaddress, channel, changedtime, pollgroup),
-		Binary(binval),
-		Changed(changed),
 		PointType(pointtype)
-	{}
+	{
+		State = MakeState(binval, 0, changed);
+	}
 
 	~MD3BinaryPoint();
 
@@ -296,50 +358,94 @@ public:
 
 	BinaryPointType GetPointType() const { return PointType; }
 
-	uint8_t GetBinary() { std::unique_lock<std::mutex> lck(PointMutex); return Binary; }
-	uint16_t GetModuleBinarySnapShot() { std::unique_lock<std::mutex> lck(PointMutex); return ModuleBinarySnapShot; }
+	uint8_t GetBinary() const { return State & BINARY; }
+	uint8_t GetBinary(MD3Time &ctime) const { return GetStateAndTime(ctime) & BINARY; }
+	// Module bits were collected (ModuleBinarySnapShot) for the queue necessary to handle Fn11 time tagged events. Have to remember all 16 bits when the event happened
+	uint16_t GetModuleBinarySnapShot() const { return static_cast<uint16_t>((State & SNAPSHOT) >> 16); }
 
-	bool GetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); return Changed; }
-	void SetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); Changed = true; }
-	bool GetAndResetChangedFlag() { std::unique_lock<std::mutex> lck(PointMutex); bool res = Changed; Changed = false; return res; }
+	bool GetChangedFlag() const { return (State & CHANGED) != 0; }
+	void SetChangedFlag() { State |= CHANGED; }
+	bool GetAndResetChangedFlag() { return (State.fetch_and(~CHANGED) & CHANGED) != 0; }
 
-	void SetBinary(const uint8_t &b, const MD3Time &ctime) { std::unique_lock<std::mutex> lck(PointMutex); HasBeenSet = true; ChangedTime = ctime; Changed = (Binary != b); Binary = b; }
-	void SetChanged(const bool &c) { std::unique_lock<std::mutex> lck(PointMutex); Changed = c; }
-	void SetModuleBinarySnapShot(const uint16_t &bm) { std::unique_lock<std::mutex> lck(PointMutex); ModuleBinarySnapShot = bm; }
+	void SetBinary(const uint8_t &b, const MD3Time &ctime)
+	{
+		UpdateStateAndTime(ctime, [b](uint64_t old)
+			{
+				const uint64_t changed = ((old & BINARY) != b) ? CHANGED : 0;
+				return (old & ~(BINARY | CHANGED)) | b | changed | HASBEENSET;
+			});
+	}
+	void SetChanged(const bool &c)
+	{
+		if (c)
+			State |= CHANGED;
+		else
+			State &= ~CHANGED;
+	}
+	void SetModuleBinarySnapShot(const uint16_t &bm)
+	{
+		UpdateState([bm](uint64_t old) { return (old & ~SNAPSHOT) | (static_cast<uint64_t>(bm) << 16); });
+	}
 
 protected:
-	// Only the values below will be changed in two places
-	uint8_t Binary = 0x01;
-	uint16_t ModuleBinarySnapShot = 0; // Used for the queue necessary to handle Fn11 time tagged events. Have to remember all 16 bits when the event happened
-	bool Changed = true;
+	static constexpr uint64_t BINARY = 0xFF;
+	static constexpr uint64_t SNAPSHOT = 0xFFFF0000;
+	static constexpr uint64_t CHANGED = uint64_t(1) << 32;
+	static uint64_t MakeState(uint8_t binary, uint16_t snapshot, bool changed)
+	{
+		return binary | (static_cast<uint64_t>(snapshot) << 16) | (changed ? CHANGED : 0);
+	}
+
 	BinaryPointType PointType = BASICINPUT;
 };
 
 class MD3AnalogCounterPoint: public MD3Point
 {
 public:
-	MD3AnalogCounterPoint() {}
+	MD3AnalogCounterPoint()
+	{
+		State = MakeState(0x8000, 0x8000);
+	}
 
 	MD3AnalogCounterPoint(uint32_t index, uint8_t moduleaddress, uint8_t channel, uint8_t pollgroup): MD3Point(index, moduleaddress, channel, static_cast<MD3Time>(0), pollgroup)
-	{}
+	{
+		State = MakeState(0x8000, 0x8000);
+	}
 	~MD3AnalogCounterPoint();
 
-	uint16_t GetAnalog() { std::unique_lock<std::mutex> lck(PointMutex); return Analog; }
-	uint16_t GetAnalogAndDelta(int &delta) { std::unique_lock<std::mutex> lck(PointMutex); delta = static_cast<int>(Analog) - static_cast<int>(LastReadAnalog); LastReadAnalog = Analog; return Analog; }
+	uint16_t GetAnalog() const { return State & ANALOG; }
+	uint16_t GetAnalog(MD3Time &ctime) const { return GetStateAndTime(ctime) & ANALOG; }
+	uint16_t GetAnalogAndDelta(int &delta)
+	{
+		// The value read becomes the last read value
+		const uint64_t old = UpdateState([](uint64_t old) { return (old & ~LASTREAD) | ((old & ANALOG) << 16); });
+		const auto analog = static_cast<uint16_t>(old & ANALOG);
+		delta = static_cast<int>(analog) - static_cast<int>((old & LASTREAD) >> 16);
+		return analog;
+	}
 
-	void SetAnalog(const uint16_t & a, const MD3Time &ctime) { std::unique_lock<std::mutex> lck(PointMutex); HasBeenSet = true; Analog = a; ChangedTime = ctime; }
-	void ResetAnalog() { std::unique_lock<std::mutex> lck(PointMutex); HasBeenSet = false; Analog = 0x8000; ChangedTime = 0; }
-	void SetLastReadAnalog(const uint16_t & a) { std::unique_lock<std::mutex> lck(PointMutex); LastReadAnalog = a; }
+	void SetAnalog(const uint16_t & a, const MD3Time &ctime)
+	{
+		UpdateStateAndTime(ctime, [a](uint64_t old) { return (old & ~ANALOG) | a | HASBEENSET; });
+	}
+	void ResetAnalog()
+	{
+		UpdateStateAndTime(0, [](uint64_t old) { return (old & LASTREAD) | 0x8000; });
+	}
+	void SetLastReadAnalog(const uint16_t & a)
+	{
+		UpdateState([a](uint64_t old) { return (old & ~LASTREAD) | (static_cast<uint64_t>(a) << 16); });
+	}
 
 protected:
-	uint16_t Analog = 0x8000;
-	uint16_t LastReadAnalog = 0x8000;
+	static constexpr uint64_t ANALOG = 0xFFFF;
+	static constexpr uint64_t LASTREAD = 0xFFFF0000;
+	static uint64_t MakeState(uint16_t analog, uint16_t lastread)
+	{
+		return analog | (static_cast<uint64_t>(lastread) << 16);
+	}
 };
 
-typedef std::map<size_t, std::shared_ptr<MD3BinaryPoint>>::iterator ODCBinaryPointMapIterType;
-typedef std::map<uint16_t, std::shared_ptr<MD3BinaryPoint>>::iterator MD3BinaryPointMapIterType;
-typedef std::map<size_t, std::shared_ptr<MD3AnalogCounterPoint>>::iterator ODCAnalogCounterPointMapIterType;
-typedef std::map<uint16_t, std::shared_ptr<MD3AnalogCounterPoint>>::iterator MD3AnalogCounterPointMapIterType;
 typedef std::map<uint8_t, uint16_t> ModuleMapType;
 
 
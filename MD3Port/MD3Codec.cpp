@@ -0,0 +1,122 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* MD3Codec.cpp
+*
+*  Created on: 19/10/2026
+*/
+
+#include "MD3Codec.h"
+
+namespace
+{
+inline uint8_t* PutBlock(uint8_t* out, const uint32_t data, const uint8_t endbyte)
+{
+	out[0] = static_cast<uint8_t>(data >> 24);
+	out[1] = static_cast<uint8_t>(data >> 16);
+	out[2] = static_cast<uint8_t>(data >> 8);
+	out[3] = static_cast<uint8_t>(data);
+	out[4] = endbyte;
+	out[5] = 0x00; // Padding
+	return out + MD3BlockArraySize;
+}
+// Data (unformatted) block end byte - CRC, FOM bit set, EOM bit on the last block
+inline uint8_t DataEndByte(const uint32_t data, const bool lastblock)
+{
+	return MD3CRC(data) | FOMBIT | (lastblock ? EOMBIT : 0x00);
+}
+}
+
+size_t MD3EncodeMessage(const MD3BlockData* blocks, size_t blockcount, uint8_t* out, size_t outsize)
+{
+	if (outsize < MD3MessageBytes(blockcount))
+		return 0;
+
+	uint8_t* p = out;
+	for (size_t i = 0; i < blockcount; i++)
+		p = PutBlock(p, blocks[i].GetData(), blocks[i].GetEndByte());
+	return static_cast<size_t>(p - out);
+}
+
+size_t MD3EncodeAnalogUnconditional(const MD3BlockData& header, const uint16_t* values, size_t count, uint8_t* out, size_t outsize)
+{
+	const size_t datablocks = count / 2 + count % 2; // 2 --> 1, 3 -->2
+	if (outsize < MD3MessageBytes(1 + datablocks))
+		return 0;
+
+	uint8_t* p = PutBlock(out, header.GetData(), header.GetEndByte());
+	for (size_t i = 0; i < datablocks; i++)
+	{
+		const uint16_t first = values[2 * i];
+		const uint16_t second = (2 * i + 1 < count) ? values[2 * i + 1] : 0;
+		const uint32_t data = static_cast<uint32_t>(first) << 16 | second;
+		p = PutBlock(p, data, DataEndByte(data, i + 1 == datablocks));
+	}
+	return static_cast<size_t>(p - out);
+}
+
+size_t MD3EncodeAnalogDelta(const MD3BlockData& header, const int* deltas, size_t count, uint8_t* out, size_t outsize)
+{
+	const size_t datablocks = count / 4 + (count % 4 == 0 ? 0 : 1);
+	if (outsize < MD3MessageBytes(1 + datablocks))
+		return 0;
+
+	uint8_t* p = PutBlock(out, header.GetData(), header.GetEndByte());
+	for (size_t i = 0; i < datablocks; i++)
+	{
+		uint32_t data = 0;
+		for (size_t j = 0; j < 4; j++)
+		{
+			const size_t idx = i * 4 + j;
+			const uint8_t delta = idx < count ? static_cast<uint8_t>(deltas[idx]) : 0;
+			data |= static_cast<uint32_t>(delta) << (8 * (3 - j));
+		}
+		p = PutBlock(p, data, DataEndByte(data, i + 1 == datablocks));
+	}
+	return static_cast<size_t>(p - out);
+}
+
+MD3DecodeResult MD3DecodeMessage(const uint8_t* in, size_t insize, MD3BlockData* out, size_t outcapacity, size_t& blockcount, size_t& consumed)
+{
+	blockcount = 0;
+	consumed = 0;
+
+	while (insize - consumed >= MD3BlockArraySize)
+	{
+		MD3BlockArray raw;
+		std::copy(in + consumed, in + consumed + MD3BlockArraySize, raw.begin());
+		MD3BlockData block(raw);
+
+		if ((raw[5] != 0x00) || !block.CheckSumPasses())
+			return MD3DecodeResult::BadBlock;
+		// Only the first block can be (and must be) formatted
+		if (block.IsFormattedBlock() != (blockcount == 0))
+			return MD3DecodeResult::BadBlock;
+		if (blockcount >= outcapacity)
+			return MD3DecodeResult::Overflow;
+
+		out[blockcount++] = block;
+		consumed += MD3BlockArraySize;
+
+		if (block.IsEndOfMessageBlock())
+			return MD3DecodeResult::Complete;
+	}
+	return MD3DecodeResult::Incomplete;
+}
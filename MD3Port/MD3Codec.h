@@ -0,0 +1,112 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* MD3Codec.h
+*
+*  Created on: 19/10/2026
+*/
+
+#ifndef MD3CODEC_H_
+#define MD3CODEC_H_
+
+#include "MD3Utility.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Whole message encode/decode into caller provided, fixed size buffers.
+// Nothing here allocates - the scan response paths build straight into bytes, computing CRC and padding for each block in the one pass.
+
+const size_t MD3MaxAnalogChannels = 16;
+
+// A vector with fixed capacity, backed by a std::array. push_back fails (returns false) rather than allocating.
+template <class T, size_t N>
+class MD3SmallVector
+{
+public:
+	bool push_back(const T& val)
+	{
+		if (count >= N)
+			return false;
+		items[count++] = val;
+		return true;
+	}
+	void clear() { count = 0; }
+	void resize(size_t n) { count = n < N ? n : N; }
+	size_t size() const { return count; }
+	bool empty() const { return count == 0; }
+	static constexpr size_t capacity() { return N; }
+
+	T& operator[](size_t i) { return items[i]; }
+	const T& operator[](size_t i) const { return items[i]; }
+	T* data() { return items.data(); }
+	const T* data() const { return items.data(); }
+	T* begin() { return items.data(); }
+	T* end() { return items.data() + count; }
+	const T* begin() const { return items.data(); }
+	const T* end() const { return items.data() + count; }
+
+private:
+	std::array<T, N> items{};
+	size_t count = 0;
+};
+
+typedef MD3SmallVector<uint16_t, MD3MaxAnalogChannels> MD3AnalogValues_t;
+typedef MD3SmallVector<int, MD3MaxAnalogChannels> MD3AnalogDeltas_t;
+
+// Bytes needed on the wire for a message of blockcount blocks
+constexpr size_t MD3MessageBytes(const size_t blockcount)
+{
+	return blockcount * MD3BlockArraySize;
+}
+
+// Encode already built blocks. Returns the number of bytes written, 0 if out is too small.
+size_t MD3EncodeMessage(const MD3BlockData* blocks, size_t blockcount, uint8_t* out, size_t outsize);
+inline size_t MD3EncodeMessage(const MD3Message_t& msg, uint8_t* out, size_t outsize)
+{
+	return MD3EncodeMessage(msg.data(), msg.size(), out, outsize);
+}
+
+// Encode the header block followed by the Fn5/Fn31 data blocks (two values to a block) - the header is sent as given.
+size_t MD3EncodeAnalogUnconditional(const MD3BlockData& header, const uint16_t* values, size_t count, uint8_t* out, size_t outsize);
+// Encode the header block followed by the Fn6 delta blocks (four signed 8 bit deltas to a block).
+size_t MD3EncodeAnalogDelta(const MD3BlockData& header, const int* deltas, size_t count, uint8_t* out, size_t outsize);
+
+enum class MD3DecodeResult
+{
+	Complete,   // Found the end of message block
+	Incomplete, // Ran out of input before the end of message block
+	BadBlock,   // A block failed its CRC/padding check, or the message did not start with a formatted block
+	Overflow    // More blocks than the output can hold
+};
+
+// Decode a block aligned buffer holding one message. consumed is set to the bytes used, blockcount to the blocks written to out.
+MD3DecodeResult MD3DecodeMessage(const uint8_t* in, size_t insize, MD3BlockData* out, size_t outcapacity, size_t& blockcount, size_t& consumed);
+
+template <size_t N>
+MD3DecodeResult MD3DecodeMessage(const uint8_t* in, size_t insize, MD3SmallVector<MD3BlockData, N>& out, size_t& consumed)
+{
+	size_t blockcount = 0;
+	auto res = MD3DecodeMessage(in, insize, out.data(), N, blockcount, consumed);
+	out.resize(blockcount);
+	return res;
+}
+
+#endif
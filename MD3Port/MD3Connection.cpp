@@ -25,6 +25,7 @@
  */
 
 #include "MD3.h"
+#include "MD3Codec.h"
 #include "MD3Connection.h"
 #include "MD3Utility.h"
 #include <functional>
@@ -267,27 +268,46 @@ void MD3Connection::Write(const ConnectionTokenType &ConnectionTok, const MD3Mes
 
 	if (auto pConnection = ConnectionTok.pConnection)
 	{
-		std::string MD3MessageString;
+		// Encode the whole message in one pass, straight into the string
+		std::string MD3MessageString(MD3MessageBytes(CompleteMD3Message.size()), '\0');
+		MD3EncodeMessage(CompleteMD3Message, reinterpret_cast<uint8_t*>(&MD3MessageString[0]), MD3MessageString.size());
 
-		MD3BlockData blk = CompleteMD3Message[0];
-
-		MD3MessageString += blk.ToBinaryString();
-
-		// Done the first block, now do the rest
-		for (uint8_t i = 1; i < CompleteMD3Message.size(); i++)
+		// This is a pointer to a function, so that we can hook it for testing. Otherwise calls the pSockMan Write templated function
+		// Small overhead to allow for testing - Is there a better way? - could not hook the pSockMan->Write function and/or another passed in function due to differences between a method and a lambda
+		if (pConnection->SendTCPDataFn != nullptr)
 		{
-			MD3MessageString += CompleteMD3Message[i].ToBinaryString();
+			pConnection->SendTCPDataFn(MD3MessageString);
 		}
+		else
+		{
+			pConnection->Write(std::move(MD3MessageString));
+		}
+	}
+	else
+	{
+		LOGERROR("MD3 Tried to write to a connection when the connection was no longer valid");
+	}
+}
+//Static method
+void MD3Connection::Write(const ConnectionTokenType &ConnectionTok, const uint8_t* data, size_t len)
+{
+	if (len == 0)
+	{
+		LOGERROR("MD3 Tried to send an empty message to the TCP Port");
+		return;
+	}
+	if (auto pConnection = ConnectionTok.pConnection)
+	{
+		// The socket owns its buffer until the write completes, so this is the one copy
+		std::string MD3MessageString(reinterpret_cast<const char*>(data), len);
 
-		// This is a pointer to a function, so that we can hook it for testing. Otherwise calls the pSockMan Write templated function
-		// Small overhead to allow for testing - Is there a better way? - could not hook the pSockMan->Write function and/or another passed in function due to differences between a method and a lambda
 		if (pConnection->SendTCPDataFn != nullptr)
 		{
 			pConnection->SendTCPDataFn(MD3MessageString);
 		}
 		else
 		{
-			pConnection->Write(MD3MessageString);
+			pConnection->Write(std::move(MD3MessageString));
 		}
 	}
 	else
@@ -297,9 +317,9 @@ void MD3Connection::Write(const ConnectionTokenType &ConnectionTok, const MD3Mes
 }
 
 // We don't need to know who is doing the writing. Just pass to the socket
-void MD3Connection::Write(std::string &msg)
+void MD3Connection::Write(std::string &&msg)
 {
-	pSockMan->Write(std::string(msg)); // Strange, it requires the std::string() constructor to be passed otherwise the templating fails.
+	pSockMan->Write(std::move(msg)); // Has to be an rvalue, otherwise the templating fails.
 }
 
 //Static method
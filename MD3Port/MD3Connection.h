@@ -41,6 +41,8 @@ The different instances on a multidrop configuration will all send through this
 If the last using class is closing, then this class will close the socket.
 The TCPSocketManager already does strand protection of the socket, so we will not have to worry about that.
 The MD3Connection class manages a static list of its own instances, so the OutStation can decide if it needs to create a new MD3Connection instance or not.
+Masters are the same, one Master port per Station. Each Master keeps its own outstanding command, retry and timeout state, so the Stations
+on a multidrop connection each have a command in flight at once. Replies are routed here by Station address, and matched to the command by function in the Master.
 */
 
 using namespace odc;
@@ -115,6 +117,8 @@ public:
 	~MD3Connection();
 
 	static void Write(const ConnectionTokenType &ConnectionTok, const MD3Message_t &CompleteMD3Message);
+	// Write a message already encoded to bytes (MD3Codec.h)
+	static void Write(const ConnectionTokenType &ConnectionTok, const uint8_t* data, size_t len);
 
 	static void InjectSimulatedTCPMessage(const ConnectionTokenType &ConnectionTok, buf_t&readbuf);
 
@@ -147,7 +151,7 @@ private:
 	void RemoveConnectionFromMap(); // Called by ConnectionToken destructor
 	void Open();
 	void Close();
-	void Write(std::string &msg);
+	void Write(std::string &&msg);
 	void RouteMD3Message(MD3Message_t &CompleteCBMessage);
 	void SocketStateHandler(bool state);
 
@@ -82,6 +82,8 @@ void MD3MasterPort::SocketStateHandler(bool state)
 	std::string msg;
 	if (state)
 	{
+		// The old round trip estimate may not apply to the new connection
+		MasterCommandStrand->dispatch([this]() { CommandRTT.Reset(); });
 		PollScheduler->Start();
 		PublishEvent(std::move(ConnectState::CONNECTED));
 		msg = Name + ": Connection established.";
@@ -112,7 +114,10 @@ void MD3MasterPort::Build()
 	MasterCommandStrand = pIOS->make_strand();
 
 	// Need a couple of things passed to the point table.
-	MyPointConf->PointTable.Build(IsOutStation, MyPointConf->NewDigitalCommands, *pIOS);
+	MyPointConf->PointTable.Build(IsOutStation, MyPointConf->NewDigitalCommands);
+
+	CommandRTT.Configure(MyPointConf->MD3CommandTimeoutmsec, MyPointConf->MD3CommandTimeoutMinmsec,
+		MyPointConf->MD3CommandTimeoutMaxmsec ? MyPointConf->MD3CommandTimeoutMaxmsec : RTTEstimator::DefaultMaxMultiple * MyPointConf->MD3CommandTimeoutmsec);
 
 	// Creates internally if necessary, returns a token for the connection
 	pConnection = MD3Connection::AddConnection(pIOS, IsServer(), MyConf->mAddrConf.IP, MyConf->mAddrConf.Port, MyConf->mAddrConf.TCPConnectRetryPeriodms); //Static method
@@ -132,10 +137,31 @@ void MD3MasterPort::Build()
 					  this->DoPoll(id);
 				  };
 		PollScheduler->Add(pg.second.pollrate, action);
+		if (id != 0) // 0 is the pollgroup of commands that are not polls
+			PollGroupQueued[id] = 0;
 	}
 	//	PollScheduler->Start(); // This is started and stopped in the socket state handler
 }
 
+const Json::Value MD3MasterPort::GetStatistics() const
+{
+	Json::Value stats;
+	stats["AdaptiveTimeout"] = MyPointConf->MD3AdaptiveTimeout;
+	stats["RTT"]["SRTTmsec"] = CommandRTT.GetSRTTmsec();
+	stats["RTT"]["RTTVARmsec"] = CommandRTT.GetRTTVARmsec();
+	stats["RTT"]["Timeoutmsec"] = Json::UInt64(CommandRTT.GetTimeout().count());
+	stats["RTT"]["Samples"] = Json::UInt64(CommandRTT.GetSamples());
+	stats["CommandTimeouts"] = Json::UInt64(NumCommandTimeouts);
+	stats["CommandRetries"] = Json::UInt64(NumCommandRetries);
+	auto& queue = MasterCommandProtectedData.MasterCommandQueue;
+	stats["CommandQueue"]["Control"] = Json::UInt64(queue.Size(CommandPriority::Control));
+	stats["CommandQueue"]["TimeSync"] = Json::UInt64(queue.Size(CommandPriority::TimeSync));
+	stats["CommandQueue"]["EventScan"] = Json::UInt64(queue.Size(CommandPriority::EventScan));
+	stats["CommandQueue"]["IntegrityScan"] = Json::UInt64(queue.Size(CommandPriority::IntegrityScan));
+	stats["CommandQueue"]["PollsCoalesced"] = Json::UInt64(NumPollsCoalesced);
+	return stats;
+}
+
 void MD3MasterPort::SendMD3Message(const MD3Message_t &CompleteMD3Message)
 {
 	if (CompleteMD3Message.size() == 0)
@@ -159,37 +185,46 @@ void MD3MasterPort::SendMD3Message(const MD3Message_t &CompleteMD3Message)
 // If the callback gets an error it will be ignored which will result in a timeout and the next command being sent.
 // This is necessary if somehow we get an old command sent to us, or a left over broadcast message.
 // Only issue is if we do a broadcast message and can get information back from multiple sources... These commands are probably not used, and we will ignore them anyway.
-void MD3MasterPort::QueueMD3Command(const MD3Message_t &CompleteMD3Message, const SharedStatusCallback_t& pStatusCallback)
+void MD3MasterPort::QueueMD3Command(const MD3Message_t &CompleteMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
-	MasterCommandStrand->dispatch([=]() // Tries to execute, if not able to will post. Note the calling thread must be one of the io_service threads.... this changes our tests!
-		{
-			if (MasterCommandProtectedData.MasterCommandQueue.size() < MasterCommandProtectedData.MaxCommandQueueSize)
-			{
-			      MasterCommandProtectedData.MasterCommandQueue.push(MasterCommandQueueItem(CompleteMD3Message, pStatusCallback)); // async
-			}
-			else
-			{
-			      LOGDEBUG("{} Tried to queue another MD3 Master Command when the command queue is full",Name);
-			      PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED); // Failed...
-			}
+	if (CompleteMD3Message.size() == 0)
+	{
+		LOGERROR("{} Tried to queue an empty MD3 Master Command", Name);
+		PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED);
+		return;
+	}
+	auto priority = GetCommandPriority(MD3BlockFormatted(CompleteMD3Message[0]).GetFunctionCode());
 
-			// Will only send if we can - i.e. not currently processing a command
-			UnprotectedSendNextMasterCommand(false);
-		});
+	// Count it before the push - the strand could pop it straight away
+	auto pollqueued = PollGroupQueued.find(pollgroup);
+	if (pollqueued != PollGroupQueued.end())
+		pollqueued->second++;
+
+	// Lock-free, so no need to get onto the strand just to queue the command
+	if (!MasterCommandProtectedData.MasterCommandQueue.Push(MasterCommandQueueItem(CompleteMD3Message, pStatusCallback, pollgroup), priority))
+	{
+		if (pollqueued != PollGroupQueued.end())
+			pollqueued->second--;
+		LOGDEBUG("{} Tried to queue another MD3 Master Command when the command queue is full",Name);
+		PostCallbackCall(pStatusCallback, CommandStatus::UNDEFINED); // Failed...
+	}
+
+	// Will only send if we can - i.e. not currently processing a command
+	SendNextMasterCommand();
 }
 // Handle the many single block command messages better
-void MD3MasterPort::QueueMD3Command(const MD3BlockData &SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback)
+void MD3MasterPort::QueueMD3Command(const MD3BlockData &SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
 	MD3Message_t CommandMD3Message;
 	CommandMD3Message.push_back(SingleBlockMD3Message);
-	QueueMD3Command(CommandMD3Message, pStatusCallback);
+	QueueMD3Command(CommandMD3Message, pStatusCallback, pollgroup);
 }
 // Handle the many single block command messages better
-void MD3MasterPort::QueueMD3Command(const MD3BlockFormatted &SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback)
+void MD3MasterPort::QueueMD3Command(const MD3BlockFormatted &SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
 	MD3Message_t CommandMD3Message;
 	CommandMD3Message.push_back(SingleBlockMD3Message);
-	QueueMD3Command(CommandMD3Message, pStatusCallback);
+	QueueMD3Command(CommandMD3Message, pStatusCallback, pollgroup);
 }
 
 // Just schedule the callback, don't want to do it in a strand protected section.
@@ -227,6 +262,7 @@ void MD3MasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 			if (MasterCommandProtectedData.RetriesLeft-- > 0)
 			{
 				MasterCommandProtectedData.ProcessingMD3Command = true;
+				NumCommandRetries++;
 				LOGDEBUG("{} Sending Retry on command: {}, Retrys Remaining: {}", Name, std::to_string(MasterCommandProtectedData.CurrentFunctionCode), MasterCommandProtectedData.RetriesLeft);
 			}
 			else
@@ -234,7 +270,7 @@ void MD3MasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 				// Have had multiple retries fail,
 
 				// Execute the callback with a fail code.
-				PostCallbackCall(MasterCommandProtectedData.CurrentCommand.second, CommandStatus::UNDEFINED);
+				PostCallbackCall(MasterCommandProtectedData.CurrentCommand.pStatusCallback, CommandStatus::UNDEFINED);
 
 				// so mark everything as if we have lost comms!
 				pIOS->post([this]()
@@ -246,27 +282,26 @@ void MD3MasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 			}
 		}
 
-		if (!MasterCommandProtectedData.MasterCommandQueue.empty() && (MasterCommandProtectedData.ProcessingMD3Command != true))
+		if ((MasterCommandProtectedData.ProcessingMD3Command != true) && MasterCommandProtectedData.MasterCommandQueue.Pop(MasterCommandProtectedData.CurrentCommand))
 		{
 			// Send the next command if there is one and we are not retrying.
+			CommandDequeued(MasterCommandProtectedData.CurrentCommand);
 
 			MasterCommandProtectedData.ProcessingMD3Command = true;
 			MasterCommandProtectedData.RetriesLeft = MyPointConf->MD3CommandRetries;
 
-			MasterCommandProtectedData.CurrentCommand = MasterCommandProtectedData.MasterCommandQueue.front();
-			MasterCommandProtectedData.MasterCommandQueue.pop();
-
-			MasterCommandProtectedData.CurrentFunctionCode = MD3BlockFormatted(MasterCommandProtectedData.CurrentCommand.first[0]).GetFunctionCode();
+			MasterCommandProtectedData.CurrentFunctionCode = MD3BlockFormatted(MasterCommandProtectedData.CurrentCommand.Message[0]).GetFunctionCode();
 			LOGDEBUG("{} Sending next command: {}", Name, std::to_string(MasterCommandProtectedData.CurrentFunctionCode));
 		}
 
 		// If either of the above situations need us to send a command, do so.
 		if (MasterCommandProtectedData.ProcessingMD3Command == true)
 		{
-			SendMD3Message(MasterCommandProtectedData.CurrentCommand.first); // This should be the only place this is called for the MD3Master...
+			SendMD3Message(MasterCommandProtectedData.CurrentCommand.Message); // This should be the only place this is called for the MD3Master...
 
 			// Start an async timed callback for a timeout - cancelled if we receive a good response.
-			MasterCommandProtectedData.TimerExpireTime = std::chrono::milliseconds(MyPointConf->MD3CommandTimeoutmsec);
+			MasterCommandProtectedData.CommandSentTime = std::chrono::steady_clock::now();
+			MasterCommandProtectedData.TimerExpireTime = GetCommandTimeout(MyPointConf->MD3CommandRetries - MasterCommandProtectedData.RetriesLeft);
 			MasterCommandProtectedData.CurrentCommandTimeoutTimer->expires_from_now(MasterCommandProtectedData.TimerExpireTime);
 
 			std::chrono::milliseconds endtime = MasterCommandProtectedData.TimerExpireTime;
@@ -286,6 +321,7 @@ void MD3MasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 								      LOGDEBUG("{} MD3 Master Timeout valid - MD3 Function {}",Name,std::to_string(MasterCommandProtectedData.CurrentFunctionCode));
 
 								      MasterCommandProtectedData.ProcessingMD3Command = false; // Only gets reset on success or timeout.
+								      NumCommandTimeouts++;
 
 								      UnprotectedSendNextMasterCommand(true); // We already have the strand, so don't need the wrapper here
 								}
@@ -305,16 +341,61 @@ void MD3MasterPort::UnprotectedSendNextMasterCommand(bool timeoutoccured)
 		}
 	}
 }
+// The fixed timeout, or if adaptive, the one from the Station's round trip time - doubled for each retry.
+std::chrono::milliseconds MD3MasterPort::GetCommandTimeout(uint32_t attempt) const
+{
+	if (MyPointConf->MD3AdaptiveTimeout)
+		return CommandRTT.GetTimeout(attempt);
+	return std::chrono::milliseconds(MyPointConf->MD3CommandTimeoutmsec);
+}
+// Controls first, then time sync, then the event (delta/change) scans and last the unconditional scans.
+CommandPriority MD3MasterPort::GetCommandPriority(uint8_t FunctionCode)
+{
+	switch (FunctionCode)
+	{
+		case SYSTEM_SET_DATETIME_CONTROL:
+		case SYSTEM_SET_DATETIME_CONTROL_NEW:
+			return CommandPriority::TimeSync;
+
+		case ANALOG_DELTA_SCAN:
+		case DIGITAL_DELTA_SCAN:
+		case HRER_LIST_SCAN:
+		case DIGITAL_CHANGE_OF_STATE:
+		case DIGITAL_CHANGE_OF_STATE_TIME_TAGGED:
+		case LOW_RES_EVENTS_LIST_SCAN:
+			return CommandPriority::EventScan;
+
+		case ANALOG_UNCONDITIONAL:
+		case DIGITAL_UNCONDITIONAL_OBS:
+		case DIGITAL_UNCONDITIONAL:
+		case COUNTER_SCAN:
+		case SYSTEM_FLAG_SCAN:
+			return CommandPriority::IntegrityScan;
+
+		default:
+			return CommandPriority::Control;
+	}
+}
+bool MD3MasterPort::IsPollQueued(uint32_t pollgroup) const
+{
+	auto pollqueued = PollGroupQueued.find(pollgroup);
+	return (pollqueued != PollGroupQueued.end()) && (pollqueued->second.load() != 0);
+}
+// Must be called for every command popped from the queue
+void MD3MasterPort::CommandDequeued(const MasterCommandQueueItem& item)
+{
+	auto pollqueued = PollGroupQueued.find(item.PollGroup);
+	if (pollqueued != PollGroupQueued.end())
+		pollqueued->second--;
+}
 // Strand protected clear the command queue.
 void MD3MasterPort::ClearMD3CommandQueue()
 {
 	MasterCommandStrand->dispatch([this]()
 		{
-			MD3Message_t NextCommand;
-			while (!MasterCommandProtectedData.MasterCommandQueue.empty())
-			{
-			      MasterCommandProtectedData.MasterCommandQueue.pop();
-			}
+			MasterCommandQueueItem item;
+			while (MasterCommandProtectedData.MasterCommandQueue.Pop(item))
+				CommandDequeued(item);
 			MasterCommandProtectedData.CurrentFunctionCode = 0;
 			MasterCommandProtectedData.ProcessingMD3Command = false;
 		});
@@ -513,10 +594,15 @@ void MD3MasterPort::ProcessMD3Message(MD3Message_t &CompleteMD3Message)
 			if (success) // Move to the next command. Only other place we do this is in the timeout.
 			{
 			      MasterCommandProtectedData.CurrentCommandTimeoutTimer->cancel(); // Have to be careful the handler still might do something?
+
+			      // Only a command answered first time gives a usable round trip time - for a retry we can't tell which send was answered.
+			      if (MasterCommandProtectedData.RetriesLeft == MyPointConf->MD3CommandRetries)
+			            CommandRTT.Sample(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - MasterCommandProtectedData.CommandSentTime));
+
 			      MasterCommandProtectedData.ProcessingMD3Command = false;         // Only gets reset on success or timeout.
 
 			      // Execute the callback with a success code.
-			      PostCallbackCall(MasterCommandProtectedData.CurrentCommand.second, CommandStatus::SUCCESS); // Does null check
+			      PostCallbackCall(MasterCommandProtectedData.CurrentCommand.pStatusCallback, CommandStatus::SUCCESS); // Does null check
 			      UnprotectedSendNextMasterCommand(false);                                                    // We already have the strand, so don't need the wrapper here. Pass in that this is not a retry.
 			}
 			else
@@ -590,7 +676,7 @@ bool MD3MasterPort::ProcessAnalogUnconditionalReturn(MD3BlockFormatted & Header,
 				QualityFlags qual = CalculateAnalogQuality(enabled, AnalogValues[i],now);
 				LOGDEBUG("MA - Published Event - Analog - Index {} Value {}",ODCIndex, to_hexstring(AnalogValues[i]));
 
-				auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
+				auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
 				event->SetPayload<EventType::Analog>(double(AnalogValues[i]));
 				PublishEvent(event);
 			}
@@ -604,7 +690,7 @@ bool MD3MasterPort::ProcessAnalogUnconditionalReturn(MD3BlockFormatted & Header,
 			{
 				QualityFlags qual = CalculateAnalogQuality(enabled, AnalogValues[i],now);
 				LOGDEBUG("MA - Published Event - Counter - Index {} Value {}",ODCIndex, to_hexstring(AnalogValues[i]));
-				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
+				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
 				event->SetPayload<EventType::Counter>(uint32_t(AnalogValues[i]));
 				PublishEvent(event);
 			}
@@ -685,7 +771,7 @@ bool MD3MasterPort::ProcessAnalogDeltaScanReturn(MD3BlockFormatted & Header, con
 			{
 				QualityFlags qual = CalculateAnalogQuality(enabled, wordres, now);
 				LOGDEBUG("MA - Published Event - Analog Index {} Value {}", ODCIndex, to_hexstring(wordres));
-				auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible
+				auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible
 				event->SetPayload<EventType::Analog>(std::move(wordres));
 				PublishEvent(event);
 			}
@@ -702,7 +788,7 @@ bool MD3MasterPort::ProcessAnalogDeltaScanReturn(MD3BlockFormatted & Header, con
 			{
 				QualityFlags qual = CalculateAnalogQuality(enabled,wordres, now);
 				LOGDEBUG("MA - Published Event - Counter Index {} Value {}", ODCIndex, to_hexstring(wordres));
-				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
+				auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
 				event->SetPayload<EventType::Counter>(std::move(wordres));
 				PublishEvent(event);
 			}
@@ -761,7 +847,7 @@ bool MD3MasterPort::ProcessAnalogNoChangeReturn(MD3BlockFormatted & Header, cons
 				{
 					QualityFlags qual = CalculateAnalogQuality(enabled, wordres, now);
 					LOGDEBUG("MA - Published Event - Analog Index {} Value {}",ODCIndex, to_hexstring(wordres));
-					auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible
+					auto event = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible
 					event->SetPayload<EventType::Analog>(std::move(wordres));
 					PublishEvent(event);
 				}
@@ -777,7 +863,7 @@ bool MD3MasterPort::ProcessAnalogNoChangeReturn(MD3BlockFormatted & Header, cons
 				{
 					QualityFlags qual = CalculateAnalogQuality(enabled, wordres, now);
 					LOGDEBUG("MA - Published Event - Counter Index {} Value {}",ODCIndex, to_hexstring(wordres));
-					auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
+					auto event = std::make_shared<EventInfo>(EventType::Counter, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(now)); // We don't get time info from MD3, so add it as soon as possible);
 					event->SetPayload<EventType::Counter>(std::move(wordres));
 					PublishEvent(event);
 				}
@@ -955,7 +1041,7 @@ void MD3MasterPort::GenerateODCEventsFromMD3ModuleWord(const uint16_t &ModuleDat
 			{
 				QualityFlags qual = CalculateBinaryQuality(enabled, eventtime);
 				LOGDEBUG("Published Event - Binary Index {} Value {}",ODCIndex,bitvalue);
-				auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, Name, qual, static_cast<msSinceEpoch_t>(eventtime));
+				auto event = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, GetID(), qual, static_cast<msSinceEpoch_t>(eventtime));
 				event->SetPayload<EventType::Binary>(bitvalue == 1);
 				PublishEvent(event);
 			}
@@ -1122,6 +1208,13 @@ bool MD3MasterPort::ProcessFlagScanReturn(MD3BlockFormatted & Header, const MD3M
 void MD3MasterPort::DoPoll(uint32_t pollgroup)
 {
 	if (!enabled) return;
+	if (IsPollQueued(pollgroup))
+	{
+		// The last one of these is still waiting behind other commands, no point queueing another the same
+		NumPollsCoalesced++;
+		LOGDEBUG("DoPoll : {} still queued, not queueing again", pollgroup);
+		return;
+	}
 	LOGDEBUG("DoPoll : " + std::to_string(pollgroup));
 
 	switch (MyPointConf->PollGroups[pollgroup].polltype)
@@ -1157,14 +1250,14 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 				LOGDEBUG("Poll Issued a Analog Unconditional Command");
 
 				MD3BlockFormatted commandblock(MyConf->mAddrConf.OutstationAddr, true, ANALOG_UNCONDITIONAL, ModuleAddress, Channels, true);
-				QueueMD3Command(commandblock, nullptr);
+				QueueMD3Command(commandblock, nullptr, pollgroup);
 			}
 			else
 			{
 				LOGDEBUG("Poll Issued a Analog Delta Command");
 				// Use a delta command Fn 6
 				MD3BlockFormatted commandblock(MyConf->mAddrConf.OutstationAddr, true, ANALOG_DELTA_SCAN, ModuleAddress, Channels, true);
-				QueueMD3Command(commandblock, nullptr);
+				QueueMD3Command(commandblock, nullptr, pollgroup);
 			}
 		}
 		break;
@@ -1200,14 +1293,14 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 				LOGDEBUG("Poll Issued a Analog Unconditional Command for Counter Values");
 
 				MD3BlockFormatted commandblock(MyConf->mAddrConf.OutstationAddr, true, ANALOG_UNCONDITIONAL, ModuleAddress, Channels, true);
-				QueueMD3Command(commandblock, nullptr);
+				QueueMD3Command(commandblock, nullptr, pollgroup);
 			}
 			else
 			{
 				LOGDEBUG("Poll Issued a Analog Delta Command for Counter Values");
 				// Use a delta command Fn 6
 				MD3BlockFormatted commandblock(MyConf->mAddrConf.OutstationAddr, true, ANALOG_DELTA_SCAN, ModuleAddress, Channels, true);
-				QueueMD3Command(commandblock, nullptr);
+				QueueMD3Command(commandblock, nullptr, pollgroup);
 			}
 		}
 		break;
@@ -1262,7 +1355,7 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 					commandblock = MD3BlockFn11MtoS(MyConf->mAddrConf.OutstationAddr, TaggedEventCount, GetAndIncrementDigitalCommandSequenceNumber(), Modules);
 				}
 
-				QueueMD3Command(commandblock, nullptr); // No callback, does not originate from ODC
+				QueueMD3Command(commandblock, nullptr, pollgroup); // No callback, does not originate from ODC
 			}
 			else // Old digital commands
 			{
@@ -1277,7 +1370,7 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 					uint8_t channels = 16; // Most we can get in one command
 					MD3BlockFormatted commandblock(MyConf->mAddrConf.OutstationAddr, true, DIGITAL_UNCONDITIONAL_OBS, ModuleAddress, channels, true);
 
-					QueueMD3Command(commandblock, nullptr); // No callback, does not originate from ODC
+					QueueMD3Command(commandblock, nullptr, pollgroup); // No callback, does not originate from ODC
 				}
 				else
 				{
@@ -1294,7 +1387,7 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 			uint64_t currenttime = MD3NowUTC();
 
 			LOGDEBUG("Poll Issued a TimeDate Command");
-			SendTimeDateChangeCommand(currenttime, nullptr);
+			SendTimeDateChangeCommand(currenttime, nullptr, pollgroup);
 		}
 		break;
 
@@ -1306,7 +1399,7 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 			LOGDEBUG("Poll Issued a NewTimeDate Command");
 			int utcoffsetminutes = tz_offset();
 
-			SendNewTimeDateChangeCommand(currenttime, utcoffsetminutes, nullptr);
+			SendNewTimeDateChangeCommand(currenttime, utcoffsetminutes, nullptr, pollgroup);
 		}
 		break;
 
@@ -1314,7 +1407,7 @@ void MD3MasterPort::DoPoll(uint32_t pollgroup)
 		{
 			// Send a flag scan command to the OutStation, (Fn 52)
 			LOGDEBUG("Poll Issued a System Flag Scan Command");
-			SendSystemFlagScanCommand(nullptr);
+			SendSystemFlagScanCommand(nullptr, pollgroup);
 		}
 		break;
 
@@ -1347,16 +1440,16 @@ void MD3MasterPort::EnablePolling(bool on)
 	else
 		PollScheduler->Stop();
 }
-void MD3MasterPort::SendTimeDateChangeCommand(const uint64_t &currenttimeinmsec, const SharedStatusCallback_t& pStatusCallback)
+void MD3MasterPort::SendTimeDateChangeCommand(const uint64_t &currenttimeinmsec, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
 	MD3BlockFn43MtoS commandblock(MyConf->mAddrConf.OutstationAddr, currenttimeinmsec % 1000);
 	MD3BlockData datablock(static_cast<uint32_t>(currenttimeinmsec / 1000), true);
 	MD3Message_t Cmd;
 	Cmd.push_back(commandblock);
 	Cmd.push_back(datablock);
-	QueueMD3Command(Cmd, pStatusCallback);
+	QueueMD3Command(Cmd, pStatusCallback, pollgroup);
 }
-void MD3MasterPort::SendNewTimeDateChangeCommand(const uint64_t &currenttimeinmsec, int utcoffsetminutes, const SharedStatusCallback_t& pStatusCallback)
+void MD3MasterPort::SendNewTimeDateChangeCommand(const uint64_t &currenttimeinmsec, int utcoffsetminutes, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup)
 {
 	MD3BlockFn44MtoS commandblock(MyConf->mAddrConf.OutstationAddr, currenttimeinmsec % 1000);
 	MD3BlockData datablock(static_cast<uint32_t>(currenttimeinmsec / 1000));
@@ -1365,19 +1458,19 @@ void MD3MasterPort::SendNewTimeDateChangeCommand(const uint64_t &currenttimeinms
 	Cmd.push_back(commandblock);
 	Cmd.push_back(datablock);
 	Cmd.push_back(datablock2);
-	QueueMD3Command(Cmd, pStatusCallback);
+	QueueMD3Command(Cmd, pStatusCallback, pollgroup);
 }
-void MD3MasterPort::SendSystemFlagScanCommand(SharedStatusCallback_t pStatusCallback)
+void MD3MasterPort::SendSystemFlagScanCommand(SharedStatusCallback_t pStatusCallback, uint32_t pollgroup)
 {
 	MD3BlockFn52MtoS commandblock(MyConf->mAddrConf.OutstationAddr);
-	QueueMD3Command(commandblock, std::move(pStatusCallback));
+	QueueMD3Command(commandblock, std::move(pStatusCallback), pollgroup);
 }
 
 void MD3MasterPort::SetAllPointsQualityToCommsLost()
 {
 	LOGDEBUG("MD3 Master setting quality to comms lost");
 
-	auto eventbinary = std::make_shared<EventInfo>(EventType::BinaryQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventbinary = std::make_shared<EventInfo>(EventType::BinaryQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventbinary->SetPayload<EventType::BinaryQuality>(QualityFlags::COMM_LOST);
 
 	// Loop through all Binary points.
@@ -1391,7 +1484,7 @@ void MD3MasterPort::SetAllPointsQualityToCommsLost()
 
 	// Analogs
 
-	auto eventanalog = std::make_shared<EventInfo>(EventType::AnalogQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventanalog = std::make_shared<EventInfo>(EventType::AnalogQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventanalog->SetPayload<EventType::AnalogQuality>(QualityFlags::COMM_LOST);
 	MyPointConf->PointTable.ForEachAnalogPoint([this,eventanalog](MD3AnalogCounterPoint &Point)
 		{
@@ -1403,7 +1496,7 @@ void MD3MasterPort::SetAllPointsQualityToCommsLost()
 			PublishEvent(eventanalog);
 		});
 	// Counters
-	auto eventcounter = std::make_shared<EventInfo>(EventType::CounterQuality, 0, Name, QualityFlags::COMM_LOST);
+	auto eventcounter = std::make_shared<EventInfo>(EventType::CounterQuality, 0, GetID(), QualityFlags::COMM_LOST);
 	eventcounter->SetPayload<EventType::CounterQuality>(QualityFlags::COMM_LOST);
 
 	MyPointConf->PointTable.ForEachCounterPoint([this,eventcounter](MD3AnalogCounterPoint &Point)
@@ -1424,10 +1517,11 @@ void MD3MasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachBinaryPoint([this](MD3BinaryPoint &Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint8_t meas = Point.GetBinary();
-			QualityFlags qual = CalculateBinaryQuality(enabled, Point.GetChangedTime());
+			MD3Time changedtime;
+			uint8_t meas = Point.GetBinary(changedtime); // Value and time from the same update
+			QualityFlags qual = CalculateBinaryQuality(enabled, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Binary, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Binary, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Binary>(meas == 1);
 			PublishEvent(event);
 		});
@@ -1436,12 +1530,13 @@ void MD3MasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachAnalogPoint([this](MD3AnalogCounterPoint &Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint16_t meas = Point.GetAnalog();
+			MD3Time changedtime;
+			uint16_t meas = Point.GetAnalog(changedtime);
 
 			// If the measurement is 0x8000 - there is a problem in the MD3 OutStation for that point.
-			QualityFlags qual = CalculateAnalogQuality(enabled, meas, Point.GetChangedTime());
+			QualityFlags qual = CalculateAnalogQuality(enabled, meas, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Analog, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Analog, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Analog>(std::move(meas));
 			PublishEvent(event);
 		});
@@ -1450,11 +1545,12 @@ void MD3MasterPort::SendAllPointEvents()
 	MyPointConf->PointTable.ForEachCounterPoint([this](MD3AnalogCounterPoint &Point)
 		{
 			uint32_t index = Point.GetIndex();
-			uint16_t meas = Point.GetAnalog();
+			MD3Time changedtime;
+			uint16_t meas = Point.GetAnalog(changedtime);
 			// If the measurement is 0x8000 - there is a problem in the MD3 OutStation for that point.
-			QualityFlags qual = CalculateAnalogQuality(enabled, meas, Point.GetChangedTime());
+			QualityFlags qual = CalculateAnalogQuality(enabled, meas, changedtime);
 
-			auto event = std::make_shared<EventInfo>(EventType::Counter, index, Name, qual, static_cast<msSinceEpoch_t>(Point.GetChangedTime()));
+			auto event = std::make_shared<EventInfo>(EventType::Counter, index, GetID(), qual, static_cast<msSinceEpoch_t>(changedtime));
 			event->SetPayload<EventType::Counter>(std::move(meas));
 			PublishEvent(event);
 		});
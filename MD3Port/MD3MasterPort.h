@@ -30,27 +30,83 @@
 #include "MD3Utility.h"
 #include "MD3Port.h"
 #include "MD3PointTableAccess.h"
-#include <queue>
+#include "ProducerConsumerQueue.h"
+#include "RTTEstimator.h"
+#include <array>
+#include <map>
+#include <memory>
 #include <utility>
 #include <opendatacon/ASIOScheduler.h>
 
+// Commands are sent highest priority first, and in order within a priority. So controls don't wait behind a queue of polls.
+enum class CommandPriority : uint8_t
+{
+	Control = 0,
+	TimeSync,
+	EventScan,
+	IntegrityScan,
+	Count
+};
+
 // The command, and an ODC callback pointer - may be nullptr. We check for that
-typedef std::pair <MD3Message_t, SharedStatusCallback_t> MasterCommandQueueItem;
+// If the command came from a poll, the poll group, so we know when that poll is no longer waiting in the queue. 0 if not a poll.
+struct MasterCommandQueueItem
+{
+	MasterCommandQueueItem() = default;
+	MasterCommandQueueItem(const MD3Message_t& message, const SharedStatusCallback_t& pstatuscallback, uint32_t pollgroup = 0):
+		Message(message),
+		pStatusCallback(pstatuscallback),
+		PollGroup(pollgroup)
+	{}
+	MD3Message_t Message;
+	SharedStatusCallback_t pStatusCallback = nullptr;
+	uint32_t PollGroup = 0;
+};
+
+// One lock-free queue per priority. Any thread can Push, only the MasterCommandStrand can Pop.
+class PriorityCommandQueue
+{
+public:
+	explicit PriorityCommandQueue(const size_t capacity)
+	{
+		for (auto& q : Queues)
+			q = std::make_unique<ProducerConsumerQueue<MasterCommandQueueItem>>(capacity);
+	}
+	bool Push(const MasterCommandQueueItem& item, CommandPriority priority)
+	{
+		return Queues[static_cast<size_t>(priority)]->Push(item);
+	}
+	// Pop the highest priority command waiting
+	bool Pop(MasterCommandQueueItem& item)
+	{
+		for (auto& q : Queues)
+			if (q->Pop(item))
+				return true;
+		return false;
+	}
+	size_t Size(CommandPriority priority) const
+	{
+		return Queues[static_cast<size_t>(priority)]->Size();
+	}
+
+private:
+	std::array<std::unique_ptr<ProducerConsumerQueue<MasterCommandQueueItem>>, static_cast<size_t>(CommandPriority::Count)> Queues;
+};
 
 // This class contains the MasterCommandQueue and management variables that all need to be protected using the MasterCommandStrand strand.
 // It has a queue of commands to be processed, as well as variables to manage where we are up to in processing the current command.
-// As everything is only accessed in strand protected code, we don't need to use a thread safe queue.
+// The queue itself is lock-free, so commands can be pushed from any thread - it is only ever popped in strand protected code.
 class MasterCommandData
 {
 public:
-	unsigned int MaxCommandQueueSize = 20; //TODO: The maximum number of MD3 commands that can be in the master queue? Somewhat arbitrary??
-	std::queue<MasterCommandQueueItem> MasterCommandQueue;
+	PriorityCommandQueue MasterCommandQueue{20}; //TODO: The maximum number of MD3 commands of each priority that can be in the master queue? Somewhat arbitrary??
 	MasterCommandQueueItem CurrentCommand; // Keep a copy of what has been sent to make retries easier.
 	uint8_t CurrentFunctionCode = 0;       // When we send a command, make sure the response we get is one we are waiting for.
 	bool ProcessingMD3Command = false;
 	std::chrono::milliseconds TimerExpireTime = std::chrono::milliseconds(0);
 	pTimer_t CurrentCommandTimeoutTimer = nullptr;
 	uint32_t RetriesLeft = 0; // Decrementing counter for retries, if we get to zero move on to the next command.
+	std::chrono::steady_clock::time_point CommandSentTime; // For the round trip time of the current command
 };
 
 class MD3MasterPort: public MD3Port
@@ -62,6 +118,7 @@ public:
 	void Enable() override;
 	void Disable() override final;
 	void Build() override;
+	const Json::Value GetStatistics() const override;
 	void SendMD3Message(const MD3Message_t & CompleteMD3Message) override;
 
 	void SocketStateHandler(bool state);
@@ -82,9 +139,10 @@ public:
 	// If the callback gets an error it will be ignored which will result in a timeout and the next command (or retry) being sent.
 	// This is necessary if somehow we get an old command sent to us, or a left over broadcast message.
 	// Only issue is if we do a broadcast message and can get information back from multiple sources... These commands are probably not used, and we will ignore them anyway.
-	void QueueMD3Command(const MD3Message_t &CompleteMD3Message, const SharedStatusCallback_t& pStatusCallback);
-	void QueueMD3Command(const MD3BlockData & SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback); // Handle the many single block command messages better
-	void QueueMD3Command(const MD3BlockFormatted & SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback);
+	// The pollgroup is only set for commands queued by DoPoll.
+	void QueueMD3Command(const MD3Message_t &CompleteMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0);
+	void QueueMD3Command(const MD3BlockData & SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0); // Handle the many single block command messages better
+	void QueueMD3Command(const MD3BlockFormatted & SingleBlockMD3Message, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0);
 	void PostCallbackCall(const odc::SharedStatusCallback_t &pStatusCallback, CommandStatus c);
 
 
@@ -96,9 +154,9 @@ public:
 
 	void EnablePolling(bool on); // Enabled by default
 
-	void SendTimeDateChangeCommand(const uint64_t &currenttime, const SharedStatusCallback_t& pStatusCallback);
-	void SendNewTimeDateChangeCommand(const uint64_t & currenttimeinmsec, int utcoffsetminutes, const SharedStatusCallback_t& pStatusCallback);
-	void SendSystemFlagScanCommand(SharedStatusCallback_t pStatusCallback);
+	void SendTimeDateChangeCommand(const uint64_t &currenttime, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0);
+	void SendNewTimeDateChangeCommand(const uint64_t & currenttimeinmsec, int utcoffsetminutes, const SharedStatusCallback_t& pStatusCallback, uint32_t pollgroup = 0);
+	void SendSystemFlagScanCommand(SharedStatusCallback_t pStatusCallback, uint32_t pollgroup = 0);
 
 	void SendDOMOutputCommand(const uint8_t & StationAddress, const uint8_t & ModuleAddress, const uint16_t & outputbits, const SharedStatusCallback_t &pStatusCallback);
 	void SendPOMOutputCommand(const uint8_t & StationAddress, const uint8_t & ModuleAddress, const uint8_t & outputselection, const SharedStatusCallback_t &pStatusCallback);
@@ -107,6 +165,7 @@ public:
 
 	// Testing use only
 	MD3PointTableAccess *GetPointTable() { return &(MyPointConf->PointTable); }
+	RTTEstimator &GetCommandRTT() { return CommandRTT; }
 private:
 
 	std::unique_ptr<asio::io_service::strand> MasterCommandStrand;
@@ -117,6 +176,19 @@ private:
 
 	void SendNextMasterCommand();
 	void UnprotectedSendNextMasterCommand(bool timeoutoccured);
+	std::chrono::milliseconds GetCommandTimeout(uint32_t attempt) const;
+
+	RTTEstimator CommandRTT; // Updated only in MasterCommandStrand
+	std::atomic<uint64_t> NumCommandTimeouts{ 0 };
+	std::atomic<uint64_t> NumCommandRetries{ 0 };
+
+	static CommandPriority GetCommandPriority(uint8_t FunctionCode);
+	bool IsPollQueued(uint32_t pollgroup) const;
+	void CommandDequeued(const MasterCommandQueueItem& item);
+	// How many commands from each poll group are waiting in the queue. A poll that is still waiting is not queued again.
+	// Only the atomics change after Build, so no lock needed.
+	std::map<uint32_t, std::atomic<uint32_t>> PollGroupQueued;
+	std::atomic<uint64_t> NumPollsCoalesced{ 0 };
 	void ClearMD3CommandQueue();
 	void ProcessMD3Message(MD3Message_t& CompleteMD3Message);
 
@@ -144,7 +144,7 @@ void MD3OutstationPort::Build()
 	std::string ChannelID = MyConf->mAddrConf.ChannelID();
 
 	// Need a couple of things passed to the point table.
-	MyPointConf->PointTable.Build(IsOutStation, MyPointConf->NewDigitalCommands, *pIOS);
+	MyPointConf->PointTable.Build(IsOutStation, MyPointConf->NewDigitalCommands);
 
 	pConnection = MD3Connection::AddConnection(pIOS, IsServer(), MyConf->mAddrConf.IP, MyConf->mAddrConf.Port, MyConf->mAddrConf.TCPConnectRetryPeriodms); //Static method
 
@@ -197,6 +197,31 @@ MD3Message_t MD3OutstationPort::CorruptMD3Message(const MD3Message_t& CompleteMD
 	}
 	return CompleteMD3Message;
 }
+void MD3OutstationPort::SendEncodedMD3Message(const uint8_t* data, size_t len)
+{
+	if (BitFlipProbability != 0.0)
+	{
+		// Corrupt a copy, the same way CorruptMD3Message does - 40 bits per block, the padding byte is left alone
+		std::vector<uint8_t> msg(data, data + len);
+		std::random_device rd;
+		std::mt19937 e2(rd());
+		std::uniform_real_distribution<> dist(0, 1);
+
+		if (dist(e2) > BitFlipProbability)
+		{
+			std::uniform_real_distribution<> bitdist(0, (len / MD3BlockArraySize) * 40 - 1);
+			int bitnum = round(bitdist(e2));
+			msg[(bitnum / 40) * MD3BlockArraySize + (bitnum % 40) / 8] ^= static_cast<uint8_t>(1 << (7 - bitnum % 8));
+		}
+		LOGDEBUG("{} - Sending Corrupted Message - Correct {}, Corrupted {}", Name, MD3MessageAsString(data, len), MD3MessageAsString(msg.data(), len));
+		MD3Port::SendEncodedMD3Message(msg.data(), len);
+	}
+	else
+	{
+		LOGDEBUG("{} - Sending Message - {}", Name, MD3MessageAsString(data, len));
+		MD3Port::SendEncodedMD3Message(data, len);
+	}
+}
 #ifdef _MSC_VER
 #pragma region OpenDataConInteraction
 #endif
@@ -29,6 +29,7 @@
 #include "MD3.h"
 #include "MD3Port.h"
 #include "MD3Utility.h"
+#include "MD3Codec.h"
 #include "MD3Connection.h"
 #include "MD3PointTableAccess.h"
 #include <unordered_map>
@@ -104,6 +105,7 @@ public:
 
 	void SendMD3Message(const MD3Message_t & CompleteMD3Message) override;
 	MD3Message_t CorruptMD3Message(const MD3Message_t& CompleteMD3Message);
+	void SendEncodedMD3Message(const uint8_t* data, size_t len) override;
 	void ProcessMD3Message(MD3Message_t &CompleteMD3Message);
 
 	// Analog
@@ -111,10 +113,10 @@ public:
 	void DoCounterScan(MD3BlockFormatted & Header);
 	void DoAnalogDeltaScan(MD3BlockFormatted &Header);
 
-	void ReadAnalogOrCounterRange(uint8_t ModuleAddress, uint8_t Channels, MD3OutstationPort::AnalogChangeType &ResponseType, std::vector<uint16_t> &AnalogValues, std::vector<int> &AnalogDeltaValues);
-	void GetAnalogModuleValues(AnalogCounterModuleType IsCounterOrAnalog, uint8_t Channels, uint8_t ModuleAddress, MD3OutstationPort::AnalogChangeType & ResponseType, std::vector<uint16_t>& AnalogValues, std::vector<int>& AnalogDeltaValues);
-	void SendAnalogOrCounterUnconditional(MD3_FUNCTION_CODE functioncode, std::vector<uint16_t> Analogs, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels);
-	void SendAnalogDelta(std::vector<int> Deltas, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels);
+	void ReadAnalogOrCounterRange(uint8_t ModuleAddress, uint8_t Channels, MD3OutstationPort::AnalogChangeType &ResponseType, MD3AnalogValues_t &AnalogValues, MD3AnalogDeltas_t &AnalogDeltaValues);
+	void GetAnalogModuleValues(AnalogCounterModuleType IsCounterOrAnalog, uint8_t Channels, uint8_t ModuleAddress, MD3OutstationPort::AnalogChangeType & ResponseType, MD3AnalogValues_t& AnalogValues, MD3AnalogDeltas_t& AnalogDeltaValues);
+	void SendAnalogOrCounterUnconditional(MD3_FUNCTION_CODE functioncode, const MD3AnalogValues_t& Analogs, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels);
+	void SendAnalogDelta(const MD3AnalogDeltas_t& Deltas, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels);
 	void SendAnalogNoChange(uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels);
 
 	// Digital/Binary
@@ -249,8 +249,8 @@ void MD3OutstationPort::DoAnalogUnconditional(MD3BlockFormatted &Header)
 {
 	LOGDEBUG("{} - DoAnalogUnconditional - Fn5",Name);
 	// This has only one response
-	std::vector<uint16_t> AnalogValues;
-	std::vector<int> AnalogDeltaValues;
+	MD3AnalogValues_t AnalogValues;
+	MD3AnalogDeltas_t AnalogDeltaValues;
 	AnalogChangeType ResponseType = NoChange;
 
 	ReadAnalogOrCounterRange(Header.GetModuleAddress(), Header.GetChannels(), ResponseType, AnalogValues, AnalogDeltaValues);
@@ -268,8 +268,8 @@ void MD3OutstationPort::DoCounterScan(MD3BlockFormatted &Header)
 {
 	LOGDEBUG("{} - DoCounterScan - Fn31",Name);
 	// This has only one response
-	std::vector<uint16_t> AnalogValues;
-	std::vector<int> AnalogDeltaValues;
+	MD3AnalogValues_t AnalogValues;
+	MD3AnalogDeltas_t AnalogDeltaValues;
 	AnalogChangeType ResponseType = NoChange;
 
 	// This is the method that has to deal with analog/counter channel overflow issues - into the next module.
@@ -283,8 +283,8 @@ void MD3OutstationPort::DoAnalogDeltaScan( MD3BlockFormatted &Header )
 {
 	LOGDEBUG("{} - DoAnalogDeltaScan - Fn6",Name);
 	// First work out what our response will be, loading the data to be sent into two vectors.
-	std::vector<uint16_t> AnalogValues;
-	std::vector<int> AnalogDeltaValues;
+	MD3AnalogValues_t AnalogValues;
+	MD3AnalogDeltas_t AnalogDeltaValues;
 	AnalogChangeType ResponseType = NoChange;
 
 	ReadAnalogOrCounterRange(Header.GetModuleAddress(), Header.GetChannels(), ResponseType, AnalogValues, AnalogDeltaValues);
@@ -304,7 +304,7 @@ void MD3OutstationPort::DoAnalogDeltaScan( MD3BlockFormatted &Header )
 	}
 }
 
-void MD3OutstationPort::ReadAnalogOrCounterRange(uint8_t ModuleAddress, uint8_t Channels, MD3OutstationPort::AnalogChangeType &ResponseType, std::vector<uint16_t> &AnalogValues, std::vector<int> &AnalogDeltaValues)
+void MD3OutstationPort::ReadAnalogOrCounterRange(uint8_t ModuleAddress, uint8_t Channels, MD3OutstationPort::AnalogChangeType &ResponseType, MD3AnalogValues_t &AnalogValues, MD3AnalogDeltas_t &AnalogDeltaValues)
 {
 	// The Analog and Counters are  maintained in two lists, we need to deal with both of them as they both can be read by this method.
 	// So if we find an entry in the analog list, we dont have to worry about overflow, as there are 16 channels, and the most we can ask for is 16.
@@ -340,7 +340,7 @@ void MD3OutstationPort::ReadAnalogOrCounterRange(uint8_t ModuleAddress, uint8_t
 		GetAnalogModuleValues(AnalogModule, Channels, ModuleAddress, ResponseType, AnalogValues, AnalogDeltaValues);
 	}
 }
-void MD3OutstationPort::GetAnalogModuleValues(AnalogCounterModuleType IsCounterOrAnalog, uint8_t Channels, uint8_t ModuleAddress, MD3OutstationPort::AnalogChangeType & ResponseType, std::vector<uint16_t> & AnalogValues, std::vector<int> & AnalogDeltaValues)
+void MD3OutstationPort::GetAnalogModuleValues(AnalogCounterModuleType IsCounterOrAnalog, uint8_t Channels, uint8_t ModuleAddress, MD3OutstationPort::AnalogChangeType & ResponseType, MD3AnalogValues_t & AnalogValues, MD3AnalogDeltas_t & AnalogDeltaValues)
 {
 	for (uint8_t i = 0; i < Channels; i++)
 	{
@@ -380,71 +380,31 @@ void MD3OutstationPort::GetAnalogModuleValues(AnalogCounterModuleType IsCounterO
 		}
 	}
 }
-void MD3OutstationPort::SendAnalogOrCounterUnconditional(MD3_FUNCTION_CODE functioncode, std::vector<uint16_t> Analogs, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels)
+void MD3OutstationPort::SendAnalogOrCounterUnconditional(MD3_FUNCTION_CODE functioncode, const MD3AnalogValues_t& Analogs, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels)
 {
-	MD3Message_t ResponseMD3Message;
-
 	// The spec says echo the formatted block, but a few things need to change. EndOfMessage, MasterToStationMessage,
-
 	MD3BlockFormatted FormattedBlock = MD3BlockFormatted(StationAddress, false, functioncode, ModuleAddress, Channels);
 	FormattedBlock.SetFlags(SystemFlags.GetRemoteStatusChangeFlag(), SystemFlags.GetTimeTaggedDataAvailableFlag(), SystemFlags.GetDigitalChangedFlag());
 
-	ResponseMD3Message.push_back(FormattedBlock);
-
 	assert(Channels == Analogs.size());
 
-	int NumberOfDataBlocks = Channels / 2 + Channels % 2; // 2 --> 1, 3 -->2
-
-	for (uint8_t i = 0; i < NumberOfDataBlocks; i++)
-	{
-		bool lastblock = (i + 1 == NumberOfDataBlocks);
-		auto firstblock = Analogs[2 * i];
-
-		uint16_t secondblock = 0;
-		if (Analogs.size() > (2u * i + 1))
-			secondblock = Analogs[2 * i + 1];
-
-		auto block = MD3BlockData(firstblock, secondblock, lastblock);
-		ResponseMD3Message.push_back(block);
-	}
-	SendMD3Message(ResponseMD3Message);
+	// Encoded straight into bytes, two values to a block
+	std::array<uint8_t, MD3MessageBytes(1 + MD3MaxAnalogChannels / 2)> Response;
+	const size_t len = MD3EncodeAnalogUnconditional(FormattedBlock, Analogs.data(), Analogs.size(), Response.data(), Response.size());
+	SendEncodedMD3Message(Response.data(), len);
 }
-void MD3OutstationPort::SendAnalogDelta(std::vector<int> Deltas, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels)
+void MD3OutstationPort::SendAnalogDelta(const MD3AnalogDeltas_t& Deltas, uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels)
 {
-	MD3Message_t ResponseMD3Message;
-
 	// The spec says echo the formatted block, but a few things need to change. EndOfMessage, MasterToStationMessage,
 	MD3BlockFormatted FormattedBlock = MD3BlockFormatted(StationAddress, false, ANALOG_DELTA_SCAN, ModuleAddress, Channels);
 	FormattedBlock.SetFlags(SystemFlags.GetRemoteStatusChangeFlag(), SystemFlags.GetTimeTaggedDataAvailableFlag(), SystemFlags.GetDigitalChangedFlag());
 
-	ResponseMD3Message.push_back(FormattedBlock);
-
 	assert(Channels == Deltas.size());
 
-	// Can be 4 channel delta values to a block.
-	int NumberOfDataBlocks = Channels / 4 + (Channels % 4 == 0 ? 0 : 1);
-
-	for (uint8_t i = 0; i < NumberOfDataBlocks; i++)
-	{
-		bool lastblock = (i + 1 == NumberOfDataBlocks);
-
-		// Check for overflows, we can only guarantee the first value....
-		auto block1 = numeric_cast<uint8_t>(Deltas[i * 4]);
-		uint8_t block2 = 0;
-		uint8_t block3 = 0;
-		uint8_t block4 = 0;
-
-		if (Deltas.size() > (i * 4u + 1))
-			block2 = numeric_cast<uint8_t>(Deltas[i * 4 + 1]);
-		if (Deltas.size() > (i * 4u + 2))
-			block3 = numeric_cast<uint8_t>(Deltas[i * 4 + 2]);
-		if (Deltas.size() > (i * 4u + 3))
-			block4 = numeric_cast<uint8_t>(Deltas[i * 4 + 3]);
-
-		auto block = MD3BlockData(block1, block2 , block3, block4, lastblock);
-		ResponseMD3Message.push_back(block);
-	}
-	SendMD3Message(ResponseMD3Message);
+	// Encoded straight into bytes, four channel delta values to a block
+	std::array<uint8_t, MD3MessageBytes(1 + MD3MaxAnalogChannels / 4)> Response;
+	const size_t len = MD3EncodeAnalogDelta(FormattedBlock, Deltas.data(), Deltas.size(), Response.data(), Response.size());
+	SendEncodedMD3Message(Response.data(), len);
 }
 void MD3OutstationPort::SendAnalogNoChange(uint8_t StationAddress, uint8_t ModuleAddress, uint8_t Channels)
 {
@@ -1200,7 +1160,7 @@ void MD3OutstationPort::DoPOMControl(MD3BlockFn17MtoS &Header, MD3Message_t &Com
 	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
 	val.functionCode = ControlCode::PULSE_ON; // Always pulse on for POM control!
 
-	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name);
+	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, GetID());
 	event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
 
 	success = (Perform(event, waitforresult) == odc::CommandStatus::SUCCESS); // If no subscribers will return quickly.
@@ -1275,7 +1235,7 @@ void MD3OutstationPort::DoDOMControl(MD3BlockFn19MtoS &Header, MD3Message_t &Com
 			EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
 			val.functionCode = ((output >> (15 - i) & 0x01) == 1) ? ControlCode::LATCH_ON : ControlCode::LATCH_OFF;
 
-			auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name);
+			auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, GetID());
 			event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
 
 			if (CommandStatus::SUCCESS != Perform(event, waitforresult)) // If no subscribers will return quickly.
@@ -1384,7 +1344,7 @@ void MD3OutstationPort::DoInputPointControl(MD3BlockFn20MtoS& Header, MD3Message
 			EventTypePayload<EventType::AnalogOutputInt16>::type val;
 			val.first = numeric_cast<int16_t>(output);
 
-			auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, Name);
+			auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, GetID());
 			event->SetPayload<EventType::AnalogOutputInt16>(std::move(val));
 			success = (Perform(event, waitforresult) == odc::CommandStatus::SUCCESS); // If no subscribers will return quickly.
 		}
@@ -1396,7 +1356,7 @@ void MD3OutstationPort::DoInputPointControl(MD3BlockFn20MtoS& Header, MD3Message
 			LOGDEBUG("{} - DoInputPointControl, Warning - received a reserved Control Code - taking a default acton", Name);
 			EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
 			val.functionCode = ControlCode::PULSE_ON;
-			auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name);
+			auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, GetID());
 			event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
 			success = (Perform(event, waitforresult) == odc::CommandStatus::SUCCESS); // If no subscribers will return quickly.
 		}
@@ -1426,7 +1386,7 @@ void MD3OutstationPort::DoInputPointControl(MD3BlockFn20MtoS& Header, MD3Message
 				break;
 		}
 
-		auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name);
+		auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, GetID());
 		event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
 		success = (Perform(event, waitforresult) == odc::CommandStatus::SUCCESS); // If no subscribers will return quickly.
 	}
@@ -1481,7 +1441,7 @@ void MD3OutstationPort::DoAOMControl(MD3BlockFn23MtoS &Header, MD3Message_t &Com
 	EventTypePayload<EventType::AnalogOutputInt16>::type val;
 	val.first = numeric_cast<int16_t>(output);
 
-	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, Name);
+	auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, ODCIndex, GetID());
 	event->SetPayload<EventType::AnalogOutputInt16>(std::move(val));
 
 	if (!failed && (Perform(event, waitforresult) == odc::CommandStatus::SUCCESS))
@@ -0,0 +1,142 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* MD3PointArray.h
+*
+*  Created on: 19/10/2026
+*/
+
+#ifndef MD3POINTARRAY_H_
+#define MD3POINTARRAY_H_
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <vector>
+
+// The points of one type, held contiguously and indexed two ways:
+//	by slot - the protocol address packed into a small dense key space (Module*16+Channel for MD3)
+//	by ODC index - a dense array, up to MaxDenseODCIndex
+// Points are only added while the configuration is loaded, before there is any concurrent access.
+// After that, finding a point is an array read, and the point values themselves are atomic, so nothing takes a lock.
+template <class PointT>
+class MD3PointArray
+{
+public:
+	explicit MD3PointArray(const size_t slots):
+		SlotIndex(slots, NONE)
+	{}
+
+	// Returns false if the slot or the ODC index is already taken
+	bool Add(const size_t slot, const PointT& pt)
+	{
+		const size_t odcindex = pt.GetIndex();
+		if (slot >= SlotIndex.size() || SlotIndex[slot] != NONE || Find(odcindex) != NONE)
+			return false;
+
+		const auto pos = static_cast<uint32_t>(Points.size());
+		Points.push_back(pt);
+		SlotIndex[slot] = pos;
+		SetODCPosition(odcindex, pos);
+		return true;
+	}
+
+	bool HasSlot(const size_t slot) const { return slot < SlotIndex.size() && SlotIndex[slot] != NONE; }
+	bool HasODCIndex(const size_t index) const { return Find(index) != NONE; }
+
+	PointT* AtSlot(const size_t slot)
+	{
+		if (slot >= SlotIndex.size() || SlotIndex[slot] == NONE)
+			return nullptr;
+		return &Points[SlotIndex[slot]];
+	}
+	PointT* AtODCIndex(const size_t index)
+	{
+		const auto pos = Find(index);
+		return (pos == NONE) ? nullptr : &Points[pos];
+	}
+
+	// In slot order
+	template <typename Fn>
+	void ForEach(Fn&& fn)
+	{
+		for (const auto pos : SlotIndex)
+			if (pos != NONE)
+				fn(Points[pos]);
+	}
+
+	// Once all the points are added - lay them out in slot order, so a scan of neighbouring slots is a linear read
+	void Compact()
+	{
+		std::vector<PointT> Ordered;
+		Ordered.reserve(Points.size());
+		std::vector<uint32_t> NewPos(Points.size(), NONE);
+		for (auto& pos : SlotIndex)
+		{
+			if (pos == NONE)
+				continue;
+			if (NewPos[pos] == NONE)
+			{
+				NewPos[pos] = static_cast<uint32_t>(Ordered.size());
+				Ordered.push_back(Points[pos]);
+			}
+			pos = NewPos[pos];
+		}
+		for (auto& pos : ODCIndex)
+			if (pos != NONE)
+				pos = NewPos[pos];
+		for (auto& index_pos : SparseODCIndex)
+			index_pos.second = NewPos[index_pos.second];
+		Points.swap(Ordered);
+	}
+
+private:
+	static constexpr uint32_t NONE = std::numeric_limits<uint32_t>::max();
+	// Above this, ODC indexes go in a map, rather than growing the dense array to match
+	static constexpr size_t MaxDenseODCIndex = 1 << 20;
+
+	uint32_t Find(const size_t index) const
+	{
+		if (index < ODCIndex.size())
+			return ODCIndex[index];
+		if (index < MaxDenseODCIndex)
+			return NONE;
+		auto it = SparseODCIndex.find(index);
+		return (it == SparseODCIndex.end()) ? NONE : it->second;
+	}
+	void SetODCPosition(const size_t index, const uint32_t pos)
+	{
+		if (index >= MaxDenseODCIndex)
+		{
+			SparseODCIndex[index] = pos;
+			return;
+		}
+		if (index >= ODCIndex.size())
+			ODCIndex.resize(index+1, NONE);
+		ODCIndex[index] = pos;
+	}
+
+	std::vector<PointT> Points;
+	std::vector<uint32_t> SlotIndex;
+	std::vector<uint32_t> ODCIndex;
+	std::map<size_t, uint32_t> SparseODCIndex;
+};
+
+#endif
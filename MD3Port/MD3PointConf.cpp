@@ -122,6 +122,21 @@ void MD3PointConf::ProcessElements(const Json::Value& JSONRoot)
 			MD3CommandRetries = JSONRoot["MD3CommandRetries"].asUInt();
 			LOGDEBUG("Conf processed - MD3CommandRetries - {}",MD3CommandRetries);
 		}
+		if (JSONRoot.isMember("MD3AdaptiveTimeout"))
+		{
+			MD3AdaptiveTimeout = JSONRoot["MD3AdaptiveTimeout"].asBool();
+			LOGDEBUG("Conf processed - MD3AdaptiveTimeout - {}",MD3AdaptiveTimeout);
+		}
+		if (JSONRoot.isMember("MD3CommandTimeoutMinmsec"))
+		{
+			MD3CommandTimeoutMinmsec = JSONRoot["MD3CommandTimeoutMinmsec"].asUInt();
+			LOGDEBUG("Conf processed - MD3CommandTimeoutMinmsec - {}",MD3CommandTimeoutMinmsec);
+		}
+		if (JSONRoot.isMember("MD3CommandTimeoutMaxmsec"))
+		{
+			MD3CommandTimeoutMaxmsec = JSONRoot["MD3CommandTimeoutMaxmsec"].asUInt();
+			LOGDEBUG("Conf processed - MD3CommandTimeoutMaxmsec - {}",MD3CommandTimeoutMaxmsec);
+		}
 	}
 	catch (const std::exception& e)
 	{
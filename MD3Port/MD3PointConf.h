@@ -97,6 +97,11 @@ public:
 	uint32_t MD3CommandTimeoutmsec = 5000;
 	// How many times do we retry a command, before we give up and move onto the next one?
 	uint32_t MD3CommandRetries = 3;
+	// If true, the Master timeout follows the measured round trip time of the Station, starting at MD3CommandTimeoutmsec.
+	// Kept between the min and max, and doubled on each retry. A max of 0 means 4 x MD3CommandTimeoutmsec.
+	bool MD3AdaptiveTimeout = false;
+	uint32_t MD3CommandTimeoutMinmsec = 100;
+	uint32_t MD3CommandTimeoutMaxmsec = 0;
 	std::string FileName;
 };
 #endif
@@ -31,129 +31,70 @@
 MD3PointTableAccess::MD3PointTableAccess()
 {}
 
-void MD3PointTableAccess::Build(const bool isoutstation, const bool newdigitalcommands, odc::asio_service &IOS)
+void MD3PointTableAccess::Build(const bool isoutstation, const bool newdigitalcommands)
 {
 	IsOutstation = isoutstation;
 	NewDigitalCommands = newdigitalcommands;
-	pBinaryTimeTaggedEventQueue = std::make_unique<StrandProtectedQueue<MD3BinaryPoint>>(IOS, 256);
+	pBinaryTimeTaggedEventQueue = std::make_shared<ProducerConsumerQueue<MD3BinaryPoint>>(256);
+
+	// All the points are loaded now - lay each table out in MD3 order
+	BinaryPoints.Compact();
+	AnalogPoints.Compact();
+	CounterPoints.Compact();
+	BinaryControlPoints.Compact();
+	AnalogControlPoints.Compact();
 }
 
 #ifdef _MSC_VER
 #pragma region Analog-Counter
 #endif
 
-bool MD3PointTableAccess::AddCounterPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const uint32_t &pollgroup)
+// Common to all the Add methods
+template <class PointT>
+static bool AddPoint(MD3PointArray<PointT>& Points, const std::string& TypeName, const size_t slot, const PointT& pt)
 {
-	uint16_t md3index = ShiftLeft8Result16Bits(moduleaddress) | channel;
-	if (CounterMD3PointMap.find(md3index) != CounterMD3PointMap.end())
+	if (Points.HasSlot(slot))
 	{
-		LOGERROR("Duplicate Counter MD3 Index " + std::to_string(moduleaddress) + " - " + std::to_string(channel));
+		LOGERROR("Duplicate " + TypeName + " MD3 Index " + std::to_string(pt.GetModuleAddress()) + " - " + std::to_string(pt.GetChannel()));
 		return false;
 	}
-
-	if (CounterODCPointMap.find(index) != CounterODCPointMap.end())
+	if (Points.HasODCIndex(pt.GetIndex()))
 	{
-		LOGERROR("Duplicate Counter ODC Index : " + std::to_string(index));
+		LOGERROR("Duplicate " + TypeName + " ODC Index : " + std::to_string(pt.GetIndex()));
 		return false;
 	}
+	return Points.Add(slot, pt);
+}
 
-	auto pt = std::make_shared<MD3AnalogCounterPoint>(index, moduleaddress, channel, pollgroup);
-	CounterMD3PointMap[md3index] = pt;
-	CounterODCPointMap[index] = pt;
-	return true;
+bool MD3PointTableAccess::AddCounterPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const uint32_t &pollgroup)
+{
+	return AddPoint(CounterPoints, "Counter", MD3Slot(moduleaddress, channel), MD3AnalogCounterPoint(index, moduleaddress, channel, pollgroup));
 }
 bool MD3PointTableAccess::AddAnalogPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const uint32_t &pollgroup)
 {
-	uint16_t md3index = ShiftLeft8Result16Bits(moduleaddress) | channel;
-	if (AnalogMD3PointMap.find(md3index) != AnalogMD3PointMap.end())
-	{
-		LOGERROR("Duplicate Analog MD3 Index " + std::to_string(moduleaddress) + " - " + std::to_string(channel));
-		return false;
-	}
-
-	if (AnalogODCPointMap.find(index) != AnalogODCPointMap.end())
-	{
-		LOGERROR("Duplicate Analog ODC Index : " + std::to_string(index));
-		return false;
-	}
-
-	auto pt = std::make_shared<MD3AnalogCounterPoint>(index, moduleaddress, channel, pollgroup);
-	AnalogMD3PointMap[md3index] = pt;
-	AnalogODCPointMap[index] = pt;
-	return true;
+	return AddPoint(AnalogPoints, "Analog", MD3Slot(moduleaddress, channel), MD3AnalogCounterPoint(index, moduleaddress, channel, pollgroup));
 }
 bool MD3PointTableAccess::AddAnalogControlPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const uint32_t &pollgroup)
 {
-	uint16_t md3index = ShiftLeft8Result16Bits(moduleaddress) | channel;
-	if (AnalogControlMD3PointMap.find(md3index) != AnalogControlMD3PointMap.end())
-	{
-		LOGERROR("Duplicate Analog MD3 Index " + std::to_string(moduleaddress) + " - " + std::to_string(channel));
-		return false;
-	}
-
-	if (AnalogControlODCPointMap.find(index) != AnalogControlODCPointMap.end())
-	{
-		LOGERROR("Duplicate Analog ODC Index : " + std::to_string(index));
-		return false;
-	}
-
-	auto pt = std::make_shared<MD3AnalogCounterPoint>(index, moduleaddress, channel, pollgroup);
-	AnalogControlMD3PointMap[md3index] = pt;
-	AnalogControlODCPointMap[index] = pt;
-	return true;
+	return AddPoint(AnalogControlPoints, "Analog", MD3Slot(moduleaddress, channel), MD3AnalogCounterPoint(index, moduleaddress, channel, pollgroup));
 }
 
 bool MD3PointTableAccess::AddBinaryPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const BinaryPointType &pointtype, const uint32_t &pollgroup)
 {
-	uint16_t md3index = ShiftLeft8Result16Bits(moduleaddress) | channel;
-	if (BinaryMD3PointMap.find(md3index) != BinaryMD3PointMap.end())
-	{
-		LOGERROR("Duplicate Binary MD3 Index " + std::to_string(moduleaddress) + " - " + std::to_string(channel));
-		return false;
-	}
-
-	if (BinaryODCPointMap.find(index) != BinaryODCPointMap.end())
-	{
-		LOGERROR("Duplicate Binary ODC Index : " + std::to_string(index));
-		return false;
-	}
-
-	auto pt = std::make_shared<MD3BinaryPoint>(index, moduleaddress, channel, pollgroup, pointtype);
-	BinaryMD3PointMap[md3index] = pt;
-	BinaryODCPointMap[index] = pt;
-	return true;
+	return AddPoint(BinaryPoints, "Binary", MD3Slot(moduleaddress, channel), MD3BinaryPoint(index, moduleaddress, channel, pollgroup, pointtype));
 }
 bool MD3PointTableAccess::AddBinaryControlPointToPointTable(const size_t &index, const uint8_t &moduleaddress, const uint8_t &channel, const BinaryPointType &pointtype, const uint32_t &pollgroup)
 {
-	uint16_t md3index = ShiftLeft8Result16Bits(moduleaddress) | channel;
-	if (BinaryControlMD3PointMap.find(md3index) != BinaryControlMD3PointMap.end())
-	{
-		LOGERROR("Duplicate BinaryControl MD3 Index " + std::to_string(moduleaddress) + " - " + std::to_string(channel));
-		return false;
-	}
-
-	if (BinaryControlODCPointMap.find(index) != BinaryControlODCPointMap.end())
-	{
-		LOGERROR("Duplicate BinaryControl ODC Index : " + std::to_string(index));
-		return false;
-	}
-
-	auto pt = std::make_shared<MD3BinaryPoint>(index, moduleaddress, channel, pollgroup, pointtype);
-	BinaryControlMD3PointMap[md3index] = pt;
-	BinaryControlODCPointMap[index] = pt;
-	return true;
+	return AddPoint(BinaryControlPoints, "BinaryControl", MD3Slot(moduleaddress, channel), MD3BinaryPoint(index, moduleaddress, channel, pollgroup, pointtype));
 }
 
 
 bool MD3PointTableAccess::GetCounterValueUsingMD3Index(const uint16_t module, const uint8_t channel, uint16_t &res, bool &hasbeenset)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = CounterMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != CounterMD3PointMap.end())
+	if (auto pt = CounterPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetAnalog();
-		hasbeenset = MD3PointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalog();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
@@ -161,57 +102,46 @@ bool MD3PointTableAccess::GetCounterValueUsingMD3Index(const uint16_t module, co
 bool MD3PointTableAccess::GetCounterValueAndChangeUsingMD3Index(const uint16_t module, const uint8_t channel, uint16_t &res, int &delta, bool &hasbeenset)
 {
 	// Change being update the last read value
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = CounterMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != CounterMD3PointMap.end())
+	if (auto pt = CounterPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetAnalogAndDelta(delta);
-		hasbeenset = MD3PointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalogAndDelta(delta);
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::SetCounterValueUsingMD3Index(const uint16_t module, const uint8_t channel, const uint16_t meas)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = CounterMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != CounterMD3PointMap.end())
+	if (auto pt = CounterPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		MD3PointMapIter->second->SetAnalog(meas, MD3NowUTC());
+		pt->SetAnalog(meas, MD3NowUTC());
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetCounterODCIndexUsingMD3Index(const uint16_t module, const uint8_t channel, size_t &res)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = CounterMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != CounterMD3PointMap.end())
+	if (auto pt = CounterPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetIndex();
+		res = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::SetCounterValueUsingODCIndex(const size_t index, const uint16_t meas)
 {
-	auto ODCPointMapIter = CounterODCPointMap.find(index);
-	if (ODCPointMapIter != CounterODCPointMap.end())
+	if (auto pt = CounterPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetAnalog(meas, MD3NowUTC());
+		pt->SetAnalog(meas, MD3NowUTC());
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::ResetCounterValueUsingODCIndex(const size_t index)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = CounterPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->ResetAnalog(); // Sets to 0x8000, time = 0, HasBeenSet to false
+		pt->ResetAnalog(); // Sets to 0x8000, time = 0, HasBeenSet to false
 		return true;
 	}
 	return false;
@@ -219,81 +149,66 @@ bool MD3PointTableAccess::ResetCounterValueUsingODCIndex(const size_t index)
 
 bool MD3PointTableAccess::GetAnalogValueUsingMD3Index(const uint16_t module, const uint8_t channel, uint16_t &res, bool &hasbeenset)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = AnalogMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != AnalogMD3PointMap.end())
+	if (auto pt = AnalogPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetAnalog();
-		hasbeenset = MD3PointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalog();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetAnalogValueAndChangeUsingMD3Index(const uint16_t module, const uint8_t channel, uint16_t &res, int &delta, bool &hasbeenset)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = AnalogMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != AnalogMD3PointMap.end())
+	if (auto pt = AnalogPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetAnalogAndDelta(delta);
-		hasbeenset = MD3PointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalogAndDelta(delta);
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetAnalogODCIndexUsingMD3Index(const uint16_t module, const uint8_t channel, size_t &res)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = AnalogMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != AnalogMD3PointMap.end())
+	if (auto pt = AnalogPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetIndex();
+		res = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::SetAnalogValueUsingMD3Index(const uint16_t module, const uint8_t channel, const uint16_t meas)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = AnalogMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != AnalogMD3PointMap.end())
+	if (auto pt = AnalogPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		MD3PointMapIter->second->SetAnalog(meas, MD3NowUTC());
+		pt->SetAnalog(meas, MD3NowUTC());
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetAnalogValueUsingODCIndex(const size_t index, uint16_t &res, bool &hasbeenset)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetAnalog();
-		hasbeenset = ODCPointMapIter->second->GetHasBeenSet();
+		res = pt->GetAnalog();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::SetAnalogValueUsingODCIndex(const size_t index, const uint16_t meas)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetAnalog(meas, MD3NowUTC());
+		pt->SetAnalog(meas, MD3NowUTC());
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::ResetAnalogValueUsingODCIndex(const size_t index)
 {
-	auto ODCPointMapIter = AnalogODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogODCPointMap.end())
+	if (auto pt = AnalogPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->ResetAnalog(); // Sets to 0x8000, time = 0, HasBeenSet to false
+		pt->ResetAnalog(); // Sets to 0x8000, time = 0, HasBeenSet to false
 		return true;
 	}
 	return false;
@@ -309,24 +224,18 @@ bool MD3PointTableAccess::ResetAnalogValueUsingODCIndex(const size_t index)
 
 bool MD3PointTableAccess::GetBinaryODCIndexUsingMD3Index(const uint16_t module, const uint8_t channel, size_t &index)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		index = MD3PointMapIter->second->GetIndex();
+		index = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetBinaryQualityUsingMD3Index(const uint16_t module, const uint8_t channel, bool &hasbeenset)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		hasbeenset = MD3PointMapIter->second->GetHasBeenSet();
+		hasbeenset = pt->GetHasBeenSet();
 		return true;
 	}
 	return false;
@@ -335,13 +244,10 @@ bool MD3PointTableAccess::GetBinaryQualityUsingMD3Index(const uint16_t module, c
 // Gets and Clears changed flag
 bool MD3PointTableAccess::GetBinaryValueUsingMD3Index(const uint16_t module, const uint8_t channel, uint8_t &res, bool &changed)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetBinary();
-		changed = MD3PointMapIter->second->GetAndResetChangedFlag();
+		res = pt->GetBinary();
+		changed = pt->GetAndResetChangedFlag();
 		return true;
 	}
 	return false;
@@ -349,12 +255,9 @@ bool MD3PointTableAccess::GetBinaryValueUsingMD3Index(const uint16_t module, con
 // Only gets value, does not clear changed flag
 bool MD3PointTableAccess::GetBinaryValueUsingMD3Index(const uint16_t module, const uint8_t channel, uint8_t &res)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		res = MD3PointMapIter->second->GetBinary();
+		res = pt->GetBinary();
 		return true;
 	}
 	return false;
@@ -362,12 +265,9 @@ bool MD3PointTableAccess::GetBinaryValueUsingMD3Index(const uint16_t module, con
 // Get the changed flag without resetting it
 bool MD3PointTableAccess::GetBinaryChangedUsingMD3Index(const uint16_t module, const uint8_t channel, bool &changed)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		changed = MD3PointMapIter->second->GetChangedFlag();
+		changed = pt->GetChangedFlag();
 		return true;
 	}
 	return false;
@@ -375,16 +275,13 @@ bool MD3PointTableAccess::GetBinaryChangedUsingMD3Index(const uint16_t module, c
 
 bool MD3PointTableAccess::SetBinaryValueUsingMD3Index(const uint16_t module, const uint8_t channel, const uint8_t meas, bool &valuechanged)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryMD3PointMap.end())
+	if (auto pt = BinaryPoints.AtSlot(MD3Slot(module, channel)))
 	{
 		//TODO: Put this functionality into the MD3BinaryPoint class
 		// If it has been changed, or has never been set...
-		if ((MD3PointMapIter->second->GetBinary() != meas) || (MD3PointMapIter->second->GetHasBeenSet() == false))
+		if ((pt->GetBinary() != meas) || (pt->GetHasBeenSet() == false))
 		{
-			MD3PointMapIter->second->SetBinary(meas, MD3NowUTC());
+			pt->SetBinary(meas, MD3NowUTC());
 			valuechanged = true;
 		}
 		return true;
@@ -394,25 +291,23 @@ bool MD3PointTableAccess::SetBinaryValueUsingMD3Index(const uint16_t module, con
 // Get value and reset changed flag..
 bool MD3PointTableAccess::GetBinaryValueUsingODCIndex(const size_t index, uint8_t &res, bool &changed)
 {
-	auto ODCPointMapIter = BinaryODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryODCPointMap.end())
+	if (auto pt = BinaryPoints.AtODCIndex(index))
 	{
-		res = ODCPointMapIter->second->GetBinary();
-		changed = ODCPointMapIter->second->GetAndResetChangedFlag();
+		res = pt->GetBinary();
+		changed = pt->GetAndResetChangedFlag();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::SetBinaryValueUsingODCIndex(const size_t index, const uint8_t meas, MD3Time eventtime)
 {
-	auto ODCPointMapIter = BinaryODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryODCPointMap.end())
+	if (auto pt = BinaryPoints.AtODCIndex(index))
 	{
-		ODCPointMapIter->second->SetBinary(meas, eventtime);
+		pt->SetBinary(meas, eventtime);
 
 		// We now need to add the change to the separate digital/binary event list
 		if (IsOutstation)
-			AddToDigitalEvents(*ODCPointMapIter->second); // Don't store if master - we just fire off ODC events.
+			AddToDigitalEvents(*pt); // Don't store if master - we just fire off ODC events.
 
 		return true;
 	}
@@ -437,21 +332,20 @@ void MD3PointTableAccess::AddToDigitalEvents(MD3BinaryPoint &inpt)
 			pt.SetModuleBinarySnapShot(wordres);
 		}
 		// Will fail if full, which is the defined MD3 behaviour. Push takes a copy
-		pBinaryTimeTaggedEventQueue->async_push(pt);
+		pBinaryTimeTaggedEventQueue->Push(pt);
 	}
 }
 uint16_t MD3PointTableAccess::CollectModuleBitsIntoWordandResetChangeFlags(const uint8_t ModuleAddress, bool &ModuleFailed)
 {
 	uint16_t wordres = 0;
 
+	// The module's channels are adjacent slots
 	for (uint8_t j = 0; j < 16; j++)
 	{
-		uint8_t bitres = 0;
-		bool changed = false; // We don't care about the returned value
-
-		if (GetBinaryValueUsingMD3Index(ModuleAddress, j, bitres, changed)) // Reading this clears the changed bit
+		if (auto pt = BinaryPoints.AtSlot(MD3Slot(ModuleAddress, j)))
 		{
-			wordres |= static_cast<uint16_t>(bitres) << (15 - j);
+			wordres |= static_cast<uint16_t>(pt->GetBinary()) << (15 - j);
+			pt->GetAndResetChangedFlag(); // Reading this clears the changed bit
 		}
 	}
 	return wordres;
@@ -462,11 +356,9 @@ uint16_t MD3PointTableAccess::CollectModuleBitsIntoWord(const uint8_t ModuleAddr
 
 	for (uint8_t j = 0; j < 16; j++)
 	{
-		uint8_t bitres = 0;
-
-		if (GetBinaryValueUsingMD3Index(ModuleAddress, j, bitres)) // Reading this clears the changed bit
+		if (auto pt = BinaryPoints.AtSlot(MD3Slot(ModuleAddress, j)))
 		{
-			wordres |= static_cast<uint16_t>(bitres) << (15 - j);
+			wordres |= static_cast<uint16_t>(pt->GetBinary()) << (15 - j);
 		}
 	}
 	return wordres;
@@ -483,47 +375,39 @@ uint16_t MD3PointTableAccess::CollectModuleBitsIntoWord(const uint8_t ModuleAddr
 
 bool MD3PointTableAccess::GetBinaryControlODCIndexUsingMD3Index(const uint16_t module, const uint8_t channel, size_t &index)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = BinaryControlMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != BinaryControlMD3PointMap.end())
+	if (auto pt = BinaryControlPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		index = MD3PointMapIter->second->GetIndex();
+		index = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetBinaryControlMD3IndexUsingODCIndex(const size_t index, uint8_t &module, uint8_t &channel, BinaryPointType &pointtype)
 {
-	auto ODCPointMapIter = BinaryControlODCPointMap.find(index);
-	if (ODCPointMapIter != BinaryControlODCPointMap.end())
+	if (auto pt = BinaryControlPoints.AtODCIndex(index))
 	{
-		module = ODCPointMapIter->second->GetModuleAddress();
-		channel = ODCPointMapIter->second->GetChannel();
-		pointtype = ODCPointMapIter->second->GetPointType();
+		module = pt->GetModuleAddress();
+		channel = pt->GetChannel();
+		pointtype = pt->GetPointType();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetAnalogControlODCIndexUsingMD3Index(const uint16_t module, const uint8_t channel, size_t &index)
 {
-	uint16_t Md3Index = ShiftLeft8Result16Bits(module) | channel;
-
-	auto MD3PointMapIter = AnalogControlMD3PointMap.find(Md3Index);
-	if (MD3PointMapIter != AnalogControlMD3PointMap.end())
+	if (auto pt = AnalogControlPoints.AtSlot(MD3Slot(module, channel)))
 	{
-		index = MD3PointMapIter->second->GetIndex();
+		index = pt->GetIndex();
 		return true;
 	}
 	return false;
 }
 bool MD3PointTableAccess::GetAnalogControlMD3IndexUsingODCIndex(const size_t index, uint8_t& module, uint8_t& channel)
 {
-	auto ODCPointMapIter = AnalogControlODCPointMap.find(index);
-	if (ODCPointMapIter != AnalogControlODCPointMap.end())
+	if (auto pt = AnalogControlPoints.AtODCIndex(index))
 	{
-		module = ODCPointMapIter->second->GetModuleAddress();
-		channel = ODCPointMapIter->second->GetChannel();
+		module = pt->GetModuleAddress();
+		channel = pt->GetChannel();
 		return true;
 	}
 	return false;
@@ -534,47 +418,38 @@ std::vector<MD3BinaryPoint> MD3PointTableAccess::DumpTimeTaggedPointList()
 	MD3BinaryPoint CurrentPoint;
 	std::vector<MD3BinaryPoint> PointList(50);
 
-	while (pBinaryTimeTaggedEventQueue->sync_front(CurrentPoint))
+	while (pBinaryTimeTaggedEventQueue->Peek(CurrentPoint))
 	{
 		PointList.emplace_back(CurrentPoint);
-		pBinaryTimeTaggedEventQueue->sync_pop();
+		pBinaryTimeTaggedEventQueue->Pop();
 	}
 
 	return PointList;
 }
 bool MD3PointTableAccess::PeekNextTaggedEventPoint(MD3BinaryPoint &pt)
 {
-	return pBinaryTimeTaggedEventQueue->sync_front(pt);
+	return pBinaryTimeTaggedEventQueue->Peek(pt);
 }
 bool MD3PointTableAccess::PopNextTaggedEventPoint()
 {
-	return pBinaryTimeTaggedEventQueue->sync_pop();
+	return pBinaryTimeTaggedEventQueue->Pop();
 }
 bool MD3PointTableAccess::TimeTaggedDataAvailable()
 {
-	return !pBinaryTimeTaggedEventQueue->sync_empty();
+	return !pBinaryTimeTaggedEventQueue->IsEmpty();
 }
 
 void MD3PointTableAccess::ForEachBinaryPoint(const std::function<void(MD3BinaryPoint &pt)>& fn)
 {
-	for (const auto& md3pt : BinaryMD3PointMap) // We always use the MD3 map - its order is the only one we care about.
-	{
-		fn(*md3pt.second);
-	}
+	BinaryPoints.ForEach(fn); // Always in MD3 order - the only one we care about.
 }
 void MD3PointTableAccess::ForEachAnalogPoint(const std::function<void(MD3AnalogCounterPoint &pt)>& fn)
 {
-	for (const auto& md3pt : AnalogMD3PointMap) // We always use the MD3 map - its order is the only one we care about.
-	{
-		fn(*md3pt.second);
-	}
+	AnalogPoints.ForEach(fn); // Always in MD3 order - the only one we care about.
 }
 void MD3PointTableAccess::ForEachCounterPoint(const std::function<void(MD3AnalogCounterPoint &pt)>& fn)
 {
-	for (const auto& md3pt : CounterMD3PointMap) // We always use the MD3 map - its order is the only one we care about.
-	{
-		fn(*md3pt.second);
-	}
+	CounterPoints.ForEach(fn); // Always in MD3 order - the only one we care about.
 }
 #ifdef _MSC_VER
 #pragma endregion
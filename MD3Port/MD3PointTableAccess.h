@@ -28,12 +28,13 @@
 #define MD3POINTTABLEACCESS_H_
 #include "MD3.h"
 #include "MD3PointConf.h"
+#include "MD3PointArray.h"
 #include <unordered_map>
 #include <vector>
 #include <functional>
 //#include "MD3PortConf.h"
 #include "MD3Utility.h"
-#include "StrandProtectedQueue.h"
+#include "ProducerConsumerQueue.h"
 
 using namespace odc;
 
@@ -42,7 +43,7 @@ class MD3PointTableAccess
 {
 public:
 	MD3PointTableAccess();
-	void Build(const bool isoutstation, const bool newdigitalcommands, odc::asio_service & IOS);
+	void Build(const bool isoutstation, const bool newdigitalcommands);
 
 	bool AddCounterPointToPointTable(const size_t & index, const uint8_t & moduleaddress, const uint8_t & channel, const uint32_t & pollgroup);
 	bool AddAnalogPointToPointTable(const size_t & index, const uint8_t & moduleaddress, const uint8_t & channel, const uint32_t & pollgroup);
@@ -101,30 +102,28 @@ public:
 	uint16_t CollectModuleBitsIntoWord(const uint8_t ModuleAddress, bool & ModuleFailed);
 
 protected:
+	// Slots are Module:Channel, so the 16 channels of a module sit together, and the order is the MD3 order.
+	static size_t MD3Slot(const uint16_t module, const uint8_t channel)
+	{
+		return ((module > 0xFF) || (channel > 0x0F)) ? MD3Slots : (static_cast<size_t>(module) << 4) | channel;
+	}
+	static constexpr size_t MD3Slots = 256 * 16;
 
-	// We access the map using a Module:Channel combination, so that they will always be in order. Makes searching the next item easier.
-	std::map<uint16_t, std::shared_ptr<MD3BinaryPoint>> BinaryMD3PointMap; // ModuleAndChannel, MD3Point
-	std::map<size_t, std::shared_ptr<MD3BinaryPoint>> BinaryODCPointMap;   // Index OpenDataCon, MD3Point
-
-	std::map<uint16_t, std::shared_ptr<MD3AnalogCounterPoint>> AnalogMD3PointMap; // ModuleAndChannel, MD3Point
-	std::map<size_t, std::shared_ptr<MD3AnalogCounterPoint>> AnalogODCPointMap;   // Index OpenDataCon, MD3Point
-
-	std::map<uint16_t, std::shared_ptr<MD3AnalogCounterPoint>> CounterMD3PointMap; // ModuleAndChannel, MD3Point
-	std::map<size_t, std::shared_ptr<MD3AnalogCounterPoint>> CounterODCPointMap;   // Index OpenDataCon, MD3Point
+	MD3PointArray<MD3BinaryPoint> BinaryPoints{MD3Slots};
+	MD3PointArray<MD3AnalogCounterPoint> AnalogPoints{MD3Slots};
+	MD3PointArray<MD3AnalogCounterPoint> CounterPoints{MD3Slots};
 
 	// Binary Control Points are not readable
-	std::map<uint16_t, std::shared_ptr<MD3BinaryPoint>> BinaryControlMD3PointMap; // ModuleAndChannel, MD3Point
-	std::map<size_t, std::shared_ptr<MD3BinaryPoint>> BinaryControlODCPointMap;   // Index OpenDataCon, MD3Point
+	MD3PointArray<MD3BinaryPoint> BinaryControlPoints{MD3Slots};
 
 	// Analog Control Points are not readable
-	std::map<uint16_t, std::shared_ptr<MD3AnalogCounterPoint>> AnalogControlMD3PointMap; // ModuleAndChannel, MD3Point
-	std::map<size_t, std::shared_ptr<MD3AnalogCounterPoint>> AnalogControlODCPointMap;   // Index OpenDataCon, MD3Point
+	MD3PointArray<MD3AnalogCounterPoint> AnalogControlPoints{MD3Slots};
 
 	bool IsOutstation = true;
 	bool NewDigitalCommands = true;
 
 	// Only used in outstation
-	std::shared_ptr<StrandProtectedQueue<MD3BinaryPoint>> pBinaryTimeTaggedEventQueue; // Separate queue for time tagged binary events.
+	std::shared_ptr<ProducerConsumerQueue<MD3BinaryPoint>> pBinaryTimeTaggedEventQueue; // Separate queue for time tagged binary events.
 };
 
 #endif
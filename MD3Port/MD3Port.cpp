@@ -128,3 +128,9 @@ void MD3Port::SendMD3Message(const MD3Message_t &CompleteMD3Message)
 	}
 	MD3Connection::Write(pConnection, CompleteMD3Message);
 }
+void MD3Port::SendEncodedMD3Message(const uint8_t* data, size_t len)
+{
+	if (!enabled.load()) return; // Port Disabled so dont process
+
+	MD3Connection::Write(pConnection, data, len);
+}
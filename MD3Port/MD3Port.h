@@ -30,7 +30,6 @@
 #include "MD3PortConf.h"
 #include "MD3Utility.h"
 #include "MD3Connection.h"
-#include "StrandProtectedQueue.h"
 #include <unordered_map>
 #include <vector>
 #include <functional>
@@ -53,6 +52,7 @@ public:
 
 	// Public only for UnitTesting
 	virtual void SendMD3Message(const MD3Message_t& CompleteMD3Message);
+	virtual void SendEncodedMD3Message(const uint8_t* data, size_t len); // Already encoded to bytes (MD3Codec.h)
 	void SetSendTCPDataFn(std::function<void(std::string)> Send);
 	void InjectSimulatedTCPMessage(buf_t & readbuf); // Equivalent of the callback handler in the MD3Connection.
 
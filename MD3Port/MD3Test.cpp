@@ -38,15 +38,24 @@
 #include "MD3MasterPort.h"
 #include "MD3OutstationPort.h"
 #include "MD3Utility.h"
+#include "MD3Codec.h"
 #include "ProducerConsumerQueue.h"
-#include "StrandProtectedQueue.h"
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
+#include <iostream>
+#include <iterator>
+#include <mutex>
 #include <opendatacon/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
+#include <thread>
 #include <utility>
+#include <vector>
 
 #ifdef NONVSTESTING
 #include <catch.hpp>
@@ -68,6 +77,7 @@ extern const char *conffilename2;
 extern const char *conffile1;
 extern const char *conffile2;
 extern std::vector<spdlog::sink_ptr> LogSinks;
+extern uint64_t (*AllocationCount)(); // main.cpp
 
 
 const char *conffilename1 = "MD3Config.conf";
@@ -367,50 +377,304 @@ TEST_CASE("Utility - MD3CRCTest")
 	REQUIRE(MD3CRCCompare(res, 0xff));
 }
 
-TEST_CASE("Utility - Strand Queue")
+TEST_CASE("Utility - Producer Consumer Queue")
 {
-	auto pIOS = odc::asio_service::Get();
-
-	auto work = pIOS->make_work(); // Just to keep things from stopping..
-
-	std::thread t1([pIOS]() {pIOS->run(); });
-	std::thread t2([pIOS]() {pIOS->run(); });
-
-	StrandProtectedQueue<int> foo(*pIOS, 10);
-	foo.sync_push(21);
-	foo.sync_push(31);
-	foo.sync_push(41);
+	ProducerConsumerQueue<int> foo(10);
+	foo.Push(21);
+	foo.Push(31);
+	foo.Push(41);
 
 	int res;
-	bool success = foo.sync_front(res);
+	bool success = foo.Peek(res);
 	REQUIRE(success);
 	REQUIRE(res == 21);
-	foo.sync_pop();
+	foo.Pop();
 
-	success = foo.sync_front(res);
+	success = foo.Peek(res);
 	REQUIRE(success);
 	REQUIRE(res == 31);
-	foo.sync_pop();
+	foo.Pop();
 
-	foo.sync_push(2 * res);
-	success = foo.sync_front(res);
-	foo.sync_pop();
+	foo.Push(2 * res);
+	success = foo.Peek(res);
+	foo.Pop();
 	REQUIRE(success);
 	REQUIRE(res == 41);
 
-	success = foo.sync_front(res);
-	foo.sync_pop();
+	success = foo.Peek(res);
+	foo.Pop();
 	REQUIRE(success);
 	REQUIRE(res == 31 * 2);
 
-	success = foo.sync_front(res);
+	success = foo.Peek(res);
 	REQUIRE(!success);
 
-	work.reset();
+	// Bounded - and a reserved space can only be used by a Push that does not reserve it
+	for (int i = 0; i < 9; i++)
+		REQUIRE(foo.Push(i, 1));
+	REQUIRE(!foo.Push(9, 1));
+	REQUIRE(foo.Push(9));
+	REQUIRE(foo.IsFull());
+	REQUIRE(!foo.Push(10));
+	for (int i = 0; i < 10; i++)
+	{
+		REQUIRE(foo.Pop(res));
+		REQUIRE(res == i);
+	}
+	REQUIRE(foo.IsEmpty());
+}
+
+TEST_CASE("Utility - Producer Consumer Queue Multiple Producers")
+{
+	const int Producers = 4;
+	const int PerProducer = 1000;
+	ProducerConsumerQueue<int> foo(64);
+
+	std::vector<std::thread> threads;
+	for (int p = 0; p < Producers; p++)
+	{
+		threads.emplace_back([&foo,p]()
+			{
+				for (int i = 0; i < PerProducer; i++)
+				{
+					while (!foo.Push(p * PerProducer + i))
+						std::this_thread::yield();
+				}
+			});
+	}
+
+	// Each producer's values must come out in the order it pushed them, and none lost
+	std::vector<int> next(Producers, 0);
+	int received = 0;
+	while (received < Producers * PerProducer)
+	{
+		int val;
+		if (!foo.Pop(val))
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const int p = val / PerProducer;
+		REQUIRE(val % PerProducer == next[p]);
+		next[p]++;
+		received++;
+	}
+	for (auto& t : threads)
+		t.join();
+	REQUIRE(foo.IsEmpty());
+}
+TEST_CASE("Utility - Point Value And Time Consistent")
+{
+	// Writers keep the time matched to the value - a reader or copy must never pair a value with another update's time
+	MD3BinaryPoint pt(1, 0x20, 3, 0, TIMETAGGEDINPUT);
+	std::atomic<bool> stop(false);
+	std::vector<std::thread> writers;
+	for (uint8_t w = 0; w < 2; w++)
+	{
+		writers.emplace_back([&pt,&stop,w]()
+			{
+				for (uint8_t n = w; !stop; n++)
+					pt.SetBinary(n & 1, 1000 + (n & 1));
+			});
+	}
+
+	size_t torn = 0;
+	for (int i = 0; i < 100000; i++)
+	{
+		MD3Time changedtime;
+		const uint8_t b = pt.GetBinary(changedtime);
+		if (changedtime != 1000u + b)
+			torn++;
+		const MD3BinaryPoint copy(pt);
+		if (copy.GetChangedTime() != 1000u + copy.GetBinary())
+			torn++;
+	}
+	stop = true;
+	for (auto& t : writers)
+		t.join();
+	REQUIRE(torn == 0);
+}
+TEST_CASE("Utility - MD3 Codec")
+{
+	// The codec output must match what the block classes produce
+	MD3BlockFormatted header(0x7C, false, ANALOG_UNCONDITIONAL, 0x20, 5);
+	MD3AnalogValues_t values;
+	for (uint16_t v : {0x1234, 0x8000, 0xFFFF, 0x0001, 0x5555})
+		values.push_back(v);
+
+	MD3Message_t msg;
+	msg.push_back(header);
+	msg.push_back(MD3BlockData(values[0], values[1]));
+	msg.push_back(MD3BlockData(values[2], values[3]));
+	msg.push_back(MD3BlockData(values[4], 0, true));
+	std::string expected;
+	for (const auto& blk : msg)
+		expected += blk.ToBinaryString();
+
+	std::array<uint8_t, MD3MessageBytes(1 + MD3MaxAnalogChannels / 2)> buf;
+	size_t len = MD3EncodeAnalogUnconditional(header, values.data(), values.size(), buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == expected);
+
+	len = MD3EncodeMessage(msg, buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == expected);
+	REQUIRE(MD3MessageAsString(buf.data(), len) == MD3MessageAsString(msg)); // Logged the same either way
+
+	// Too small an output buffer
+	REQUIRE(MD3EncodeMessage(msg, buf.data(), MD3MessageBytes(3)) == 0);
+
+	MD3SmallVector<MD3BlockData, 16> decoded;
+	size_t consumed = 0;
+	REQUIRE(MD3DecodeMessage(buf.data(), len, decoded, consumed) == MD3DecodeResult::Complete);
+	REQUIRE(consumed == len);
+	REQUIRE(decoded.size() == msg.size());
+	for (size_t i = 0; i < msg.size(); i++)
+	{
+		REQUIRE(decoded[i].GetData() == msg[i].GetData());
+		REQUIRE(decoded[i].GetEndByte() == msg[i].GetEndByte());
+	}
+
+	REQUIRE(MD3DecodeMessage(buf.data(), len - MD3BlockArraySize, decoded, consumed) == MD3DecodeResult::Incomplete);
+	MD3SmallVector<MD3BlockData, 2> tiny;
+	REQUIRE(MD3DecodeMessage(buf.data(), len, tiny, consumed) == MD3DecodeResult::Overflow);
+	buf[7] ^= 0x01; // Corrupt the first data block
+	REQUIRE(MD3DecodeMessage(buf.data(), len, decoded, consumed) == MD3DecodeResult::BadBlock);
+
+	// Deltas, 4 to a block
+	MD3BlockFormatted deltaheader(0x7C, false, ANALOG_DELTA_SCAN, 0x20, 6);
+	MD3AnalogDeltas_t deltas;
+	for (int d : {1, -1, 127, -128, 0, 5})
+		deltas.push_back(d);
+	expected = deltaheader.ToBinaryString()
+	           + MD3BlockData(uint8_t(1), uint8_t(0xFF), uint8_t(127), uint8_t(0x80)).ToBinaryString()
+	           + MD3BlockData(uint8_t(0), uint8_t(5), uint8_t(0), uint8_t(0), true).ToBinaryString();
+	len = MD3EncodeAnalogDelta(deltaheader, deltas.data(), deltas.size(), buf.data(), buf.size());
+	REQUIRE(std::string(reinterpret_cast<char*>(buf.data()), len) == expected);
+}
+
+TEST_CASE("Master - Adaptive Timeout Simulated Link")
+{
+	// A simulated link, with a pseudo random (but repeatable) round trip time of base +- jitter msec
+	uint32_t seed = 12345;
+	auto LinkRTT = [&seed](int base, int jitter)
+			   {
+				   seed = seed * 1103515245 + 12345;
+				   return std::chrono::microseconds((base - jitter + int((seed >> 16) % (2 * jitter + 1))) * 1000);
+			   };
+
+	STANDARD_TEST_SETUP();
+
+	// No max set, so the default has to leave the timeout room to grow
+	Json::Value MAportoverride;
+	MAportoverride["MD3AdaptiveTimeout"] = true;
+	MAportoverride["MD3CommandTimeoutmsec"] = 700;
+	MAportoverride["MD3CommandTimeoutMinmsec"] = 100;
+	TEST_MD3MAPort(MAportoverride);
+
+	auto& rtt = MD3MAPort->GetCommandRTT();
+	REQUIRE(rtt.GetTimeout() == std::chrono::milliseconds(700)); // No samples yet
+	REQUIRE(rtt.GetTimeout(1) == std::chrono::milliseconds(1400));
+	REQUIRE(rtt.GetTimeout(10) == std::chrono::milliseconds(700 * RTTEstimator::DefaultMaxMultiple)); // Backoff stops at the max
+
+	// Slow radio link, 600msec +- 200. A fixed 700msec timeout (fine on a wire) retries about a quarter of the time.
+	// The adaptive one learns the link. A command that times out doesn't give a sample.
+	const int Commands = 1000;
+	int fixedspurious = 0;
+	int adaptivespurious = 0;
+	for (int i = 0; i < Commands; i++)
+	{
+		auto r = LinkRTT(600, 200);
+		if (r > std::chrono::milliseconds(700))
+			fixedspurious++;
+		if (r > rtt.GetTimeout())
+			adaptivespurious++;
+		else
+			rtt.Sample(r);
+	}
+	REQUIRE(fixedspurious > Commands / 5);
+	REQUIRE(adaptivespurious < fixedspurious / 10);
+	REQUIRE(rtt.GetSRTTmsec() > 450);
+	REQUIRE(rtt.GetSRTTmsec() < 750);
+	REQUIRE(rtt.GetTimeout() > std::chrono::milliseconds(700)); // Has grown past the fixed timeout
+
+	// Fast link, 20msec +- 5. With the fixed 700msec timeout and one retry, a dead Station takes 1.4 seconds to find.
+	// Adaptive finds it at the min timeout plus the backed off retry.
+	for (int i = 0; i < 100; i++)
+		rtt.Sample(LinkRTT(20, 5));
+	const auto fixeddetect = std::chrono::milliseconds(700 * 2);
+	const auto adaptivedetect = rtt.GetTimeout(0) + rtt.GetTimeout(1);
+	REQUIRE(adaptivedetect == std::chrono::milliseconds(100 + 200));
+	REQUIRE(adaptivedetect * 4 < fixeddetect);
+
+	// A reconnect starts the estimate again
+	START_IOS(1);
+	MD3MAPort->Enable();
+	MD3MAPort->SocketStateHandler(true);
+	for (int i = 0; (i < 100) && (rtt.GetSamples() != 0); i++)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	REQUIRE(rtt.GetSamples() == 0);
+	REQUIRE(rtt.GetTimeout() == std::chrono::milliseconds(700));
 
-	t1.join(); // Wait for thread to end
-	t2.join();
+	MD3MAPort->Disable();
+	STOP_IOS();
+	TestTearDown();
 }
+
+// Not run by default - run with the [.benchmark] tag
+TEST_CASE("Utility - MD3 Codec Benchmark", "[.benchmark]")
+{
+	const size_t Iterations = 1000000;
+	MD3BlockFormatted header(0x7C, false, ANALOG_UNCONDITIONAL, 0x20, 16);
+	MD3AnalogValues_t values;
+	for (uint16_t i = 0; i < MD3MaxAnalogChannels; i++)
+		values.push_back(static_cast<uint16_t>(i * 1000));
+
+	std::array<uint8_t, MD3MessageBytes(1 + MD3MaxAnalogChannels / 2)> buf;
+	size_t bytes = 0;
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations; i++)
+	{
+		values[0] = static_cast<uint16_t>(i);
+		bytes += MD3EncodeAnalogUnconditional(header, values.data(), values.size(), buf.data(), buf.size());
+	}
+	auto encodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// The block by block way - vector of blocks, then a string per block
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations / 10; i++)
+	{
+		values[0] = static_cast<uint16_t>(i);
+		MD3Message_t msg;
+		msg.push_back(header);
+		for (size_t b = 0; b < MD3MaxAnalogChannels / 2; b++)
+			msg.push_back(MD3BlockData(values[2 * b], values[2 * b + 1], b + 1 == MD3MaxAnalogChannels / 2));
+		std::string str;
+		for (const auto& blk : msg)
+			str += blk.ToBinaryString();
+		bytes += str.size();
+	}
+	auto oldencodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 10;
+
+	MD3SmallVector<MD3BlockData, 16> decoded;
+	size_t consumed = 0;
+	size_t blocks = 0;
+	const size_t len = MD3EncodeAnalogUnconditional(header, values.data(), values.size(), buf.data(), buf.size());
+	start = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < Iterations; i++)
+	{
+		MD3DecodeMessage(buf.data(), len, decoded, consumed);
+		blocks += decoded.size();
+	}
+	auto decodetime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	REQUIRE(bytes > 0);
+	REQUIRE(blocks == Iterations * (1 + MD3MaxAnalogChannels / 2));
+	std::cout << "MD3 16 channel analog unconditional response (" << len << " bytes)" << std::endl
+	          << "  codec encode:       " << Iterations / encodetime << " msg/s" << std::endl
+	          << "  block/string encode: " << Iterations / oldencodetime << " msg/s" << std::endl
+	          << "  codec decode:       " << Iterations / decodetime << " msg/s" << std::endl;
+}
+
 #ifdef _MSC_VER
 #pragma region Block Tests
 #endif
@@ -3607,6 +3871,346 @@ TEST_CASE("Master - Multi-drop Disable/Enable Single Port Test Using TCP")
 	STOP_IOS();
 	TestTearDown();
 }
+TEST_CASE("Master - Multi-drop Stations Are Independent Using TCP")
+{
+	// Each Master port is one Station, and keeps its own outstanding command, retry and timeout state.
+	// So a Station that is not answering must not hold up the other Stations sharing the connection - the poll cycle
+	// on a multi-drop link should be set by the slowest Station, not the sum of all of them.
+	STANDARD_TEST_SETUP();
+	// Outstations are as for the conf files
+	TEST_MD3OSPort(Json::nullValue);
+	TEST_MD3OSPort2(Json::nullValue);
+
+	// The masters need to be TCP Clients - should be only change necessary.
+	Json::Value MAportoverride;
+	MAportoverride["TCPClientServer"] = "CLIENT";
+	TEST_MD3MAPort(MAportoverride);
+
+	Json::Value MAportoverride2;
+	MAportoverride2["TCPClientServer"] = "CLIENT";
+	TEST_MD3MAPort2(MAportoverride2);
+
+	START_IOS(1);
+
+	MD3OSPort->Enable();
+	MD3OSPort2->Enable();
+	MD3MAPort->Enable();
+	MD3MAPort2->Enable();
+
+	// Allow everything to get setup.
+	Wait(*IOS, 2);
+
+	// Stop polling, so the only commands in the queues are ours. Let any polls already sent be answered.
+	MD3MAPort->EnablePolling(false);
+	MD3MAPort2->EnablePolling(false);
+	Wait(*IOS, 1);
+
+	// The second Station stops answering, its Master will have to time out and retry (4 seconds, 1 retry in the conf file).
+	MD3OSPort2->Disable();
+
+	CommandStatus res = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([=, &res](CommandStatus command_stat)
+		{
+			LOGDEBUG("Callback on CONTROL command result : {}", std::to_string(static_cast<int>(command_stat)));
+			res = command_stat;
+		});
+	CommandStatus res2 = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback2 = std::make_shared<std::function<void(CommandStatus)>>([=, &res2](CommandStatus command_stat)
+		{
+			LOGDEBUG("Callback on CONTROL command result : {}", std::to_string(static_cast<int>(command_stat)));
+			res2 = command_stat;
+		});
+
+	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
+	val.functionCode = ControlCode::LATCH_ON;
+
+	// Command to the silent Station first, then straight away to the good one.
+	auto event2 = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 16, "TestHarness");
+	event2->SetPayload<EventType::ControlRelayOutputBlock>(EventTypePayload<EventType::ControlRelayOutputBlock>::type(val));
+	MD3MAPort2->Event(event2, "TestHarness2", pStatusCallback2);
+
+	auto event1 = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 116, "TestHarness");
+	event1->SetPayload<EventType::ControlRelayOutputBlock>(EventTypePayload<EventType::ControlRelayOutputBlock>::type(val));
+	MD3MAPort->Event(event1, "TestHarness", pStatusCallback);
+
+	// Well inside the first timeout of the silent Station, the good one has already answered.
+	Wait(*IOS, 2);
+
+	REQUIRE(res == CommandStatus::SUCCESS);
+	REQUIRE(res2 == CommandStatus::NOT_AUTHORIZED);
+
+	// After the timeout and retry, the silent Station command fails
+	Wait(*IOS, 8);
+
+	REQUIRE(res2 == CommandStatus::UNDEFINED);
+
+	MD3OSPort->Disable();
+	MD3MAPort->Disable();
+	MD3MAPort2->Disable();
+
+	STOP_IOS();
+	TestTearDown();
+}
+TEST_CASE("Master - Control Latency With Saturated Poll Queue")
+{
+	// Poll faster than the Outstation can answer, and make sure the poll commands do not pile up in the queue,
+	// and that a control does not have to wait behind all of them.
+	STANDARD_TEST_SETUP();
+
+	Json::Value MAportoverride;
+	MAportoverride["MD3CommandTimeoutmsec"] = 200;
+	MAportoverride["MD3CommandRetries"] = 0;
+	TEST_MD3MAPort(MAportoverride);
+
+	START_IOS(1);
+
+	// Hook the output function, nothing ever answers.
+	std::mutex SentMutex;
+	std::vector<uint8_t> SentFunctionCodes;
+	MD3MAPort->SetSendTCPDataFn([&](std::string MD3Message)
+		{
+			std::lock_guard<std::mutex> lck(SentMutex);
+			SentFunctionCodes.push_back(static_cast<uint8_t>(MD3Message[1]));
+		});
+
+	MD3MAPort->Enable();
+	MD3MAPort->EnablePolling(false); // We will call DoPoll ourselves
+
+	// A second's worth of polls on a badly saturated link
+	for (int i = 0; i < 100; i++)
+	{
+		MD3MAPort->DoPoll(1);
+		MD3MAPort->DoPoll(2);
+	}
+
+	CommandStatus res = CommandStatus::NOT_AUTHORIZED;
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&res](CommandStatus command_stat)
+		{
+			res = command_stat;
+		});
+
+	EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
+	val.functionCode = ControlCode::LATCH_ON;
+	auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, 116, "TestHarness");
+	event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(val));
+	MD3MAPort->Event(event, "TestHarness", pStatusCallback);
+
+	Wait(*IOS, 1);
+
+	{
+		std::lock_guard<std::mutex> lck(SentMutex);
+		// The first poll command went straight out, the control is next - ahead of the queued polls
+		REQUIRE(SentFunctionCodes.size() >= 2);
+		REQUIRE(SentFunctionCodes[0] != POM_TYPE_CONTROL);
+		REQUIRE(SentFunctionCodes[1] == POM_TYPE_CONTROL);
+	}
+	REQUIRE(res == CommandStatus::UNDEFINED); // Timed out, nothing answering
+
+	// Only one of each poll is ever waiting, the rest are coalesced
+	auto stats = MD3MAPort->GetStatistics();
+	REQUIRE(stats["CommandQueue"]["PollsCoalesced"].asUInt64() >= 190);
+
+	MD3MAPort->Disable();
+
+	STOP_IOS();
+	TestTearDown();
+}
+
+// Counts the events a port publishes
+class EventCountingPort: public IOHandler
+{
+public:
+	explicit EventCountingPort(const std::string& aName): IOHandler(aName) {}
+	void Event(ConnectState state, const std::string& SenderName) override {}
+	void Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback) override
+	{
+		Count++;
+		(*pStatusCallback)(CommandStatus::SUCCESS);
+	}
+	void Enable() override {}
+	void Disable() override {}
+
+	std::atomic<uint64_t> Count{0};
+};
+
+// Split a captured byte stream into messages, skipping over anything that is not a valid block.
+// Returns each message with true if it is Master to Station.
+std::vector<std::pair<bool, std::string>> SplitMD3Stream(const std::string& Stream)
+{
+	std::vector<std::pair<bool, std::string>> Frames;
+	MD3SmallVector<MD3BlockData, 64> blocks;
+	size_t pos = 0;
+	while (pos < Stream.size())
+	{
+		size_t consumed = 0;
+		auto res = MD3DecodeMessage(reinterpret_cast<const uint8_t*>(Stream.data()) + pos, Stream.size() - pos, blocks, consumed);
+		if (res == MD3DecodeResult::Incomplete)
+			break;
+		if (res != MD3DecodeResult::Complete)
+		{
+			pos++;
+			continue;
+		}
+		Frames.emplace_back(MD3BlockFormatted(blocks[0]).IsMasterToStationMessage(), Stream.substr(pos, consumed));
+		pos += consumed;
+	}
+	return Frames;
+}
+
+// Not run by default - run with the [.benchmark] tag
+// Replays a byte stream through the connection framing into an Outstation, then the command/response pairs through a Master (framing, decode and point table),
+// as fast as they will go. Set MD3_REPLAY_FILE to a raw capture of the link (both directions) to replay that, otherwise a synthetic analog scan stream is used.
+TEST_CASE("Master - Replay Benchmark", "[.benchmark]")
+{
+	STANDARD_TEST_SETUP();
+
+	Json::Value OSportoverride;
+	OSportoverride["Port"] = static_cast<Json::UInt64>(10001);
+	TEST_MD3OSPort(OSportoverride);
+
+	Json::Value MAportoverride;
+	MAportoverride["MD3CommandTimeoutmsec"] = 100;
+	MAportoverride["MD3CommandRetries"] = 0; // A retry would put the responses out of step
+	TEST_MD3MAPort(MAportoverride);
+
+	START_IOS(1);
+
+	std::string Stream;
+	std::vector<std::string> Commands;
+	std::vector<std::string> Responses;
+
+	const char* ReplayFile = std::getenv("MD3_REPLAY_FILE");
+	if (ReplayFile != nullptr)
+	{
+		std::ifstream f(ReplayFile, std::ios::binary);
+		REQUIRE(f.is_open());
+		Stream.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+
+		// Pair each command with the response that follows it
+		std::string LastCommand;
+		for (const auto& frame : SplitMD3Stream(Stream))
+		{
+			if (frame.first)
+			{
+				LastCommand = frame.second;
+			}
+			else if (!LastCommand.empty())
+			{
+				Commands.push_back(LastCommand);
+				Responses.push_back(frame.second);
+				LastCommand.clear();
+			}
+		}
+	}
+	else
+	{
+		// The responses will be whatever the Outstation sends back
+		for (size_t i = 0; i < 20000; i++)
+		{
+			MD3BlockFormatted commandblock(0x7C, true, (i % 2 == 0) ? ANALOG_UNCONDITIONAL : ANALOG_DELTA_SCAN, 0x20, 16, true);
+			Commands.push_back(commandblock.ToBinaryString());
+			Stream += Commands.back();
+		}
+	}
+	const size_t StreamFrames = SplitMD3Stream(Stream).size();
+	REQUIRE(StreamFrames > 0);
+
+	auto Allocations = [] { return AllocationCount ? AllocationCount() : 0; };
+
+	// Outstation - the whole stream, in TCP sized chunks. Processing is synchronous, so everything is done when the last inject returns.
+	std::vector<std::string> StationResponses;
+	StationResponses.reserve(StreamFrames);
+	MD3OSPort->SetSendTCPDataFn([&StationResponses](std::string MD3Message) { StationResponses.push_back(std::move(MD3Message)); });
+	MD3OSPort->Enable();
+
+	const size_t ChunkSize = 1460;
+	buf_t readbuf;
+	std::ostream input(&readbuf);
+	auto StationAllocations = Allocations();
+	auto start = std::chrono::steady_clock::now();
+	for (size_t pos = 0; pos < Stream.size(); pos += ChunkSize)
+	{
+		input.write(Stream.data() + pos, static_cast<std::streamsize>(std::min(ChunkSize, Stream.size() - pos)));
+		MD3OSPort->InjectSimulatedTCPMessage(readbuf);
+	}
+	auto stationtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	StationAllocations = Allocations() - StationAllocations;
+	MD3OSPort->Disable();
+
+	if (ReplayFile == nullptr)
+	{
+		REQUIRE(StationResponses.size() == Commands.size());
+		Responses = StationResponses;
+	}
+
+	// Master - each command is answered with its response as soon as it is sent, and the next command queued.
+	std::vector<MD3Message_t> CommandMessages;
+	for (const auto& cmd : Commands)
+	{
+		MD3SmallVector<MD3BlockData, 64> blocks;
+		size_t consumed = 0;
+		MD3DecodeMessage(reinterpret_cast<const uint8_t*>(cmd.data()), cmd.size(), blocks, consumed);
+		CommandMessages.emplace_back(blocks.begin(), blocks.end());
+	}
+
+	EventCountingPort EventCounter("ReplayEventCounter");
+	MD3MAPort->Subscribe(&EventCounter, "ReplayEventCounter");
+	MD3MAPort->Enable();
+	MD3MAPort->EnablePolling(false);
+	Wait(*IOS, 2); // Let anything queued on enable time out
+
+	std::atomic<size_t> Completed(0);
+	std::atomic<size_t> Succeeded(0);
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&Completed, &Succeeded](CommandStatus command_stat)
+		{
+			if (command_stat == CommandStatus::SUCCESS)
+				Succeeded++;
+			Completed++;
+		});
+
+	size_t NextCommand = 0;
+	size_t Sent = 0;
+	buf_t responsebuf;
+	std::ostream responseinput(&responsebuf);
+	MD3MAPort->SetSendTCPDataFn([&](std::string MD3Message)
+		{
+			// On the master strand
+			size_t i = Sent++;
+			IOS->post([&, i]()
+				{
+					responseinput << Responses[i];
+					MD3MAPort->InjectSimulatedTCPMessage(responsebuf);
+				});
+			if (NextCommand < CommandMessages.size())
+				MD3MAPort->QueueMD3Command(CommandMessages[NextCommand++], pStatusCallback);
+		});
+
+	auto MasterAllocations = Allocations();
+	auto MasterEvents = EventCounter.Count.load();
+	start = std::chrono::steady_clock::now();
+	MD3MAPort->QueueMD3Command(CommandMessages[NextCommand++], pStatusCallback);
+	while ((Completed < CommandMessages.size()) && (std::chrono::steady_clock::now() - start < std::chrono::seconds(120)))
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	auto mastertime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	MasterAllocations = Allocations() - MasterAllocations;
+	MasterEvents = EventCounter.Count.load() - MasterEvents;
+
+	REQUIRE(Completed == CommandMessages.size());
+	if (ReplayFile == nullptr)
+		REQUIRE(Succeeded == CommandMessages.size());
+
+	std::cout << "MD3 replay of " << (ReplayFile ? ReplayFile : "synthetic analog scans") << ", " << Stream.size() << " bytes, " << StreamFrames << " frames" << std::endl
+	          << "  outstation: " << StreamFrames / stationtime << " frames/s, " << static_cast<double>(StationAllocations) / StreamFrames << " allocs/frame" << std::endl
+	          << "  master:     " << Completed / mastertime << " frames/s, " << MasterEvents / mastertime << " events/s, "
+	          << static_cast<double>(MasterAllocations) / Completed << " allocs/frame, " << Succeeded << " of " << Completed << " responses accepted" << std::endl;
+	if (AllocationCount == nullptr)
+		std::cout << "  (allocations are not counted by this test runner)" << std::endl;
+
+	MD3MAPort->Disable();
+
+	STOP_IOS();
+	TestTearDown();
+}
 #ifdef _MSC_VER
 #pragma endregion
 #endif
@@ -43,11 +43,7 @@ MD3BinaryPoint& MD3BinaryPoint::operator=(const MD3BinaryPoint& src)
 		ModuleAddress = src.ModuleAddress;
 		Channel = src.Channel;
 		PollGroup = src.PollGroup;
-		ChangedTime = src.ChangedTime;
-		HasBeenSet = src.HasBeenSet;
-		Binary = src.Binary;
-		ModuleBinarySnapShot = src.ModuleBinarySnapShot;
-		Changed = src.Changed;
+		CopyStateFrom(src);
 		PointType = src.PointType;
 	}
 	return *this;
@@ -114,6 +110,20 @@ std::string MD3MessageAsString(const MD3Message_t& CompleteMD3Message)
 	}
 	return res;
 }
+std::string MD3MessageAsString(const uint8_t* data, size_t len)
+{
+	// Same layout as the block version, a space after every block
+	std::ostringstream oss;
+	oss.fill('0');
+	oss << std::hex;
+	for (size_t i = 0; i < len; i++)
+	{
+		oss << std::setw(2) << static_cast<uint32_t>(data[i]);
+		if ((i + 1) % MD3BlockArraySize == 0)
+			oss << " ";
+	}
+	return oss.str();
+}
 
 MD3Time MD3NowUTC()
 {
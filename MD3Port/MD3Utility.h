@@ -304,6 +304,7 @@ protected:
 
 typedef std::vector<MD3BlockData> MD3Message_t;
 std::string MD3MessageAsString(const MD3Message_t& CompleteMD3Message);
+std::string MD3MessageAsString(const uint8_t* data, size_t len); // An encoded message
 
 class MD3BlockFormatted: public MD3BlockData
 {
@@ -17,88 +17,142 @@
 *	See the License for the specific language governing permissions and
 *	limitations under the License.
 */
-/*
-* ProducerConsumerQueue.h
-*
-*  Created on: 01/04/2018
-*      Author: Scott Ellis <scott.ellis@novatex.com.au>
-*/
 
 #ifndef PRODUCERCONSUMERQUEUE_H_
 #define PRODUCERCONSUMERQUEUE_H_
 
-#include <queue>
-#include <mutex>
-#include <shared_mutex>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 
-// Threadsafe , size limited producer/consumer queue
+// Bounded, lock-free, multi producer / single consumer queue.
+// A fixed ring of cells, each with a sequence number that says whose turn it is (Vyukov's bounded queue).
+// Producers claim a cell with a CAS on the tail, so any number of threads can Push concurrently.
+// Peek/Pop must only be called by one consumer at a time (e.g. from a strand, or the one thread draining the queue).
+// Nothing blocks or allocates after construction - a full queue just refuses the Push.
 template <class T>
 class ProducerConsumerQueue
 {
-private:
-	const uint32_t MaxSize = 255; // MD3 maximum event queue size
-	std::queue<T> Queue;
-	std::shared_timed_mutex m;
-
 public:
-	bool Peek(T& item)
+	explicit ProducerConsumerQueue(const size_t capacity = 255): // MD3 maximum event queue size
+		Capacity(capacity ? capacity : 1),
+		Cells(new Cell[Capacity])
+	{
+		for (size_t i = 0; i < Capacity; i++)
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+	}
+
+	ProducerConsumerQueue(const ProducerConsumerQueue&) = delete;
+	ProducerConsumerQueue& operator=(const ProducerConsumerQueue&) = delete;
+
+	// Returns false if the queue is full. If reserve is non-zero, that many cells are held back,
+	// so a producer can keep space for a final "queue full" marker.
+	bool Push(const T& item, const size_t reserve = 0)
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		if (Queue.empty())
+		size_t pos = Tail.load(std::memory_order_relaxed);
+		for (;;)
 		{
-			return false;
+			Cell& cell = Cells[pos % Capacity];
+			const size_t seq = cell.Sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+			if (diff == 0)
+			{
+				if (reserve && (pos - Head.load(std::memory_order_acquire) + reserve >= Capacity))
+					return false;
+				if (Tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					cell.Item = item;
+					cell.Sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				// The consumer hasn't freed this cell yet - full
+				return false;
+			}
+			else
+			{
+				// Another producer beat us to it
+				pos = Tail.load(std::memory_order_relaxed);
+			}
 		}
-		item = Queue.front();
+	}
+
+	bool Peek(T& item)
+	{
+		Cell* cell = Front();
+		if (!cell)
+			return false;
+		item = cell->Item;
 		return true;
 	}
 	bool Pop(T& item)
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		if (Queue.empty())
-		{
+		Cell* cell = Front();
+		if (!cell)
 			return false;
-		}
-		item = Queue.front();
-		Queue.pop();
+		item = std::move(cell->Item);
+		Release(*cell);
 		return true;
 	}
 	bool Pop()
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		if (Queue.empty())
-		{
+		Cell* cell = Front();
+		if (!cell)
 			return false;
-		}
-		Queue.pop();
+		Release(*cell);
 		return true;
 	}
 
-	bool Push(const T& item)
+	bool IsEmpty() const
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-
-		// Limit the number of elements...
-		if (Queue.size() >= MaxSize)
-			return false;
-
-		Queue.push(item);
-		return true;
+		return Size() == 0;
 	}
-
-	bool IsEmpty()
+	// Approximate if producers are active
+	size_t Size() const
+	{
+		const size_t head = Head.load(std::memory_order_acquire);
+		const size_t tail = Tail.load(std::memory_order_acquire);
+		return tail > head ? tail - head : 0;
+	}
+	bool IsFull() const
+	{
+		return Size() >= Capacity;
+	}
+	size_t GetCapacity() const
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		return Queue.empty();
+		return Capacity;
 	}
-	size_t Size()
+
+private:
+	struct Cell
+	{
+		std::atomic<size_t> Sequence{0};
+		T Item{};
+	};
+
+	// The cell at the head, if its producer has finished writing it
+	Cell* Front()
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		return Queue.size();
+		const size_t pos = Head.load(std::memory_order_relaxed);
+		Cell& cell = Cells[pos % Capacity];
+		if (cell.Sequence.load(std::memory_order_acquire) != pos + 1)
+			return nullptr;
+		return &cell;
 	}
-	bool IsFull()
+	void Release(Cell& cell)
 	{
-		std::shared_lock<std::shared_timed_mutex> lck(m);
-		return (Queue.size >= MaxSize);
+		const size_t pos = Head.load(std::memory_order_relaxed);
+		cell.Item = T(); // Don't hang on to anything the item owns
+		Head.store(pos + 1, std::memory_order_release);
+		cell.Sequence.store(pos + Capacity, std::memory_order_release);
 	}
+
+	const size_t Capacity;
+	std::unique_ptr<Cell[]> Cells;
+	alignas(64) std::atomic<size_t> Head{0};
+	alignas(64) std::atomic<size_t> Tail{0};
 };
 #endif
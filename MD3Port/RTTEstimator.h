@@ -0,0 +1,115 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+
+#ifndef RTTESTIMATOR_H_
+#define RTTESTIMATOR_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+
+// Smoothed round trip time estimate for one Station, used to set the Master command timeout.
+// Same sums as TCP's retransmission timer (RFC 6298): SRTT and RTTVAR are moving averages, gains 1/8 and 1/4,
+// and the timeout is SRTT + 4*RTTVAR, kept between the configured min and max. Each retry doubles the timeout (up to max).
+// Only one thread (the Master command strand) updates it. The values are atomic so statistics can be read from anywhere.
+class RTTEstimator
+{
+public:
+	// With no max configured, the timeout can grow to this many times the initial (fixed) timeout
+	static constexpr uint32_t DefaultMaxMultiple = 4;
+
+	RTTEstimator() = default;
+	RTTEstimator(const uint32_t initialmsec, const uint32_t minmsec, const uint32_t maxmsec)
+	{
+		Configure(initialmsec, minmsec, maxmsec);
+	}
+
+	void Configure(const uint32_t initialmsec, const uint32_t minmsec, const uint32_t maxmsec)
+	{
+		MinTimeoutus = int64_t(minmsec) * 1000;
+		MaxTimeoutus = std::max(MinTimeoutus, int64_t(maxmsec) * 1000);
+		InitialTimeoutus = Clamp(int64_t(initialmsec) * 1000);
+		Reset();
+	}
+
+	// Back to no samples - e.g. when the link comes back up, the old estimate may not apply.
+	void Reset()
+	{
+		SRTTus = 0;
+		RTTVARus = 0;
+		Timeoutus = InitialTimeoutus;
+		Samples = 0;
+	}
+
+	// Only feed in the round trip of a command answered first time. Once a command has been resent,
+	// we can't tell which send the reply belongs to (Karn's algorithm).
+	void Sample(const std::chrono::microseconds rtt)
+	{
+		const int64_t r = std::max(int64_t(0), int64_t(rtt.count()));
+		int64_t srtt = SRTTus;
+		int64_t rttvar = RTTVARus;
+		if (Samples == 0)
+		{
+			srtt = r;
+			rttvar = r / 2;
+		}
+		else
+		{
+			rttvar = rttvar - rttvar / 4 + std::abs(srtt - r) / 4;
+			srtt = srtt - srtt / 8 + r / 8;
+		}
+		SRTTus = srtt;
+		RTTVARus = rttvar;
+		Timeoutus = Clamp(srtt + 4 * rttvar);
+		Samples++;
+	}
+
+	// The timeout for a send, attempt 0 is the first send, 1 the first retry and so on.
+	std::chrono::milliseconds GetTimeout(const uint32_t attempt = 0) const
+	{
+		int64_t to = Timeoutus;
+		for (uint32_t i = 0; i < attempt && to < MaxTimeoutus; i++)
+			to *= 2;
+		// Round up, a timeout of 0 would fire before anything could be answered
+		return std::chrono::milliseconds((Clamp(to) + 999) / 1000);
+	}
+
+	double GetSRTTmsec() const { return double(SRTTus) / 1000; }
+	double GetRTTVARmsec() const { return double(RTTVARus) / 1000; }
+	uint64_t GetSamples() const { return Samples; }
+
+private:
+	int64_t Clamp(const int64_t us) const
+	{
+		return std::min(std::max(us, MinTimeoutus), MaxTimeoutus);
+	}
+
+	int64_t MinTimeoutus = 0;
+	int64_t MaxTimeoutus = 0;
+	int64_t InitialTimeoutus = 0;
+	std::atomic<int64_t> SRTTus{ 0 };
+	std::atomic<int64_t> RTTVARus{ 0 };
+	std::atomic<int64_t> Timeoutus{ 0 };
+	std::atomic<uint64_t> Samples{ 0 };
+};
+
+#endif
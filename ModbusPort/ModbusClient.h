@@ -0,0 +1,47 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusClient.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSCLIENT_H_
+#define MODBUSCLIENT_H_
+
+#include "ModbusPDU.h"
+#include <json/json.h>
+#include <vector>
+
+//Transport used by ModbusMasterPort to talk to an outstation
+//	Requests are PDUs, and the handler gets the response PDU (or failure status) asynchronously.
+//	Handlers for a client are never called concurrently.
+//	The state callback passed to the implementations reports the connection opening/closing.
+class ModbusClient
+{
+public:
+	virtual ~ModbusClient(){}
+	virtual void Open() = 0;
+	virtual void Close() = 0;
+	virtual void Request(std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler) = 0;
+	virtual Json::Value GetStatistics() const { return Json::Value(); }
+};
+
+#endif /* MODBUSCLIENT_H_ */
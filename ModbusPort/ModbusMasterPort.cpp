@@ -25,6 +25,8 @@
  */
 
 #include "ModbusMasterPort.h"
+#include "ModbusRTUClient.h"
+#include "ModbusTCPClient.h"
 #include <array>
 #include <chrono>
 #include <opendatacon/IOTypes.h>
@@ -34,8 +36,6 @@
 ModbusMasterPort::~ModbusMasterPort()
 {
 	Disable();
-	if (modbus_read_buffer != nullptr)
-		free(modbus_read_buffer);
 }
 
 void ModbusMasterPort::Enable()
@@ -43,81 +43,54 @@ void ModbusMasterPort::Enable()
 	if(enabled) return;
 	enabled = true;
 
-	pTCPRetryTimer = pIOS->make_steady_timer();
 	PollScheduler = std::make_unique<ASIOScheduler>(*pIOS);
 
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
 	// Only change stack state if it is a persistent server
 	if (pConf->mAddrConf.ServerType == server_type_t::PERSISTENT)
-	{
-		MBSync->Execute([this](modbus_t* mb)
-			{
-				Connect(mb);
-			});
-	}
+		Connect();
 }
 
-void ModbusMasterPort::Connect(modbus_t* mb)
+void ModbusMasterPort::Connect()
 {
 	if(!enabled) return;
 	if (stack_enabled) return;
 
-	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
-
-	if (mb == nullptr)
+	if (pClient == nullptr)
 	{
 		if(auto log = odc::spdlog_get("ModbusPort"))
 			log->error("{}: Connect error: 'Modbus stack failed'", Name);
 		return;
 	}
 
-	if (modbus_connect(mb) == -1)
-	{
-		if(auto log = odc::spdlog_get("ModbusPort"))
-			log->warn("{}: Connect error: '{}'", Name, modbus_strerror(errno));
+	//the client retries on its own (except for manual connections) and lets us know via ConnectionState()
+	pClient->Open();
+}
 
-		//try again later - except for manual connections
-		if (pConf->mAddrConf.ServerType == server_type_t::PERSISTENT || pConf->mAddrConf.ServerType == server_type_t::ONDEMAND)
-		{
-			pTCPRetryTimer->expires_from_now(std::chrono::seconds(5));
-			pTCPRetryTimer->async_wait(
-				[this](asio::error_code err_code)
-				{
-					if(err_code != asio::error::operation_aborted)
-						MBSync->Execute([this](modbus_t* mb)
-							{
-								Connect(mb);
-							});
-				});
-		}
+void ModbusMasterPort::ConnectionState(bool connected)
+{
+	if(!connected)
+	{
+		StackDown();
 		return;
 	}
 
-	stack_enabled = true;
+	if(!enabled) return;
+	if(stack_enabled.exchange(true)) return;
+
 	if(auto log = odc::spdlog_get("ModbusPort"))
 		log->info("{}: Connect success!", Name);
 
-	modbus_set_slave(mb, pConf->mAddrConf.OutstationAddr);
-
-// doesn't work - at least not with my serial RTU
-//    uint8_t tab_bytes[64];
-//    int rc = modbus_report_slave_id(mb, tab_bytes);
-//    if (rc > 1)
-//    {
-//	    //log
-//    }
+	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
 	PollScheduler->Clear();
 	for(auto pg : pConf->pPointConf->PollGroups)
 	{
 		auto id = pg.second.ID;
-		auto action = [=]()
+		auto action = [this,id]()
 				  {
-					  MBSync->Execute([=](modbus_t* mb)
-						  {
-							  DoPoll(id,mb);
-						  });
+					  DoPoll(id);
 				  };
 		PollScheduler->Add(pg.second.pollrate, action);
 	}
@@ -133,24 +106,26 @@ void ModbusMasterPort::Disable()
 
 void ModbusMasterPort::Disconnect()
 {
-	if (!stack_enabled) return;
-	stack_enabled = false;
+	if(pClient)
+		pClient->Close();
+	StackDown();
+}
+
+void ModbusMasterPort::StackDown()
+{
+	if (!stack_enabled.exchange(false)) return;
 
 	//cancel the timers (otherwise it would tie up the io_service on shutdown)
-	pTCPRetryTimer->cancel();
 	PollScheduler->Stop();
 
-	if(!MBSync->isNull())
-		MBSync->Execute([](modbus_t* mb)
-			{
-				modbus_close(mb);
-			});
+	//values are COMM_LOST now, so they all need publishing after the next good poll
+	pDecoder->Invalidate();
 
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
 	//TODO: implement a comms point
 
-	auto event = std::make_shared<EventInfo>(EventType::BinaryQuality,0,Name,QualityFlags::COMM_LOST);
+	auto event = std::make_shared<EventInfo>(EventType::BinaryQuality,0,GetID(),QualityFlags::COMM_LOST);
 	event->SetPayload<EventType::BinaryQuality>(QualityFlags::COMM_LOST);
 
 	// Modbus function code 0x01 (read coil status)
@@ -186,58 +161,14 @@ void ModbusMasterPort::Disconnect()
 		}
 }
 
-void ModbusMasterPort::HandleError(int errnum, const std::string& source)
+void ModbusMasterPort::HandleError(const ModbusResponse& response, const std::string& source)
 {
 	if(auto log = odc::spdlog_get("ModbusPort"))
-		log->warn("{}: {} error: '{}'", Name, source, modbus_strerror(errno));
-
-	// If not a modbus error, tear down the connection?
-//    if (errnum < MODBUS_ENOBASE)
-//    {
-//        this->Disconnect();
-
-//        ModbusPortConf* pConf = static_cast<ModbusPortConf*>(this->pConf.get());
-
-//        // Try and re-connect if a persistent connection
-//        if (pConf->mAddrConf.ServerType == server_type_t::PERSISTENT)
-//        {
-//            //try again later
-//            pTCPRetryTimer->expires_from_now(std::chrono::seconds(5));
-//            pTCPRetryTimer->async_wait(
-//                                       [this](asio::error_code err_code)
-//                                       {
-//                                           if(err_code != asio::error::operation_aborted)
-//                                               this->Connect();
-//                                       });
-//        }
-//    }
-}
-
-CommandStatus ModbusMasterPort::HandleWriteError(int errnum, const std::string& source)
-{
-	HandleError(errnum, source);
-	switch (errno)
 	{
-		case EMBXILFUN: //return "Illegal function";
-			return CommandStatus::NOT_SUPPORTED;
-		case EMBBADCRC:  //return "Invalid CRC";
-		case EMBBADDATA: //return "Invalid data";
-		case EMBBADEXC:  //return "Invalid exception code";
-		case EMBXILADD:  //return "Illegal data address";
-		case EMBXILVAL:  //return "Illegal data value";
-		case EMBMDATA:   //return "Too many data";
-			return CommandStatus::FORMAT_ERROR;
-		case EMBXSFAIL:  //return "Slave device or server failure";
-		case EMBXMEMPAR: //return "Memory parity error";
-			return CommandStatus::HARDWARE_ERROR;
-		case EMBXGTAR: //return "Target device failed to respond";
-			return CommandStatus::TIMEOUT;
-		case EMBXACK:   //return "Acknowledge";
-		case EMBXSBUSY: //return "Slave device or server is busy";
-		case EMBXNACK:  //return "Negative acknowledge";
-		case EMBXGPATH: //return "Gateway path unavailable";
-		default:
-			return CommandStatus::UNDEFINED;
+		if(response.ExceptionCode)
+			log->warn("{}: {} error: exception code {}", Name, source, response.ExceptionCode);
+		else
+			log->warn("{}: {} error: '{}'", Name, source, ToString(response.Status));
 	}
 }
 
@@ -245,202 +176,112 @@ void ModbusMasterPort::Build()
 {
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
-	std::string log_id;
+	pReadPlan = std::make_unique<const ModbusReadPlan>(*pConf->pPointConf, pConf->pPointConf->MaxReadGap);
+	if(auto log = odc::spdlog_get("ModbusPort"))
+		log->debug("{}: Read plan: {} configured ranges in {} requests", Name, pReadPlan->ConfiguredRanges(), pReadPlan->PlannedRequests());
+	ReadPending = std::make_unique<std::atomic_bool[]>(pReadPlan->PlannedRequests());
+	pDecoder = std::make_unique<ModbusPollDecoder>(*pReadPlan, GetID(), std::chrono::milliseconds(pConf->pPointConf->FullRefreshPeriodms));
 
-	if(pConf->mAddrConf.IP != "")
-	{
-		log_id = "mast_" + pConf->mAddrConf.IP + ":" + std::to_string(pConf->mAddrConf.Port);
+	const bool auto_reopen = (pConf->mAddrConf.ServerType != server_type_t::MANUAL);
 
-		//TODO: collect these on a collection of modbus tcp connections
-		MBSync = std::make_unique<ModbusExecutor>(
-			modbus_new_tcp_pi(pConf->mAddrConf.IP.c_str(), std::to_string(pConf->mAddrConf.Port).c_str()), *pIOS);
+	//Handlers on the client only hold weak references to the port
+	auto state_callback = [weak_self{weak_from_this()},this](bool connected)
+				    {
+					    if(auto self = weak_self.lock())
+						    ConnectionState(connected);
+				    };
 
-		if (MBSync->isNull())
+	try
+	{
+		if(pConf->mAddrConf.IP != "")
 		{
-			std::string msg = Name + ": Stack error: 'Modbus stack creation failed'";
-			if(auto log = odc::spdlog_get("ModbusPort"))
-				log->error(msg);
-			throw std::runtime_error(msg);
+			pClient = std::make_shared<ModbusTCPClient>(pIOS, Name, pConf->mAddrConf.IP, pConf->mAddrConf.Port,
+				pConf->mAddrConf.OutstationAddr, pConf->mAddrConf.ResponseTimeoutms, pConf->mAddrConf.MaxInFlight, auto_reopen, state_callback);
 		}
-	}
-	else if(pConf->mAddrConf.SerialDevice != "")
-	{
-		log_id = "mast_" + pConf->mAddrConf.SerialDevice;
-		MBSync = std::make_unique<ModbusExecutor>(
-			modbus_new_rtu(pConf->mAddrConf.SerialDevice.c_str(),pConf->mAddrConf.BaudRate,(char)pConf->mAddrConf.Parity,pConf->mAddrConf.DataBits,pConf->mAddrConf.StopBits), *pIOS);
-
-		if (MBSync->isNull())
+		else if(pConf->mAddrConf.SerialDevice != "")
 		{
-			std::string msg = Name + ": Stack error: 'Modbus stack creation failed'";
-			if(auto log = odc::spdlog_get("ModbusPort"))
-				log->error(msg);
-			throw std::runtime_error(msg);
+			pClient = std::make_shared<ModbusRTUClient>(pIOS, Name, pConf->mAddrConf,
+				pConf->mAddrConf.ResponseTimeoutms, auto_reopen, state_callback);
+		}
+		else
+		{
+			throw std::runtime_error(Name + ": No IP address or serial device defined");
 		}
-
-//Not needed? - doesn't work at least
-//		if(modbus_rtu_set_serial_mode(mb,MODBUS_RTU_RS232) == -1)
-//		{
-//			std::string msg = Name + ": Stack error: 'Failed to set Modbus serial mode to RS232'";
-//			auto log_entry = openpal::LogEntry("ModbusMasterPort", openpal::logflags::ERR,"", msg.c_str(), -1);
-//			pLoggers->Log(log_entry);
-//			throw std::runtime_error(msg);
-//		}
 	}
-	else
+	catch(const std::exception& e)
 	{
-		std::string msg = Name + ": No IP address or serial device defined";
 		if(auto log = odc::spdlog_get("ModbusPort"))
-			log->error(msg);
-		throw std::runtime_error(msg);
+			log->error(e.what());
+		throw;
 	}
 }
 
-void ModbusMasterPort::DoPoll(uint32_t pollgroup, modbus_t* mb)
+void ModbusMasterPort::DoPoll(uint32_t pollgroup)
 {
-	if(!enabled) return;
-
-	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
-	int rc;
+	if(!enabled || !stack_enabled) return;
 
-	// Modbus function code 0x01 (read coil status)
-	for(const auto& range : pConf->pPointConf->BitIndicies)
+	//The requests all go out at once - the client queues them, and the handlers publish as the responses arrive
+	//	The plan lives as long as the port, so the handlers can refer to it
+	//	A read that's still waiting from the last poll isn't queued again - a slow outstation would only build a backlog of stale polls
+	for(const auto& read : pReadPlan->Get(pollgroup))
 	{
-		if (pollgroup && (range.pollgroup != pollgroup))
-			continue;
-		if (range.count > modbus_read_buffer_size)
-		{
-			if(modbus_read_buffer != nullptr)
-				free(modbus_read_buffer);
-			modbus_read_buffer = malloc(range.count);
-			modbus_read_buffer_size = range.count;
-		}
-		rc = modbus_read_bits(mb, range.start, range.count, (uint8_t*)modbus_read_buffer);
-		if (rc == -1)
+		if(ReadPending[read.id].exchange(true))
 		{
-			HandleError(errno, "read bits poll");
-			if(!enabled) return;
-		}
-		else
-		{
-			uint16_t index = range.start;
-			for(uint16_t i = 0; i < rc; i++ )
-			{
-				auto event = std::make_shared<EventInfo>(EventType::BinaryOutputStatus,index,Name,QualityFlags::ONLINE);
-				event->SetPayload<EventType::BinaryOutputStatus>(((uint8_t*)modbus_read_buffer)[i] != false);
-				PublishEvent(event);
-				++index;
-			}
-		}
-	}
-
-	// Modbus function code 0x02 (read input status)
-	for(const auto& range : pConf->pPointConf->InputBitIndicies)
-	{
-		if (pollgroup && (range.pollgroup != pollgroup))
+			NumReadsSkipped++;
 			continue;
-		if (range.count > modbus_read_buffer_size)
-		{
-			if(modbus_read_buffer != nullptr)
-				free(modbus_read_buffer);
-			modbus_read_buffer = malloc(range.count);
-			modbus_read_buffer_size = range.count;
 		}
-		rc = modbus_read_input_bits(mb, range.start, range.count, (uint8_t*)modbus_read_buffer);
-		if (rc == -1)
-		{
-			HandleError(errno, "read input bits poll");
-			if(!enabled) return;
-		}
-		else
-		{
-			uint16_t index = range.start;
-			for(uint16_t i = 0; i < rc; i++ )
+		NumReadRequests++;
+		pClient->Request(ModbusReadRequest(read.fc,read.start,read.count),
+			[this,weak_self{weak_from_this()},&read](ModbusResponse& response)
 			{
-				auto event = std::make_shared<EventInfo>(EventType::Binary,index,Name,QualityFlags::ONLINE);
-				event->SetPayload<EventType::Binary>(((uint8_t*)modbus_read_buffer)[i] != false);
-				PublishEvent(event);
-				++index;
-			}
-		}
+				auto self = weak_self.lock();
+				if(!self)
+					return;
+				ReadPending[read.id] = false;
+				if(!enabled)
+					return;
+				if(response.Status != CommandStatus::SUCCESS || !pDecoder->Decode(read,response,PollEvents))
+				{
+					NumReadErrors++;
+					HandleError(response, "read poll (function "+std::to_string(static_cast<int>(read.fc))
+						+", start "+std::to_string(read.start)+", count "+std::to_string(read.count)+")");
+					return;
+				}
+				for(auto& event : PollEvents)
+					PublishEvent(event,pIgnoreStatus);
+				PollEvents.clear();
+			});
 	}
+}
 
-	// Modbus function code 0x03 (read holding registers)
-	for(const auto& range : pConf->pPointConf->RegIndicies)
+const Json::Value ModbusMasterPort::GetStatistics() const
+{
+	Json::Value stats;
+	if(pReadPlan)
 	{
-		if (pollgroup && (range.pollgroup != pollgroup))
-			continue;
-		if (range.count*2 > modbus_read_buffer_size)
-		{
-			if(modbus_read_buffer != nullptr)
-				free(modbus_read_buffer);
-			modbus_read_buffer = malloc(range.count*2);
-			modbus_read_buffer_size = range.count*2;
-		}
-		rc = modbus_read_registers(mb, range.start, range.count, (uint16_t*)modbus_read_buffer);
-		if (rc == -1)
-		{
-			HandleError(errno, "read registers poll");
-			if(!enabled) return;
-		}
-		else
-		{
-			uint16_t index = range.start;
-			for(uint16_t i = 0; i < rc; i++ )
-			{
-				auto event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16,index,Name,QualityFlags::ONLINE);
-				auto payload = AO16(((uint16_t*)modbus_read_buffer)[i],CommandStatus::SUCCESS);
-				event->SetPayload<EventType::AnalogOutputInt16>(std::move(payload));
-				PublishEvent(event);
-				++index;
-			}
-		}
+		stats["readplan"]["numConfiguredRanges"] = Json::UInt64(pReadPlan->ConfiguredRanges());
+		stats["readplan"]["numPlannedRequests"] = Json::UInt64(pReadPlan->PlannedRequests());
 	}
-
-	// Modbus function code 0x04 (read input registers)
-	for(const auto& range : pConf->pPointConf->InputRegIndicies)
+	stats["numReadRequests"] = Json::UInt64(NumReadRequests);
+	stats["numReadErrors"] = Json::UInt64(NumReadErrors);
+	stats["numReadsSkipped"] = Json::UInt64(NumReadsSkipped);
+	if(pDecoder)
+		stats["numUnchangedSuppressed"] = Json::UInt64(pDecoder->GetSuppressed());
+	if(pClient)
 	{
-		if (pollgroup && (range.pollgroup != pollgroup))
-			continue;
-		if (range.count*2 > modbus_read_buffer_size)
-		{
-			if(modbus_read_buffer != nullptr)
-				free(modbus_read_buffer);
-			modbus_read_buffer = malloc(range.count*2);
-			modbus_read_buffer_size = range.count*2;
-		}
-		rc = modbus_read_input_registers(mb, range.start, range.count, (uint16_t*)modbus_read_buffer);
-		if (rc == -1)
-		{
-			HandleError(errno, "read input registers poll");
-			if(!enabled) return;
-		}
-		else
-		{
-			uint16_t index = range.start;
-			for(uint16_t i = 0; i < rc; i++ )
-			{
-				auto event = std::make_shared<EventInfo>(EventType::Analog,index,Name,QualityFlags::ONLINE);
-				event->SetPayload<EventType::Analog>(double(((uint16_t*)modbus_read_buffer)[i]));
-				PublishEvent(event);
-				++index;
-			}
-		}
+		auto client_stats = pClient->GetStatistics();
+		if(!client_stats.isNull())
+			stats["client"] = client_stats;
 	}
+	return stats;
 }
 
 template <EventType t>
-ModbusReadGroup *ModbusMasterPort::GetRange(uint16_t index)
+const ModbusReadGroup* ModbusMasterPort::GetRange(uint16_t index)
 {
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
-	ModbusReadGroupCollection collection;
-	switch(t)
-	{
-		case EventType::Analog:
-			collection = pConf->pPointConf->RegIndicies; break;
-		case EventType::Binary:
-			collection = pConf->pPointConf->BitIndicies; break;
-	}
-	for(auto& range : collection)
+	const ModbusReadGroupCollection& collection = (t == EventType::Binary) ? pConf->pPointConf->BitIndicies : pConf->pPointConf->RegIndicies;
+	for(const auto& range : collection)
 	{
 		if ((index >= range.start) && (index < range.start + range.count))
 			return &range;
@@ -448,92 +289,84 @@ ModbusReadGroup *ModbusMasterPort::GetRange(uint16_t index)
 	return nullptr;
 }
 
-CommandStatus ModbusMasterPort::WriteObject(modbus_t *mb, const ControlRelayOutputBlock& command, uint16_t index)
+void ModbusMasterPort::Write(std::vector<uint8_t>&& PDU, const ModbusReadGroup* TargetRange, const std::string& source, SharedStatusCallback_t pStatusCallback)
+{
+	const auto pollgroup = TargetRange->pollgroup;
+	pClient->Request(std::move(PDU),[this,weak_self{weak_from_this()},pollgroup,source,pStatusCallback](ModbusResponse& response)
+		{
+			auto self = weak_self.lock();
+			if(self && response.Status != CommandStatus::SUCCESS)
+				HandleError(response, source);
+
+			// If the index is part of a non-zero pollgroup, queue a poll task for the group
+			if(self && pollgroup > 0)
+				DoPoll(pollgroup);
+
+			(*pStatusCallback)(response.Status);
+		});
+}
+
+void ModbusMasterPort::WriteObject(const ControlRelayOutputBlock& command, uint16_t index, SharedStatusCallback_t pStatusCallback)
 {
 	if (
 		(command.functionCode == ControlCode::NUL) ||
 		(command.functionCode == ControlCode::UNDEFINED)
 		)
 	{
-		return CommandStatus::NOT_SUPPORTED;
+		return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
 	}
 
 	// Modbus function code 0x01 (read coil status)
-	ModbusReadGroup* TargetRange = GetRange<EventType::Binary>(index);
-	if (TargetRange == nullptr) return CommandStatus::NOT_SUPPORTED;
+	auto TargetRange = GetRange<EventType::Binary>(index);
+	if (TargetRange == nullptr) return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
 
-	int rc;
+	bool value;
 	if (
 		(command.functionCode == ControlCode::LATCH_OFF) ||
 		(command.functionCode == ControlCode::TRIP_PULSE_ON)
 		)
 	{
-		rc = modbus_write_bit(mb, index, false);
+		value = false;
 	}
 	else
 	{
 		//ControlCode::PULSE_CLOSE || ControlCode::PULSE || ControlCode::LATCH_ON
-		rc = modbus_write_bit(mb, index, true);
+		value = true;
 	}
 
-	// If the index is part of a non-zero pollgroup, queue a poll task for the group
-	if (TargetRange->pollgroup > 0)
-		MBSync->Execute([=](modbus_t* mb)
-			{
-				DoPoll(TargetRange->pollgroup,mb);
-			});
-
-	if (rc == -1) return HandleWriteError(errno, "write bit");
-	return CommandStatus::SUCCESS;
+	Write(ModbusWriteCoilRequest(index,value), TargetRange, "write bit", pStatusCallback);
 }
 
-CommandStatus ModbusMasterPort::WriteObject(modbus_t* mb, const int16_t output, uint16_t index)
+void ModbusMasterPort::WriteObject(const int16_t output, uint16_t index, SharedStatusCallback_t pStatusCallback)
 {
-	ModbusReadGroup* TargetRange = GetRange<EventType::Analog>(index);
-	if (TargetRange == nullptr) return CommandStatus::NOT_SUPPORTED;
-
-	int rc = modbus_write_register(mb, index, output);
+	auto TargetRange = GetRange<EventType::Analog>(index);
+	if (TargetRange == nullptr) return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
+	if (TargetRange->codec) return WriteTyped(output, index, TargetRange, pStatusCallback);
 
-	// If the index is part of a non-zero pollgroup, queue a poll task for the group
-	if (TargetRange->pollgroup > 0)
-		MBSync->Execute([=](modbus_t* mb)
-			{
-				DoPoll(TargetRange->pollgroup,mb);
-			});
-
-	if (rc == -1) return HandleWriteError(errno, "write register");
-	return CommandStatus::SUCCESS;
+	Write(ModbusWriteRegisterRequest(index,static_cast<uint16_t>(output)), TargetRange, "write register", pStatusCallback);
 }
 
-CommandStatus ModbusMasterPort::WriteObject(modbus_t* mb, const int32_t output, uint16_t index)
+void ModbusMasterPort::WriteObject(const int32_t output, uint16_t index, SharedStatusCallback_t pStatusCallback)
 {
-	ModbusReadGroup* TargetRange = GetRange<EventType::Analog>(index);
-	if (TargetRange == nullptr) return CommandStatus::NOT_SUPPORTED;
+	auto TargetRange = GetRange<EventType::Analog>(index);
+	if (TargetRange == nullptr) return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
+	if (TargetRange->codec) return WriteTyped(output, index, TargetRange, pStatusCallback);
 
 	if(output > std::numeric_limits<int16_t>::max() || output < std::numeric_limits<int16_t>::min())
 	{
 		if(auto log = odc::spdlog_get("ModbusPort"))
 			log->error("Analog overrange for 16-bit modbus write to index {}",index);
-		return CommandStatus::OUT_OF_RANGE;
+		return (*pStatusCallback)(CommandStatus::OUT_OF_RANGE);
 	}
 
-	int rc = modbus_write_register(mb, index, static_cast<int16_t>(output));
-
-	// If the index is part of a non-zero pollgroup, queue a poll task for the group
-	if (TargetRange->pollgroup > 0)
-		MBSync->Execute([=](modbus_t* mb)
-			{
-				DoPoll(TargetRange->pollgroup,mb);
-			});
-
-	if (rc == -1) return HandleWriteError(errno, "write register");
-	return CommandStatus::SUCCESS;
+	Write(ModbusWriteRegisterRequest(index,static_cast<uint16_t>(static_cast<int16_t>(output))), TargetRange, "write register", pStatusCallback);
 }
 
-CommandStatus ModbusMasterPort::WriteObject(modbus_t* mb, const double output, uint16_t index)
+void ModbusMasterPort::WriteObject(const double output, uint16_t index, SharedStatusCallback_t pStatusCallback)
 {
-	ModbusReadGroup* TargetRange = GetRange<EventType::Analog>(index);
-	if (TargetRange == nullptr) return CommandStatus::NOT_SUPPORTED;
+	auto TargetRange = GetRange<EventType::Analog>(index);
+	if (TargetRange == nullptr) return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
+	if (TargetRange->codec) return WriteTyped(output, index, TargetRange, pStatusCallback);
 
 	//TODO: implement scaling in the config - hard code for now:
 	auto scaled_float = output * 100;
@@ -541,30 +374,44 @@ CommandStatus ModbusMasterPort::WriteObject(modbus_t* mb, const double output, u
 	{
 		if(auto log = odc::spdlog_get("ModbusPort"))
 			log->error("Scaled float overrange for 16-bit modbus write to index {}",index);
-		return CommandStatus::OUT_OF_RANGE;
+		return (*pStatusCallback)(CommandStatus::OUT_OF_RANGE);
 	}
 
 	uint16_t scaled_output = static_cast<int16_t>(scaled_float);
-	int rc = modbus_write_register(mb, index, scaled_output);
+	Write(ModbusWriteRegisterRequest(index,scaled_output), TargetRange, "write register", pStatusCallback);
+}
+void ModbusMasterPort::WriteTyped(const double output, uint16_t index, const ModbusReadGroup* TargetRange, SharedStatusCallback_t pStatusCallback)
+{
+	const auto& codec = *TargetRange->codec;
+	if ((index - TargetRange->start) % codec.Width())
+	{
+		if(auto log = odc::spdlog_get("ModbusPort"))
+			log->error("{}: Write to index {} isn't aligned to a {}-register value", Name, index, codec.Width());
+		return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
+	}
 
-	// If the index is part of a non-zero pollgroup, queue a poll task for the group
-	if (TargetRange->pollgroup > 0)
-		MBSync->Execute([=](modbus_t* mb)
-			{
-				DoPoll(TargetRange->pollgroup,mb);
-			});
+	uint16_t regs[2];
+	if (!codec.Encode(output, regs))
+	{
+		if(auto log = odc::spdlog_get("ModbusPort"))
+			log->error("{}: Value {} overrange for modbus write to index {}", Name, output, index);
+		return (*pStatusCallback)(CommandStatus::OUT_OF_RANGE);
+	}
 
-	if (rc == -1) return HandleWriteError(errno, "write register");
-	return CommandStatus::SUCCESS;
+	if (codec.Width() == 1)
+		Write(ModbusWriteRegisterRequest(index,regs[0]), TargetRange, "write register", pStatusCallback);
+	else
+		Write(ModbusWriteRegistersRequest(index,regs,codec.Width()), TargetRange, "write registers", pStatusCallback);
 }
-CommandStatus ModbusMasterPort::WriteObject(modbus_t *mb, const float output, uint16_t index)
+
+void ModbusMasterPort::WriteObject(const float output, uint16_t index, SharedStatusCallback_t pStatusCallback)
 {
-	return WriteObject(mb, static_cast<double>(output),index);
+	WriteObject(static_cast<double>(output),index,pStatusCallback);
 }
 
 void ModbusMasterPort::Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback)
 {
-	if(!enabled)
+	if(!enabled || !pClient)
 	{
 		(*pStatusCallback)(CommandStatus::UNDEFINED);
 		return;
@@ -572,26 +419,18 @@ void ModbusMasterPort::Event(std::shared_ptr<const EventInfo> event, const std::
 
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
-	auto write = [=](auto payload)
-			 {
-				 MBSync->Execute([=](modbus_t* mb)
-					 {
-						 (*pStatusCallback)(WriteObject(mb, payload, event->GetIndex()));
-					 });
-			 };
-
 	switch(event->GetEventType())
 	{
 		case EventType::ControlRelayOutputBlock:
-			return write(event->GetPayload<EventType::ControlRelayOutputBlock>());
+			return WriteObject(event->GetPayload<EventType::ControlRelayOutputBlock>(), event->GetIndex(), pStatusCallback);
 		case EventType::AnalogOutputInt16:
-			return write(event->GetPayload<EventType::AnalogOutputInt16>().first);
+			return WriteObject(event->GetPayload<EventType::AnalogOutputInt16>().first, event->GetIndex(), pStatusCallback);
 		case EventType::AnalogOutputInt32:
-			return write(event->GetPayload<EventType::AnalogOutputInt32>().first);
+			return WriteObject(event->GetPayload<EventType::AnalogOutputInt32>().first, event->GetIndex(), pStatusCallback);
 		case EventType::AnalogOutputFloat32:
-			return write(event->GetPayload<EventType::AnalogOutputFloat32>().first);
+			return WriteObject(event->GetPayload<EventType::AnalogOutputFloat32>().first, event->GetIndex(), pStatusCallback);
 		case EventType::AnalogOutputDouble64:
-			return write(event->GetPayload<EventType::AnalogOutputDouble64>().first);
+			return WriteObject(event->GetPayload<EventType::AnalogOutputDouble64>().first, event->GetIndex(), pStatusCallback);
 		case EventType::ConnectState:
 		{
 			auto state = event->GetPayload<EventType::ConnectState>();
@@ -601,12 +440,7 @@ void ModbusMasterPort::Event(std::shared_ptr<const EventInfo> event, const std::
 			{
 				// Only change stack state if it is an on demand server
 				if (pConf->mAddrConf.ServerType == server_type_t::ONDEMAND)
-				{
-					MBSync->Execute([=](modbus_t* mb)
-						{
-							Connect(mb);
-						});
-				}
+					Connect();
 			}
 			else if (state == ConnectState::DISCONNECTED)
 			{
@@ -622,7 +456,3 @@ void ModbusMasterPort::Event(std::shared_ptr<const EventInfo> event, const std::
 			return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
 	}
 }
-
-
-
-
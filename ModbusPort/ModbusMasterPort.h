@@ -26,7 +26,10 @@
 
 #ifndef ModbusCLIENTPORT_H_
 #define ModbusCLIENTPORT_H_
+#include "ModbusClient.h"
+#include "ModbusPollDecoder.h"
 #include "ModbusPort.h"
+#include "ModbusReadPlan.h"
 #include <queue>
 #include <opendatacon/ASIOScheduler.h>
 #include <utility>
@@ -67,9 +70,7 @@ class ModbusMasterPort: public ModbusPort
 {
 public:
 	ModbusMasterPort(const std::string& aName, const std::string& aConfFilename, const Json::Value& aConfOverrides):
-		ModbusPort(aName, aConfFilename, aConfOverrides),
-		modbus_read_buffer(nullptr),
-		modbus_read_buffer_size(0)
+		ModbusPort(aName, aConfFilename, aConfOverrides)
 	{}
 
 	~ModbusMasterPort() override;
@@ -77,32 +78,43 @@ public:
 	// Implement ModbusPort
 	void Enable() override;
 	void Disable() override final;
-	void Connect(modbus_t *mb);
+	void Connect();
 	void Disconnect();
 	void Build() override;
 
 	void Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback) override;
 
+	const Json::Value GetStatistics() const override;
+
 private:
-	CommandStatus WriteObject(modbus_t* mb, const ControlRelayOutputBlock& output, uint16_t index);
-	CommandStatus WriteObject(modbus_t* mb, const int16_t output, uint16_t index);
-	CommandStatus WriteObject(modbus_t* mb, const int32_t output, uint16_t index);
-	CommandStatus WriteObject(modbus_t* mb, const double output, uint16_t index);
-	CommandStatus WriteObject(modbus_t* mb, const float output, uint16_t index);
+	void WriteObject(const ControlRelayOutputBlock& output, uint16_t index, SharedStatusCallback_t pStatusCallback);
+	void WriteObject(const int16_t output, uint16_t index, SharedStatusCallback_t pStatusCallback);
+	void WriteObject(const int32_t output, uint16_t index, SharedStatusCallback_t pStatusCallback);
+	void WriteObject(const double output, uint16_t index, SharedStatusCallback_t pStatusCallback);
+	void WriteObject(const float output, uint16_t index, SharedStatusCallback_t pStatusCallback);
+	void WriteTyped(const double output, uint16_t index, const ModbusReadGroup* TargetRange, SharedStatusCallback_t pStatusCallback);
+	void Write(std::vector<uint8_t>&& PDU, const ModbusReadGroup* TargetRange, const std::string& source, SharedStatusCallback_t pStatusCallback);
 
-	void DoPoll(uint32_t pollgroup, modbus_t *mb);
+	void DoPoll(uint32_t pollgroup);
 
 private:
-	void HandleError(int errnum, const std::string& source);
-	CommandStatus HandleWriteError(int errnum, const std::string& source);
+	void ConnectionState(bool connected);
+	void StackDown();
+	void HandleError(const ModbusResponse& response, const std::string& source);
 
 	template<EventType t>
-	ModbusReadGroup* GetRange(uint16_t index);
-
-	void* modbus_read_buffer;
-	size_t modbus_read_buffer_size;
-	typedef asio::basic_waitable_timer<std::chrono::steady_clock> Timer_t;
-	std::unique_ptr<Timer_t> pTCPRetryTimer;
+	const ModbusReadGroup* GetRange(uint16_t index);
+
+	std::shared_ptr<ModbusClient> pClient;
+	std::unique_ptr<const ModbusReadPlan> pReadPlan;
+	std::unique_ptr<ModbusPollDecoder> pDecoder;
+	std::vector<std::shared_ptr<EventInfo>> PollEvents; //only used by the (serialised) response handlers
+	const SharedStatusCallback_t pIgnoreStatus = std::make_shared<std::function<void (CommandStatus status)>>([] (CommandStatus status){});
+	std::atomic<uint64_t> NumReadRequests = 0;
+	std::atomic<uint64_t> NumReadErrors = 0;
+	std::atomic<uint64_t> NumReadsSkipped = 0;
+	//one flag per planned read (by id), set while it's queued or in flight
+	std::unique_ptr<std::atomic_bool[]> ReadPending;
 	std::unique_ptr<ASIOScheduler> PollScheduler;
 };
 
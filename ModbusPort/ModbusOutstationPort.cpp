@@ -27,6 +27,8 @@
 #define NOMINMAX
 
 #include "ModbusOutstationPort.h"
+#include "ModbusPDU.h"
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <opendatacon/util.h>
@@ -39,8 +41,6 @@ ModbusOutstationPort::ModbusOutstationPort(const std::string& aName, const std::
 ModbusOutstationPort::~ModbusOutstationPort()
 {
 	Disable();
-	if (mb_mapping != nullptr)
-		modbus_mapping_free(mb_mapping);
 }
 
 void ModbusOutstationPort::Enable()
@@ -63,39 +63,19 @@ void ModbusOutstationPort::Connect()
 	if(!enabled) return;
 	if (stack_enabled) return;
 
-	stack_enabled = true;
-
-	if (MBSync->isNull())
+	if (!pServer)
 	{
 		if(auto log = odc::spdlog_get("ModbusPort"))
 			log->error("{}: Connect error: 'Modbus stack failed'", Name);
 		return;
 	}
 
-	MBSync->Execute([this](modbus_t* mb)
-		{
-			int s = modbus_tcp_pi_listen(mb, 1);
-			if (s == -1)
-			{
-			      if(auto log = odc::spdlog_get("ModbusPort"))
-					log->warn("{}: Connect error: '{}'", Name, modbus_strerror(errno));
-			      return;
-			}
-
-			int r = modbus_tcp_pi_accept(mb, &s);
-			if (r == -1)
-			{
-			      if(auto log = odc::spdlog_get("ModbusPort"))
-					log->warn("{}: Connect error: '{}'", Name, modbus_strerror(errno));
-			      return;
-			}
-			PublishEvent(ConnectState::CONNECTED);
-		});
+	stack_enabled = true;
+	pServer->Start();
 }
 
 void ModbusOutstationPort::Disable()
 {
-	//cancel the retry timers (otherwise it would tie up the io_service on shutdown)
 	Disconnect();
 	enabled = false;
 }
@@ -105,58 +85,69 @@ void ModbusOutstationPort::Disconnect()
 	if (!stack_enabled) return;
 	stack_enabled = false;
 
-	if(MBSync->isNull())
-		return;
-	MBSync->Execute([this](modbus_t* mb)
-		{
-			modbus_close(mb);
-			PublishEvent(ConnectState::DISCONNECTED);
-		});
+	//closes all the client connections too
+	pServer->Stop();
+}
+
+void ModbusOutstationPort::ConnectionCount(const size_t count)
+{
+	//connected as long as any master is
+	if(count > 0 && Connections == 0)
+		PublishEvent(ConnectState::CONNECTED);
+	else if(count == 0 && Connections > 0)
+		PublishEvent(ConnectState::DISCONNECTED);
+	Connections = count;
 }
 
 void ModbusOutstationPort::Build()
 {
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
 
-	std::string log_id;
+	pRegisterMap = std::make_unique<ModbusRegisterMap>(*pConf->pPointConf);
+
+	//start values - only the analog and binary tables take them
+	auto load_startvals = [this](const ModbusReadGroupCollection& collection, bool bits, ModbusRegisterMap::Table table)
+				    {
+					    for(const auto& group : collection)
+					    {
+						    if(!group.startval || (group.startval->GetQuality() & QualityFlags::ONLINE) != QualityFlags::ONLINE)
+							    continue;
+						    for(auto index = group.start + group.index_offset; index < group.start + group.index_offset + group.count; index += group.width())
+						    {
+							    if(bits)
+								    LoadBit(table, collection, index, group.startval->GetPayload<EventType::Binary>());
+							    else
+								    LoadRegisters(table, collection, index, group.startval->GetPayload<EventType::Analog>(), 100);
+						    }
+					    }
+				    };
+	load_startvals(pConf->pPointConf->BitIndicies, true, ModbusRegisterMap::Table::COILS);
+	load_startvals(pConf->pPointConf->InputBitIndicies, true, ModbusRegisterMap::Table::INPUT_BITS);
+	load_startvals(pConf->pPointConf->RegIndicies, false, ModbusRegisterMap::Table::HOLDING_REGISTERS);
+	load_startvals(pConf->pPointConf->InputRegIndicies, false, ModbusRegisterMap::Table::INPUT_REGISTERS);
 
 	if(pConf->mAddrConf.IP != "")
 	{
-		log_id = "outst_" + pConf->mAddrConf.IP + ":" + std::to_string(pConf->mAddrConf.Port);
-
-		//TODO: collect these on a collection of modbus tcp connections
-		MBSync = std::make_unique<ModbusExecutor>(
-			modbus_new_tcp_pi(pConf->mAddrConf.IP.c_str(), std::to_string(pConf->mAddrConf.Port).c_str()),*pIOS);
-		if (MBSync->isNull())
-		{
-			if(auto log = odc::spdlog_get("ModbusPort"))
-				log->error("{}: Stack error: 'Modbus stack creation failed'", Name);
-			//TODO: should this throw an exception instead of return?
-			return;
-		}
+		//Handlers on the server only hold weak references to the port
+		std::weak_ptr<DataPort> weak_self = weak_from_this();
+		pServer = std::make_shared<ModbusTCPServer>(pIOS, Name, pConf->mAddrConf.IP, pConf->mAddrConf.Port, pConf->mAddrConf.MaxConnections,
+			[this,weak_self](std::vector<uint8_t>&& PDU, const uint8_t UnitID, const ModbusTCPServer::Reply_t& Reply)
+			{
+				if(auto self = weak_self.lock())
+					HandleRequest(std::move(PDU), UnitID, Reply);
+			},
+			[this,weak_self](size_t count)
+			{
+				if(auto self = weak_self.lock())
+					ConnectionCount(count);
+			});
 	}
 	else if(pConf->mAddrConf.SerialDevice != "")
 	{
-		log_id = "outst_" + pConf->mAddrConf.SerialDevice;
-		MBSync = std::make_unique<ModbusExecutor>(
-			modbus_new_rtu(pConf->mAddrConf.SerialDevice.c_str(),pConf->mAddrConf.BaudRate,(char)pConf->mAddrConf.Parity,pConf->mAddrConf.DataBits,pConf->mAddrConf.StopBits), *pIOS);
-		if (MBSync->isNull())
-		{
-			if(auto log = odc::spdlog_get("ModbusPort"))
-				log->error("{}: Stack error: 'Modbus stack creation failed'", Name);
-			//TODO: should this throw an exception instead of return?
-			return;
-		}
-		MBSync->Execute([this](modbus_t* mb)
-			{
-				if(modbus_rtu_set_serial_mode(mb,MODBUS_RTU_RS232))
-				{
-				      if(auto log = odc::spdlog_get("ModbusPort"))
-						log->error("{}: Stack error: 'Failed to set Modbus serial mode to RS232'", Name);
-				//TODO: should this throw an exception instead of return?
-				      return;
-				}
-			});
+		if(auto log = odc::spdlog_get("ModbusPort"))
+			log->error("{}: Modbus serial outstation isn't supported - use IP", Name);
+		//TODO: should this throw an exception instead of return?
+		return;
 	}
 	else
 	{
@@ -165,96 +156,351 @@ void ModbusOutstationPort::Build()
 		//TODO: should this throw an exception instead of return?
 		return;
 	}
+}
 
+//Finds the configured group holding the point index, and the modbus address it maps to
+static const ModbusReadGroup* find_group(const ModbusReadGroupCollection& aCollection, uint16_t index, uint32_t& address)
+{
+	for(const auto& group : aCollection)
+		if(index >= group.start + group.index_offset && index < group.start + group.index_offset + group.count)
+		{
+			address = index - group.index_offset;
+			return &group;
+		}
+	return nullptr;
+}
 
-	//Allocate memory for bits, input bits, registers, and input registers */
-	mb_mapping = modbus_mapping_new(pConf->pPointConf->BitIndicies.Total(),
-		pConf->pPointConf->InputBitIndicies.Total(),
-		pConf->pPointConf->RegIndicies.Total(),
-		pConf->pPointConf->InputRegIndicies.Total());
-	if (mb_mapping == nullptr)
+//Finds the configured group holding a modbus address
+static const ModbusReadGroup* find_group_by_address(const ModbusReadGroupCollection& aCollection, uint32_t address)
+{
+	for(const auto& group : aCollection)
+		if(address >= group.start && address < group.start + group.count)
+			return &group;
+	return nullptr;
+}
+
+static uint8_t StatusToException(const CommandStatus status)
+{
+	switch(status)
 	{
-		if(auto log = odc::spdlog_get("ModbusPort"))
-			log->error("{}: Failed to allocate the modbus register mapping: {}", Name, modbus_strerror(errno));
-		//TODO: should this throw an exception instead of return?
-		return;
+		case CommandStatus::NOT_SUPPORTED:
+			return 0x01; //Illegal function
+		case CommandStatus::FORMAT_ERROR:
+		case CommandStatus::OUT_OF_RANGE:
+			return 0x03; //Illegal data value
+		default:
+			return 0x04; //Slave device failure
 	}
 }
 
-int find_index (const ModbusReadGroupCollection& aCollection, uint16_t index)
+CommandStatus ModbusOutstationPort::LoadRegisters(const ModbusRegisterMap::Table table, const ModbusReadGroupCollection& collection, const uint16_t index, const double value, const double legacy_scale)
 {
-	for(const auto& group : aCollection)
-		for(auto group_index = group.start; group_index < group.start + group.count; group_index++)
-			if(group_index + group.index_offset == index)
-				return (int)group_index;
-	return -1;
+	uint32_t address;
+	auto group = find_group(collection, index, address);
+	if(!group)
+		return CommandStatus::NOT_SUPPORTED;
+
+	uint16_t regs[2];
+	if(group->codec)
+	{
+		if((address - group->start) % group->codec->Width())
+		{
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("{}: Index {} isn't aligned to a {}-register value", Name, index, group->codec->Width());
+			return CommandStatus::NOT_SUPPORTED;
+		}
+		if(!group->codec->Encode(value, regs))
+		{
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("{}: Value overrange for modbus load to index {}", Name, index);
+			return CommandStatus::OUT_OF_RANGE;
+		}
+	}
+	else
+	{
+		//no descriptor configured - legacy fixed scaling
+		auto scaled_float = value*legacy_scale;
+		if(scaled_float > std::numeric_limits<int16_t>::max() || scaled_float < std::numeric_limits<int16_t>::min())
+		{
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("Scaled float overrange for 16-bit modbus load to index {}",index);
+			return CommandStatus::OUT_OF_RANGE;
+		}
+		regs[0] = static_cast<int16_t>(scaled_float);
+	}
+
+	pRegisterMap->SetRegisters(table, address, regs, group->width());
+	return CommandStatus::SUCCESS;
+}
+
+bool ModbusOutstationPort::LoadBit(const ModbusRegisterMap::Table table, const ModbusReadGroupCollection& collection, const uint16_t index, const bool value)
+{
+	uint32_t address;
+	if(!find_group(collection, index, address))
+		return false;
+	pRegisterMap->SetBit(table, address, value);
+	return true;
 }
 
 void ModbusOutstationPort::Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback)
 {
-	if(!enabled)
+	if(!enabled || !pRegisterMap)
 	{
 		(*pStatusCallback)(CommandStatus::UNDEFINED);
 		return;
 	}
 
 	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
-	auto event_type = event->GetEventType();
+	const auto& points = *pConf->pPointConf;
 	auto index = event->GetIndex();
 
-	if(event_type == EventType::Analog)
+	//analogs go to the input registers, or else the holding registers
+	auto load_analog = [&](double value, double legacy_scale)
+				 {
+					 uint32_t address;
+					 if(find_group(points.InputRegIndicies, index, address))
+						 return LoadRegisters(ModbusRegisterMap::Table::INPUT_REGISTERS, points.InputRegIndicies, index, value, legacy_scale);
+					 return LoadRegisters(ModbusRegisterMap::Table::HOLDING_REGISTERS, points.RegIndicies, index, value, legacy_scale);
+				 };
+
+	switch(event->GetEventType())
 	{
-		//TODO: scaling option in config - use 100 for now
-		auto scaled_float = event->GetPayload<EventType::Analog>()*100;
-		if(scaled_float > std::numeric_limits<int16_t>::max() || scaled_float < std::numeric_limits<int16_t>::min())
+		case EventType::Analog:
+			//TODO: scaling option in config - use 100 for now
+			return (*pStatusCallback)(load_analog(event->GetPayload<EventType::Analog>(),100));
+		//output statuses are what a master publishes for holding registers and coils - pass them straight through
+		case EventType::AnalogOutputInt16:
+			return (*pStatusCallback)(LoadRegisters(ModbusRegisterMap::Table::HOLDING_REGISTERS, points.RegIndicies, index, event->GetPayload<EventType::AnalogOutputInt16>().first, 1));
+		case EventType::AnalogOutputInt32:
+			return (*pStatusCallback)(LoadRegisters(ModbusRegisterMap::Table::HOLDING_REGISTERS, points.RegIndicies, index, event->GetPayload<EventType::AnalogOutputInt32>().first, 1));
+		case EventType::AnalogOutputFloat32:
+			return (*pStatusCallback)(LoadRegisters(ModbusRegisterMap::Table::HOLDING_REGISTERS, points.RegIndicies, index, event->GetPayload<EventType::AnalogOutputFloat32>().first, 1));
+		case EventType::AnalogOutputDouble64:
+			return (*pStatusCallback)(LoadRegisters(ModbusRegisterMap::Table::HOLDING_REGISTERS, points.RegIndicies, index, event->GetPayload<EventType::AnalogOutputDouble64>().first, 1));
+		case EventType::Binary:
 		{
-			if(auto log = odc::spdlog_get("ModbusPort"))
-				log->error("Scaled float overrange for 16-bit modbus load to index {}",index);
-			return (*pStatusCallback)(CommandStatus::OUT_OF_RANGE);
+			const bool val = event->GetPayload<EventType::Binary>();
+			const bool loaded = LoadBit(ModbusRegisterMap::Table::INPUT_BITS, points.InputBitIndicies, index, val)
+			                    || LoadBit(ModbusRegisterMap::Table::COILS, points.BitIndicies, index, val);
+			return (*pStatusCallback)(loaded ? CommandStatus::SUCCESS : CommandStatus::NOT_SUPPORTED);
 		}
-
-		int map_index = find_index(pConf->pPointConf->InputRegIndicies, index);
-		if(map_index >= 0)
-			*(mb_mapping->tab_input_registers + index) = static_cast<int16_t>(scaled_float);
-		else
+		case EventType::BinaryOutputStatus:
 		{
-			map_index = find_index(pConf->pPointConf->RegIndicies, index);
-			if(map_index >= 0)
-				*(mb_mapping->tab_registers + index) = static_cast<int16_t>(scaled_float);
+			const bool loaded = LoadBit(ModbusRegisterMap::Table::COILS, points.BitIndicies, index, event->GetPayload<EventType::BinaryOutputStatus>());
+			return (*pStatusCallback)(loaded ? CommandStatus::SUCCESS : CommandStatus::NOT_SUPPORTED);
 		}
+		//TODO: impl other types
+		default:
+			return (*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
+	}
+}
 
-		if(map_index == 0)
+void ModbusOutstationPort::PublishCommands(std::vector<std::shared_ptr<EventInfo>>&& events, std::function<void(CommandStatus)>&& done)
+{
+	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
+
+	//done gets called exactly once - with the first failure, or success once all are successful,
+	//	or TIMEOUT if there's no answer (eg. nothing is connected to take the commands)
+	auto pending = std::make_shared<std::atomic<size_t>>(events.size());
+	auto replied = std::make_shared<std::atomic_bool>(false);
+	auto pDone = std::make_shared<std::function<void(CommandStatus)>>(std::move(done));
+	std::shared_ptr<asio::steady_timer> pTimer = pIOS->make_steady_timer(std::chrono::milliseconds(pConf->mAddrConf.ResponseTimeoutms));
+	pTimer->async_wait([replied,pDone,pTimer](asio::error_code err_code)
 		{
-			(*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
-			return;
-		}
+			if(!err_code && !replied->exchange(true))
+				(*pDone)(CommandStatus::TIMEOUT);
+		});
 
-		(*pStatusCallback)(CommandStatus::SUCCESS);
-		return;
-	}
-	else if(event_type == EventType::Binary)
+	auto pStatusCallback = std::make_shared<std::function<void (CommandStatus status)>>([pending,replied,pDone,pTimer](CommandStatus status)
+		{
+			if(status != CommandStatus::SUCCESS)
+			{
+				if(!replied->exchange(true))
+				{
+					pTimer->cancel();
+					(*pDone)(status);
+				}
+				return;
+			}
+			if(--(*pending) == 0 && !replied->exchange(true))
+			{
+				pTimer->cancel();
+				(*pDone)(CommandStatus::SUCCESS);
+			}
+		});
+
+	for(auto& event : events)
+		PublishEvent(event, pStatusCallback);
+}
+
+void ModbusOutstationPort::HandleRequest(std::vector<uint8_t>&& PDU, const uint8_t UnitID, const ModbusTCPServer::Reply_t& Reply)
+{
+	auto pConf = static_cast<ModbusPortConf*>(this->pConf.get());
+	const auto& points = *pConf->pPointConf;
+
+	//0 and 255 are commonly used to address whatever is on the other end of a TCP connection
+	if(UnitID != pConf->mAddrConf.OutstationAddr && UnitID != 0 && UnitID != 0xFF)
+		return Reply({});
+	if(PDU.empty() || !enabled)
+		return Reply({});
+
+	const uint8_t fc = PDU[0];
+	auto exception = [&](uint8_t code)
+			     {
+				     Reply({static_cast<uint8_t>(fc | 0x80), code});
+			     };
+	auto reply_status = [fc,Reply](std::vector<uint8_t>&& response)
+				  {
+					  return [fc,Reply,response{std::move(response)}](CommandStatus status) mutable
+						   {
+							   if(status == CommandStatus::SUCCESS)
+								   Reply(std::move(response));
+							   else
+								   Reply({static_cast<uint8_t>(fc | 0x80), StatusToException(status)});
+						   };
+				  };
+
+	switch(static_cast<ModbusFunction>(fc))
 	{
-		int map_index = find_index(pConf->pPointConf->InputBitIndicies, index);
-		if(map_index >= 0)
-			*(mb_mapping->tab_input_bits + index) = event->GetPayload<EventType::Binary>();
-		else
+		// Modbus function code 0x01 (read coil status)
+		// Modbus function code 0x02 (read input status)
+		case ModbusFunction::READ_COILS:
+		case ModbusFunction::READ_DISCRETE_INPUTS:
 		{
-			map_index = find_index(pConf->pPointConf->BitIndicies, index);
-			if(map_index >= 0)
-				*(mb_mapping->tab_bits + index) = event->GetPayload<EventType::Binary>();
+			if(PDU.size() != 5)
+				return exception(0x03);
+			const uint16_t start = GetBE16(PDU.data()+1);
+			const uint16_t count = GetBE16(PDU.data()+3);
+			if(count < 1 || count > 2000)
+				return exception(0x03);
+			const auto table = (fc == 0x01) ? ModbusRegisterMap::Table::COILS : ModbusRegisterMap::Table::INPUT_BITS;
+			if(!pRegisterMap->Valid(table, start, count))
+				return exception(0x02);
+			std::vector<uint8_t> response(2+(count+7)/8);
+			response[0] = fc;
+			response[1] = static_cast<uint8_t>((count+7)/8);
+			pRegisterMap->GetBits(table, start, count, response.data()+2);
+			return Reply(std::move(response));
 		}
-
-		if(map_index == 0)
+		// Modbus function code 0x03 (read holding registers)
+		// Modbus function code 0x04 (read input registers)
+		case ModbusFunction::READ_HOLDING_REGISTERS:
+		case ModbusFunction::READ_INPUT_REGISTERS:
 		{
-			(*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
-			return;
+			if(PDU.size() != 5)
+				return exception(0x03);
+			const uint16_t start = GetBE16(PDU.data()+1);
+			const uint16_t count = GetBE16(PDU.data()+3);
+			if(count < 1 || count > 125)
+				return exception(0x03);
+			const auto table = (fc == 0x03) ? ModbusRegisterMap::Table::HOLDING_REGISTERS : ModbusRegisterMap::Table::INPUT_REGISTERS;
+			if(!pRegisterMap->Valid(table, start, count))
+				return exception(0x02);
+			std::vector<uint8_t> response(2+2*count);
+			response[0] = fc;
+			response[1] = static_cast<uint8_t>(2*count);
+			pRegisterMap->GetRegisters(table, start, count, response.data()+2);
+			return Reply(std::move(response));
 		}
-
-		(*pStatusCallback)(CommandStatus::SUCCESS);
-		return;
+		// Writes are passed on as controls - the reply waits for the result
+		case ModbusFunction::WRITE_SINGLE_COIL:
+		case ModbusFunction::WRITE_MULTIPLE_COILS:
+		{
+			std::vector<std::pair<uint16_t,bool>> writes;
+			if(fc == 0x05)
+			{
+				if(PDU.size() != 5)
+					return exception(0x03);
+				const uint16_t val = GetBE16(PDU.data()+3);
+				if(val != 0xFF00 && val != 0x0000)
+					return exception(0x03);
+				writes.emplace_back(GetBE16(PDU.data()+1), val == 0xFF00);
+			}
+			else
+			{
+				if(PDU.size() < 6)
+					return exception(0x03);
+				const uint16_t start = GetBE16(PDU.data()+1);
+				const uint16_t count = GetBE16(PDU.data()+3);
+				if(count < 1 || count > 1968 || PDU[5] != (count+7)/8 || PDU.size() != 6u+PDU[5])
+					return exception(0x03);
+				for(uint16_t i = 0; i < count; i++)
+					writes.emplace_back(start+i, (PDU[6+i/8] >> (i%8)) & 0x01);
+			}
+			std::vector<std::shared_ptr<EventInfo>> events;
+			for(const auto& write : writes)
+			{
+				auto group = find_group_by_address(points.BitIndicies, write.first);
+				if(!group)
+					return exception(0x02);
+				auto event = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, write.first + group->index_offset, GetID());
+				ControlRelayOutputBlock command;
+				command.functionCode = write.second ? ControlCode::LATCH_ON : ControlCode::LATCH_OFF;
+				event->SetPayload<EventType::ControlRelayOutputBlock>(std::move(command));
+				events.push_back(event);
+			}
+			//single writes echo the request, multiple writes echo the address and count
+			if(fc == 0x0F)
+				PDU.resize(5);
+			return PublishCommands(std::move(events), reply_status(std::move(PDU)));
+		}
+		case ModbusFunction::WRITE_SINGLE_REGISTER:
+		case ModbusFunction::WRITE_MULTIPLE_REGISTERS:
+		{
+			uint16_t start, count;
+			const uint8_t* data;
+			if(fc == 0x06)
+			{
+				if(PDU.size() != 5)
+					return exception(0x03);
+				start = GetBE16(PDU.data()+1);
+				count = 1;
+				data = PDU.data()+3;
+			}
+			else
+			{
+				if(PDU.size() < 6)
+					return exception(0x03);
+				start = GetBE16(PDU.data()+1);
+				count = GetBE16(PDU.data()+3);
+				if(count < 1 || count > 123 || PDU[5] != 2*count || PDU.size() != 6u+PDU[5])
+					return exception(0x03);
+				data = PDU.data()+6;
+			}
+			std::vector<std::shared_ptr<EventInfo>> events;
+			for(uint16_t offset = 0; offset < count;)
+			{
+				const uint32_t address = start+offset;
+				auto group = find_group_by_address(points.RegIndicies, address);
+				if(!group)
+					return exception(0x02);
+				const auto width = group->width();
+				//only whole values can be written
+				if((address - group->start) % width || offset + width > count)
+					return exception(0x02);
+
+				std::shared_ptr<EventInfo> event;
+				if(group->codec)
+				{
+					double val;
+					if(!group->codec->Decode(data+2*offset, val))
+						return exception(0x03);
+					event = std::make_shared<EventInfo>(EventType::AnalogOutputDouble64, address + group->index_offset, GetID());
+					event->SetPayload<EventType::AnalogOutputDouble64>(AOD(val,CommandStatus::SUCCESS));
+				}
+				else
+				{
+					event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16, address + group->index_offset, GetID());
+					event->SetPayload<EventType::AnalogOutputInt16>(AO16(static_cast<int16_t>(GetBE16(data+2*offset)),CommandStatus::SUCCESS));
+				}
+				events.push_back(event);
+				offset += width;
+			}
+			if(fc == 0x10)
+				PDU.resize(5);
+			return PublishCommands(std::move(events), reply_status(std::move(PDU)));
+		}
+		default:
+			return exception(0x01);
 	}
-	//TODO: impl other types
-
-	(*pStatusCallback)(CommandStatus::NOT_SUPPORTED);
 }
-
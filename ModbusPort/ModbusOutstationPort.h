@@ -27,6 +27,8 @@
 #ifndef ModbusSERVERPORT_H_
 #define ModbusSERVERPORT_H_
 #include "ModbusPort.h"
+#include "ModbusRegisterMap.h"
+#include "ModbusTCPServer.h"
 #include <unordered_map>
 
 class ModbusOutstationPort: public ModbusPort
@@ -45,7 +47,15 @@ public:
 	void Disconnect();
 
 private:
-	modbus_mapping_t *mb_mapping{};
+	void HandleRequest(std::vector<uint8_t>&& PDU, const uint8_t UnitID, const ModbusTCPServer::Reply_t& Reply);
+	void ConnectionCount(const size_t count);
+	void PublishCommands(std::vector<std::shared_ptr<EventInfo>>&& events, std::function<void(CommandStatus)>&& done);
+	CommandStatus LoadRegisters(const ModbusRegisterMap::Table table, const ModbusReadGroupCollection& collection, const uint16_t index, const double value, const double legacy_scale);
+	bool LoadBit(const ModbusRegisterMap::Table table, const ModbusReadGroupCollection& collection, const uint16_t index, const bool value);
+
+	std::unique_ptr<ModbusRegisterMap> pRegisterMap;
+	std::shared_ptr<ModbusTCPServer> pServer;
+	size_t Connections = 0; //only touched by the server's (serialised) count callback
 };
 
 #endif /* ModbusSERVERPORT_H_ */
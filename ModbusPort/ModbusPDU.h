@@ -0,0 +1,205 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusPDU.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSPDU_H_
+#define MODBUSPDU_H_
+
+#include <opendatacon/IOTypes.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+using namespace odc;
+
+//Building and parsing of Modbus protocol data units (function code + data)
+//	independent of the transport (TCP MBAP header, or RTU address and CRC)
+
+enum class ModbusFunction: uint8_t
+{
+	READ_COILS = 0x01,
+	READ_DISCRETE_INPUTS = 0x02,
+	READ_HOLDING_REGISTERS = 0x03,
+	READ_INPUT_REGISTERS = 0x04,
+	WRITE_SINGLE_COIL = 0x05,
+	WRITE_SINGLE_REGISTER = 0x06,
+	WRITE_MULTIPLE_COILS = 0x0F,
+	WRITE_MULTIPLE_REGISTERS = 0x10
+};
+
+//Result of a request. If Status isn't SUCCESS, the PDU may be empty
+struct ModbusResponse
+{
+	ModbusResponse(CommandStatus aStatus = CommandStatus::UNDEFINED, std::vector<uint8_t>&& aPDU = {}):
+		Status(aStatus),
+		ExceptionCode(0),
+		PDU(std::move(aPDU))
+	{}
+	CommandStatus Status;
+	uint8_t ExceptionCode;
+	std::vector<uint8_t> PDU;
+};
+
+typedef std::function<void(ModbusResponse&)> ModbusResponseHandler_t;
+
+inline void PushBE16(std::vector<uint8_t>& buf, const uint16_t val)
+{
+	buf.push_back(static_cast<uint8_t>(val >> 8));
+	buf.push_back(static_cast<uint8_t>(val & 0xFF));
+}
+
+inline uint16_t GetBE16(const uint8_t* p)
+{
+	return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+//Controls - the clients send these ahead of any queued polls
+inline bool ModbusIsWrite(const std::vector<uint8_t>& PDU)
+{
+	if(PDU.empty())
+		return false;
+	switch(static_cast<ModbusFunction>(PDU[0]))
+	{
+		case ModbusFunction::WRITE_SINGLE_COIL:
+		case ModbusFunction::WRITE_SINGLE_REGISTER:
+		case ModbusFunction::WRITE_MULTIPLE_COILS:
+		case ModbusFunction::WRITE_MULTIPLE_REGISTERS:
+			return true;
+		default:
+			return false;
+	}
+}
+
+inline std::vector<uint8_t> ModbusReadRequest(const ModbusFunction fc, const uint16_t start, const uint16_t count)
+{
+	std::vector<uint8_t> pdu;
+	pdu.reserve(5);
+	pdu.push_back(static_cast<uint8_t>(fc));
+	PushBE16(pdu,start);
+	PushBE16(pdu,count);
+	return pdu;
+}
+
+inline std::vector<uint8_t> ModbusWriteCoilRequest(const uint16_t addr, const bool val)
+{
+	std::vector<uint8_t> pdu;
+	pdu.reserve(5);
+	pdu.push_back(static_cast<uint8_t>(ModbusFunction::WRITE_SINGLE_COIL));
+	PushBE16(pdu,addr);
+	PushBE16(pdu,val ? 0xFF00 : 0x0000);
+	return pdu;
+}
+
+inline std::vector<uint8_t> ModbusWriteRegisterRequest(const uint16_t addr, const uint16_t val)
+{
+	std::vector<uint8_t> pdu;
+	pdu.reserve(5);
+	pdu.push_back(static_cast<uint8_t>(ModbusFunction::WRITE_SINGLE_REGISTER));
+	PushBE16(pdu,addr);
+	PushBE16(pdu,val);
+	return pdu;
+}
+
+inline std::vector<uint8_t> ModbusWriteRegistersRequest(const uint16_t addr, const uint16_t* vals, const uint16_t count)
+{
+	std::vector<uint8_t> pdu;
+	pdu.reserve(6+2*count);
+	pdu.push_back(static_cast<uint8_t>(ModbusFunction::WRITE_MULTIPLE_REGISTERS));
+	PushBE16(pdu,addr);
+	PushBE16(pdu,count);
+	pdu.push_back(static_cast<uint8_t>(2*count));
+	for(uint16_t i = 0; i < count; i++)
+		PushBE16(pdu,vals[i]);
+	return pdu;
+}
+
+//Same mapping the libmodbus errno values used to get
+inline CommandStatus ModbusExceptionToStatus(const uint8_t exception_code)
+{
+	switch(exception_code)
+	{
+		case 0x01: //Illegal function
+			return CommandStatus::NOT_SUPPORTED;
+		case 0x02: //Illegal data address
+		case 0x03: //Illegal data value
+			return CommandStatus::FORMAT_ERROR;
+		case 0x04: //Slave device or server failure
+		case 0x08: //Memory parity error
+			return CommandStatus::HARDWARE_ERROR;
+		case 0x0B: //Target device failed to respond
+			return CommandStatus::TIMEOUT;
+		case 0x05: //Acknowledge
+		case 0x06: //Slave device or server is busy
+		case 0x07: //Negative acknowledge
+		case 0x0A: //Gateway path unavailable
+		default:
+			return CommandStatus::UNDEFINED;
+	}
+}
+
+//Check a response PDU matches the request function code, and turn exception responses into a status
+inline void ModbusCheckResponse(ModbusResponse& response, const uint8_t request_fc)
+{
+	if(response.Status != CommandStatus::SUCCESS)
+		return;
+	if(response.PDU.empty())
+	{
+		response.Status = CommandStatus::FORMAT_ERROR;
+		return;
+	}
+	if(response.PDU[0] == (request_fc | 0x80))
+	{
+		response.ExceptionCode = response.PDU.size() > 1 ? response.PDU[1] : 0;
+		response.Status = ModbusExceptionToStatus(response.ExceptionCode);
+		return;
+	}
+	if(response.PDU[0] != request_fc)
+		response.Status = CommandStatus::FORMAT_ERROR;
+}
+
+//Unpack a read coils/discrete inputs response into one byte per bit
+inline bool ModbusUnpackBits(const ModbusResponse& response, const uint16_t count, std::vector<uint8_t>& bits)
+{
+	if(response.PDU.size() < 2 || response.PDU[1] < (count+7)/8 || response.PDU.size() < 2u + response.PDU[1])
+		return false;
+	bits.resize(count);
+	const uint8_t* data = response.PDU.data()+2;
+	for(uint16_t i = 0; i < count; i++)
+		bits[i] = (data[i/8] >> (i%8)) & 0x01;
+	return true;
+}
+
+//Unpack a read holding/input registers response into host order registers
+inline bool ModbusUnpackRegisters(const ModbusResponse& response, const uint16_t count, std::vector<uint16_t>& regs)
+{
+	if(response.PDU.size() < 2 || response.PDU[1] < count*2 || response.PDU.size() < 2u + response.PDU[1])
+		return false;
+	regs.resize(count);
+	const uint8_t* data = response.PDU.data()+2;
+	for(uint16_t i = 0; i < count; i++)
+		regs[i] = GetBE16(data+2*i);
+	return true;
+}
+
+#endif /* MODBUSPDU_H_ */
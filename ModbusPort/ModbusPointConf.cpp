@@ -33,7 +33,9 @@
 using namespace odc;
 
 ModbusPointConf::ModbusPointConf(const std::string& FileName):
-	ConfigParser(FileName)
+	ConfigParser(FileName),
+	MaxReadGap(0),
+	FullRefreshPeriodms(60000)
 {
 	ProcessFile();
 }
@@ -112,7 +114,22 @@ void ModbusPointConf::ProcessReadGroup(const Json::Value& Ranges, ModbusReadGrou
 			continue;
 		}
 
-		ReadGroup.emplace_back(start,stop-start+1,pollgroup,startval,offset);
+		size_t count = stop-start+1;
+		std::shared_ptr<const ModbusRegisterCodec> codec;
+		if(T == EventType::Analog)
+		{
+			codec = ModbusRegisterCodec::FromJSON(Ranges[n]);
+			if(codec && count % codec->Width())
+			{
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->error("Range doesn't hold a whole number of {}-register values, ignoring the remainder: '{}'", codec->Width(), Ranges[n].toStyledString());
+				count -= count % codec->Width();
+				if(count == 0)
+					continue;
+			}
+		}
+
+		ReadGroup.emplace_back(start,count,pollgroup,startval,offset,codec);
 	}
 }
 
@@ -129,6 +146,11 @@ void ModbusPointConf::ProcessElements(const Json::Value& JSONRoot)
 	if(JSONRoot.isMember("InputRegIndicies"))
 		ProcessReadGroup<EventType::Analog>(JSONRoot["InputRegIndicies"], InputRegIndicies);
 
+	if(JSONRoot.isMember("MaxReadGap"))
+		MaxReadGap = JSONRoot["MaxReadGap"].asUInt();
+	if(JSONRoot.isMember("FullRefreshPeriodms"))
+		FullRefreshPeriodms = JSONRoot["FullRefreshPeriodms"].asUInt();
+
 	if(JSONRoot.isMember("PollGroups"))
 	{
 		auto jPollGroups = JSONRoot["PollGroups"];
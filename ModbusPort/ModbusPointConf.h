@@ -27,6 +27,7 @@
 #ifndef ModbusPOINTCONF_H_
 #define ModbusPOINTCONF_H_
 
+#include "ModbusRegisterCodec.h"
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -58,12 +59,14 @@ public:
 class ModbusReadGroup
 {
 public:
-	ModbusReadGroup(uint32_t start_, uint32_t count_, uint32_t pollgroup_, std::shared_ptr<const EventInfo> startval_, uint32_t offset):
+	ModbusReadGroup(uint32_t start_, uint32_t count_, uint32_t pollgroup_, std::shared_ptr<const EventInfo> startval_, uint32_t offset,
+		std::shared_ptr<const ModbusRegisterCodec> codec_ = nullptr):
 		start(start_),
 		count(count_),
 		pollgroup(pollgroup_),
 		startval(startval_),
-		index_offset(offset)
+		index_offset(offset),
+		codec(codec_)
 	{ }
 
 	bool operator<(const ModbusReadGroup& other) const
@@ -76,6 +79,14 @@ public:
 	uint32_t pollgroup;
 	std::shared_ptr<const EventInfo> startval;
 	uint32_t index_offset;
+	//registers only - null means plain 16-bit values, with the legacy event types and scaling
+	std::shared_ptr<const ModbusRegisterCodec> codec;
+
+	//registers per value
+	uint8_t width() const
+	{
+		return codec ? codec->Width() : 1;
+	}
 };
 
 class ModbusReadGroupCollection: public std::vector<ModbusReadGroup>
@@ -107,6 +118,11 @@ public:
 
 	std::map<uint32_t, ModbusPollGroup> PollGroups;
 
+	//how many unconfigured addresses a read can span to join two ranges into one request
+	uint16_t MaxReadGap;
+	//unchanged values are only re-published this often (0 means every poll)
+	uint32_t FullRefreshPeriodms;
+
 private:
 	template<EventType T>
 	void ProcessReadGroup(const Json::Value& Ranges,ModbusReadGroupCollection& ReadGroup);
@@ -0,0 +1,228 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusPollDecoder.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusPollDecoder.h"
+#include <algorithm>
+#include <cstring>
+
+static bool IsBitRead(const ModbusFunction fc)
+{
+	return fc == ModbusFunction::READ_COILS || fc == ModbusFunction::READ_DISCRETE_INPUTS;
+}
+
+static bool InSpans(const ModbusPlannedRead& read, const uint16_t index)
+{
+	for(const auto& span : read.spans)
+		if(index >= span.start && index < span.start+span.count)
+			return true;
+	return false;
+}
+
+static size_t NumValues(const ModbusPlannedRead& read)
+{
+	size_t values = 0;
+	for(const auto& span : read.spans)
+		values += span.count/span.width();
+	return values;
+}
+
+ModbusPollDecoder::ModbusPollDecoder(const ModbusReadPlan& Plan, const NameID_t aSourceID, const std::chrono::milliseconds aFullRefreshPeriod):
+	SourceID(aSourceID),
+	FullRefreshPeriod(aFullRefreshPeriod),
+	Shadows(Plan.PlannedRequests()),
+	Generation(1),
+	NumSuppressed(0)
+{}
+
+bool ModbusPollDecoder::Decode(const ModbusPlannedRead& read, const ModbusResponse& response, std::vector<std::shared_ptr<EventInfo>>& events)
+{
+	const size_t len = IsBitRead(read.fc) ? (read.count+7)/8 : read.count*2;
+	if(response.PDU.size() < 2 || response.PDU[1] < len || response.PDU.size() < 2+len)
+		return false;
+	const uint8_t* data = response.PDU.data()+2;
+
+	auto& shadow = Shadows[read.id];
+	const auto now = std::chrono::steady_clock::now();
+	const auto generation = Generation.load();
+
+	if(shadow.generation != generation
+	   || shadow.data.size() != len
+	   || FullRefreshPeriod.count() == 0
+	   || now - shadow.last_full >= FullRefreshPeriod)
+	{
+		DecodeAll(read,data,events);
+		shadow.data.assign(data,data+len);
+		shadow.generation = generation;
+		shadow.last_full = now;
+		return true;
+	}
+
+	const size_t configured = NumValues(read);
+
+	//nothing changed is by far the common case
+	if(memcmp(data,shadow.data.data(),len) == 0)
+	{
+		NumSuppressed += configured;
+		return true;
+	}
+
+	const auto num_before = events.size();
+	DecodeChanged(read,data,shadow.data.data(),len,events);
+	std::copy(data,data+len,shadow.data.begin());
+	NumSuppressed += configured - (events.size()-num_before);
+	return true;
+}
+
+std::shared_ptr<EventInfo> ModbusPollDecoder::MakeEvent(const ModbusFunction fc, const uint16_t index, const uint16_t val) const
+{
+	std::shared_ptr<EventInfo> event;
+	switch(fc)
+	{
+		// Modbus function code 0x01 (read coil status)
+		case ModbusFunction::READ_COILS:
+			event = std::make_shared<EventInfo>(EventType::BinaryOutputStatus,index,SourceID,QualityFlags::ONLINE);
+			event->SetPayload<EventType::BinaryOutputStatus>(val != 0);
+			break;
+		// Modbus function code 0x02 (read input status)
+		case ModbusFunction::READ_DISCRETE_INPUTS:
+			event = std::make_shared<EventInfo>(EventType::Binary,index,SourceID,QualityFlags::ONLINE);
+			event->SetPayload<EventType::Binary>(val != 0);
+			break;
+		// Modbus function code 0x03 (read holding registers)
+		case ModbusFunction::READ_HOLDING_REGISTERS:
+		{
+			event = std::make_shared<EventInfo>(EventType::AnalogOutputInt16,index,SourceID,QualityFlags::ONLINE);
+			auto payload = AO16(val,CommandStatus::SUCCESS);
+			event->SetPayload<EventType::AnalogOutputInt16>(std::move(payload));
+			break;
+		}
+		// Modbus function code 0x04 (read input registers)
+		case ModbusFunction::READ_INPUT_REGISTERS:
+		default:
+			event = std::make_shared<EventInfo>(EventType::Analog,index,SourceID,QualityFlags::ONLINE);
+			event->SetPayload<EventType::Analog>(double(val));
+			break;
+	}
+	return event;
+}
+
+std::shared_ptr<EventInfo> ModbusPollDecoder::MakeRegisterEvent(const ModbusFunction fc, const ModbusReadSpan& span, const uint16_t index, const uint8_t* data) const
+{
+	if(!span.codec)
+		return MakeEvent(fc,index,GetBE16(data));
+
+	//typed values are published as engineering values
+	double val = 0;
+	auto quality = QualityFlags::ONLINE;
+	if(!span.codec->Decode(data,val))
+		quality |= QualityFlags::REFERENCE_ERR;
+
+	std::shared_ptr<EventInfo> event;
+	if(fc == ModbusFunction::READ_HOLDING_REGISTERS)
+	{
+		event = std::make_shared<EventInfo>(EventType::AnalogOutputDouble64,index,SourceID,quality);
+		event->SetPayload<EventType::AnalogOutputDouble64>(AOD(val,CommandStatus::SUCCESS));
+	}
+	else
+	{
+		event = std::make_shared<EventInfo>(EventType::Analog,index,SourceID,quality);
+		event->SetPayload<EventType::Analog>(std::move(val));
+	}
+	return event;
+}
+
+void ModbusPollDecoder::DecodeAll(const ModbusPlannedRead& read, const uint8_t* data, std::vector<std::shared_ptr<EventInfo>>& events) const
+{
+	if(IsBitRead(read.fc))
+	{
+		for(const auto& span : read.spans)
+		{
+			for(uint16_t index = span.start; index < span.start+span.count; index++)
+			{
+				const size_t offset = index-read.start;
+				events.push_back(MakeEvent(read.fc,index,(data[offset/8] >> (offset%8)) & 0x01));
+			}
+		}
+		return;
+	}
+	for(const auto& span : read.spans)
+	{
+		const auto width = span.width();
+		for(uint16_t index = span.start; index < span.start+span.count; index += width)
+			events.push_back(MakeRegisterEvent(read.fc,span,index,data+2*(index-read.start)));
+	}
+}
+
+void ModbusPollDecoder::DecodeChanged(const ModbusPlannedRead& read, const uint8_t* data, const uint8_t* old, const size_t len, std::vector<std::shared_ptr<EventInfo>>& events) const
+{
+	if(!IsBitRead(read.fc))
+	{
+		for(const auto& span : read.spans)
+		{
+			const size_t span_offset = 2*(span.start-read.start);
+			if(memcmp(data+span_offset,old+span_offset,2*span.count) == 0)
+				continue;
+			const auto width = span.width();
+			for(uint16_t index = span.start; index < span.start+span.count; index += width)
+			{
+				const size_t offset = 2*(index-read.start);
+				if(memcmp(data+offset,old+offset,2*width) != 0)
+					events.push_back(MakeRegisterEvent(read.fc,span,index,data+offset));
+			}
+		}
+		return;
+	}
+
+	size_t pos = 0;
+	while(pos < len)
+	{
+		//skip identical words a machine word at a time
+		if(pos+sizeof(uint64_t) <= len)
+		{
+			uint64_t new_word, old_word;
+			memcpy(&new_word,data+pos,sizeof(uint64_t));
+			memcpy(&old_word,old+pos,sizeof(uint64_t));
+			if(new_word == old_word)
+			{
+				pos += sizeof(uint64_t);
+				continue;
+			}
+		}
+		const size_t block_end = std::min(pos+sizeof(uint64_t),len);
+		for(; pos < block_end; pos++)
+		{
+			uint8_t diff = data[pos] ^ old[pos];
+			for(uint8_t bit = 0; diff; bit++, diff >>= 1)
+			{
+				const size_t offset = pos*8+bit;
+				if(!(diff & 0x01) || offset >= read.count)
+					continue;
+				const uint16_t index = read.start+offset;
+				if(InSpans(read,index))
+					events.push_back(MakeEvent(read.fc,index,(data[pos] >> bit) & 0x01));
+			}
+		}
+	}
+}
@@ -0,0 +1,74 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusPollDecoder.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSPOLLDECODER_H_
+#define MODBUSPOLLDECODER_H_
+
+#include "ModbusReadPlan.h"
+#include <opendatacon/IOTypes.h>
+#include <opendatacon/NameRegistry.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+//Turns poll responses into events - but only for values that changed since the last poll of the same read,
+//	plus everything on the first poll, after Invalidate(), and every FullRefreshPeriod (zero means every poll)
+//	Keeps a shadow of the raw response data per planned read.
+//	Decode() isn't re-entrant - call it from one strand (the client's response handlers are serialised)
+class ModbusPollDecoder
+{
+public:
+	ModbusPollDecoder(const ModbusReadPlan& Plan, const NameID_t SourceID, const std::chrono::milliseconds FullRefreshPeriod);
+
+	//false if the response doesn't hold the data the read asked for
+	bool Decode(const ModbusPlannedRead& read, const ModbusResponse& response, std::vector<std::shared_ptr<EventInfo>>& events);
+
+	//Forget the shadows, so the next poll of each read is published in full (eg. after comms loss)
+	void Invalidate() { Generation++; }
+
+	uint64_t GetSuppressed() const { return NumSuppressed; }
+
+private:
+	struct Shadow
+	{
+		std::vector<uint8_t> data;
+		uint32_t generation = 0;
+		std::chrono::steady_clock::time_point last_full;
+	};
+
+	std::shared_ptr<EventInfo> MakeEvent(const ModbusFunction fc, const uint16_t index, const uint16_t val) const;
+	std::shared_ptr<EventInfo> MakeRegisterEvent(const ModbusFunction fc, const ModbusReadSpan& span, const uint16_t index, const uint8_t* data) const;
+	void DecodeAll(const ModbusPlannedRead& read, const uint8_t* data, std::vector<std::shared_ptr<EventInfo>>& events) const;
+	void DecodeChanged(const ModbusPlannedRead& read, const uint8_t* data, const uint8_t* old, const size_t len, std::vector<std::shared_ptr<EventInfo>>& events) const;
+
+	const NameID_t SourceID;
+	const std::chrono::milliseconds FullRefreshPeriod;
+	std::vector<Shadow> Shadows;
+	std::atomic<uint32_t> Generation;
+	std::atomic<uint64_t> NumSuppressed;
+};
+
+#endif /* MODBUSPOLLDECODER_H_ */
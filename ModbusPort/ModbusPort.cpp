@@ -83,5 +83,14 @@ void ModbusPort::ProcessElements(const Json::Value& JSONRoot)
 		else //if (JSONRoot["ServerType"].asString()=="MANUAL")
 			static_cast<ModbusPortConf*>(pConf.get())->mAddrConf.ServerType = server_type_t::MANUAL;
 	}
+
+	if(JSONRoot.isMember("ResponseTimeoutms"))
+		static_cast<ModbusPortConf*>(pConf.get())->mAddrConf.ResponseTimeoutms = JSONRoot["ResponseTimeoutms"].asUInt();
+
+	if(JSONRoot.isMember("MaxInFlight"))
+		static_cast<ModbusPortConf*>(pConf.get())->mAddrConf.MaxInFlight = JSONRoot["MaxInFlight"].asUInt();
+
+	if(JSONRoot.isMember("MaxConnections"))
+		static_cast<ModbusPortConf*>(pConf.get())->mAddrConf.MaxConnections = JSONRoot["MaxConnections"].asUInt();
 }
 
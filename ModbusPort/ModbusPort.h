@@ -72,7 +72,6 @@ public:
 	void ProcessElements(const Json::Value& JSONRoot) override;
 
 protected:
-	std::unique_ptr<ModbusExecutor> MBSync;
 	std::atomic_bool stack_enabled;
 };
 
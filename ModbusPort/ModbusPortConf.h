@@ -57,6 +57,9 @@ struct ModbusAddrConf
 	//Common
 	uint8_t OutstationAddr;
 	server_type_t ServerType;
+	uint32_t ResponseTimeoutms;
+	uint16_t MaxInFlight; //TCP only - serial is always one at a time
+	uint16_t MaxConnections; //TCP outstation only
 
 	ModbusAddrConf():
 		SerialDevice(""),
@@ -67,7 +70,10 @@ struct ModbusAddrConf
 		IP(""),
 		Port(502),
 		OutstationAddr(1),
-		ServerType(server_type_t::ONDEMAND)
+		ServerType(server_type_t::ONDEMAND),
+		ResponseTimeoutms(500),
+		MaxInFlight(1),
+		MaxConnections(8)
 	{}
 };
 
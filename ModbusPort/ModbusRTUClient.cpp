@@ -0,0 +1,78 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRTUClient.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusRTUClient.h"
+
+ModbusRTUClient::ModbusRTUClient(std::shared_ptr<odc::asio_service> apIOS,
+	const std::string& aName,
+	const ModbusAddrConf& aAddrConf,
+	const uint32_t aResponseTimeoutms,
+	const bool aAutoReopen,
+	const std::function<void(bool)>& aStateCallback):
+	Name(aName),
+	SlaveAddr(aAddrConf.OutstationAddr),
+	ResponseTimeoutms(aResponseTimeoutms),
+	AutoReopen(aAutoReopen),
+	StateCallback(aStateCallback),
+	pBus(ModbusSerialBus::Get(apIOS,aAddrConf)),
+	pStats(std::make_shared<ModbusSerialBus::SlaveStats>())
+{}
+
+ModbusRTUClient::~ModbusRTUClient()
+{
+	pBus->Detach(Name);
+}
+
+void ModbusRTUClient::Open()
+{
+	pBus->Attach(Name, SlaveAddr, ResponseTimeoutms, AutoReopen, pStats, StateCallback);
+}
+
+void ModbusRTUClient::Close()
+{
+	pBus->Detach(Name);
+}
+
+void ModbusRTUClient::Request(std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler)
+{
+	pBus->Request(Name, std::move(PDU), Handler);
+}
+
+Json::Value ModbusRTUClient::GetStatistics() const
+{
+	Json::Value stats;
+	const auto elapsedus = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - pStats->Since).count();
+	const uint64_t requests = pStats->Requests;
+	stats["numBusRequests"] = Json::UInt64(requests);
+	stats["numBusErrors"] = Json::UInt64(pStats->Errors);
+	stats["numBusTimeouts"] = Json::UInt64(pStats->Timeouts);
+	stats["numBusReadsCoalesced"] = Json::UInt64(pStats->Coalesced);
+	stats["busTimems"] = Json::UInt64(pStats->BusTimeus/1000);
+	//share of the bus time this slave has used
+	stats["busUtilisationPercent"] = elapsedus > 0 ? 100.0*pStats->BusTimeus/elapsedus : 0.0;
+	stats["avgQueueDelayms"] = requests > 0 ? pStats->QueueTimeus/1000.0/requests : 0.0;
+	stats["interFrameGapus"] = Json::UInt64(pBus->GetInterFrameGap().count());
+	return stats;
+}
@@ -0,0 +1,62 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRTUClient.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSRTUCLIENT_H_
+#define MODBUSRTUCLIENT_H_
+
+#include "ModbusClient.h"
+#include "ModbusSerialBus.h"
+#include <memory>
+#include <string>
+
+//Modbus RTU client for one slave on a serial line
+//	The line itself is a ModbusSerialBus, shared with any other ports configured on the same device
+class ModbusRTUClient: public ModbusClient
+{
+public:
+	ModbusRTUClient(std::shared_ptr<odc::asio_service> apIOS,
+		const std::string& aName,
+		const ModbusAddrConf& aAddrConf,
+		const uint32_t aResponseTimeoutms,
+		const bool aAutoReopen,
+		const std::function<void(bool)>& aStateCallback);
+	~ModbusRTUClient() override;
+
+	void Open() override;
+	void Close() override;
+	void Request(std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler) override;
+	Json::Value GetStatistics() const override;
+
+private:
+	const std::string Name;
+	const uint8_t SlaveAddr;
+	const uint32_t ResponseTimeoutms;
+	const bool AutoReopen;
+	const std::function<void(bool)> StateCallback;
+	std::shared_ptr<ModbusSerialBus> pBus;
+	std::shared_ptr<ModbusSerialBus::SlaveStats> pStats;
+};
+
+#endif /* MODBUSRTUCLIENT_H_ */
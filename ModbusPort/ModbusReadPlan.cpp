@@ -0,0 +1,139 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusReadPlan.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusReadPlan.h"
+#include <algorithm>
+#include <opendatacon/util.h>
+
+ModbusReadPlan::ModbusReadPlan(const ModbusPointConf& PointConf, const uint16_t aMaxGap):
+	MaxGap(aMaxGap),
+	NumConfigured(0)
+{
+	AddCollection(PointConf.BitIndicies, ModbusFunction::READ_COILS, MAX_READ_BITS);
+	AddCollection(PointConf.InputBitIndicies, ModbusFunction::READ_DISCRETE_INPUTS, MAX_READ_BITS);
+	AddCollection(PointConf.RegIndicies, ModbusFunction::READ_HOLDING_REGISTERS, MAX_READ_REGISTERS);
+	AddCollection(PointConf.InputRegIndicies, ModbusFunction::READ_INPUT_REGISTERS, MAX_READ_REGISTERS);
+
+	for(auto& pg_reads : ByPollGroup)
+	{
+		for(auto& read : pg_reads.second)
+			read.id = All.size() + (&read - pg_reads.second.data());
+		All.insert(All.end(),pg_reads.second.begin(),pg_reads.second.end());
+	}
+}
+
+const std::vector<ModbusPlannedRead>& ModbusReadPlan::Get(const uint32_t pollgroup) const
+{
+	if(pollgroup == 0)
+		return All;
+	auto it = ByPollGroup.find(pollgroup);
+	return it == ByPollGroup.end() ? Empty : it->second;
+}
+
+void ModbusReadPlan::AddCollection(const ModbusReadGroupCollection& collection, const ModbusFunction fc, const uint16_t limit)
+{
+	NumConfigured += collection.size();
+
+	struct Span
+	{
+		uint32_t first;
+		uint32_t last;
+		const ModbusRegisterCodec* codec;
+		bool operator<(const Span& other) const { return first < other.first; }
+		uint32_t width() const { return codec ? codec->Width() : 1; }
+	};
+	auto same_codec = [](const ModbusRegisterCodec* a, const ModbusRegisterCodec* b)
+				{
+					return a == b || (a && b && *a == *b);
+				};
+
+	//sorted spans of configured addresses, per poll group
+	std::map<uint32_t,std::vector<Span>> spans_by_pg;
+	for(const auto& range : collection)
+		if(range.count > 0)
+			spans_by_pg[range.pollgroup].push_back({range.start,range.start+range.count-1,range.codec.get()});
+
+	for(auto& pg_spans : spans_by_pg)
+	{
+		auto& spans = pg_spans.second;
+		std::stable_sort(spans.begin(),spans.end());
+
+		//join runs that are decoded the same way
+		std::vector<Span> merged;
+		for(auto span : spans)
+		{
+			if(!merged.empty() && span.first <= merged.back().last+1 && same_codec(span.codec,merged.back().codec)
+			   && (span.first-merged.back().first) % span.width() == 0)
+			{
+				merged.back().last = std::max(merged.back().last,span.last);
+				continue;
+			}
+			//addresses can't be decoded two ways (they'd be published twice per poll) - the first config wins
+			if(!merged.empty() && span.first <= merged.back().last)
+			{
+				const uint32_t overlap = merged.back().last+1-span.first;
+				const uint32_t skip = (overlap+span.width()-1)/span.width()*span.width();
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->warn("Modbus function {} addresses {} to {} are already configured to decode differently - ignoring {} of them",
+						static_cast<int>(fc), span.first, span.last, std::min(skip,span.last+1-span.first));
+				if(span.first+skip > span.last)
+					continue;
+				span.first += skip;
+			}
+			merged.push_back(span);
+		}
+
+		auto& reads = ByPollGroup[pg_spans.first];
+		bool open = false;
+		for(auto span : merged)
+		{
+			const uint32_t width = span.width();
+			while(span.first <= span.last)
+			{
+				if(open)
+				{
+					auto& read = reads.back();
+					const uint32_t end = read.start+read.count; //one past
+					const uint32_t room = read.start+limit > span.first ? read.start+limit-span.first : 0;
+					if(span.first <= end+MaxGap && room >= width)
+					{
+						//bridge the gap, and take as many whole values of the span as fit
+						const uint32_t last = std::min<uint32_t>(span.last, span.first+(room/width)*width-1);
+						read.count = static_cast<uint16_t>(std::max(end,last+1)-read.start);
+						read.spans.push_back({static_cast<uint16_t>(span.first),static_cast<uint16_t>(last+1-span.first),span.codec});
+						span.first = last+1;
+						continue;
+					}
+				}
+				const uint32_t last = std::min<uint32_t>(span.last, span.first+(limit/width)*width-1);
+				ModbusPlannedRead read{fc, static_cast<uint16_t>(span.first), static_cast<uint16_t>(last+1-span.first), pg_spans.first, {}, 0};
+				read.spans.push_back({static_cast<uint16_t>(span.first),static_cast<uint16_t>(last+1-span.first),span.codec});
+				reads.push_back(std::move(read));
+				open = true;
+				span.first = last+1;
+			}
+		}
+	}
+}
@@ -0,0 +1,84 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusReadPlan.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSREADPLAN_H_
+#define MODBUSREADPLAN_H_
+
+#include "ModbusPDU.h"
+#include "ModbusPointConf.h"
+#include <map>
+#include <vector>
+
+//A run of configured addresses within a read, all decoded the same way
+struct ModbusReadSpan
+{
+	uint16_t start;
+	uint16_t count;
+	const ModbusRegisterCodec* codec; //owned by the point conf, null for bits and plain registers
+	uint8_t width() const { return codec ? codec->Width() : 1; }
+};
+
+//A read request as it goes on the wire, and which parts of it are configured points
+//	(the rest is gap that was bridged to save a request, and isn't published)
+struct ModbusPlannedRead
+{
+	ModbusFunction fc;
+	uint16_t start;
+	uint16_t count;
+	uint32_t pollgroup;
+	std::vector<ModbusReadSpan> spans;
+	size_t id; //0 to PlannedRequests()-1, for keeping state per read
+};
+
+//Compiles the configured read groups into the fewest requests per poll group and function code,
+//	merging ranges that overlap, touch, or are within MaxGap addresses of each other - up to the PDU limits.
+//	Multi-register values are never split between requests.
+//	Addresses configured more than once with different decoding are only read (and published) as the first one.
+//	Built once from the point config and reused for every poll.
+class ModbusReadPlan
+{
+public:
+	static constexpr uint16_t MAX_READ_BITS = 2000;
+	static constexpr uint16_t MAX_READ_REGISTERS = 125;
+
+	ModbusReadPlan(const ModbusPointConf& PointConf, const uint16_t MaxGap);
+
+	//pollgroup 0 means all of them
+	const std::vector<ModbusPlannedRead>& Get(const uint32_t pollgroup) const;
+
+	size_t ConfiguredRanges() const { return NumConfigured; }
+	size_t PlannedRequests() const { return All.size(); }
+
+private:
+	void AddCollection(const ModbusReadGroupCollection& collection, const ModbusFunction fc, const uint16_t limit);
+
+	const uint16_t MaxGap;
+	size_t NumConfigured;
+	std::map<uint32_t,std::vector<ModbusPlannedRead>> ByPollGroup;
+	std::vector<ModbusPlannedRead> All;
+	const std::vector<ModbusPlannedRead> Empty;
+};
+
+#endif /* MODBUSREADPLAN_H_ */
@@ -0,0 +1,231 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRegisterCodec.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusRegisterCodec.h"
+#include <opendatacon/util.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+std::shared_ptr<const ModbusRegisterCodec> ModbusRegisterCodec::FromJSON(const Json::Value& JSONRange)
+{
+	if(!JSONRange.isMember("Type") && !JSONRange.isMember("WordOrder") && !JSONRange.isMember("ByteOrder")
+	   && !JSONRange.isMember("ScaleFactor") && !JSONRange.isMember("Offset"))
+		return nullptr;
+
+	auto codec = std::make_shared<ModbusRegisterCodec>();
+
+	if(JSONRange.isMember("Type"))
+	{
+		auto type = JSONRange["Type"].asString();
+		if(type == "UINT16")
+			codec->Type = ModbusDataType::UINT16;
+		else if(type == "INT16")
+			codec->Type = ModbusDataType::INT16;
+		else if(type == "UINT32")
+			codec->Type = ModbusDataType::UINT32;
+		else if(type == "INT32")
+			codec->Type = ModbusDataType::INT32;
+		else if(type == "FLOAT32")
+			codec->Type = ModbusDataType::FLOAT32;
+		else if(type == "BCD16")
+			codec->Type = ModbusDataType::BCD16;
+		else if(type == "BCD32")
+			codec->Type = ModbusDataType::BCD32;
+		else if(auto log = odc::spdlog_get("ModbusPort"))
+			log->error("Invalid register Type '{}', should be UINT16, INT16, UINT32, INT32, FLOAT32, BCD16 or BCD32. Using UINT16.", type);
+	}
+	if(JSONRange.isMember("WordOrder"))
+	{
+		auto order = JSONRange["WordOrder"].asString();
+		if(order == "LITTLE")
+			codec->WordSwap = true;
+		else if(order != "BIG")
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("Invalid WordOrder '{}', should be BIG or LITTLE.", order);
+	}
+	if(JSONRange.isMember("ByteOrder"))
+	{
+		auto order = JSONRange["ByteOrder"].asString();
+		if(order == "LITTLE")
+			codec->ByteSwap = true;
+		else if(order != "BIG")
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("Invalid ByteOrder '{}', should be BIG or LITTLE.", order);
+	}
+	if(JSONRange.isMember("ScaleFactor"))
+	{
+		codec->ScaleFactor = JSONRange["ScaleFactor"].asDouble();
+		if(codec->ScaleFactor == 0)
+		{
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->error("ScaleFactor of zero ignored: '{}'", JSONRange.toStyledString());
+			codec->ScaleFactor = 1;
+		}
+	}
+	if(JSONRange.isMember("Offset"))
+		codec->Offset = JSONRange["Offset"].asDouble();
+
+	return codec;
+}
+
+static bool FromBCD(uint32_t bcd, const uint8_t digits, uint32_t& val)
+{
+	val = 0;
+	for(int shift = (digits-1)*4; shift >= 0; shift -= 4)
+	{
+		const uint32_t digit = (bcd >> shift) & 0x0F;
+		if(digit > 9)
+			return false;
+		val = val*10 + digit;
+	}
+	return true;
+}
+
+static uint32_t ToBCD(uint32_t val)
+{
+	uint32_t bcd = 0;
+	for(int shift = 0; val; shift += 4, val /= 10)
+		bcd |= (val % 10) << shift;
+	return bcd;
+}
+
+bool ModbusRegisterCodec::Decode(const uint8_t* data, double& eng) const
+{
+	uint16_t regs[2];
+	for(uint8_t i = 0; i < Width(); i++)
+	{
+		regs[i] = static_cast<uint16_t>((data[2*i] << 8) | data[2*i+1]);
+		if(ByteSwap)
+			regs[i] = static_cast<uint16_t>((regs[i] << 8) | (regs[i] >> 8));
+	}
+	const uint32_t u32 = WordSwap ? (uint32_t(regs[1]) << 16) | regs[0] : (uint32_t(regs[0]) << 16) | regs[1];
+
+	double raw;
+	switch(Type)
+	{
+		case ModbusDataType::UINT16:
+			raw = regs[0];
+			break;
+		case ModbusDataType::INT16:
+			raw = static_cast<int16_t>(regs[0]);
+			break;
+		case ModbusDataType::UINT32:
+			raw = u32;
+			break;
+		case ModbusDataType::INT32:
+			raw = static_cast<int32_t>(u32);
+			break;
+		case ModbusDataType::FLOAT32:
+		{
+			float f;
+			static_assert(sizeof(f) == sizeof(u32), "float32 needs to be 32 bits");
+			memcpy(&f,&u32,sizeof(f));
+			raw = f;
+			break;
+		}
+		case ModbusDataType::BCD16:
+		case ModbusDataType::BCD32:
+		{
+			uint32_t val;
+			if(!FromBCD(Type == ModbusDataType::BCD16 ? regs[0] : u32, Width()*4, val))
+				return false;
+			raw = val;
+			break;
+		}
+		default:
+			return false;
+	}
+	eng = raw*ScaleFactor + Offset;
+	return true;
+}
+
+bool ModbusRegisterCodec::Encode(const double eng, uint16_t* regs) const
+{
+	const double raw = (eng - Offset)/ScaleFactor;
+	if(std::isnan(raw))
+		return false;
+
+	//integer types are range checked after rounding
+	const double rounded = std::round(raw);
+	auto in_range = [rounded](double min, double max){ return rounded >= min && rounded <= max; };
+
+	uint32_t u32 = 0;
+	switch(Type)
+	{
+		case ModbusDataType::UINT16:
+			if(!in_range(0,std::numeric_limits<uint16_t>::max()))
+				return false;
+			u32 = static_cast<uint16_t>(rounded);
+			break;
+		case ModbusDataType::INT16:
+			if(!in_range(std::numeric_limits<int16_t>::min(),std::numeric_limits<int16_t>::max()))
+				return false;
+			u32 = static_cast<uint16_t>(static_cast<int16_t>(rounded));
+			break;
+		case ModbusDataType::UINT32:
+			if(!in_range(0,std::numeric_limits<uint32_t>::max()))
+				return false;
+			u32 = static_cast<uint32_t>(rounded);
+			break;
+		case ModbusDataType::INT32:
+			if(!in_range(std::numeric_limits<int32_t>::min(),std::numeric_limits<int32_t>::max()))
+				return false;
+			u32 = static_cast<uint32_t>(static_cast<int32_t>(rounded));
+			break;
+		case ModbusDataType::FLOAT32:
+		{
+			if(raw < std::numeric_limits<float>::lowest() || raw > std::numeric_limits<float>::max())
+				return false;
+			const float f = static_cast<float>(raw);
+			memcpy(&u32,&f,sizeof(f));
+			break;
+		}
+		case ModbusDataType::BCD16:
+			if(!in_range(0,9999))
+				return false;
+			u32 = ToBCD(static_cast<uint32_t>(rounded));
+			break;
+		case ModbusDataType::BCD32:
+			if(!in_range(0,99999999))
+				return false;
+			u32 = ToBCD(static_cast<uint32_t>(rounded));
+			break;
+		default:
+			return false;
+	}
+
+	if(Width() == 1)
+		regs[0] = static_cast<uint16_t>(u32);
+	else
+	{
+		regs[WordSwap ? 1 : 0] = static_cast<uint16_t>(u32 >> 16);
+		regs[WordSwap ? 0 : 1] = static_cast<uint16_t>(u32 & 0xFFFF);
+	}
+	if(ByteSwap)
+		for(uint8_t i = 0; i < Width(); i++)
+			regs[i] = static_cast<uint16_t>((regs[i] << 8) | (regs[i] >> 8));
+	return true;
+}
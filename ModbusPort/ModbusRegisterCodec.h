@@ -0,0 +1,85 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRegisterCodec.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSREGISTERCODEC_H_
+#define MODBUSREGISTERCODEC_H_
+
+#include <json/json.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+enum class ModbusDataType: uint8_t
+{
+	UINT16,
+	INT16,
+	UINT32,
+	INT32,
+	FLOAT32,
+	BCD16,
+	BCD32
+};
+
+//Describes how to turn one or two registers into an engineering value and back:
+//	eng = raw*ScaleFactor + Offset
+//	Multi-register values are high word first unless WordSwap, and register bytes are the usual big endian unless ByteSwap
+struct ModbusRegisterCodec
+{
+	ModbusDataType Type = ModbusDataType::UINT16;
+	bool WordSwap = false;
+	bool ByteSwap = false;
+	double ScaleFactor = 1;
+	double Offset = 0;
+
+	//Parses the descriptor members of a read group config, or returns null if there aren't any (legacy 16-bit handling)
+	static std::shared_ptr<const ModbusRegisterCodec> FromJSON(const Json::Value& JSONRange);
+
+	uint8_t Width() const
+	{
+		switch(Type)
+		{
+			case ModbusDataType::UINT32:
+			case ModbusDataType::INT32:
+			case ModbusDataType::FLOAT32:
+			case ModbusDataType::BCD32:
+				return 2;
+			default:
+				return 1;
+		}
+	}
+
+	//Decode from Width() registers of raw (big endian) PDU data. False if the data isn't valid for the type (eg. BCD digit > 9)
+	bool Decode(const uint8_t* data, double& eng) const;
+	//Encode to Width() register values (as they go on the wire). False if out of range for the type
+	bool Encode(const double eng, uint16_t* regs) const;
+
+	bool operator==(const ModbusRegisterCodec& other) const
+	{
+		return Type == other.Type && WordSwap == other.WordSwap && ByteSwap == other.ByteSwap
+		       && ScaleFactor == other.ScaleFactor && Offset == other.Offset;
+	}
+};
+
+#endif /* MODBUSREGISTERCODEC_H_ */
@@ -0,0 +1,115 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRegisterMap.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusRegisterMap.h"
+#include <algorithm>
+#include <thread>
+
+ModbusRegisterMap::ModbusRegisterMap(const ModbusPointConf& PointConf)
+{
+	Configure(Tables[static_cast<size_t>(Table::COILS)], PointConf.BitIndicies);
+	Configure(Tables[static_cast<size_t>(Table::INPUT_BITS)], PointConf.InputBitIndicies);
+	Configure(Tables[static_cast<size_t>(Table::HOLDING_REGISTERS)], PointConf.RegIndicies);
+	Configure(Tables[static_cast<size_t>(Table::INPUT_REGISTERS)], PointConf.InputRegIndicies);
+}
+
+void ModbusRegisterMap::Configure(TableData& table, const ModbusReadGroupCollection& collection)
+{
+	size_t size = 0;
+	for(const auto& group : collection)
+		size = std::max<size_t>(size, group.start + group.count);
+
+	table.configured.assign(size,false);
+	table.vals = std::make_unique<std::atomic<uint16_t>[]>(size);
+	for(size_t i = 0; i < size; i++)
+		table.vals[i].store(0,std::memory_order_relaxed);
+
+	for(const auto& group : collection)
+		for(size_t address = group.start; address < group.start + group.count; address++)
+			table.configured[address] = true;
+}
+
+bool ModbusRegisterMap::Valid(const Table t, const uint32_t start, const uint32_t count) const
+{
+	const auto& table = Tables[static_cast<size_t>(t)];
+	if(count == 0 || start + count > table.configured.size())
+		return false;
+	for(auto address = start; address < start + count; address++)
+		if(!table.configured[address])
+			return false;
+	return true;
+}
+
+void ModbusRegisterMap::SetBit(const Table t, const uint32_t address, const bool val)
+{
+	uint16_t reg = val;
+	SetRegisters(t, address, &reg, 1);
+}
+
+void ModbusRegisterMap::SetRegisters(const Table t, const uint32_t address, const uint16_t* vals, const uint8_t count)
+{
+	auto& table = Tables[static_cast<size_t>(t)];
+	//claim the table - only from even (no other update in progress) to odd
+	uint32_t seq = table.Seq.load(std::memory_order_relaxed);
+	do
+	{
+		while(seq & 1)
+		{
+			std::this_thread::yield();
+			seq = table.Seq.load(std::memory_order_relaxed);
+		}
+	} while(!table.Seq.compare_exchange_weak(seq, seq+1, std::memory_order_acquire, std::memory_order_relaxed));
+	std::atomic_thread_fence(std::memory_order_release);
+	for(uint8_t i = 0; i < count; i++)
+		table.vals[address+i].store(vals[i],std::memory_order_relaxed);
+	table.Seq.store(seq+2,std::memory_order_release);
+}
+
+void ModbusRegisterMap::GetBits(const Table t, const uint16_t start, const uint16_t count, uint8_t* packed) const
+{
+	const auto& table = Tables[static_cast<size_t>(t)];
+	Read(table,[&]()
+		{
+			for(uint16_t byte = 0; byte < (count+7)/8; byte++)
+				packed[byte] = 0;
+			for(uint16_t i = 0; i < count; i++)
+				if(table.vals[start+i].load(std::memory_order_relaxed))
+					packed[i/8] |= (1 << (i%8));
+		});
+}
+
+void ModbusRegisterMap::GetRegisters(const Table t, const uint16_t start, const uint16_t count, uint8_t* data) const
+{
+	const auto& table = Tables[static_cast<size_t>(t)];
+	Read(table,[&]()
+		{
+			for(uint16_t i = 0; i < count; i++)
+			{
+				const auto reg = table.vals[start+i].load(std::memory_order_relaxed);
+				data[2*i] = static_cast<uint8_t>(reg >> 8);
+				data[2*i+1] = static_cast<uint8_t>(reg & 0xFF);
+			}
+		});
+}
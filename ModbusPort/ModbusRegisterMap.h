@@ -0,0 +1,89 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusRegisterMap.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSREGISTERMAP_H_
+#define MODBUSREGISTERMAP_H_
+
+#include "ModbusPointConf.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+
+//The outstation's data tables, addressed as on the wire.
+//	Nothing takes a lock: values are atomics, and each table has a sequence counter (a seqlock)
+//	that lets a reader retry on the rare occasion it overlaps an update to the same table, so multi-register values are never torn.
+//	Updates (from Event()) claim a table by CASing its sequence from even to odd, and release it by making it even again.
+class ModbusRegisterMap
+{
+public:
+	enum class Table: uint8_t
+	{
+		COILS,
+		INPUT_BITS,
+		HOLDING_REGISTERS,
+		INPUT_REGISTERS
+	};
+
+	ModbusRegisterMap(const ModbusPointConf& PointConf);
+
+	//true if every address in the block is configured
+	bool Valid(const Table t, const uint32_t start, const uint32_t count) const;
+
+	void SetBit(const Table t, const uint32_t address, const bool val);
+	void SetRegisters(const Table t, const uint32_t address, const uint16_t* vals, const uint8_t count);
+
+	//packed least significant bit first, as in a read response
+	void GetBits(const Table t, const uint16_t start, const uint16_t count, uint8_t* packed) const;
+	//big endian, as in a read response
+	void GetRegisters(const Table t, const uint16_t start, const uint16_t count, uint8_t* data) const;
+
+private:
+	struct TableData
+	{
+		std::vector<bool> configured;
+		std::unique_ptr<std::atomic<uint16_t>[]> vals;
+		std::atomic<uint32_t> Seq{0};
+	};
+	void Configure(TableData& table, const ModbusReadGroupCollection& collection);
+
+	template<typename Fn>
+	static void Read(const TableData& table, Fn&& fn)
+	{
+		uint32_t before, after;
+		do
+		{
+			//odd means an update is in progress
+			while((before = table.Seq.load(std::memory_order_acquire)) & 1)
+				std::atomic_thread_fence(std::memory_order_acquire);
+			fn();
+			std::atomic_thread_fence(std::memory_order_acquire);
+			after = table.Seq.load(std::memory_order_relaxed);
+		} while(before != after);
+	}
+
+	TableData Tables[4];
+};
+
+#endif /* MODBUSREGISTERMAP_H_ */
@@ -0,0 +1,362 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusSerialBus.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusSerialBus.h"
+#include <opendatacon/util.h>
+#include <algorithm>
+#include <cerrno>
+
+std::unordered_map<std::string, std::weak_ptr<ModbusSerialBus>> ModbusSerialBus::Buses;
+std::mutex ModbusSerialBus::BusesMutex;
+
+static CommandStatus ModbusErrnoToStatus(int errnum)
+{
+	switch(errnum)
+	{
+		case EMBXILFUN: //return "Illegal function";
+			return CommandStatus::NOT_SUPPORTED;
+		case EMBBADCRC:  //return "Invalid CRC";
+		case EMBBADDATA: //return "Invalid data";
+		case EMBBADEXC:  //return "Invalid exception code";
+		case EMBXILADD:  //return "Illegal data address";
+		case EMBXILVAL:  //return "Illegal data value";
+		case EMBMDATA:   //return "Too many data";
+			return CommandStatus::FORMAT_ERROR;
+		case EMBXSFAIL:  //return "Slave device or server failure";
+		case EMBXMEMPAR: //return "Memory parity error";
+			return CommandStatus::HARDWARE_ERROR;
+		case EMBXGTAR: //return "Target device failed to respond";
+		case ETIMEDOUT:
+			return CommandStatus::TIMEOUT;
+		case EMBXACK:   //return "Acknowledge";
+		case EMBXSBUSY: //return "Slave device or server is busy";
+		case EMBXNACK:  //return "Negative acknowledge";
+		case EMBXGPATH: //return "Gateway path unavailable";
+		default:
+			return CommandStatus::UNDEFINED;
+	}
+}
+
+//Modbus RTU frames are separated by at least 3.5 character times of silence
+//	above 19200 baud the spec fixes it at 1.75ms
+static std::chrono::microseconds CalcInterFrameGap(const ModbusAddrConf& aAddrConf)
+{
+	if(aAddrConf.BaudRate > 19200 || aAddrConf.BaudRate == 0)
+		return std::chrono::microseconds(1750);
+	//start bit, data bits, parity bit and stop bits
+	const uint32_t char_bits = 1 + aAddrConf.DataBits + (aAddrConf.Parity == SerialParity::NONE ? 0 : 1) + aAddrConf.StopBits;
+	return std::chrono::microseconds((uint64_t(char_bits)*3500000 + aAddrConf.BaudRate - 1)/aAddrConf.BaudRate);
+}
+
+std::shared_ptr<ModbusSerialBus> ModbusSerialBus::Get(std::shared_ptr<odc::asio_service> apIOS, const ModbusAddrConf& aAddrConf)
+{
+	std::lock_guard<std::mutex> lck(BusesMutex);
+	auto& weak_bus = Buses[aAddrConf.SerialDevice];
+	if(auto bus = weak_bus.lock())
+	{
+		const auto& conf = bus->AddrConf;
+		if(conf.BaudRate != aAddrConf.BaudRate || conf.Parity != aAddrConf.Parity || conf.DataBits != aAddrConf.DataBits || conf.StopBits != aAddrConf.StopBits)
+		{
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->warn("Serial settings for shared Modbus bus '{}' differ between ports - using the first: {} baud, {}{}{}",
+					aAddrConf.SerialDevice, conf.BaudRate, conf.DataBits, static_cast<char>(conf.Parity), conf.StopBits);
+		}
+		return bus;
+	}
+	auto bus = std::make_shared<ModbusSerialBus>(apIOS,aAddrConf);
+	weak_bus = bus;
+	return bus;
+}
+
+ModbusSerialBus::ModbusSerialBus(std::shared_ptr<odc::asio_service> apIOS, const ModbusAddrConf& aAddrConf):
+	pIOS(apIOS),
+	Device(aAddrConf.SerialDevice),
+	AddrConf(aAddrConf),
+	InterFrameGap(CalcInterFrameGap(aAddrConf)),
+	MBSync(std::make_unique<ModbusExecutor>(
+		modbus_new_rtu(aAddrConf.SerialDevice.c_str(),aAddrConf.BaudRate,(char)aAddrConf.Parity,aAddrConf.DataBits,aAddrConf.StopBits), *pIOS)),
+	pStrand(pIOS->make_strand()),
+	pGapTimer(pIOS->make_steady_timer()),
+	pRetryTimer(pIOS->make_steady_timer())
+{
+	if (MBSync->isNull())
+		throw std::runtime_error(Device + ": Stack error: 'Modbus stack creation failed'");
+}
+
+ModbusSerialBus::~ModbusSerialBus()
+{
+	//the device is already closed - the last Detach() queues the close, which holds a reference until done
+	std::lock_guard<std::mutex> lck(BusesMutex);
+	auto it = Buses.find(Device);
+	if(it != Buses.end() && it->second.expired())
+		Buses.erase(it);
+}
+
+void ModbusSerialBus::Attach(const std::string& aName, const uint8_t aSlave, const uint32_t aResponseTimeoutms, const bool aAutoReopen,
+	const std::shared_ptr<SlaveStats>& apStats, const std::function<void(bool)>& aStateCallback)
+{
+	pStrand->post([=,self{shared_from_this()}]()
+		{
+			auto& slave = Slaves[aName];
+			slave.Address = aSlave;
+			slave.ResponseTimeoutms = aResponseTimeoutms;
+			slave.AutoReopen = aAutoReopen;
+			slave.pStats = apStats;
+			slave.StateCallback = aStateCallback;
+			if(isConnected)
+				slave.StateCallback(true);
+			else
+				Connect();
+		});
+}
+
+void ModbusSerialBus::Detach(const std::string& aName)
+{
+	pStrand->post([=,self{shared_from_this()}]()
+		{
+			auto it = Slaves.find(aName);
+			if(it == Slaves.end())
+				return;
+
+			//fail anything still waiting for the bus
+			for(auto queue : {&it->second.Writes, &it->second.Reads})
+				for(auto& tx : *queue)
+				{
+					ModbusResponse response(CommandStatus::UNDEFINED);
+					tx.Handler(response);
+				}
+			auto StateCallback = std::move(it->second.StateCallback);
+			Slaves.erase(it);
+			if(isConnected)
+				StateCallback(false);
+
+			if(Slaves.empty())
+				Disconnect();
+		});
+}
+
+void ModbusSerialBus::Connect()
+{
+	if(isConnected || Connecting || Slaves.empty())
+		return;
+	Connecting = true;
+
+	MBSync->Execute([this,self{shared_from_this()}](modbus_t* mb)
+		{
+			bool success = true;
+			if (modbus_connect(mb) == -1)
+			{
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->warn("{}: Connect error: '{}'", Device, modbus_strerror(errno));
+				success = false;
+			}
+			pStrand->post([this,self,success]()
+				{
+					Connected(success);
+				});
+		});
+}
+
+void ModbusSerialBus::Connected(const bool success)
+{
+	Connecting = false;
+	if(success)
+	{
+		if(auto log = odc::spdlog_get("ModbusPort"))
+			log->info("{}: Opened serial bus for {} port(s), inter-frame gap {}us", Device, Slaves.size(), InterFrameGap.count());
+		isConnected = true;
+		//everyone may have detached while it was opening
+		if(Slaves.empty())
+			return Disconnect();
+		for(auto& name_slave : Slaves)
+			name_slave.second.StateCallback(true);
+		return Schedule();
+	}
+
+	//try again later - unless all the ports want manual connections
+	for(const auto& name_slave : Slaves)
+	{
+		if(name_slave.second.AutoReopen)
+		{
+			pRetryTimer->expires_from_now(std::chrono::seconds(5));
+			pRetryTimer->async_wait(pStrand->wrap([this,weak_self{weak_from_this()}](asio::error_code err_code)
+				{
+					auto self = weak_self.lock();
+					if(!self || err_code)
+						return;
+					Connect();
+				}));
+			return;
+		}
+	}
+}
+
+void ModbusSerialBus::Disconnect()
+{
+	pRetryTimer->cancel();
+	if(!isConnected)
+		return;
+	isConnected = false;
+	//goes after any transaction still on the bus
+	MBSync->Execute([this,self{shared_from_this()}](modbus_t* mb)
+		{
+			modbus_close(mb);
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->info("{}: Closed serial bus", Device);
+		});
+}
+
+void ModbusSerialBus::Request(const std::string& aName, std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler)
+{
+	pStrand->post([this,self{shared_from_this()},aName,PDU{std::move(PDU)},Handler]() mutable
+		{
+			auto it = Slaves.find(aName);
+			if(!isConnected || it == Slaves.end() || PDU.empty())
+			{
+				ModbusResponse response(CommandStatus::UNDEFINED);
+				ModbusCheckResponse(response,PDU.empty() ? 0 : PDU[0]);
+				Handler(response);
+				return;
+			}
+			if(ModbusIsWrite(PDU))
+			{
+				it->second.Writes.push_back({std::move(PDU),Handler,std::chrono::steady_clock::now()});
+				return Schedule();
+			}
+			//a slave that's slow (or timing out) mustn't let its polls pile up on the bus
+			//	so an identical read that's still waiting just gets the same response
+			auto& reads = it->second.Reads;
+			auto dup = std::find_if(reads.begin(),reads.end(),[&PDU](const Transaction& tx){ return tx.PDU == PDU; });
+			if(dup != reads.end())
+			{
+				it->second.pStats->Coalesced++;
+				dup->Handler = [first{std::move(dup->Handler)},Handler](ModbusResponse& response)
+				{
+					ModbusResponse copy(response);
+					first(response);
+					Handler(copy);
+				};
+				return;
+			}
+			reads.push_back({std::move(PDU),Handler,std::chrono::steady_clock::now()});
+			Schedule();
+		});
+}
+
+void ModbusSerialBus::Schedule()
+{
+	if(Busy || !isConnected || Slaves.empty())
+		return;
+
+	//writes first, then reads - taking turns between the ports, starting after the last one served
+	for(auto queue : {&Slave::Writes, &Slave::Reads})
+	{
+		auto it = Slaves.upper_bound(LastServed);
+		for(size_t i = 0; i < Slaves.size(); i++, ++it)
+		{
+			if(it == Slaves.end())
+				it = Slaves.begin();
+			auto& transactions = it->second.*queue;
+			if(!transactions.empty())
+			{
+				LastServed = it->first;
+				auto tx = std::move(transactions.front());
+				transactions.pop_front();
+				return Execute(it->second, std::move(tx));
+			}
+		}
+	}
+}
+
+void ModbusSerialBus::Execute(Slave& aSlave, Transaction&& tx)
+{
+	Busy = true;
+	const auto now = std::chrono::steady_clock::now();
+	aSlave.pStats->Requests++;
+	aSlave.pStats->QueueTimeus += std::chrono::duration_cast<std::chrono::microseconds>(now - tx.Queued).count();
+
+	MBSync->Execute([this,self{shared_from_this()},Address{aSlave.Address},Timeoutms{aSlave.ResponseTimeoutms},pStats{aSlave.pStats},tx{std::move(tx)}](modbus_t* mb) mutable
+		{
+			const auto start = std::chrono::steady_clock::now();
+			//the slave address filters the responses as well as addressing the request
+			modbus_set_slave(mb, Address);
+			modbus_set_response_timeout(mb, Timeoutms/1000, (Timeoutms%1000)*1000);
+
+			//raw requests take the PDU with the slave address prepended - libmodbus adds the CRC
+			std::vector<uint8_t> raw;
+			raw.reserve(tx.PDU.size()+1);
+			raw.push_back(Address);
+			raw.insert(raw.end(),tx.PDU.begin(),tx.PDU.end());
+
+			ModbusResponse response(CommandStatus::UNDEFINED);
+			uint8_t rsp[MODBUS_RTU_MAX_ADU_LENGTH];
+			int rc = modbus_send_raw_request(mb, raw.data(), static_cast<int>(raw.size()));
+			if(rc != -1)
+				rc = modbus_receive_confirmation(mb, rsp);
+
+			const int header_length = modbus_get_header_length(mb);
+			if(rc == -1)
+			{
+				const int errnum = errno;
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->warn("{}: Request error for slave {}: '{}'", Device, Address, modbus_strerror(errnum));
+				response.Status = ModbusErrnoToStatus(errnum);
+				modbus_flush(mb);
+			}
+			else if(rc < header_length+1+2)
+				response.Status = CommandStatus::FORMAT_ERROR;
+			else
+			{
+				//strip the address and CRC
+				response.Status = CommandStatus::SUCCESS;
+				response.PDU.assign(rsp+header_length, rsp+rc-2);
+			}
+
+			const auto end = std::chrono::steady_clock::now();
+			pStats->BusTimeus += std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+
+			pStrand->post([this,self,end,pStats,response{std::move(response)},tx{std::move(tx)}]() mutable
+				{
+					ModbusCheckResponse(response,tx.PDU[0]);
+					if(response.Status == CommandStatus::TIMEOUT)
+						pStats->Timeouts++;
+					if(response.Status != CommandStatus::SUCCESS)
+						pStats->Errors++;
+					tx.Handler(response);
+					Done(end);
+				});
+		});
+}
+
+void ModbusSerialBus::Done(const std::chrono::steady_clock::time_point LineQuiet)
+{
+	//nothing goes on the bus until the inter-frame gap has passed
+	pGapTimer->expires_at(LineQuiet + InterFrameGap);
+	pGapTimer->async_wait(pStrand->wrap([this,self{shared_from_this()}](asio::error_code)
+		{
+			Busy = false;
+			Schedule();
+		}));
+}
@@ -0,0 +1,125 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusSerialBus.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSSERIALBUS_H_
+#define MODBUSSERIALBUS_H_
+
+#include "ModbusPDU.h"
+#include "ModbusPort.h"
+#include <opendatacon/asio.h>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/*
+  One RS-485 bus (serial device), shared by all the Modbus RTU master ports configured on it.
+  There's one instance per device, found/created through Get(), and kept as long as a port holds it.
+  Each port attaches (by port name) while it's open - the device is opened for the first and closed after the last.
+
+  Only one transaction is ever on the bus. The next one is chosen by the scheduler:
+	- writes (controls) go before reads (polls)
+	- within each priority, the attached ports take turns (round robin)
+  and is only sent once the line has been quiet for the 3.5 character inter-frame gap.
+  A read identical to one a port already has waiting isn't queued again - both get the same response.
+*/
+class ModbusSerialBus: public std::enable_shared_from_this<ModbusSerialBus>
+{
+public:
+	//Per-port bus statistics - owned by the port, updated by the bus
+	struct SlaveStats
+	{
+		std::atomic<uint64_t> Requests{0};
+		std::atomic<uint64_t> Errors{0};
+		std::atomic<uint64_t> Timeouts{0};
+		std::atomic<uint64_t> Coalesced{0};
+		std::atomic<uint64_t> BusTimeus{0};
+		std::atomic<uint64_t> QueueTimeus{0};
+		const std::chrono::steady_clock::time_point Since = std::chrono::steady_clock::now();
+	};
+
+	static std::shared_ptr<ModbusSerialBus> Get(std::shared_ptr<odc::asio_service> apIOS, const ModbusAddrConf& aAddrConf);
+
+	ModbusSerialBus(std::shared_ptr<odc::asio_service> apIOS, const ModbusAddrConf& aAddrConf);
+	~ModbusSerialBus();
+
+	void Attach(const std::string& aName, const uint8_t aSlave, const uint32_t aResponseTimeoutms, const bool aAutoReopen,
+		const std::shared_ptr<SlaveStats>& apStats, const std::function<void(bool)>& aStateCallback);
+	void Detach(const std::string& aName);
+	//Handler is called on the bus strand - so never concurrently
+	void Request(const std::string& aName, std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler);
+
+	std::chrono::microseconds GetInterFrameGap() const { return InterFrameGap; }
+
+private:
+	struct Transaction
+	{
+		std::vector<uint8_t> PDU;
+		ModbusResponseHandler_t Handler;
+		std::chrono::steady_clock::time_point Queued;
+	};
+	struct Slave
+	{
+		uint8_t Address;
+		uint32_t ResponseTimeoutms;
+		bool AutoReopen;
+		std::shared_ptr<SlaveStats> pStats;
+		std::function<void(bool)> StateCallback;
+		std::deque<Transaction> Writes;
+		std::deque<Transaction> Reads;
+	};
+
+	void Connect();
+	void Connected(const bool success);
+	void Disconnect();
+	void Schedule();
+	void Execute(Slave& aSlave, Transaction&& tx);
+	void Done(const std::chrono::steady_clock::time_point LineQuiet);
+
+	std::shared_ptr<odc::asio_service> pIOS;
+	const std::string Device;
+	const ModbusAddrConf AddrConf;
+	const std::chrono::microseconds InterFrameGap;
+	std::unique_ptr<ModbusExecutor> MBSync;
+	//scheduler state - only touched on the strand
+	std::unique_ptr<asio::io_service::strand> pStrand;
+	std::unique_ptr<asio::steady_timer> pGapTimer;
+	std::unique_ptr<asio::steady_timer> pRetryTimer;
+	std::map<std::string,Slave> Slaves;
+	std::string LastServed;
+	bool isConnected = false;
+	bool Connecting = false;
+	bool Busy = false; //a transaction is on the bus, or the line is in its inter-frame gap
+
+	static std::unordered_map<std::string, std::weak_ptr<ModbusSerialBus>> Buses;
+	static std::mutex BusesMutex;
+};
+
+#endif /* MODBUSSERIALBUS_H_ */
@@ -0,0 +1,268 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusTCPClient.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusTCPClient.h"
+#include <opendatacon/util.h>
+#include <algorithm>
+
+//MBAP header: transaction id, protocol id, length (of unit id + PDU), unit id
+static constexpr size_t MBAP_HEADER_LENGTH = 7;
+static constexpr size_t MAX_PDU_LENGTH = 253;
+
+ModbusTCPClient::ModbusTCPClient(std::shared_ptr<odc::asio_service> apIOS,
+	const std::string& aName,
+	const std::string& aIP,
+	const uint16_t aPort,
+	const uint8_t aUnitID,
+	const uint32_t aResponseTimeoutms,
+	const size_t aMaxInFlight,
+	const bool aAutoReopen,
+	const std::function<void(bool)>& aStateCallback):
+	pIOS(apIOS),
+	Name(aName),
+	IP(aIP),
+	Port(aPort),
+	UnitID(aUnitID),
+	ResponseTimeoutms(aResponseTimeoutms),
+	MaxInFlight(aMaxInFlight ? aMaxInFlight : 1),
+	AutoReopen(aAutoReopen),
+	StateCallback(aStateCallback),
+	pStrand(pIOS->make_strand()),
+	isConnected(false),
+	NextTID(0)
+{}
+
+void ModbusTCPClient::Open()
+{
+	pStrand->post([this,weak_self{weak_from_this()}]()
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+			if(!pSockMan)
+			{
+				try
+				{
+					//the socket manager can outlive a callback's target, so only pass weak refs
+					pSockMan = std::make_unique<odc::TCPSocketManager<std::string>>(
+						pIOS, false, IP, std::to_string(Port),
+						[weak_self](odc::buf_t& readbuf)
+						{
+							std::string data(std::istreambuf_iterator<char>(&readbuf),{});
+							if(auto self = weak_self.lock())
+								self->pStrand->post([self,data{std::move(data)}]() mutable
+									{
+										self->ReadCompletion(std::move(data));
+									});
+						},
+						[weak_self](bool connected)
+						{
+							if(auto self = weak_self.lock())
+								self->pStrand->post([self,connected]()
+									{
+										self->SocketState(connected);
+									});
+						},
+						0, //requests are never buffered while disconnected - they fail instead
+						AutoReopen,
+						5000);
+				}
+				catch(const std::exception& e)
+				{
+					if(auto log = odc::spdlog_get("ModbusPort"))
+						log->error("{}: Failed to set up Modbus TCP connection to {}:{}: '{}'", Name, IP, Port, e.what());
+					return;
+				}
+			}
+			pSockMan->Open();
+		});
+}
+
+void ModbusTCPClient::Close()
+{
+	pStrand->post([this,weak_self{weak_from_this()}]()
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+			if(pSockMan)
+				pSockMan->Close();
+		});
+}
+
+void ModbusTCPClient::Request(std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler)
+{
+	pStrand->post([this,weak_self{weak_from_this()},PDU{std::move(PDU)},Handler]() mutable
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+			if(!isConnected)
+			{
+				ModbusResponse response(CommandStatus::UNDEFINED);
+				Handler(response);
+				return;
+			}
+			//writes jump the queue of polls, but stay in order amongst themselves
+			auto pos = Queue.end();
+			if(ModbusIsWrite(PDU))
+				pos = std::find_if(Queue.begin(),Queue.end(),[](const Transaction& t){ return !ModbusIsWrite(t.PDU); });
+			Queue.insert(pos,{0,std::move(PDU),Handler,nullptr});
+			SendNext();
+		});
+}
+
+void ModbusTCPClient::SocketState(bool connected)
+{
+	if(connected == isConnected)
+		return;
+	isConnected = connected;
+
+	if(auto log = odc::spdlog_get("ModbusPort"))
+	{
+		if(connected)
+			log->info("{}: Connected to {}:{}", Name, IP, Port);
+		else
+			log->warn("{}: Disconnected from {}:{}", Name, IP, Port);
+	}
+
+	if(!connected)
+	{
+		RxBuf.clear();
+		FailAll(CommandStatus::UNDEFINED);
+	}
+	StateCallback(connected);
+}
+
+void ModbusTCPClient::SendNext()
+{
+	while(isConnected && !Queue.empty() && InFlight.size() < MaxInFlight)
+	{
+		//skip any ids still outstanding after wrapping around
+		while(InFlight.count(NextTID))
+			NextTID++;
+		const uint16_t TID = NextTID++;
+
+		auto& transaction = InFlight.emplace(TID,std::move(Queue.front())).first->second;
+		Queue.pop_front();
+		transaction.TID = TID;
+
+		const auto len = transaction.PDU.size()+1;
+		std::string adu;
+		adu.reserve(MBAP_HEADER_LENGTH-1+len);
+		adu.push_back(static_cast<char>(TID >> 8));
+		adu.push_back(static_cast<char>(TID & 0xFF));
+		adu.push_back(0); //protocol id 0 == Modbus
+		adu.push_back(0);
+		adu.push_back(static_cast<char>(len >> 8));
+		adu.push_back(static_cast<char>(len & 0xFF));
+		adu.push_back(static_cast<char>(UnitID));
+		adu.append(transaction.PDU.begin(),transaction.PDU.end());
+		pSockMan->Write(std::move(adu));
+
+		transaction.pTimeoutTimer = pIOS->make_steady_timer(std::chrono::milliseconds(ResponseTimeoutms));
+		transaction.pTimeoutTimer->async_wait(pStrand->wrap([this,weak_self{weak_from_this()},TID](asio::error_code err_code)
+			{
+				auto self = weak_self.lock();
+				if(!self || err_code)
+					return;
+				if(!InFlight.count(TID))
+					return;
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->debug("{}: Response timeout for transaction {}", Name, TID);
+				Complete(TID,ModbusResponse(CommandStatus::TIMEOUT));
+			}));
+	}
+}
+
+void ModbusTCPClient::ReadCompletion(std::string&& data)
+{
+	RxBuf.append(data);
+
+	while(RxBuf.size() >= MBAP_HEADER_LENGTH)
+	{
+		auto header = reinterpret_cast<const uint8_t*>(RxBuf.data());
+		const uint16_t TID = GetBE16(header);
+		const uint16_t protocol = GetBE16(header+2);
+		const uint16_t len = GetBE16(header+4);
+
+		if(protocol != 0 || len < 2 || len > MAX_PDU_LENGTH+1)
+		{
+			//no way to find the next frame boundary - drop what we have and start afresh
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->warn("{}: Discarding {} bytes of malformed Modbus TCP data", Name, RxBuf.size());
+			RxBuf.clear();
+			return;
+		}
+
+		const size_t frame_len = MBAP_HEADER_LENGTH-1+len;
+		if(RxBuf.size() < frame_len)
+			return;
+
+		if(InFlight.count(TID))
+		{
+			ModbusResponse response(CommandStatus::SUCCESS,
+				std::vector<uint8_t>(header+MBAP_HEADER_LENGTH, header+frame_len));
+			RxBuf.erase(0,frame_len);
+			Complete(TID,std::move(response));
+			continue;
+		}
+
+		if(auto log = odc::spdlog_get("ModbusPort"))
+			log->debug("{}: Discarding unexpected (or late) response for transaction {}", Name, TID);
+
+		RxBuf.erase(0,frame_len);
+	}
+}
+
+void ModbusTCPClient::Complete(const uint16_t TID, ModbusResponse&& response)
+{
+	auto it = InFlight.find(TID);
+	auto transaction = std::move(it->second);
+	InFlight.erase(it);
+	transaction.pTimeoutTimer->cancel();
+	ModbusCheckResponse(response,transaction.PDU[0]);
+	transaction.Handler(response);
+	SendNext();
+}
+
+void ModbusTCPClient::FailAll(const CommandStatus status)
+{
+	std::deque<Transaction> failed;
+	for(auto& tid_transaction : InFlight)
+	{
+		tid_transaction.second.pTimeoutTimer->cancel();
+		failed.push_back(std::move(tid_transaction.second));
+	}
+	InFlight.clear();
+	for(auto& t : Queue)
+		failed.push_back(std::move(t));
+	Queue.clear();
+	for(auto& t : failed)
+	{
+		ModbusResponse response(status);
+		t.Handler(response);
+	}
+}
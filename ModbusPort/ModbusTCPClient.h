@@ -0,0 +1,94 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusTCPClient.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSTCPCLIENT_H_
+#define MODBUSTCPCLIENT_H_
+
+#include "ModbusClient.h"
+#include <opendatacon/TCPSocketManager.h>
+#include <opendatacon/asio.h>
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+//Non-blocking Modbus TCP client on the shared io_service
+//	Requests are queued, and up to MaxInFlight are outstanding at once (matched by MBAP transaction id),
+//	each with its own response timeout. Responses can complete out of order.
+//	Writes are queued ahead of any reads that haven't been sent yet.
+//	No handler ever waits on the network - a slow or dead outstation only costs a timer.
+class ModbusTCPClient: public ModbusClient, public std::enable_shared_from_this<ModbusTCPClient>
+{
+public:
+	ModbusTCPClient(std::shared_ptr<odc::asio_service> apIOS,
+		const std::string& aName,
+		const std::string& aIP,
+		const uint16_t aPort,
+		const uint8_t aUnitID,
+		const uint32_t aResponseTimeoutms,
+		const size_t aMaxInFlight,
+		const bool aAutoReopen,
+		const std::function<void(bool)>& aStateCallback);
+
+	void Open() override;
+	void Close() override;
+	void Request(std::vector<uint8_t>&& PDU, const ModbusResponseHandler_t& Handler) override;
+
+private:
+	struct Transaction
+	{
+		uint16_t TID;
+		std::vector<uint8_t> PDU;
+		ModbusResponseHandler_t Handler;
+		std::unique_ptr<asio::steady_timer> pTimeoutTimer;
+	};
+
+	void SocketState(bool connected);
+	void ReadCompletion(std::string&& data);
+	void SendNext();
+	void Complete(const uint16_t TID, ModbusResponse&& response);
+	void FailAll(const CommandStatus status);
+
+	std::shared_ptr<odc::asio_service> pIOS;
+	const std::string Name;
+	const std::string IP;
+	const uint16_t Port;
+	const uint8_t UnitID;
+	const uint32_t ResponseTimeoutms;
+	const size_t MaxInFlight;
+	const bool AutoReopen;
+	const std::function<void(bool)> StateCallback;
+
+	//everything below is only touched on pStrand
+	std::unique_ptr<asio::io_service::strand> pStrand;
+	std::unique_ptr<odc::TCPSocketManager<std::string>> pSockMan;
+	std::deque<Transaction> Queue;
+	std::unordered_map<uint16_t,Transaction> InFlight;
+	std::string RxBuf;
+	bool isConnected;
+	uint16_t NextTID;
+};
+
+#endif /* MODBUSTCPCLIENT_H_ */
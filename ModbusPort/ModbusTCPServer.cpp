@@ -0,0 +1,264 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusTCPServer.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusTCPServer.h"
+#include <opendatacon/util.h>
+#include <chrono>
+
+//MBAP header: transaction id, protocol id, length (of unit id + PDU), unit id
+static constexpr size_t MBAP_HEADER_LENGTH = 7;
+static constexpr size_t MAX_PDU_LENGTH = 253;
+static constexpr uint32_t ACCEPT_RETRY_MS = 500;
+
+class ModbusTCPServer::Session: public std::enable_shared_from_this<Session>
+{
+public:
+	Session(std::shared_ptr<odc::asio_service> pIOS, std::shared_ptr<asio::ip::tcp::socket> apSock, std::weak_ptr<ModbusTCPServer> apServer):
+		pSock(apSock),
+		pStrand(pIOS->make_strand()),
+		pServer(apServer)
+	{}
+
+	void Start()
+	{
+		pStrand->post([self{shared_from_this()}](){ self->ReadHeader(); });
+	}
+	void Close()
+	{
+		pStrand->post([self{shared_from_this()}]()
+			{
+				asio::error_code err;
+				self->pSock->shutdown(asio::ip::tcp::socket::shutdown_both,err);
+				self->pSock->close(err);
+			});
+	}
+
+private:
+	void ReadHeader()
+	{
+		asio::async_read(*pSock, asio::buffer(Header), pStrand->wrap([self{shared_from_this()}](asio::error_code err_code, std::size_t)
+			{
+				if(err_code)
+					return self->Closed();
+				const uint16_t protocol = (self->Header[2] << 8) | self->Header[3];
+				const uint16_t len = (self->Header[4] << 8) | self->Header[5];
+				if(protocol != 0 || len < 2 || len > MAX_PDU_LENGTH+1)
+				{
+					//can't find the next frame - drop the connection
+					if(auto log = odc::spdlog_get("ModbusPort"))
+						log->warn("Malformed Modbus TCP header, closing connection");
+					self->Close();
+					return self->Closed();
+				}
+				self->PDU.resize(len-1);
+				self->ReadBody();
+			}));
+	}
+	void ReadBody()
+	{
+		asio::async_read(*pSock, asio::buffer(PDU), pStrand->wrap([self{shared_from_this()}](asio::error_code err_code, std::size_t)
+			{
+				if(err_code)
+					return self->Closed();
+				auto server = self->pServer.lock();
+				if(!server)
+					return self->Close();
+
+				//the reply can come from anywhere - get back on the strand to write it
+				std::weak_ptr<Session> weak_self = self;
+				server->RequestHandler(std::move(self->PDU), self->Header[6], [weak_self](std::vector<uint8_t>&& response)
+					{
+						if(auto self = weak_self.lock())
+							self->pStrand->post([self,response{std::move(response)}]()
+								{
+									self->WriteResponse(response);
+								});
+					});
+			}));
+	}
+	void WriteResponse(const std::vector<uint8_t>& response)
+	{
+		if(response.empty())
+			return ReadHeader();
+
+		const auto len = response.size()+1;
+		auto adu = std::make_shared<std::vector<uint8_t>>();
+		adu->reserve(MBAP_HEADER_LENGTH-1+len);
+		adu->insert(adu->end(),Header,Header+4); //same transaction and protocol id
+		adu->push_back(static_cast<uint8_t>(len >> 8));
+		adu->push_back(static_cast<uint8_t>(len & 0xFF));
+		adu->push_back(Header[6]);
+		adu->insert(adu->end(),response.begin(),response.end());
+
+		asio::async_write(*pSock, asio::buffer(*adu), pStrand->wrap([self{shared_from_this()},adu](asio::error_code err_code, std::size_t)
+			{
+				if(err_code)
+					return self->Closed();
+				self->ReadHeader();
+			}));
+	}
+	void Closed()
+	{
+		if(auto server = pServer.lock())
+			server->SessionClosed(shared_from_this());
+	}
+
+	std::shared_ptr<asio::ip::tcp::socket> pSock;
+	std::unique_ptr<asio::io_service::strand> pStrand;
+	std::weak_ptr<ModbusTCPServer> pServer;
+	uint8_t Header[MBAP_HEADER_LENGTH];
+	std::vector<uint8_t> PDU;
+};
+
+ModbusTCPServer::ModbusTCPServer(std::shared_ptr<odc::asio_service> apIOS,
+	const std::string& aName,
+	const std::string& aIP,
+	const uint16_t aPort,
+	const size_t aMaxConnections,
+	const RequestHandler_t& aRequestHandler,
+	const std::function<void(size_t)>& aConnectionCountCallback):
+	pIOS(apIOS),
+	Name(aName),
+	IP(aIP),
+	Port(aPort),
+	MaxConnections(aMaxConnections),
+	RequestHandler(aRequestHandler),
+	ConnectionCountCallback(aConnectionCountCallback),
+	pStrand(pIOS->make_strand()),
+	pRetryTimer(pIOS->make_steady_timer())
+{}
+
+void ModbusTCPServer::Start()
+{
+	pStrand->post([this,weak_self{weak_from_this()}]()
+		{
+			auto self = weak_self.lock();
+			if(!self || pAcceptor)
+				return;
+			try
+			{
+				auto resolver = pIOS->make_tcp_resolver();
+				asio::ip::tcp::endpoint endpoint = *resolver->resolve(IP, std::to_string(Port)).begin();
+				pAcceptor = pIOS->make_tcp_acceptor();
+				pAcceptor->open(endpoint.protocol());
+				pAcceptor->set_option(asio::ip::tcp::acceptor::reuse_address(true));
+				pAcceptor->bind(endpoint);
+				pAcceptor->listen();
+			}
+			catch(const std::exception& e)
+			{
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->error("{}: Failed to listen on {}:{}: '{}'", Name, IP, Port, e.what());
+				pAcceptor.reset();
+				return;
+			}
+			if(auto log = odc::spdlog_get("ModbusPort"))
+				log->info("{}: Listening on {}:{}", Name, IP, Port);
+			Accept();
+		});
+}
+
+void ModbusTCPServer::Stop()
+{
+	pStrand->post([this,weak_self{weak_from_this()}]()
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+			if(pAcceptor)
+			{
+				asio::error_code err;
+				pAcceptor->close(err);
+				pAcceptor.reset();
+			}
+			pRetryTimer->cancel();
+			for(auto& pSession : Sessions)
+				pSession->Close();
+			//the sessions let us know when they're done
+		});
+}
+
+void ModbusTCPServer::Accept()
+{
+	std::shared_ptr<asio::ip::tcp::socket> pSock = pIOS->make_tcp_socket();
+	pAcceptor->async_accept(*pSock,pStrand->wrap([this,weak_self{weak_from_this()},pSock](asio::error_code err_code)
+		{
+			auto self = weak_self.lock();
+			if(!self || !pAcceptor)
+				return;
+
+			if(!err_code)
+			{
+				if(Sessions.size() >= MaxConnections)
+				{
+					if(auto log = odc::spdlog_get("ModbusPort"))
+						log->warn("{}: Refusing connection - already serving the maximum of {}", Name, MaxConnections);
+					asio::error_code err;
+					pSock->close(err);
+				}
+				else
+				{
+					auto pSession = std::make_shared<Session>(pIOS,pSock,weak_self);
+					Sessions.insert(pSession);
+					pSession->Start();
+					if(auto log = odc::spdlog_get("ModbusPort"))
+						log->debug("{}: Accepted connection ({} total)", Name, Sessions.size());
+					ConnectionCountCallback(Sessions.size());
+				}
+			}
+			else
+			{
+				//eg. out of file descriptors - retrying straight away would just spin until one's free
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->warn("{}: Accept error: '{}'", Name, err_code.message());
+				pRetryTimer->expires_from_now(std::chrono::milliseconds(ACCEPT_RETRY_MS));
+				pRetryTimer->async_wait(pStrand->wrap([this,weak_self](asio::error_code err_code)
+					{
+						auto self = weak_self.lock();
+						if(!self || err_code || !pAcceptor)
+							return;
+						Accept();
+					}));
+				return;
+			}
+			Accept();
+		}));
+}
+
+void ModbusTCPServer::SessionClosed(const std::shared_ptr<Session>& pSession)
+{
+	pStrand->post([this,weak_self{weak_from_this()},pSession]()
+		{
+			auto self = weak_self.lock();
+			if(!self)
+				return;
+			if(Sessions.erase(pSession))
+			{
+				if(auto log = odc::spdlog_get("ModbusPort"))
+					log->debug("{}: Connection closed ({} remaining)", Name, Sessions.size());
+				ConnectionCountCallback(Sessions.size());
+			}
+		});
+}
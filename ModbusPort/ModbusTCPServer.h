@@ -0,0 +1,78 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusTCPServer.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef MODBUSTCPSERVER_H_
+#define MODBUSTCPSERVER_H_
+
+#include <opendatacon/asio.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+//Modbus TCP server on the shared io_service, for any number of concurrent client connections
+//	Each connection is served in order (one request at a time), independently of the others.
+//	The request handler is given the request PDU and unit id, and calls the reply function (from any thread)
+//	with the response PDU - or an empty PDU to send nothing.
+class ModbusTCPServer: public std::enable_shared_from_this<ModbusTCPServer>
+{
+public:
+	typedef std::function<void(std::vector<uint8_t>&& PDU)> Reply_t;
+	typedef std::function<void(std::vector<uint8_t>&& PDU, const uint8_t UnitID, const Reply_t& Reply)> RequestHandler_t;
+
+	ModbusTCPServer(std::shared_ptr<odc::asio_service> apIOS,
+		const std::string& aName,
+		const std::string& aIP,
+		const uint16_t aPort,
+		const size_t aMaxConnections,
+		const RequestHandler_t& aRequestHandler,
+		const std::function<void(size_t)>& aConnectionCountCallback);
+
+	void Start();
+	void Stop();
+
+private:
+	class Session;
+	void Accept();
+	void SessionClosed(const std::shared_ptr<Session>& pSession);
+
+	std::shared_ptr<odc::asio_service> pIOS;
+	const std::string Name;
+	const std::string IP;
+	const uint16_t Port;
+	const size_t MaxConnections;
+	const RequestHandler_t RequestHandler;
+	const std::function<void(size_t)> ConnectionCountCallback;
+
+	//everything below is only touched on pStrand
+	std::unique_ptr<asio::io_service::strand> pStrand;
+	std::unique_ptr<asio::ip::tcp::acceptor> pAcceptor;
+	std::unique_ptr<asio::steady_timer> pRetryTimer;
+	std::set<std::shared_ptr<Session>> Sessions;
+};
+
+#endif /* MODBUSTCPSERVER_H_ */
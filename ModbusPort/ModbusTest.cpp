@@ -0,0 +1,410 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ModbusTest.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include "ModbusPointConf.h"
+#include "ModbusReadPlan.h"
+#include "ModbusRegisterCodec.h"
+#include "ModbusRegisterMap.h"
+#include <catch.hpp>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SUITE(name) "ModbusTests - " name
+
+namespace
+{
+std::unique_ptr<ModbusPointConf> MakePointConf(const std::string& json)
+{
+	Json::CharReaderBuilder builder;
+	std::unique_ptr<Json::CharReader> const reader(builder.newCharReader());
+	Json::Value root;
+	std::string err_str;
+	REQUIRE(reader->parse(json.data(), json.data()+json.size(), &root, &err_str));
+	auto pConf = std::make_unique<ModbusPointConf>("");
+	pConf->ProcessElements(root);
+	return pConf;
+}
+
+ModbusRegisterCodec MakeCodec(const ModbusDataType Type, const bool WordSwap = false, const bool ByteSwap = false, const double ScaleFactor = 1, const double Offset = 0)
+{
+	ModbusRegisterCodec codec;
+	codec.Type = Type;
+	codec.WordSwap = WordSwap;
+	codec.ByteSwap = ByteSwap;
+	codec.ScaleFactor = ScaleFactor;
+	codec.Offset = Offset;
+	return codec;
+}
+
+//Decodes the register image (as the bytes appear in a PDU) to eng, and encodes eng back to the same image
+void CheckImage(const ModbusRegisterCodec& codec, const double eng, const std::vector<uint8_t>& image)
+{
+	REQUIRE(image.size() == 2*codec.Width());
+
+	double decoded;
+	REQUIRE(codec.Decode(image.data(), decoded));
+	REQUIRE(decoded == Approx(eng));
+
+	uint16_t regs[2];
+	REQUIRE(codec.Encode(eng, regs));
+	std::vector<uint8_t> encoded;
+	for(uint8_t i = 0; i < codec.Width(); i++)
+	{
+		encoded.push_back(static_cast<uint8_t>(regs[i] >> 8));
+		encoded.push_back(static_cast<uint8_t>(regs[i] & 0xFF));
+	}
+	REQUIRE(encoded == image);
+}
+} //namespace
+
+TEST_CASE(SUITE("ReadPlanMergesAdjacentRanges"))
+{
+	//overlapping and touching ranges of the same type become one read and one span
+	auto pConf = MakePointConf(R"({"RegIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 9}},
+		{"Range" : {"Start" : 10, "Stop" : 19}},
+		{"Range" : {"Start" : 15, "Stop" : 24}}]})");
+	ModbusReadPlan plan(*pConf, 0);
+	REQUIRE(plan.ConfiguredRanges() == 3);
+	REQUIRE(plan.PlannedRequests() == 1);
+	const auto& read = plan.Get(0)[0];
+	REQUIRE(read.fc == ModbusFunction::READ_HOLDING_REGISTERS);
+	REQUIRE(read.start == 0);
+	REQUIRE(read.count == 25);
+	REQUIRE(read.spans.size() == 1);
+}
+
+TEST_CASE(SUITE("ReadPlanBridgesGaps"))
+{
+	const std::string json = R"({"InputRegIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 9}},
+		{"Range" : {"Start" : 15, "Stop" : 19}}]})";
+	auto pConf = MakePointConf(json);
+
+	//a gap of 5 addresses is bridged when MaxGap allows it, but the gap isn't a span
+	ModbusReadPlan bridged(*pConf, 5);
+	REQUIRE(bridged.PlannedRequests() == 1);
+	const auto& read = bridged.Get(0)[0];
+	REQUIRE(read.fc == ModbusFunction::READ_INPUT_REGISTERS);
+	REQUIRE(read.start == 0);
+	REQUIRE(read.count == 20);
+	REQUIRE(read.spans.size() == 2);
+	REQUIRE(read.spans[0].start == 0);
+	REQUIRE(read.spans[0].count == 10);
+	REQUIRE(read.spans[1].start == 15);
+	REQUIRE(read.spans[1].count == 5);
+
+	//but not when it's one short
+	ModbusReadPlan separate(*pConf, 4);
+	REQUIRE(separate.PlannedRequests() == 2);
+	REQUIRE(separate.Get(0)[1].start == 15);
+	REQUIRE(separate.Get(0)[1].count == 5);
+}
+
+TEST_CASE(SUITE("ReadPlanPDULimits"))
+{
+	auto pConf = MakePointConf(R"({
+		"RegIndicies" : [{"Range" : {"Start" : 0, "Stop" : 199}}],
+		"BitIndicies" : [{"Range" : {"Start" : 0, "Stop" : 2999}}]})");
+	ModbusReadPlan plan(*pConf, 0);
+	REQUIRE(plan.PlannedRequests() == 4);
+
+	size_t coil_reads = 0, reg_reads = 0;
+	for(const auto& read : plan.Get(0))
+	{
+		if(read.fc == ModbusFunction::READ_COILS)
+		{
+			REQUIRE(read.start == coil_reads*ModbusReadPlan::MAX_READ_BITS);
+			REQUIRE(read.count == (coil_reads == 0 ? 2000 : 1000));
+			coil_reads++;
+		}
+		else
+		{
+			REQUIRE(read.fc == ModbusFunction::READ_HOLDING_REGISTERS);
+			REQUIRE(read.start == reg_reads*ModbusReadPlan::MAX_READ_REGISTERS);
+			REQUIRE(read.count == (reg_reads == 0 ? 125 : 75));
+			reg_reads++;
+		}
+	}
+	REQUIRE(coil_reads == 2);
+	REQUIRE(reg_reads == 2);
+}
+
+TEST_CASE(SUITE("ReadPlanKeepsMultiRegisterValuesWhole"))
+{
+	//125 float32 values - a read can only hold 62 of them (124 registers)
+	auto pFloats = MakePointConf(R"({"RegIndicies" : [{"Range" : {"Start" : 0, "Stop" : 249}, "Type" : "FLOAT32"}]})");
+	ModbusReadPlan floats(*pFloats, 0);
+	REQUIRE(floats.PlannedRequests() == 3);
+	REQUIRE(floats.Get(0)[0].start == 0);
+	REQUIRE(floats.Get(0)[0].count == 124);
+	REQUIRE(floats.Get(0)[1].start == 124);
+	REQUIRE(floats.Get(0)[1].count == 124);
+	REQUIRE(floats.Get(0)[2].start == 248);
+	REQUIRE(floats.Get(0)[2].count == 2);
+
+	//a read with 2 registers of room left takes one float, and the next float starts a new read
+	auto pMixed = MakePointConf(R"({"RegIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 122}},
+		{"Range" : {"Start" : 123, "Stop" : 126}, "Type" : "FLOAT32"}]})");
+	ModbusReadPlan mixed(*pMixed, 0);
+	REQUIRE(mixed.PlannedRequests() == 2);
+	const auto& first = mixed.Get(0)[0];
+	REQUIRE(first.count == 125);
+	REQUIRE(first.spans.size() == 2);
+	REQUIRE(first.spans[1].start == 123);
+	REQUIRE(first.spans[1].count == 2);
+	REQUIRE(first.spans[1].width() == 2);
+	REQUIRE(mixed.Get(0)[1].start == 125);
+	REQUIRE(mixed.Get(0)[1].count == 2);
+
+	//only one register of room - the float isn't split
+	auto pSplit = MakePointConf(R"({"RegIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 123}},
+		{"Range" : {"Start" : 124, "Stop" : 125}, "Type" : "INT32"}]})");
+	ModbusReadPlan split(*pSplit, 0);
+	REQUIRE(split.PlannedRequests() == 2);
+	REQUIRE(split.Get(0)[0].count == 124);
+	REQUIRE(split.Get(0)[1].start == 124);
+	REQUIRE(split.Get(0)[1].count == 2);
+}
+
+TEST_CASE(SUITE("ReadPlanPollGroups"))
+{
+	auto pConf = MakePointConf(R"({"BitIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 9}, "PollGroup" : 1},
+		{"Range" : {"Start" : 10, "Stop" : 19}, "PollGroup" : 2}]})");
+	ModbusReadPlan plan(*pConf, 0);
+	REQUIRE(plan.PlannedRequests() == 2);
+	REQUIRE(plan.Get(1).size() == 1);
+	REQUIRE(plan.Get(1)[0].start == 0);
+	REQUIRE(plan.Get(2).size() == 1);
+	REQUIRE(plan.Get(2)[0].start == 10);
+	REQUIRE(plan.Get(3).empty());
+	//ids index the whole plan
+	REQUIRE(plan.Get(0)[0].id == 0);
+	REQUIRE(plan.Get(0)[1].id == 1);
+}
+
+TEST_CASE(SUITE("ReadPlanRejectsOverlappingDecoding"))
+{
+	//the first config of an address wins, so nothing is decoded (and published) twice
+	auto pConf = MakePointConf(R"({"RegIndicies" : [
+		{"Range" : {"Start" : 0, "Stop" : 9}},
+		{"Range" : {"Start" : 5, "Stop" : 8}, "Type" : "FLOAT32"},
+		{"Range" : {"Start" : 8, "Stop" : 13}, "Type" : "INT32"}]})");
+	ModbusReadPlan plan(*pConf, 0);
+	REQUIRE(plan.PlannedRequests() == 1);
+	const auto& read = plan.Get(0)[0];
+	REQUIRE(read.start == 0);
+	REQUIRE(read.count == 14);
+	//the float is entirely covered, and the int32 loses its first (overlapped) value
+	REQUIRE(read.spans.size() == 2);
+	REQUIRE(read.spans[0].start == 0);
+	REQUIRE(read.spans[0].count == 10);
+	REQUIRE(read.spans[0].codec == nullptr);
+	REQUIRE(read.spans[1].start == 10);
+	REQUIRE(read.spans[1].count == 4);
+	REQUIRE(read.spans[1].width() == 2);
+}
+
+TEST_CASE(SUITE("RegisterCodec16Bit"))
+{
+	CheckImage(MakeCodec(ModbusDataType::UINT16), 4660, {0x12,0x34});
+	CheckImage(MakeCodec(ModbusDataType::UINT16), 65535, {0xFF,0xFF});
+	CheckImage(MakeCodec(ModbusDataType::UINT16,false,true), 4660, {0x34,0x12});
+	CheckImage(MakeCodec(ModbusDataType::INT16), -2, {0xFF,0xFE});
+	CheckImage(MakeCodec(ModbusDataType::INT16), -32768, {0x80,0x00});
+	CheckImage(MakeCodec(ModbusDataType::INT16,false,true), -2, {0xFE,0xFF});
+	//word order means nothing for one register
+	CheckImage(MakeCodec(ModbusDataType::INT16,true), 1000, {0x03,0xE8});
+}
+
+TEST_CASE(SUITE("RegisterCodec32Bit"))
+{
+	//100000 == 0x000186A0
+	CheckImage(MakeCodec(ModbusDataType::UINT32), 100000, {0x00,0x01,0x86,0xA0});
+	CheckImage(MakeCodec(ModbusDataType::UINT32,true), 100000, {0x86,0xA0,0x00,0x01});
+	CheckImage(MakeCodec(ModbusDataType::UINT32,false,true), 100000, {0x01,0x00,0xA0,0x86});
+	CheckImage(MakeCodec(ModbusDataType::UINT32,true,true), 100000, {0xA0,0x86,0x01,0x00});
+	CheckImage(MakeCodec(ModbusDataType::UINT32), 4294967295.0, {0xFF,0xFF,0xFF,0xFF});
+
+	//-100000 == 0xFFFE7960
+	CheckImage(MakeCodec(ModbusDataType::INT32), -100000, {0xFF,0xFE,0x79,0x60});
+	CheckImage(MakeCodec(ModbusDataType::INT32,true), -100000, {0x79,0x60,0xFF,0xFE});
+	CheckImage(MakeCodec(ModbusDataType::INT32,false,true), -100000, {0xFE,0xFF,0x60,0x79});
+	CheckImage(MakeCodec(ModbusDataType::INT32,true,true), -100000, {0x60,0x79,0xFE,0xFF});
+
+	//1.5f == 0x3FC00000, -2.25f == 0xC0100000
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32), 1.5, {0x3F,0xC0,0x00,0x00});
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32), -2.25, {0xC0,0x10,0x00,0x00});
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32,true), 1.5, {0x00,0x00,0x3F,0xC0});
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32,false,true), 1.5, {0xC0,0x3F,0x00,0x00});
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32,true,true), -2.25, {0x00,0x00,0x10,0xC0});
+}
+
+TEST_CASE(SUITE("RegisterCodecBCD"))
+{
+	CheckImage(MakeCodec(ModbusDataType::BCD16), 1234, {0x12,0x34});
+	CheckImage(MakeCodec(ModbusDataType::BCD16), 9999, {0x99,0x99});
+	CheckImage(MakeCodec(ModbusDataType::BCD16,false,true), 1234, {0x34,0x12});
+	CheckImage(MakeCodec(ModbusDataType::BCD32), 12345678, {0x12,0x34,0x56,0x78});
+	CheckImage(MakeCodec(ModbusDataType::BCD32,true), 12345678, {0x56,0x78,0x12,0x34});
+	CheckImage(MakeCodec(ModbusDataType::BCD32,true,true), 12345678, {0x78,0x56,0x34,0x12});
+
+	//a nibble over 9 isn't BCD
+	double eng;
+	const uint8_t bad16[] = {0x12,0xA4};
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::BCD16).Decode(bad16, eng));
+	const uint8_t bad32[] = {0x12,0x34,0x56,0x7F};
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::BCD32).Decode(bad32, eng));
+}
+
+TEST_CASE(SUITE("RegisterCodecScaling"))
+{
+	//eng = raw*ScaleFactor + Offset: raw 1000 (0x03E8) -> 1000*0.1 - 50
+	CheckImage(MakeCodec(ModbusDataType::INT16,false,false,0.1,-50), 50, {0x03,0xE8});
+	//raw -100000 -> -100000*0.01 + 1000
+	CheckImage(MakeCodec(ModbusDataType::INT32,true,false,0.01,1000), 0, {0x79,0x60,0xFF,0xFE});
+	CheckImage(MakeCodec(ModbusDataType::FLOAT32,false,false,2,1), 4, {0x3F,0xC0,0x00,0x00});
+	CheckImage(MakeCodec(ModbusDataType::BCD16,false,false,10), 12340, {0x12,0x34});
+
+	//integer types round to the nearest raw value on the way out
+	uint16_t regs[2];
+	REQUIRE(MakeCodec(ModbusDataType::UINT16,false,false,0.1).Encode(12.36, regs));
+	REQUIRE(regs[0] == 124);
+}
+
+TEST_CASE(SUITE("RegisterCodecEncodeRange"))
+{
+	uint16_t regs[2];
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::UINT16).Encode(65536, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::UINT16).Encode(-1, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::INT16).Encode(32768, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::INT16).Encode(-32769, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::UINT32).Encode(4294967296.0, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::INT32).Encode(2147483648.0, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::FLOAT32).Encode(1e39, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::BCD16).Encode(10000, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::BCD32).Encode(100000000, regs));
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::INT32).Encode(std::nan(""), regs));
+	//the range is of the raw value, after scaling
+	REQUIRE_FALSE(MakeCodec(ModbusDataType::INT16,false,false,0.1).Encode(3276.8, regs));
+	REQUIRE(MakeCodec(ModbusDataType::INT16,false,false,0.1).Encode(3276.7, regs));
+}
+
+TEST_CASE(SUITE("RegisterCodecFromJSON"))
+{
+	//no descriptor members means the legacy 16-bit handling
+	Json::Value plain;
+	plain["Range"]["Start"] = 0;
+	REQUIRE(ModbusRegisterCodec::FromJSON(plain) == nullptr);
+
+	Json::Value typed;
+	typed["Type"] = "FLOAT32";
+	typed["WordOrder"] = "LITTLE";
+	typed["ByteOrder"] = "BIG";
+	typed["ScaleFactor"] = 0.5;
+	typed["Offset"] = 3;
+	auto codec = ModbusRegisterCodec::FromJSON(typed);
+	REQUIRE(codec);
+	REQUIRE(*codec == MakeCodec(ModbusDataType::FLOAT32,true,false,0.5,3));
+	REQUIRE(codec->Width() == 2);
+
+	//a zero scale factor would make the values unwritable
+	Json::Value zero;
+	zero["ScaleFactor"] = 0;
+	REQUIRE(ModbusRegisterCodec::FromJSON(zero)->ScaleFactor == 1);
+}
+
+TEST_CASE(SUITE("RegisterMapReadWrite"))
+{
+	auto pConf = MakePointConf(R"({
+		"BitIndicies" : [{"Range" : {"Start" : 0, "Stop" : 9}}],
+		"RegIndicies" : [{"Range" : {"Start" : 0, "Stop" : 3}}, {"Range" : {"Start" : 10, "Stop" : 11}}]})");
+	ModbusRegisterMap map(*pConf);
+	using Table = ModbusRegisterMap::Table;
+
+	REQUIRE(map.Valid(Table::COILS, 0, 10));
+	REQUIRE_FALSE(map.Valid(Table::COILS, 5, 6));
+	REQUIRE_FALSE(map.Valid(Table::HOLDING_REGISTERS, 2, 4)); //4-9 aren't configured
+	REQUIRE_FALSE(map.Valid(Table::INPUT_REGISTERS, 0, 1));
+
+	map.SetBit(Table::COILS, 0, true);
+	map.SetBit(Table::COILS, 9, true);
+	uint8_t packed[2];
+	map.GetBits(Table::COILS, 0, 10, packed);
+	REQUIRE(packed[0] == 0x01);
+	REQUIRE(packed[1] == 0x02);
+
+	const uint16_t regs[] = {0x1234, 0xABCD};
+	map.SetRegisters(Table::HOLDING_REGISTERS, 10, regs, 2);
+	uint8_t data[4];
+	map.GetRegisters(Table::HOLDING_REGISTERS, 10, 2, data);
+	REQUIRE(data[0] == 0x12);
+	REQUIRE(data[1] == 0x34);
+	REQUIRE(data[2] == 0xAB);
+	REQUIRE(data[3] == 0xCD);
+}
+
+TEST_CASE(SUITE("RegisterMapUntornUpdates"))
+{
+	//two writers keep both registers of a value equal - a reader must never see them differ
+	auto pConf = MakePointConf(R"({
+		"RegIndicies" : [{"Range" : {"Start" : 0, "Stop" : 1}}],
+		"InputRegIndicies" : [{"Range" : {"Start" : 0, "Stop" : 1}}]})");
+	ModbusRegisterMap map(*pConf);
+	using Table = ModbusRegisterMap::Table;
+
+	std::atomic<bool> stop(false);
+	std::vector<std::thread> writers;
+	for(uint16_t w = 0; w < 2; w++)
+		writers.emplace_back([&map,&stop,w]()
+			{
+				for(uint16_t n = 0; !stop; n++)
+				{
+					const uint16_t regs[] = {static_cast<uint16_t>(n+w*0x8000), static_cast<uint16_t>(n+w*0x8000)};
+					map.SetRegisters(Table::HOLDING_REGISTERS, 0, regs, 2);
+					map.SetRegisters(Table::INPUT_REGISTERS, 0, regs, 2);
+				}
+			});
+
+	size_t torn = 0;
+	for(size_t i = 0; i < 100000; i++)
+	{
+		uint8_t data[4];
+		map.GetRegisters(i%2 ? Table::HOLDING_REGISTERS : Table::INPUT_REGISTERS, 0, 2, data);
+		if(data[0] != data[2] || data[1] != data[3])
+			torn++;
+	}
+	stop = true;
+	for(auto& writer : writers)
+		writer.join();
+	REQUIRE(torn == 0);
+}
@@ -27,6 +27,9 @@
 #include "ModbusOutstationPort.h"
 #include "ModbusMasterPort.h"
 
+#define CATCH_CONFIG_RUNNER
+#include <catch.hpp>
+
 extern "C" ModbusMasterPort* new_ModbusMasterPort(const std::string& Name, const std::string& File, const Json::Value& Overrides)
 {
 	return new ModbusMasterPort(Name,File,Overrides);
@@ -48,3 +51,8 @@ extern "C" void delete_ModbusOutstationPort(ModbusOutstationPort* aModbusOutstat
 	delete aModbusOutstationPort_ptr;
 	return;
 }
+
+extern "C" int run_tests( int argc, char* argv[] )
+{
+	return Catch::Session().run( argc, argv );
+}
@@ -24,12 +24,187 @@
  *      Author: Neil Stephens <dearknarl@gmail.com>
  */
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <sys/stat.h>
 #include <opendatacon/ConfigParser.h>
 #include <opendatacon/util.h>
 
-std::unordered_map<std::string,Json::Value> ConfigParser::JSONCache;
+std::unordered_map<std::string,ConfigParser::CachedFile> ConfigParser::JSONCache;
+std::mutex ConfigParser::JSONCacheMtx;
+bool ConfigParser::JSONCacheChanged = false;
+
+namespace
+{
+//Size and content hash are used to tell if a snapshot of a file is stale
+//	the size is just a cheap first check - an edit can keep the size (and the mtime, within its resolution)
+bool GetFileSize(const std::string& FileName, uint64_t& Size)
+{
+	struct stat file_stat;
+	if(stat(FileName.c_str(), &file_stat) != 0)
+		return false;
+	Size = static_cast<uint64_t>(file_stat.st_size);
+	return true;
+}
+bool ReadFile(const std::string& FileName, std::string& Content)
+{
+	std::ifstream fin(FileName, std::ios::binary);
+	if(fin.fail())
+		return false;
+	Content.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+	return !fin.bad();
+}
+//64-bit FNV-1a
+uint64_t HashContent(const std::string& Content)
+{
+	uint64_t hash = 0xcbf29ce484222325ULL;
+	for(auto ch : Content)
+	{
+		hash ^= static_cast<uint8_t>(ch);
+		hash *= 0x100000001b3ULL;
+	}
+	return hash;
+}
+
+//Compact type-tagged binary encoding of Json::Value
+//	much cheaper to read back than text, because there's no tokenising or number parsing
+const char SnapshotMagic[] = "ODCCONFSNAP2";
+
+template<typename T>
+void WriteRaw(std::ostream& out, const T& val)
+{
+	out.write(reinterpret_cast<const char*>(&val), sizeof(T));
+}
+void WriteString(std::ostream& out, const std::string& str)
+{
+	WriteRaw(out, static_cast<uint32_t>(str.size()));
+	out.write(str.data(), str.size());
+}
+void WriteValue(std::ostream& out, const Json::Value& val)
+{
+	WriteRaw(out, static_cast<uint8_t>(val.type()));
+	switch(val.type())
+	{
+		case Json::nullValue:
+			break;
+		case Json::intValue:
+			WriteRaw(out, static_cast<int64_t>(val.asInt64()));
+			break;
+		case Json::uintValue:
+			WriteRaw(out, static_cast<uint64_t>(val.asUInt64()));
+			break;
+		case Json::realValue:
+			WriteRaw(out, val.asDouble());
+			break;
+		case Json::stringValue:
+			WriteString(out, val.asString());
+			break;
+		case Json::booleanValue:
+			WriteRaw(out, static_cast<uint8_t>(val.asBool()));
+			break;
+		case Json::arrayValue:
+			WriteRaw(out, static_cast<uint32_t>(val.size()));
+			for(const auto& element : val)
+				WriteValue(out, element);
+			break;
+		case Json::objectValue:
+			WriteRaw(out, static_cast<uint32_t>(val.size()));
+			for(auto it = val.begin(); it != val.end(); ++it)
+			{
+				WriteString(out, it.name());
+				WriteValue(out, *it);
+			}
+			break;
+	}
+}
+
+//Reads from an in-memory copy of the snapshot, throws on truncated or corrupt data
+class SnapshotReader
+{
+public:
+	explicit SnapshotReader(std::string&& aData):
+		data(std::move(aData)),
+		pos(0)
+	{}
+	bool AtEnd() const { return pos == data.size(); }
+	template<typename T>
+	T ReadRaw()
+	{
+		Need(sizeof(T));
+		T val;
+		memcpy(&val, data.data()+pos, sizeof(T));
+		pos += sizeof(T);
+		return val;
+	}
+	std::string ReadString()
+	{
+		auto len = ReadRaw<uint32_t>();
+		Need(len);
+		std::string str(data.data()+pos, len);
+		pos += len;
+		return str;
+	}
+	void ReadValue(Json::Value& val)
+	{
+		switch(static_cast<Json::ValueType>(ReadRaw<uint8_t>()))
+		{
+			case Json::nullValue:
+				val = Json::Value::nullSingleton();
+				break;
+			case Json::intValue:
+				val = Json::Value(static_cast<Json::Int64>(ReadRaw<int64_t>()));
+				break;
+			case Json::uintValue:
+				val = Json::Value(static_cast<Json::UInt64>(ReadRaw<uint64_t>()));
+				break;
+			case Json::realValue:
+				val = Json::Value(ReadRaw<double>());
+				break;
+			case Json::stringValue:
+				val = Json::Value(ReadString());
+				break;
+			case Json::booleanValue:
+				val = Json::Value(ReadRaw<uint8_t>() != 0);
+				break;
+			case Json::arrayValue:
+			{
+				auto count = ReadRaw<uint32_t>();
+				val = Json::Value(Json::arrayValue);
+				if(count > 0)
+					val.resize(count);
+				for(Json::ArrayIndex n = 0; n < count; n++)
+					ReadValue(val[n]);
+				break;
+			}
+			case Json::objectValue:
+			{
+				auto count = ReadRaw<uint32_t>();
+				val = Json::Value(Json::objectValue);
+				for(uint32_t n = 0; n < count; n++)
+				{
+					auto key = ReadString();
+					ReadValue(val[key]);
+				}
+				break;
+			}
+			default:
+				throw std::runtime_error("Invalid value type");
+		}
+	}
+private:
+	void Need(size_t n)
+	{
+		if(data.size() - pos < n)
+			throw std::runtime_error("Unexpected end of data");
+	}
+	const std::string data;
+	size_t pos;
+};
+} //namespace
 
 ConfigParser::ConfigParser(const std::string& aConfFilename, const Json::Value& aConfOverrides):
 	ConfFilename(aConfFilename),
@@ -38,13 +213,15 @@ ConfigParser::ConfigParser(const std::string& aConfFilename, const Json::Value&
 
 void ConfigParser::ProcessInherits(const std::string& FileName)
 {
-	Json::Value* pJSONRoot;
+	//cached roots are shared between threads - only use const access
+	const Json::Value* pJSONRoot;
 	pJSONRoot = RecallOrCreate(FileName);
 	if(pJSONRoot != nullptr)
 	{
-		if(!(*pJSONRoot)["Inherits"].isNull())
-			for(Json::ArrayIndex n=0; n<(*pJSONRoot)["Inherits"].size(); n++)
-				ProcessInherits((*pJSONRoot)["Inherits"][n].asString());
+		const Json::Value& Inherits = (*pJSONRoot)["Inherits"];
+		if(!Inherits.isNull())
+			for(Json::ArrayIndex n=0; n<Inherits.size(); n++)
+				ProcessInherits(Inherits[n].asString());
 		ProcessElements(*pJSONRoot);
 	}
 }
@@ -57,41 +234,152 @@ void ConfigParser::ProcessFile()
 		ProcessElements(ConfOverrides);
 }
 
-Json::Value* ConfigParser::RecallOrCreate(const std::string& FileName)
+const Json::Value* ConfigParser::RecallOrCreate(const std::string& FileName)
 {
-	if(!(JSONCache.count(FileName))) //not cached - read it in
 	{
-		std::ifstream fin(FileName);
-		if (fin.fail())
+		std::lock_guard<std::mutex> lck(JSONCacheMtx);
+		auto cached = JSONCache.find(FileName);
+		if(cached != JSONCache.end())
+			return &cached->second.Root;
+	}
+
+	//not cached - read it in
+	//	don't hold the lock while parsing, so different files can be parsed in parallel
+	CachedFile file;
+	std::string content;
+	if (!ReadFile(FileName, content))
+	{
+		std::string msg("Config file " + FileName + " open fail.");
+		if(auto log = odc::spdlog_get("opendatacon"))
+			log->error(msg);
+		else
+			std::cerr << "ERROR: " << msg << std::endl;
+		return nullptr;
+	}
+	file.Size = content.size();
+	file.Hash = HashContent(content);
+
+	Json::CharReaderBuilder JSONReader;
+	std::unique_ptr<Json::CharReader> const pReader(JSONReader.newCharReader());
+	std::string err_str;
+	bool parse_success = pReader->parse(content.data(), content.data()+content.size(), &file.Root, &err_str);
+	if (!parse_success)
+	{
+		std::string msg("Failed to parse configuration from '" + FileName + "' : " + err_str);
+		if(auto log = odc::spdlog_get("opendatacon"))
+			log->error(msg);
+		else
+			std::cerr << "ERROR: " << msg <<std::endl;
+		return nullptr;
+	}
+
+	std::lock_guard<std::mutex> lck(JSONCacheMtx);
+	//if another thread beat us to it, emplace keeps theirs
+	auto inserted = JSONCache.emplace(FileName, std::move(file));
+	if(inserted.second)
+		JSONCacheChanged = true;
+	return &inserted.first->second.Root;
+}
+
+size_t ConfigParser::LoadSnapshot(const std::string& SnapshotFilename)
+{
+	std::ifstream fin(SnapshotFilename, std::ios::binary);
+	if(fin.fail())
+		return 0;
+	std::string data((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+	std::unordered_map<std::string,CachedFile> recalled;
+	size_t stale_count = 0;
+	try
+	{
+		SnapshotReader reader(std::move(data));
+		for(auto ch : std::string(SnapshotMagic))
+			if(reader.ReadRaw<char>() != ch)
+				throw std::runtime_error("Not a config snapshot");
+
+		while(!reader.AtEnd())
 		{
-			std::string msg("Config file " + FileName + " open fail.");
-			if(auto log = odc::spdlog_get("opendatacon"))
-				log->error(msg);
+			auto FileName = reader.ReadString();
+			CachedFile file;
+			file.Size = reader.ReadRaw<uint64_t>();
+			file.Hash = reader.ReadRaw<uint64_t>();
+			reader.ReadValue(file.Root);
+
+			uint64_t size;
+			std::string content;
+			if(GetFileSize(FileName, size) && size == file.Size
+			   && ReadFile(FileName, content) && HashContent(content) == file.Hash)
+				recalled.emplace(FileName, std::move(file));
 			else
-				std::cerr << "ERROR: " << msg << std::endl;
-			return nullptr;
+				stale_count++;
 		}
-		Json::CharReaderBuilder JSONReader;
-		std::string err_str;
-		bool parse_success = Json::parseFromStream(JSONReader,fin, &JSONCache[FileName], &err_str);
-		if (!parse_success)
+	}
+	catch(const std::exception& e)
+	{
+		std::string msg("Ignoring config snapshot '" + SnapshotFilename + "' : " + e.what());
+		if(auto log = odc::spdlog_get("opendatacon"))
+			log->warn(msg);
+		else
+			std::cerr << "WARNING: " << msg << std::endl;
+		return 0;
+	}
+
+	std::lock_guard<std::mutex> lck(JSONCacheMtx);
+	size_t count = 0;
+	for(auto& file : recalled)
+		if(JSONCache.emplace(file.first, std::move(file.second)).second)
+			count++;
+	//stale files will be re-parsed, so the snapshot will need refreshing
+	if(stale_count > 0)
+		JSONCacheChanged = true;
+	return count;
+}
+
+bool ConfigParser::SaveSnapshot(const std::string& SnapshotFilename)
+{
+	std::lock_guard<std::mutex> lck(JSONCacheMtx);
+	if(!JSONCacheChanged)
+		return false;
+
+	//write to a temporary, then rename, so we never leave a half written snapshot
+	const std::string temp_filename = SnapshotFilename + ".tmp";
+	{
+		std::ofstream fout(temp_filename, std::ios::binary | std::ios::trunc);
+		if(fout.fail())
+			return false;
+		fout.write(SnapshotMagic, sizeof(SnapshotMagic)-1);
+		for(const auto& file : JSONCache)
 		{
-			std::string msg("Failed to parse configuration from '" + FileName + "' : " + err_str);
-			if(auto log = odc::spdlog_get("opendatacon"))
-				log->error(msg);
-			else
-				std::cerr << "ERROR: " << msg <<std::endl;
-			return nullptr;
+			WriteString(fout, file.first);
+			WriteRaw(fout, file.second.Size);
+			WriteRaw(fout, file.second.Hash);
+			WriteValue(fout, file.second.Root);
 		}
+		if(fout.fail())
+			return false;
 	}
-	return &JSONCache[FileName];
+	std::remove(SnapshotFilename.c_str());
+	if(std::rename(temp_filename.c_str(), SnapshotFilename.c_str()) != 0)
+		return false;
+
+	JSONCacheChanged = false;
+	return true;
+}
+
+void ConfigParser::ClearCache()
+{
+	std::lock_guard<std::mutex> lck(JSONCacheMtx);
+	JSONCache.clear();
+	JSONCacheChanged = false;
 }
 
 const Json::Value ConfigParser::GetConfiguration(const std::string& pFileName)
 {
-	if(JSONCache.count(pFileName))
+	std::lock_guard<std::mutex> lck(JSONCacheMtx);
+	auto cached = JSONCache.find(pFileName);
+	if(cached != JSONCache.end())
 	{
-		return JSONCache[pFileName];
+		return cached->second.Root;
 	}
 
 	return Json::Value();
@@ -30,6 +30,7 @@ namespace odc
 {
 
 std::unordered_map<std::string,IOHandler*> IOHandler::IOHandlers;
+std::mutex IOHandler::IOHandlersMtx;
 
 std::unordered_map<std::string, IOHandler*>& IOHandler::GetIOHandlers()
 {
@@ -40,15 +41,28 @@ IOHandler::IOHandler(const std::string& aName):
 	InitState(InitState_t::ENABLED),
 	EnableDelayms(0),
 	Name(aName),
+	ID(InternName(aName)),
 	pIOS(asio_service::Get()),
-	enabled(false)
+	enabled(false),
+	FirstConnectTime(0)
 {
+	//IOHandlers can be constructed in parallel
+	std::lock_guard<std::mutex> lck(IOHandlersMtx);
 	IOHandlers[Name]=this;
 }
 
 void IOHandler::Subscribe(IOHandler* pIOHandler, const std::string& aName)
 {
-	this->Subscribers[aName] = pIOHandler;
+	auto id = InternName(aName);
+	for(auto& IOHandler_pair : Subscribers)
+	{
+		if(IOHandler_pair.first == id)
+		{
+			IOHandler_pair.second = pIOHandler;
+			return;
+		}
+	}
+	Subscribers.emplace_back(id,pIOHandler);
 }
 
 bool DemandMap::InDemand()
@@ -60,21 +74,21 @@ bool DemandMap::InDemand()
 	return false;
 }
 
-bool DemandMap::MuxConnectionEvents(ConnectState state, const std::string& SenderName)
+bool DemandMap::MuxConnectionEvents(ConnectState state, NameID_t SenderID)
 {
 	if (state == ConnectState::DISCONNECTED)
 	{
 		{
 			std::lock_guard<std::mutex> lck (mtx);
-			connection_demands[SenderName] = false;
+			connection_demands[SenderID] = false;
 		}
 		return !InDemand();
 	}
 	else if (state == ConnectState::CONNECTED)
 	{
 		std::lock_guard<std::mutex> lck (mtx);
-		bool new_demand = !connection_demands[SenderName];
-		connection_demands[SenderName] = true;
+		bool new_demand = !connection_demands[SenderID];
+		connection_demands[SenderID] = true;
 		return new_demand;
 	}
 	return true;
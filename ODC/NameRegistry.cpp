@@ -0,0 +1,121 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * NameRegistry.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+
+#include <opendatacon/NameRegistry.h>
+#include <opendatacon/util.h>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace odc
+{
+
+//Names are stored in fixed size chunks that never move once allocated,
+//	so NameOf() can index them without taking a lock
+static constexpr size_t ChunkBits = 8;
+static constexpr size_t ChunkSize = 1 << ChunkBits;
+static constexpr size_t MaxChunks = 4096;
+typedef std::array<std::string,ChunkSize> NameChunk_t;
+
+struct NameRegistry
+{
+	std::array<std::atomic<NameChunk_t*>,MaxChunks> Chunks{};
+	std::vector<std::unique_ptr<NameChunk_t>> ChunkStore;
+	std::atomic<NameID_t> Count{0};
+	std::unordered_map<std::string,NameID_t> IDs;
+	std::shared_mutex mtx;
+	std::atomic_bool Full{false};
+
+	NameRegistry()
+	{
+		Add(""); //the empty name is id 0
+	}
+
+	//must hold unique lock
+	//	returns the empty name's id if the registry is full, so interning never throws (it's done constructing events)
+	NameID_t Add(const std::string& name)
+	{
+		const NameID_t id = Count;
+		const size_t chunk = id >> ChunkBits;
+		if(chunk >= MaxChunks)
+		{
+			if(!Full.exchange(true))
+			{
+				if(auto log = odc::spdlog_get("opendatacon"))
+					log->error("Name registry full ({} names) - new names will be treated as empty", id);
+			}
+			return 0;
+		}
+		if(!Chunks[chunk])
+		{
+			ChunkStore.push_back(std::make_unique<NameChunk_t>());
+			Chunks[chunk] = ChunkStore.back().get();
+		}
+		(*Chunks[chunk])[id & (ChunkSize-1)] = name;
+		IDs[name] = id;
+		Count = id+1;
+		return id;
+	}
+};
+
+static NameRegistry& GetNameRegistry()
+{
+	static NameRegistry Registry;
+	return Registry;
+}
+
+NameID_t InternName(const std::string& name)
+{
+	//the empty name (the default event source) is always 0 - no need to look it up
+	if(name.empty())
+		return 0;
+	auto& reg = GetNameRegistry();
+	{
+		std::shared_lock<std::shared_mutex> lck(reg.mtx);
+		auto it = reg.IDs.find(name);
+		if(it != reg.IDs.end())
+			return it->second;
+	}
+	std::unique_lock<std::shared_mutex> lck(reg.mtx);
+	//check again - someone else may have added it while we weren't holding the lock
+	auto it = reg.IDs.find(name);
+	if(it != reg.IDs.end())
+		return it->second;
+	return reg.Add(name);
+}
+
+const std::string& NameOf(const NameID_t id)
+{
+	auto& reg = GetNameRegistry();
+	if(id >= reg.Count)
+		return (*reg.Chunks[0])[0];
+	return (*reg.Chunks[id >> ChunkBits])[id & (ChunkSize-1)];
+}
+
+} //namespace odc
@@ -52,6 +52,18 @@ std::shared_ptr<spdlog::details::thread_pool> spdlog_thread_pool()
 	return spdlog::thread_pool();
 }
 
+bool spdlog_overrun_count(size_t& count)
+{
+#if defined(SPDLOG_VERSION) && SPDLOG_VERSION >= 10800
+	if(auto pool = spdlog::thread_pool())
+	{
+		count = pool->overrun_counter();
+		return true;
+	}
+#endif
+	return false;
+}
+
 void spdlog_flush_all()
 {
 	spdlog::apply_all([](const std::shared_ptr<spdlog::logger>& l) {l->flush(); });
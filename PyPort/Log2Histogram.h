@@ -0,0 +1,89 @@
+/*	opendatacon
+*
+*	Copyright (c) 2018:
+*
+*		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+*		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+*
+*	Licensed under the Apache License, Version 2.0 (the "License");
+*	you may not use this file except in compliance with the License.
+*	You may obtain a copy of the License at
+*
+*		http://www.apache.org/licenses/LICENSE-2.0
+*
+*	Unless required by applicable law or agreed to in writing, software
+*	distributed under the License is distributed on an "AS IS" BASIS,
+*	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+*	See the License for the specific language governing permissions and
+*	limitations under the License.
+*/
+/*
+* Log2Histogram.h
+*
+*  Created on: 19/10/2026
+*/
+
+#ifndef LOG2HISTOGRAM_H_
+#define LOG2HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <json/json.h>
+
+// Counts values into power of two buckets (0-1, 2-3, 4-7, 8-15...), the last bucket takes everything bigger.
+// Only atomics, so it can be added to from the python strand and read for the statistics from anywhere.
+class Log2Histogram
+{
+public:
+	Log2Histogram()
+	{
+		for (auto& bucket : Buckets)
+			bucket = 0;
+	}
+
+	void Add(uint64_t value)
+	{
+		size_t b = 0;
+		while (((value >> b) > 1) && (b < Buckets.size() - 1))
+			b++;
+		Buckets[b]++;
+		Count++;
+		Total += value;
+
+		uint64_t max = Max.load();
+		while ((value > max) && !Max.compare_exchange_weak(max, value))
+		{}
+	}
+
+	// Buckets are listed up to the last one with anything in it, as {"UpTo": n, "Count": n}
+	Json::Value ToJson() const
+	{
+		Json::Value hist;
+		const uint64_t count = Count.load();
+		hist["Count"] = Json::UInt64(count);
+		hist["Mean"] = count ? double(Total.load()) / count : 0.0;
+		hist["Max"] = Json::UInt64(Max.load());
+		hist["Buckets"] = Json::arrayValue;
+
+		size_t used = Buckets.size();
+		while ((used > 0) && (Buckets[used - 1].load() == 0))
+			used--;
+		for (size_t b = 0; b < used; b++)
+		{
+			Json::Value bucket;
+			bucket["UpTo"] = Json::UInt64((uint64_t(2) << b) - 1);
+			bucket["Count"] = Json::UInt64(Buckets[b].load());
+			hist["Buckets"].append(bucket);
+		}
+		return hist;
+	}
+
+private:
+	std::array<std::atomic<uint64_t>, 32> Buckets;
+	std::atomic<uint64_t> Count{0};
+	std::atomic<uint64_t> Total{0};
+	std::atomic<uint64_t> Max{0};
+};
+
+#endif
@@ -34,13 +34,16 @@
 // So leave the extension bit out for the moment, just get to the pont where we can load the class and call its methods...
 
 #include "PyPort.h"
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <cstdio>
 #include <ctime>
 #include <ctime>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <sstream>
 #include <utility>
 #include <vector>
@@ -163,9 +166,13 @@ void PyPort::Build()
 			LOGSTRAND("Entered Strand on Build");
 			// If first time constructor is called, will instansiate the interpreter.
 			// Pass in a pointer to our SetTimer method, so it can be called from Python code - bit circular - I know!
-			// Also pass in a PublishEventCall method, so Python can send us Events to Publish.
+			// Also pass in PublishEventCall and PublishEventsCall methods, so Python can send us Events to Publish.
 			pWrapper = std::make_unique<PythonWrapper>(this->Name, pIOS, std::bind(&PyPort::SetTimer, this, std::placeholders::_1, std::placeholders::_2),
-				std::bind(&PyPort::PublishEventCall, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4));
+				std::bind(&PyPort::PublishEventCall, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4),
+				std::bind(&PyPort::PublishEventsCall, this, std::placeholders::_1));
+			pWrapper->SetBinaryEventMarshalling(MyConf->pyBinaryEventMarshalling);
+			if (MyConf->pyEventsAreQueued)
+				pWrapper->CreateEventQueue(MyConf->pyEventQueueSize, MyConf->pyEventQueueOverflow);
 			LOGDEBUG("pWrapper Created #####");
 			try
 			{
@@ -174,6 +181,17 @@ void PyPort::Build()
 
 			      pWrapper->Config(JSONMain, JSONOverride);
 			      LOGDEBUG("Loaded Python Module \"{}\" ", MyConf->pyModuleName);
+
+			      if (MyConf->pyEventBatchWindowms != 0)
+			      {
+				      if (pWrapper->HasEventsHandler())
+				      {
+					      EventBatchTimer = pIOS->make_steady_timer();
+					      EventBatching = true;
+				      }
+				      else
+					      LOGERROR("EventBatchWindowms is set, but the Python class has no EventsHandler method - events will not be batched");
+			      }
 			}
 			catch (std::exception& e)
 			{
@@ -319,12 +337,13 @@ void PyPort::Disable()
 	python_strand->dispatch([this]()
 		{
 			LOGSTRAND("Entered Strand on Disable");
+			FlushEventBatch(); // Anything already batched was accepted while we were enabled
 			pWrapper->Disable();
 			LOGSTRAND("Exit Strand");
 		});
 }
 
-std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromStrParams(const std::string& EventTypeStr, size_t& ODCIndex, const std::string& QualityStr, const std::string& PayloadStr, const std::string& Name)
+std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromStrParams(const std::string& EventTypeStr, size_t& ODCIndex, const std::string& QualityStr, const std::string& PayloadStr, const NameID_t SourceID)
 {
 	EventType EventTypeResult;
 	if (!GetEventTypeFromStringName(EventTypeStr, EventTypeResult))
@@ -351,14 +370,14 @@ std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromStrParams(const std::stri
 				LOGERROR("Invalid Connection State passed from Python Code to ODC - {}", PayloadStr);
 				return nullptr;
 			}
-			pubevent = std::make_shared<EventInfo>(EventType::ConnectState, 0, Name);
+			pubevent = std::make_shared<EventInfo>(EventType::ConnectState, 0, SourceID);
 			pubevent->SetPayload<EventType::ConnectState>(std::move(state));
 		}
 		break;
 
 		case EventType::Binary:
 		{
-			pubevent = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, Name, QualityResult);
+			pubevent = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, SourceID, QualityResult);
 			bool val = (PayloadStr.find('1') != std::string::npos);
 			pubevent->SetPayload<EventType::Binary>(std::move(val));
 		}
@@ -367,7 +386,7 @@ std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromStrParams(const std::stri
 		case EventType::Analog:
 			try
 			{
-				pubevent = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, Name, QualityResult);
+				pubevent = std::make_shared<EventInfo>(EventType::Analog, ODCIndex, SourceID, QualityResult);
 				double dval = std::stod(PayloadStr);
 				pubevent->SetPayload<EventType::Analog>(std::move(dval));
 
@@ -392,7 +411,7 @@ std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromStrParams(const std::stri
 		case EventType::ControlRelayOutputBlock:
 			try
 			{
-				pubevent = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, Name, QualityResult);
+				pubevent = std::make_shared<EventInfo>(EventType::ControlRelayOutputBlock, ODCIndex, SourceID, QualityResult);
 				// Payload String looks like: "|LATCH_ON|Count 1|ON 100ms|OFF 100ms|"
 				EventTypePayload<EventType::ControlRelayOutputBlock>::type val;
 				auto Parts = split(PayloadStr, '|');
@@ -457,11 +476,101 @@ void PyPort::PublishEventCall(const std::string &EventTypeStr, size_t ODCIndex,
 	//LOGDEBUG("PyPort Publish Event {}, {}, {}, {}", EventTypeStr, ODCIndex, QualityStr, PayloadStr);
 
 	// Separate call to allow testing
-	std::shared_ptr<EventInfo> pubevent = CreateEventFromStrParams(EventTypeStr, ODCIndex, QualityStr, PayloadStr, Name);
+	std::shared_ptr<EventInfo> pubevent = CreateEventFromStrParams(EventTypeStr, ODCIndex, QualityStr, PayloadStr, GetID());
 
 	if (pubevent)
 		PublishEvent(pubevent);
 }
+
+// Counter values come from Python as doubles - anything negative, fractional, NaN or too big can't be converted.
+static bool TypedValueToCounter(const double Value, uint32_t& Counter)
+{
+	if (!std::isfinite(Value) || (Value < 0) || (Value > std::numeric_limits<uint32_t>::max()) || (std::trunc(Value) != Value))
+		return false;
+	Counter = static_cast<uint32_t>(Value);
+	return true;
+}
+
+// The typed version of the above, the values have already been converted from Python objects so there is no string parsing.
+// Sets the payload from the double value as appropriate for the event type. Returns nullptr for types we can't handle.
+std::shared_ptr<odc::EventInfo> PyPort::CreateEventFromTypedParams(const PyTypedEvent& TypedEvent, const NameID_t SourceID)
+{
+	std::shared_ptr<odc::EventInfo> pubevent;
+
+	switch (TypedEvent.Type)
+	{
+		case EventType::ConnectState:
+		{
+			const double value = TypedEvent.Value;
+			if (!std::isfinite(value) || (std::trunc(value) != value)
+			    || (value < static_cast<double>(ConnectState::PORT_UP)) || (value > static_cast<double>(ConnectState::PORT_DOWN)))
+			{
+				LOGERROR("Invalid Connection State passed from Python Code to ODC - {}", value);
+				return nullptr;
+			}
+			auto state = static_cast<ConnectState>(static_cast<int>(value));
+			pubevent = std::make_shared<EventInfo>(EventType::ConnectState, 0, SourceID);
+			pubevent->SetPayload<EventType::ConnectState>(std::move(state));
+		}
+		break;
+		case EventType::Binary:
+			pubevent = std::make_shared<EventInfo>(EventType::Binary, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::Binary>(TypedEvent.Value != 0);
+			break;
+		case EventType::BinaryOutputStatus:
+			pubevent = std::make_shared<EventInfo>(EventType::BinaryOutputStatus, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::BinaryOutputStatus>(TypedEvent.Value != 0);
+			break;
+		case EventType::Analog:
+			pubevent = std::make_shared<EventInfo>(EventType::Analog, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::Analog>(double(TypedEvent.Value));
+			break;
+		case EventType::AnalogOutputStatus:
+			pubevent = std::make_shared<EventInfo>(EventType::AnalogOutputStatus, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::AnalogOutputStatus>(double(TypedEvent.Value));
+			break;
+		case EventType::Counter:
+		{
+			uint32_t count;
+			if (!TypedValueToCounter(TypedEvent.Value, count))
+			{
+				LOGERROR("Invalid Counter value passed from Python Code to ODC - {}", TypedEvent.Value);
+				return nullptr;
+			}
+			pubevent = std::make_shared<EventInfo>(EventType::Counter, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::Counter>(std::move(count));
+		}
+		break;
+		case EventType::FrozenCounter:
+		{
+			uint32_t count;
+			if (!TypedValueToCounter(TypedEvent.Value, count))
+			{
+				LOGERROR("Invalid FrozenCounter value passed from Python Code to ODC - {}", TypedEvent.Value);
+				return nullptr;
+			}
+			pubevent = std::make_shared<EventInfo>(EventType::FrozenCounter, TypedEvent.ODCIndex, SourceID, TypedEvent.Quality);
+			pubevent->SetPayload<EventType::FrozenCounter>(std::move(count));
+		}
+		break;
+		default:
+			LOGERROR("PublishEvents from Python passed an EventType that we can't handle - {}", ToString(TypedEvent.Type));
+			break;
+	}
+	return pubevent;
+}
+
+// Called from odc.PublishEvents with a whole batch of events from the Python code. As for PublishEventCall, no feedback.
+void PyPort::PublishEventsCall(const std::vector<PyTypedEvent>& Events)
+{
+	for (const auto& TypedEvent : Events)
+	{
+		std::shared_ptr<EventInfo> pubevent = CreateEventFromTypedParams(TypedEvent, GetID());
+
+		if (pubevent)
+			PublishEvent(pubevent);
+	}
+}
 std::string getISOCurrentTimestampUTC_from_msSinceEpoch_t(const odc::msSinceEpoch_t& ts)
 {
 	// TimeDate Needs to be "2019-07-17T01:34:20.072Z" ISO8601 format.
@@ -536,8 +645,8 @@ void PyPort::Event(std::shared_ptr<const EventInfo> event, const std::string& Se
 				event->GetPayloadString(),                                 // 4
 				SenderName,                                                // 5
 				TagValue);                                                 // 6
-			pWrapper->QueueEvent(jsonevent);
 			LOGTRACE("Queued Event {}", jsonevent);
+			pWrapper->QueueEvent(std::move(jsonevent));
 			PostCallbackCall(pStatusCallback, CommandStatus::SUCCESS);
 		}
 		catch(std::exception& e)
@@ -547,16 +656,88 @@ void PyPort::Event(std::shared_ptr<const EventInfo> event, const std::string& Se
 	}
 	else
 	{
-		python_strand->dispatch([this, event, SenderName, pStatusCallback]()
+		auto Arrived = std::chrono::steady_clock::now();
+		python_strand->dispatch([this, event, SenderName, pStatusCallback, Arrived]()
 			{
 				LOGSTRAND("Entered Strand on Event");
+				if (EventBatching)
+				{
+				      QueueBatchedEvent({ event, SenderName, pStatusCallback, Arrived });
+				      LOGSTRAND("Exit Strand");
+				      return;
+				}
 				CommandStatus result = pWrapper->Event(event, SenderName); // Expect no long processing or waits in the python code to handle this.
+				EventLatencyus.Add(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - Arrived).count());
 
 				PostCallbackCall(pStatusCallback, result);
 				LOGSTRAND("Exit Strand");
 			});
 	}
 }
+// Only called on the python_strand. The batch goes to Python when it reaches EventBatchMaxCount, or EventBatchWindowms after the first event arrived.
+void PyPort::QueueBatchedEvent(PyBatchedEvent&& BatchedEvent)
+{
+	EventBatch.push_back(std::move(BatchedEvent));
+	if (EventBatch.size() >= MyConf->pyEventBatchMaxCount)
+	{
+		FlushEventBatch();
+	}
+	else if (EventBatch.size() == 1)
+	{
+		// The generation stops a window timer that was already on its way from flushing a later batch early.
+		auto generation = EventBatchGeneration;
+		EventBatchTimer->expires_from_now(std::chrono::milliseconds(MyConf->pyEventBatchWindowms));
+		EventBatchTimer->async_wait(python_strand->wrap(
+			[this, generation](asio::error_code err_code)
+			{
+				if ((err_code != asio::error::operation_aborted) && (generation == EventBatchGeneration))
+				{
+				      LOGSTRAND("Entered Strand on EventBatchTimer");
+				      FlushEventBatch();
+				      LOGSTRAND("Exit Strand");
+				}
+			}));
+	}
+}
+
+// Only called on the python_strand. One call into Python for the whole batch, then resolve each status callback from the results.
+void PyPort::FlushEventBatch()
+{
+	EventBatchGeneration++;
+	if (EventBatch.empty())
+		return;
+
+	std::vector<PyBatchedEvent> Batch;
+	Batch.swap(EventBatch);
+
+	std::vector<CommandStatus> Results;
+	pWrapper->Events(Batch, Results);
+
+	auto now = std::chrono::steady_clock::now();
+	EventBatchSize.Add(Batch.size());
+	for (size_t i = 0; i < Batch.size(); i++)
+	{
+		EventLatencyus.Add(std::chrono::duration_cast<std::chrono::microseconds>(now - Batch[i].Arrived).count());
+		PostCallbackCall(Batch[i].pStatusCallback, Results[i]);
+	}
+}
+
+const Json::Value PyPort::GetStatistics() const
+{
+	Json::Value stats;
+	stats["EventBatchWindowms"] = MyConf->pyEventBatchWindowms;
+	stats["EventBatchMaxCount"] = Json::UInt64(MyConf->pyEventBatchMaxCount);
+	stats["EventBatchSize"] = EventBatchSize.ToJson();
+	stats["EventLatencyus"] = EventLatencyus.ToJson();
+	if (pWrapper)
+	{
+		stats["EventQueue"]["Size"] = Json::UInt64(pWrapper->GetEventQueueSize());
+		stats["EventQueue"]["Capacity"] = Json::UInt64(pWrapper->GetEventQueueCapacity());
+		stats["EventQueue"]["Dropped"] = Json::UInt64(pWrapper->GetEventQueueDropped());
+	}
+	return stats;
+}
+
 void PyPort::SetTimer(uint32_t id, uint32_t delayms)
 {
 	if (!enabled)
@@ -655,6 +836,26 @@ void PyPort::ProcessElements(const Json::Value& JSONRoot)
 		MyConf->pyEventsAreQueued = JSONRoot["EventsAreQueued"].asBool();
 	if (JSONRoot.isMember("OnlyQueueEventsWithTags"))
 		MyConf->pyOnlyQueueEventsWithTags = JSONRoot["OnlyQueueEventsWithTags"].asBool();
+	if (JSONRoot.isMember("EventQueueSize"))
+		MyConf->pyEventQueueSize = std::max(2u, JSONRoot["EventQueueSize"].asUInt());
+	if (JSONRoot.isMember("EventQueueOverflow"))
+	{
+		auto overflow = JSONRoot["EventQueueOverflow"].asString();
+		if (overflow == "DropNewest")
+			MyConf->pyEventQueueOverflow = EventQueueOverflow::DropNewest;
+		else if (overflow == "DropOldest")
+			MyConf->pyEventQueueOverflow = EventQueueOverflow::DropOldest;
+		else if (overflow == "Block")
+			MyConf->pyEventQueueOverflow = EventQueueOverflow::Block;
+		else
+			LOGERROR("Invalid EventQueueOverflow {}, should be DropNewest, DropOldest or Block", overflow);
+	}
+	if (JSONRoot.isMember("BinaryEventMarshalling"))
+		MyConf->pyBinaryEventMarshalling = JSONRoot["BinaryEventMarshalling"].asBool();
+	if (JSONRoot.isMember("EventBatchWindowms"))
+		MyConf->pyEventBatchWindowms = JSONRoot["EventBatchWindowms"].asUInt();
+	if (JSONRoot.isMember("EventBatchMaxCount"))
+		MyConf->pyEventBatchMaxCount = std::max(1u, JSONRoot["EventBatchMaxCount"].asUInt());
 
 	//TODO: The following parameter should always be set to the same value. If different throw an exception as the conf file is wrong!
 	if (JSONRoot.isMember("GlobalUseSystemPython"))
@@ -27,6 +27,7 @@
 #ifndef PYPORT_H_
 #define PYPORT_H_
 #include "PythonWrapper.h"
+#include "Log2Histogram.h"
 #include "PyPortConf.h"
 #include "../HTTP/HttpServerManager.h"
 #include <opendatacon/DataPort.h>
@@ -60,8 +61,11 @@ public:
 	void SetTimer(uint32_t id, uint32_t delayms);
 	void RestHandler(const std::string& url, const std::string& content, const ResponseCallback_t& pResponseCallback);
 	void PublishEventCall(const std::string &EventTypeStr, size_t ODCIndex, const std::string &QualityStr, const std::string &PayloadStr);
+	void PublishEventsCall(const std::vector<PyTypedEvent>& Events);
+	const Json::Value GetStatistics() const override;
 
-	static std::shared_ptr<odc::EventInfo> CreateEventFromStrParams(const std::string& EventTypeStr, size_t& ODCIndex, const std::string& QualityStr, const std::string& PayloadStr, const std::string &Name);
+	static std::shared_ptr<odc::EventInfo> CreateEventFromStrParams(const std::string& EventTypeStr, size_t& ODCIndex, const std::string& QualityStr, const std::string& PayloadStr, const NameID_t SourceID);
+	static std::shared_ptr<odc::EventInfo> CreateEventFromTypedParams(const PyTypedEvent& TypedEvent, const NameID_t SourceID);
 
 	// Keep track of each PyPort so static methods can get access to the correct PyPort instance
 	static std::unordered_map<PyObject*, PyPort*> PyPorts;
@@ -84,6 +88,16 @@ private:
 
 	ServerTokenType pServer;
 
+	// Event batching into the Python EventsHandler. Only touched on the python_strand (apart from the histograms).
+	bool EventBatching = false;
+	std::vector<PyBatchedEvent> EventBatch;
+	pTimer_t EventBatchTimer;
+	uint64_t EventBatchGeneration = 0;
+	Log2Histogram EventBatchSize;
+	Log2Histogram EventLatencyus; // From arriving in Event until Python has returned the status
+	void QueueBatchedEvent(PyBatchedEvent&& BatchedEvent);
+	void FlushEventBatch();
+
 	// We need one strand, for ALL python ports, so that we control access to the Python Interpreter to one thread.
 	static std::shared_ptr<asio::io_context::strand> python_strand;
 	static std::once_flag python_strand_flag;
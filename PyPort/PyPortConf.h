@@ -27,6 +27,7 @@
 #ifndef PyPortCONF_H_
 #define PyPortCONF_H_
 
+#include "SpecialEventQueue.h"
 #include <memory>
 #include <string>
 #include <opendatacon/DataPortConf.h>
@@ -42,6 +43,11 @@ public:
 		pyHTTPPort("8000"),
 		pyQueueFormatString("{{\"Tag\" : \"{0}\", \"Idx\" : {1}, \"Val\" : \"{4}\", \"Qual\" : \"{3}\", \"TS\" : \"{2}\"}}"),
 		pyEventsAreQueued(false),
+		pyEventQueueSize(65536),
+		pyEventQueueOverflow(EventQueueOverflow::DropNewest),
+		pyBinaryEventMarshalling(false),
+		pyEventBatchWindowms(0),
+		pyEventBatchMaxCount(100),
 		pyOnlyQueueEventsWithTags(false),
 		GlobalUseSystemPython(false)
 	{}
@@ -52,6 +58,11 @@ public:
 	std::string pyHTTPPort;
 	std::string pyQueueFormatString;
 	bool pyEventsAreQueued;
+	size_t pyEventQueueSize; // Rounded up to a power of 2. The slots are preallocated (~40 bytes each), so the default is for normal traffic - set EventQueueSize to 1000000 for the previous limit
+	EventQueueOverflow pyEventQueueOverflow;
+	bool pyBinaryEventMarshalling;
+	uint32_t pyEventBatchWindowms; // 0 is no batching, each event is a separate call into Python
+	size_t pyEventBatchMaxCount;
 	bool pyOnlyQueueEventsWithTags;
 	bool GlobalUseSystemPython;
 
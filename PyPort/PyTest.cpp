@@ -33,6 +33,7 @@
 #include <array>
 #include <cassert>
 #include <chrono>
+#include <cmath>
 #include <cstdint>
 #include <fstream>
 #include <thread>
@@ -296,11 +297,201 @@ private:
 #define TEST_PythonPort5(overridejson)\
 	auto PythonPort5 = std::make_shared<PyPort>("TestMaster5", conffilename1, overridejson); \
 	PythonPort5->Build()
+#define TEST_PythonPort6(overridejson)\
+	auto PythonPort6 = std::make_shared<PyPort>("TestMaster6", conffilename1, overridejson); \
+	PythonPort6->Build()
+#define TEST_PythonPort7(overridejson)\
+	auto PythonPort7 = std::make_shared<PyPort>("TestMaster7", conffilename1, overridejson); \
+	PythonPort7->Build()
 
 #ifdef _MSC_VER
 #pragma endregion TEST_HELPERS
 #endif
 
+namespace EventQueueTests
+{
+TEST_CASE("Py.SpecialEventQueue")
+{
+	SIMPLE_TEST_SETUP();
+
+	INFO("DropNewest")
+	{
+		SpecialEventQueue<std::string> q(5, EventQueueOverflow::DropNewest);
+		REQUIRE(q.Capacity() == 8);
+		for (int i = 0; i < 8; i++)
+			REQUIRE(q.push(std::to_string(i)));
+		REQUIRE_FALSE(q.push("8"));
+		REQUIRE(q.Size() == 8);
+		REQUIRE(q.Dropped() == 1);
+
+		std::string val;
+		REQUIRE(q.pop(val));
+		REQUIRE(val == "0");
+		REQUIRE(q.Size() == 7);
+	}
+	INFO("DropOldest")
+	{
+		SpecialEventQueue<std::string> q(4, EventQueueOverflow::DropOldest);
+		for (int i = 0; i < 6; i++)
+			REQUIRE(q.push(std::to_string(i)));
+		REQUIRE(q.Size() == 4);
+		REQUIRE(q.Dropped() == 2);
+
+		std::vector<std::string> vals;
+		REQUIRE(q.pop(vals, 10) == 4);
+		REQUIRE(vals == std::vector<std::string>({ "2", "3", "4", "5" }));
+		REQUIRE(q.Size() == 0);
+		std::string val;
+		REQUIRE_FALSE(q.pop(val));
+	}
+	INFO("BatchPopAndWrap")
+	{
+		SpecialEventQueue<uint64_t> q(4);
+		uint64_t next_push = 0, next_pop = 0;
+		for (int lap = 0; lap < 100; lap++)
+		{
+			while (q.push(next_push))
+				next_push++;
+			std::vector<uint64_t> vals;
+			REQUIRE(q.pop(vals, 3) == 3);
+			REQUIRE(q.Size() == 1);
+			uint64_t val;
+			REQUIRE(q.pop(val));
+			vals.push_back(val);
+			for (auto v : vals)
+				REQUIRE(v == next_pop++);
+		}
+		REQUIRE(next_pop == 400);
+	}
+	INFO("Block")
+	{
+		SpecialEventQueue<uint64_t> q(4, EventQueueOverflow::Block);
+		for (uint64_t i = 0; i < 4; i++)
+			REQUIRE(q.push(i));
+		std::atomic<bool> pushed(false);
+		std::thread producer([&q,&pushed]()
+			{
+				q.push(4);
+				pushed = true;
+			});
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		REQUIRE_FALSE(pushed);
+		uint64_t val;
+		REQUIRE(q.pop(val));
+		producer.join();
+		REQUIRE(pushed);
+		REQUIRE(q.Size() == 4);
+		REQUIRE(q.Dropped() == 0);
+	}
+	INFO("MultiProducer")
+	{
+		// Small queue so the producers keep lapping the ring and blocking. Every item arrives once, and in order for each producer.
+		const uint64_t Producers = 4;
+		const uint64_t PerProducer = 100000;
+		SpecialEventQueue<uint64_t> q(1024, EventQueueOverflow::Block);
+
+		std::vector<std::thread> threads;
+		for (uint64_t p = 0; p < Producers; p++)
+		{
+			threads.emplace_back([&q,p,PerProducer]()
+				{
+					for (uint64_t i = 0; i < PerProducer; i++)
+						q.push((p << 32) | i);
+				});
+		}
+
+		std::vector<uint64_t> next(Producers, 0);
+		uint64_t received = 0;
+		bool inorder = true;
+		std::vector<uint64_t> vals;
+		while (received < Producers * PerProducer)
+		{
+			vals.clear();
+			q.pop(vals, 100);
+			for (auto v : vals)
+			{
+				auto p = v >> 32;
+				if ((p >= Producers) || ((v & 0xFFFFFFFF) != next[p]))
+					inorder = false;
+				else
+					next[p]++;
+			}
+			received += vals.size();
+		}
+		for (auto& t : threads)
+			t.join();
+
+		REQUIRE(inorder);
+		REQUIRE(received == Producers * PerProducer);
+		REQUIRE(q.Size() == 0);
+		REQUIRE(q.Dropped() == 0);
+	}
+
+	STANDARD_TEST_TEARDOWN();
+}
+
+// Push and pop rates for queued json event strings, with a single batched consumer and increasing numbers of producer threads.
+TEST_CASE("Py.SpecialEventQueueBenchmark", "[.benchmark]")
+{
+	SIMPLE_TEST_SETUP();
+
+	const size_t PerProducer = 250000;
+	const std::string JsonEvent = "{\"Tag\" : \"Test2\", \"Idx\" : 2, \"Val\" : \"1\", \"Quality\" : \"|ONLINE|\", \"TS\" : \"2019-07-17T01:34:20.072Z\"}";
+
+	std::cout << "SpecialEventQueue, " << PerProducer << " events per producer" << std::endl;
+	for (size_t Producers : { 1, 2, 4, 8 })
+	{
+		SpecialEventQueue<std::string> q(65536, EventQueueOverflow::Block);
+
+		// Make the strings up front, so we are timing the queue and not the allocations
+		std::vector<std::vector<std::string>> events(Producers, std::vector<std::string>(PerProducer, JsonEvent));
+
+		std::atomic<size_t> ready(0);
+		std::atomic<bool> go(false);
+		std::vector<double> push_secs(Producers);
+		std::vector<std::thread> threads;
+		for (size_t p = 0; p < Producers; p++)
+		{
+			threads.emplace_back([&,p]()
+				{
+					ready++;
+					while (!go)
+						std::this_thread::yield();
+					auto start = std::chrono::high_resolution_clock::now();
+					for (auto& e : events[p])
+						q.push(std::move(e));
+					push_secs[p] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+				});
+		}
+		while (ready < Producers)
+			std::this_thread::yield();
+
+		size_t received = 0;
+		std::vector<std::string> vals;
+		vals.reserve(1000);
+		auto start = std::chrono::high_resolution_clock::now();
+		go = true;
+		while (received < Producers * PerProducer)
+		{
+			vals.clear();
+			received += q.pop(vals, 1000);
+		}
+		auto pop_secs = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+		for (auto& t : threads)
+			t.join();
+
+		double push_rate = 0;
+		for (size_t p = 0; p < Producers; p++)
+			push_rate += PerProducer / push_secs[p];
+
+		std::cout << "  " << Producers << " producer(s) : push " << push_rate << " events/sec, pop " << (received / pop_secs) << " events/sec" << std::endl;
+		REQUIRE(received == Producers * PerProducer);
+	}
+
+	STANDARD_TEST_TEARDOWN();
+}
+}
+
 namespace EventTests
 {
 void CheckEventStringConversions(const std::shared_ptr<EventInfo>& inevent)
@@ -312,7 +503,7 @@ void CheckEventStringConversions(const std::shared_ptr<EventInfo>& inevent)
 	size_t ODCIndex = inevent->GetIndex();
 
 	// Create a new event from those strings
-	std::shared_ptr<EventInfo> pubevent = PyPort::CreateEventFromStrParams(EventTypeStr, ODCIndex, QualityStr, PayloadStr, "Testing");
+	std::shared_ptr<EventInfo> pubevent = PyPort::CreateEventFromStrParams(EventTypeStr, ODCIndex, QualityStr, PayloadStr, InternName("Testing"));
 
 	// Check that we got back data matching the original event.
 	REQUIRE(odc::ToString(pubevent->GetEventType()) == EventTypeStr);
@@ -364,6 +555,54 @@ TEST_CASE("Py.TestEventStringConversions")
 	STANDARD_TEST_TEARDOWN();
 }
 
+TEST_CASE("Py.TestTypedEventCreation")
+{
+	// The typed events from odc.PublishEvents should come out the same as the string version
+	STANDARD_TEST_SETUP();
+
+	size_t ODCIndex = 1001;
+
+	auto binevent = PyPort::CreateEventFromTypedParams({ EventType::Binary, 1001, QualityFlags::ONLINE | QualityFlags::RESTART, 1 }, InternName("Testing"));
+	auto strbinevent = PyPort::CreateEventFromStrParams("Binary", ODCIndex, "|ONLINE|RESTART|", "1", InternName("Testing"));
+	REQUIRE(binevent);
+	REQUIRE(binevent->GetEventType() == strbinevent->GetEventType());
+	REQUIRE(binevent->GetIndex() == strbinevent->GetIndex());
+	REQUIRE(binevent->GetQuality() == strbinevent->GetQuality());
+	REQUIRE(binevent->GetPayload<EventType::Binary>() == strbinevent->GetPayload<EventType::Binary>());
+
+	auto anaevent = PyPort::CreateEventFromTypedParams({ EventType::Analog, 1001, QualityFlags::ONLINE, 100.1 }, InternName("Testing"));
+	auto stranaevent = PyPort::CreateEventFromStrParams("Analog", ODCIndex, "|ONLINE|", "100.1", InternName("Testing"));
+	REQUIRE(anaevent);
+	REQUIRE(anaevent->GetEventType() == stranaevent->GetEventType());
+	REQUIRE(anaevent->GetQuality() == stranaevent->GetQuality());
+	REQUIRE(anaevent->GetPayload<EventType::Analog>() == stranaevent->GetPayload<EventType::Analog>());
+
+	auto cntevent = PyPort::CreateEventFromTypedParams({ EventType::Counter, 12, QualityFlags::ONLINE, 65537 }, InternName("Testing"));
+	REQUIRE(cntevent);
+	REQUIRE(cntevent->GetIndex() == 12);
+	REQUIRE(cntevent->GetPayload<EventType::Counter>() == 65537);
+
+	auto csevent = PyPort::CreateEventFromTypedParams({ EventType::ConnectState, 0, QualityFlags::NONE, static_cast<double>(ConnectState::CONNECTED) }, InternName("Testing"));
+	REQUIRE(csevent);
+	REQUIRE(csevent->GetPayload<EventType::ConnectState>() == ConnectState::CONNECTED);
+
+	// Bad connect state and not handled types give nothing to publish
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::ConnectState, 0, QualityFlags::NONE, 7 }, InternName("Testing")) == nullptr);
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::OctetString, 1, QualityFlags::ONLINE, 0 }, InternName("Testing")) == nullptr);
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::ConnectState, 0, QualityFlags::NONE, 1.5 }, InternName("Testing")) == nullptr);
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::ConnectState, 0, QualityFlags::NONE, std::nan("") }, InternName("Testing")) == nullptr);
+
+	// Counter values that don't fit a uint32_t are rejected rather than converted
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::Counter, 12, QualityFlags::ONLINE, -1 }, InternName("Testing")) == nullptr);
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::Counter, 12, QualityFlags::ONLINE, 1e20 }, InternName("Testing")) == nullptr);
+	REQUIRE(PyPort::CreateEventFromTypedParams({ EventType::FrozenCounter, 12, QualityFlags::ONLINE, std::nan("") }, InternName("Testing")) == nullptr);
+	auto maxcntevent = PyPort::CreateEventFromTypedParams({ EventType::FrozenCounter, 12, QualityFlags::ONLINE, 4294967295.0 }, InternName("Testing"));
+	REQUIRE(maxcntevent);
+	REQUIRE(maxcntevent->GetPayload<EventType::FrozenCounter>() == 4294967295u);
+
+	STANDARD_TEST_TEARDOWN();
+}
+
 uint32_t GetProcessedEventsFromJSON(const std::string& jsonstr)
 {
 	Json::Value root;
@@ -587,6 +826,76 @@ TEST_CASE("Py.TestsUsingPython")
 		} ());
 	LOGDEBUG("Ports1-4 Disabled");
 
+	INFO("BatchedEvents")
+	{
+		Json::Value portoverride;
+		portoverride["EventBatchWindowms"] = static_cast<Json::UInt>(20);
+		portoverride["EventBatchMaxCount"] = static_cast<Json::UInt>(50);
+		TEST_PythonPort6(portoverride);
+
+		PythonPort6->Enable();
+		REQUIRE_NOTHROW([IOS,PythonPort6]()
+			{
+				if (!WaitIOSFnResult(IOS, 11, [PythonPort6]()
+					{
+						return (PythonPort6->Enabled());
+					}))
+				{
+				      throw std::runtime_error("Waiting for Port6 to Enable timed out");
+				}
+			} ());
+
+		std::atomic<size_t> done_count(0);
+		std::atomic<size_t> success_count(0);
+		auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&done_count,&success_count](CommandStatus command_stat)
+			{
+				if (command_stat == CommandStatus::SUCCESS)
+					success_count++;
+				done_count++;
+			});
+
+		// Not a multiple of the batch size, so the last few have to go when the window times out
+		const size_t EventCount = 520;
+		for (size_t ODCIndex = 0; ODCIndex < EventCount; ODCIndex++)
+		{
+			auto boolevent = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, "Testing", QualityFlags::ONLINE);
+			boolevent->SetPayload<EventType::Binary>(ODCIndex % 2 == 0);
+			PythonPort6->Event(boolevent, "TestHarness", pStatusCallback);
+		}
+
+		REQUIRE_NOTHROW([IOS,&done_count,EventCount]()
+			{
+				if (!WaitIOSFnResult(IOS, 10, [&done_count,EventCount]()
+					{
+						return (done_count >= EventCount);
+					}))
+				{
+				      throw std::runtime_error("Waiting for batched event callbacks timed out");
+				}
+			} ());
+		REQUIRE(success_count == EventCount);
+
+		auto stats = PythonPort6->GetStatistics();
+		LOGDEBUG("Port6 Statistics {}", stats.toStyledString());
+		REQUIRE(stats["EventLatencyus"]["Count"].asUInt64() == EventCount);
+		REQUIRE(stats["EventBatchSize"]["Max"].asUInt64() <= 50);
+		REQUIRE(stats["EventBatchSize"]["Count"].asUInt64() >= EventCount / 50);
+		REQUIRE(stats["EventBatchSize"]["Count"].asUInt64() < EventCount);
+
+		PythonPort6->Disable();
+		REQUIRE_NOTHROW([IOS,PythonPort6]()
+			{
+				if (!WaitIOSFnResult(IOS, 11, [PythonPort6]()
+					{
+						return (!PythonPort6->Enabled());
+					}))
+				{
+				      throw std::runtime_error("Waiting for Port6 to be disabled timed out");
+				}
+			} ());
+		LOGDEBUG("Port6 Disabled");
+	}
+
 	INFO("QueuedEvents")
 	{
 		LOGERROR("Queued Events Tests..");
@@ -690,7 +999,7 @@ TEST_CASE("Py.TestsUsingPython")
 			{
 				if (!WaitIOSFnResult(IOS, 6, [PythonPort5]()
 					{
-						if(PythonPort5->GetEventQueueSize() > 1)
+						if(PythonPort5->GetEventQueueSize() > 0)
 							return false;
 						return true;
 					}))
@@ -719,8 +1028,58 @@ TEST_CASE("Py.TestsUsingPython")
 
 		size_t QueueSize = PythonPort5->GetEventQueueSize();
 
-		REQUIRE(ProcessedEvents == 14999);
-		REQUIRE(QueueSize == 1);
+		REQUIRE(ProcessedEvents == 15000);
+		REQUIRE(QueueSize == 0);
+
+		// Port5 drains with odc.GetNextEvent, Port7 does the same with odc.GetNextEvents
+		Json::Value batchoverride;
+		batchoverride["EventsAreQueued"] = static_cast<Json::UInt>(1);
+		batchoverride["EventBatchSize"] = static_cast<Json::UInt>(100);
+		TEST_PythonPort7(batchoverride);
+
+		PythonPort7->Enable();
+		REQUIRE_NOTHROW([IOS,PythonPort7]()
+			{
+				if (!WaitIOSFnResult(IOS, 11, [PythonPort7]()
+					{
+						return (PythonPort7->Enabled());
+					}))
+				{
+				      throw std::runtime_error("Waiting for Port7 to Enable timed out");
+				}
+			} ());
+
+		const uint32_t BatchEventCount = 1050; // Not a multiple of the batch size
+		std::atomic<size_t> batch_count(0);
+		auto batch_callback = std::make_shared<std::function<void (CommandStatus status)>>([&batch_count] (CommandStatus status)
+			{
+				batch_count++;
+			});
+		for (uint32_t ODCIndex = 1; ODCIndex <= BatchEventCount; ODCIndex++)
+		{
+			auto boolevent = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, "Testing3");
+			boolevent->SetPayload<EventType::Binary>(ODCIndex % 2 == 0);
+			PythonPort7->Event(boolevent, "TestHarness", batch_callback);
+		}
+
+		REQUIRE_NOTHROW([IOS,PythonPort7,&batch_count,BatchEventCount]()
+			{
+				if (!WaitIOSFnResult(IOS, 10, [PythonPort7,&batch_count,BatchEventCount]()
+					{
+						return (batch_count >= BatchEventCount) && (PythonPort7->GetEventQueueSize() == 0);
+					}))
+				{
+				      throw std::runtime_error("Waiting for batch queued events timed out");
+				}
+			} ());
+
+		callresp = "";
+		REQUIRE(DoHttpRequst("localhost", "10000", "/TestMaster7", callresp));
+		pos = callresp.find(matchstr);
+		REQUIRE(pos != std::string::npos);
+		REQUIRE(GetProcessedEventsFromJSON(callresp.substr(pos + matchstr.length())) == BatchEventCount);
+
+		PythonPort7->Disable();
 
 		LOGDEBUG("Tests Complete, starting teardown");
 
@@ -746,6 +1105,198 @@ TEST_CASE("Py.TestsUsingPython")
 	LOGDEBUG("Test Teardown complete");
 }
 
+// Hidden, and run on its own by name, as the Python interpreter can only be started once per test run. Compares events/sec through PythonWrapper::Event
+// (and back out through the PyPortSim echo) with the default string arguments and with BinaryEventMarshalling.
+TEST_CASE("Py.EventMarshallingBenchmark", "[.benchmark]")
+{
+	STANDARD_TEST_SETUP();
+
+	const size_t EventCount = 20000;
+
+	TEST_PythonPort(Json::nullValue);
+
+	Json::Value binaryoverride;
+	binaryoverride["BinaryEventMarshalling"] = true;
+	TEST_PythonPort2(binaryoverride);
+
+	START_IOS();
+
+	PythonPort->Enable();
+	PythonPort2->Enable();
+	REQUIRE_NOTHROW([=]()
+		{
+			if (!WaitIOSFnResult(IOS, 10, [=]()
+				{
+					return (PythonPort->Enabled() && PythonPort2->Enabled());
+				}))
+			{
+			      throw std::runtime_error("Waiting for Ports to Enable timed out");
+			}
+		} ());
+
+	std::atomic<size_t> done_count(0);
+	std::atomic<size_t> success_count(0);
+	auto pStatusCallback = std::make_shared<std::function<void(CommandStatus)>>([&done_count,&success_count](CommandStatus command_stat)
+		{
+			if (command_stat == CommandStatus::SUCCESS)
+				success_count++;
+			done_count++;
+		});
+
+	std::cout << "PyPort event marshalling, " << EventCount << " events each" << std::endl;
+	for (auto Type : { EventType::Binary, EventType::Analog })
+	{
+		for (const auto& Port : { PythonPort, PythonPort2 })
+		{
+			done_count = 0;
+			success_count = 0;
+			auto start = std::chrono::high_resolution_clock::now();
+			for (size_t ODCIndex = 0; ODCIndex < EventCount; ODCIndex++)
+			{
+				auto event = std::make_shared<EventInfo>(Type, ODCIndex, "Benchmark", QualityFlags::ONLINE);
+				if (Type == EventType::Binary)
+					event->SetPayload<EventType::Binary>(ODCIndex % 2 == 0);
+				else
+					event->SetPayload<EventType::Analog>(ODCIndex * 0.5);
+				Port->Event(event, "TestHarness", pStatusCallback);
+			}
+			REQUIRE_NOTHROW([&]()
+				{
+					if (!WaitIOSFnResult(IOS, 60, [&]()
+						{
+							return done_count >= EventCount;
+						}))
+					{
+					      throw std::runtime_error("Waiting for the events to be processed timed out");
+					}
+				} ());
+			auto secs = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+			REQUIRE(success_count == EventCount);
+
+			std::cout << "  " << ToString(Type) << (Port == PythonPort2 ? " binary : " : " string : ") << (EventCount / secs) << " events/sec" << std::endl;
+		}
+	}
+
+	PythonPort->Disable();
+	PythonPort2->Disable();
+	REQUIRE_NOTHROW([=]()
+		{
+			if (!WaitIOSFnResult(IOS, 10, [=]()
+				{
+					return (!PythonPort->Enabled() && !PythonPort2->Enabled());
+				}))
+			{
+			      throw std::runtime_error("Waiting for Ports to be disabled timed out");
+			}
+		} ());
+
+	STOP_IOS();
+	STANDARD_TEST_TEARDOWN();
+}
+
+// Hidden, as the Python interpreter can only be started once per test run - so run it on its own, by name.
+// Compares how fast PyPortSim can empty the event queue with odc.GetNextEvent (one event per call) against odc.GetNextEvents (batched).
+TEST_CASE("Py.EventQueueDrainBenchmark", "[.benchmark]")
+{
+	STANDARD_TEST_SETUP();
+
+	const uint32_t EventCount = 200000;
+
+	Json::Value singleoverride;
+	singleoverride["EventsAreQueued"] = static_cast<Json::UInt>(1);
+	singleoverride["EventBatchSize"] = static_cast<Json::UInt>(0);
+	TEST_PythonPort(singleoverride);
+
+	Json::Value batchoverride;
+	batchoverride["EventsAreQueued"] = static_cast<Json::UInt>(1);
+	batchoverride["EventBatchSize"] = static_cast<Json::UInt>(1000);
+	TEST_PythonPort2(batchoverride);
+
+	START_IOS();
+
+	PythonPort->Enable();
+	PythonPort2->Enable();
+	REQUIRE_NOTHROW([=]()
+		{
+			if (!WaitIOSFnResult(IOS, 10, [=]()
+				{
+					return (PythonPort->Enabled() && PythonPort2->Enabled());
+				}))
+			{
+			      throw std::runtime_error("Waiting for Ports to Enable timed out");
+			}
+		} ());
+
+	for (const auto& Port : { PythonPort, PythonPort2 })
+	{
+		IOS->post([Port,EventCount]()
+			{
+				for (uint32_t ODCIndex = 1; ODCIndex <= EventCount; ODCIndex++)
+				{
+				      bool val = (ODCIndex % 2 == 0);
+				      auto boolevent = std::make_shared<EventInfo>(EventType::Binary, ODCIndex, "Benchmark");
+				      boolevent->SetPayload<EventType::Binary>(std::move(val));
+				      Port->Event(boolevent, "TestHarness", nullptr);
+				}
+			});
+	}
+
+	auto GetDrainStats = [](const std::string& PortName, uint32_t& ProcessedEvents, double& DrainSeconds)
+				   {
+					   std::string callresp;
+					   if (!DoHttpRequst("localhost", "10000", "/" + PortName, callresp))
+						   return false;
+					   std::string matchstr("json\r\n\n");
+					   size_t pos = callresp.find(matchstr);
+					   if (pos == std::string::npos)
+						   return false;
+
+					   Json::Value root;
+					   Json::CharReaderBuilder jsonReader;
+					   std::string errs;
+					   std::stringstream jsonstream(callresp.substr(pos + matchstr.length()));
+					   if (!Json::parseFromStream(jsonReader, jsonstream, &root, &errs))
+						   return false;
+					   ProcessedEvents = root["processedevents"].asUInt();
+					   DrainSeconds = root["drainseconds"].asDouble();
+					   return true;
+				   };
+
+	uint32_t SingleEvents = 0, BatchEvents = 0;
+	double SingleSeconds = 0, BatchSeconds = 0;
+	REQUIRE_NOTHROW([&]()
+		{
+			if (!WaitIOSFnResult(IOS, 60, [&]()
+				{
+					return GetDrainStats("TestMaster", SingleEvents, SingleSeconds) && GetDrainStats("TestMaster2", BatchEvents, BatchSeconds)
+					       && (SingleEvents == EventCount) && (BatchEvents == EventCount);
+				}))
+			{
+			      throw std::runtime_error("Waiting for the event queues to drain timed out");
+			}
+		} ());
+
+	std::cout << "PyPort event queue drain, " << EventCount << " events" << std::endl
+	          << "  GetNextEvent  : " << SingleSeconds << " sec, " << (SingleEvents / SingleSeconds) << " events/sec" << std::endl
+	          << "  GetNextEvents : " << BatchSeconds << " sec, " << (BatchEvents / BatchSeconds) << " events/sec" << std::endl;
+
+	PythonPort->Disable();
+	PythonPort2->Disable();
+	REQUIRE_NOTHROW([=]()
+		{
+			if (!WaitIOSFnResult(IOS, 10, [=]()
+				{
+					return (!PythonPort->Enabled() && !PythonPort2->Enabled());
+				}))
+			{
+			      throw std::runtime_error("Waiting for Ports to be disabled timed out");
+			}
+		} ());
+
+	STOP_IOS();
+	STANDARD_TEST_TEARDOWN();
+}
+
 }
 
 #endif
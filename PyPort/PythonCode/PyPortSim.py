@@ -1,6 +1,7 @@
 import types
 import json
 import sys
+import time
 from datetime import datetime
 import odc
 
@@ -23,7 +24,7 @@ class SimPortClass:
     ''' Our class to handle an ODC Port. We must have __init__, ProcessJSONConfig, Enable, Disable, EventHander, TimerHandler and
     RestRequestHandler defined, as they will be called by our c/c++ code.
     ODC publishes some functions to this Module (when run) they are part of the odc module(include).
-    We currently have odc.log, odc.SetTimer and odc.PublishEvent.
+    We currently have odc.log, odc.SetTimer, odc.PublishEvent(s), odc.GetNextEvent(s) and odc.GetEventQueueSize.
     '''
 
     # Worker Methods. They need to be high in the code so they are available in the code below. No forward declaration in Python
@@ -50,6 +51,8 @@ class SimPortClass:
         self.ConfigDict = {}      # Config Dictionary
         self.LogDebug("*********** SimPortClass Init Called - File Version 1.002 - {}".format(objectname))
         self.processedevents = 0
+        self.EventBatchSize = 0      # How many queued events to get per odc.GetNextEvents call. 0 gets them one at a time with odc.GetNextEvent
+        self.drainseconds = 0.0      # Time spent emptying the event queue, so the draining rate can be measured.
         return
 
     # Required Method
@@ -79,6 +82,7 @@ class SimPortClass:
         self.LogDebug("Combined (Merged) JSON Config {}".format(json.dumps(self.ConfigDict)))
 
         # Now extract what is needed for this instance, or just reference the ConfigDict when needed.
+        self.EventBatchSize = int(self.ConfigDict.get("EventBatchSize", self.EventBatchSize))
         return
 
     # Required Method
@@ -102,12 +106,23 @@ class SimPortClass:
 
     # Needs to return True or False, which will be translated into CommandStatus::SUCCESS or CommandStatus::UNDEFINED
     # EventType (string) Index (int), Time (msSinceEpoch), Quality (string) Payload (string) Sender (string)
+    # With "BinaryEventMarshalling" set, EventType and Quality are ints (odc.Binary, odc.ONLINE etc.) and Payload is a bool/float/int where possible.
     # There is no callback available, the ODC code expects this method to return without delay.
     def EventHandler(self,EventType, Index, Time, Quality, Payload, Sender):
         self.LogTrace("EventHander: {}, {}, {} {} - {}".format(self.guid,Sender,Index,EventType,Payload))
 
         self.processedevents += 1
 
+        if isinstance(EventType, int):
+            if (EventType == odc.Binary):
+                self.LogDebug("Event is a Binary")
+            if not (Quality & odc.ONLINE):
+                self.LogDebug("Event Quality not ONLINE")
+
+            if not isinstance(Payload, str):
+                odc.PublishEvents(self.guid, [(EventType,Index,Quality,Payload)])  # Echoing Event for testing. Sender, Time auto created in ODC
+            return True
+
         if (EventType == "Binary"):
             self.LogDebug("Event is a Binary")
         if ("ONLINE" not in Quality):
@@ -116,6 +131,11 @@ class SimPortClass:
         odc.PublishEvent(self.guid,EventType,Index,Quality,Payload)  # Echoing Event for testing. Sender, Time auto created in ODC
         return True
 
+    # Optional. Only used when "EventBatchWindowms" is set in the config, then ODC gathers events up and passes them in as a list of
+    # tuples of the EventHandler arguments - one call for the lot. Return a list of True/False, one per event in the same order.
+    def EventsHandler(self, Events):
+        return [self.EventHandler(*Event) for Event in Events]
+
     # Will be called at the appropriate time by the ASIO handler system. Will be passed an id for the timeout,
     # so you can have multiple timers running.
     def TimerHandler(self,TimerId):
@@ -125,12 +145,22 @@ class SimPortClass:
             #currentqueuesize = odc.GetEventQueueSize(self.guid)
             #self.LogDebug("TimerHander: Event Queue Size {}".format(currentqueuesize))
             # Get Events from the queue and process them
-            while (True):
-                JsonEvent, empty = odc.GetNextEvent(self.guid)
-
-                if (empty == True):
-                    break
-                self.processedevents += 1     # Python is single threaded, so no concurrency issues (unless specipically enabled for multi)
+            starttime = time.perf_counter()
+            if (self.EventBatchSize > 0):
+                while (True):
+                    JsonEvents = odc.GetNextEvents(self.guid, self.EventBatchSize)
+                    self.processedevents += len(JsonEvents)
+
+                    if (len(JsonEvents) < self.EventBatchSize):
+                        break
+            else:
+                while (True):
+                    JsonEvent, empty = odc.GetNextEvent(self.guid)
+
+                    if (empty == True):
+                        break
+                    self.processedevents += 1     # Python is single threaded, so no concurrency issues (unless specipically enabled for multi)
+            self.drainseconds += time.perf_counter() - starttime
 
             odc.SetTimer(self.guid, 1, 250)     #250 msec - timer 1 restarts itself!
 
@@ -149,6 +179,7 @@ class SimPortClass:
         if ("GET" in url):
             Response["test"] = "GET"
             Response["processedevents"] = self.processedevents
+            Response["drainseconds"] = self.drainseconds
         else:
             Response["test"] = "POST"
         # Just to make sure it gets called and the call succeeds.
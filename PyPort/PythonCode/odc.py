@@ -11,6 +11,38 @@ def PublishEvent(guid, EventType, ODCIndex, Quality, PayLoad ):
     print("Publish Event - Guid - {} - {} {} {}".format(guid, EventType, ODCIndex, Quality, PayLoad))
     return True
 
+# "LO:PublishEvents"
+# Sequence of (EventType, ODCIndex, Quality, Value) tuples, using the integer constants below. Returns the number accepted
+def PublishEvents(guid, Events):
+    print("Publish Events - Guid - {} - {} events".format(guid, len(Events)))
+    return len(Events)
+
+# Integer constants for PublishEvents, the C++ module adds these from the ODC enums
+ConnectState = 44
+Binary = 1
+Analog = 3
+Counter = 4
+FrozenCounter = 5
+BinaryOutputStatus = 6
+AnalogOutputStatus = 7
+
+NONE = 0
+ONLINE = 1<<0
+RESTART = 1<<1
+COMM_LOST = 1<<2
+REMOTE_FORCED = 1<<3
+LOCAL_FORCED = 1<<4
+OVERRANGE = 1<<5
+REFERENCE_ERR = 1<<6
+ROLLOVER = 1<<7
+DISCONTINUITY = 1<<8
+CHATTER_FILTER = 1<<9
+
+PORT_UP = 0
+CONNECTED = 1
+DISCONNECTED = 2
+PORT_DOWN = 3
+
 # "LII:SetTimer"
 def SetTimer(guid, id, milliseconds):
     print("SetTimer - Guid - {} - ID {} - Delay - {}".format(guid, id, milliseconds))
@@ -21,6 +53,12 @@ def GetNextEvent(guid):
     print("GetNextEvent - Guid - {} ".format(guid))
     return  "Binary",0,0,"|ONLINE|","1","Dummy"
 
+# "LI:GetNextEvents"
+# Returns a list of up to maxcount json event strings, empty list if the queue is empty
+def GetNextEvents(guid, maxcount):
+    print("GetNextEvents - Guid - {} - Max {}".format(guid, maxcount))
+    return  []
+
 # "L:GetEventQueueSize"
 def GetEventQueueSize(guid):
     print("GetEventQueueSize - Guid - {} ".format(guid))
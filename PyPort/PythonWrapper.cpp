@@ -37,6 +37,7 @@
 #include "PythonWrapper.h"
 #include "PyPort.h"
 #include <Python.h>
+#include <algorithm>
 #include <chrono>
 #include <ctime>
 #include <ctime>
@@ -201,6 +202,80 @@ static PyObject* odc_PublishEvent(PyObject* self, PyObject* args)
 	return Py_BuildValue("i", 1);
 }
 
+// Batched, typed version of PublishEvent. Takes a sequence of (EventType, ODCIndex, Quality, Value) tuples of numbers,
+// using the odc.Binary, odc.ONLINE etc. constants, so we can create the ODC events without any string parsing.
+// Returns the number of events accepted, badly formed tuples are logged and skipped.
+static PyObject* odc_PublishEvents(PyObject* self, PyObject* args)
+{
+	size_t Accepted = 0;
+	try
+	{
+		uint64_t guid;
+		PyObject* pyEvents;
+
+		// Now parse the arguments provided, Long (L) and a pyObject (O) and the function name.
+		if (!PyArg_ParseTuple(args, "LO:PublishEvents", &guid, &pyEvents))
+		{
+			PythonWrapper::PyErrOutput();
+			Py_RETURN_NONE; // This will throw an execption in the python code.
+		}
+
+		// Work out which instance of our PyWrapper is talking to us.
+		PythonWrapper* thisPyWrapper = PythonWrapper::GetThisFromPythonSelf(guid);
+
+		if (thisPyWrapper)
+		{
+			PyObject* pySeq = PySequence_Fast(pyEvents, "PublishEvents expects a sequence of event tuples");
+			if (!pySeq)
+			{
+				PythonWrapper::PyErrOutput();
+				Py_RETURN_NONE;
+			}
+			Py_ssize_t Count = PySequence_Fast_GET_SIZE(pySeq);
+			PyObject** pyItems = PySequence_Fast_ITEMS(pySeq);
+
+			std::vector<PyTypedEvent> Events;
+			Events.reserve(static_cast<size_t>(Count));
+			for (Py_ssize_t i = 0; i < Count; i++)
+			{
+				PyObject* pyItem = pyItems[i];
+				if (!PyTuple_Check(pyItem) || (PyTuple_GET_SIZE(pyItem) != 4))
+				{
+					LOGERROR("odc.PublishEvents item {} is not an (EventType, ODCIndex, Quality, Value) tuple - ignored", i);
+					continue;
+				}
+				unsigned long Type = PyLong_AsUnsignedLong(PyTuple_GET_ITEM(pyItem, 0));
+				unsigned long ODCIndex = PyLong_AsUnsignedLong(PyTuple_GET_ITEM(pyItem, 1));
+				unsigned long Quality = PyLong_AsUnsignedLong(PyTuple_GET_ITEM(pyItem, 2));
+				double Value = PyFloat_AsDouble(PyTuple_GET_ITEM(pyItem, 3));
+				if (PyErr_Occurred())
+				{
+					PyErr_Clear();
+					LOGERROR("odc.PublishEvents item {} has a value that is not a number - ignored", i);
+					continue;
+				}
+				Events.push_back({ static_cast<EventType>(Type), static_cast<uint32_t>(ODCIndex), static_cast<QualityFlags>(Quality), Value });
+			}
+			Py_DECREF(pySeq);
+
+			Accepted = Events.size();
+			// The PyPort ensures that pyWrapper is managed within a strand
+			LOGTRACE("Python Publish Events {} of {}", Accepted, Count);
+			auto fn = thisPyWrapper->GetPythonPortPublishEventsCallFn();
+			fn(Events);
+		}
+		else
+		{
+			LOGDEBUG("odc.PublishEvents called from Python code for unknown PyPort object - ignored");
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOGERROR("Excception Caught in odc_PublishEvents() - {}", e.what());
+	}
+	return PyLong_FromSize_t(Accepted);
+}
+
 // This is an extension method that we have provided to our embedded Python. It get the current EventQueue length.
 // It is static, so we have to work out which instance of the PythonWrapper class should handle it.
 static PyObject* odc_GetEventQueueSize(PyObject* self, PyObject* args)
@@ -330,11 +405,61 @@ static PyObject* odc_GetNextEvent(PyObject* self, PyObject* args)
 	Py_RETURN_NONE; // This will throw an execption in the python code.
 }
 
+// Batched version of GetNextEvent, returns a list of up to maxcount json strings. An empty list means the queue is empty.
+// Saves a round trip through the Python/C boundary (and the PyPort lookup) for every event.
+static PyObject* odc_GetNextEvents(PyObject* self, PyObject* args)
+{
+	try
+	{
+		uint64_t guid;
+		uint32_t maxcount;
+
+		// Now parse the arguments provided, Long (L) Unsigned int (I) and the function name.
+		if (!PyArg_ParseTuple(args, "LI:GetNextEvents", &guid, &maxcount))
+		{
+			PythonWrapper::PyErrOutput();
+			// Will cause Pyhton exception
+			Py_RETURN_NONE;
+		}
+
+		// Work out which instance of our PyWrapper is talking to us.
+		PythonWrapper* thisPyWrapper = PythonWrapper::GetThisFromPythonSelf(guid);
+
+		if (thisPyWrapper)
+		{
+			// The PyPort ensures that pyWrapper is managed within a strand
+			std::vector<std::string> events;
+			events.reserve(std::min<size_t>(maxcount, thisPyWrapper->GetEventQueueSize()));
+			size_t count = thisPyWrapper->DequeueEvents(events, maxcount);
+
+			auto pyList = PyList_New(static_cast<Py_ssize_t>(count));
+			for (size_t i = 0; i < count; i++)
+			{
+				// The json string is stolen into the list - so only need to release pyList
+				PyList_SET_ITEM(pyList, static_cast<Py_ssize_t>(i), PyUnicode_FromStringAndSize(events[i].data(), static_cast<Py_ssize_t>(events[i].size())));
+			}
+			return pyList;
+		}
+		else
+		{
+			LOGDEBUG("odc.GetNextEvents called from Python code for unknown PyPort object - ignored");
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOGERROR("Excception Caught in odc_GetNextEvents() - {}", e.what());
+	}
+
+	Py_RETURN_NONE; // This will throw an execption in the python code.
+}
+
 static PyMethodDef odcMethods[] = {
 	{"log", odc_log, METH_VARARGS, "Process a log message, level and string message"},
 	{"PublishEvent", odc_PublishEvent, METH_VARARGS, "Publish ODC event to subscribed ports"},
+	{"PublishEvents", odc_PublishEvents, METH_VARARGS, "Publish a sequence of (EventType, ODCIndex, Quality, Value) tuples as ODC events to subscribed ports"},
 	{"SetTimer", odc_SetTimer, METH_VARARGS, "Set a Timer Callback up"},
 	{"GetNextEvent", odc_GetNextEvent, METH_VARARGS, "Get the next event from the queue - return None if empty"},
+	{"GetNextEvents", odc_GetNextEvents, METH_VARARGS, "Get up to the given number of events from the queue as a list - empty list if empty"},
 	{"GetEventQueueSize", odc_GetEventQueueSize, METH_VARARGS, "How many elements are there in the event queue - return None if empty"},
 	{nullptr, nullptr, 0, nullptr}
 };
@@ -345,7 +470,25 @@ static PyModuleDef odcModule = {
 
 static PyObject* PyInit_odc(void)
 {
-	return PyModule_Create(&odcModule);
+	PyObject* pyModule = PyModule_Create(&odcModule);
+	if (pyModule)
+	{
+		// The integer values used in the odc.PublishEvents tuples, so the Python code can use odc.Analog, odc.ONLINE|odc.RESTART etc.
+		for (auto et : { EventType::ConnectState, EventType::Binary, EventType::Analog, EventType::Counter, EventType::FrozenCounter,
+		                 EventType::BinaryOutputStatus, EventType::AnalogOutputStatus })
+			PyModule_AddIntConstant(pyModule, odc::ToString(et).c_str(), static_cast<long>(et));
+		for (auto q : { QualityFlags::NONE, QualityFlags::ONLINE, QualityFlags::RESTART, QualityFlags::COMM_LOST, QualityFlags::REMOTE_FORCED,
+		                QualityFlags::LOCAL_FORCED, QualityFlags::OVERRANGE, QualityFlags::REFERENCE_ERR, QualityFlags::ROLLOVER,
+		                QualityFlags::DISCONTINUITY, QualityFlags::CHATTER_FILTER })
+		{
+			std::string qname = ToString(q);
+			qname.erase(std::remove(qname.begin(), qname.end(), '|'), qname.end());
+			PyModule_AddIntConstant(pyModule, qname.c_str(), static_cast<long>(q));
+		}
+		for (auto cs : { ConnectState::PORT_UP, ConnectState::CONNECTED, ConnectState::DISCONNECTED, ConnectState::PORT_DOWN })
+			PyModule_AddIntConstant(pyModule, ToString(cs).c_str(), static_cast<long>(cs));
+	}
+	return pyModule;
 }
 
 
@@ -355,14 +498,13 @@ static PyObject* PyInit_odc(void)
 #pragma region Startup/Setup Functions
 #endif
 
-PythonWrapper::PythonWrapper(const std::string& aName, std::shared_ptr<odc::asio_service> _pIOS, SetTimerFnType SetTimerFn, PublishEventCallFnType PublishEventCallFn):
+PythonWrapper::PythonWrapper(const std::string& aName, std::shared_ptr<odc::asio_service> _pIOS, SetTimerFnType SetTimerFn, PublishEventCallFnType PublishEventCallFn, PublishEventsCallFnType PublishEventsCallFn):
 	Name(aName),
 	pIOS(std::move(_pIOS)),
 	PythonPortSetTimerFn(std::move(SetTimerFn)),
-	PythonPortPublishEventCallFn(std::move(PublishEventCallFn))
-{
-	EventQueue = std::make_shared<SpecialEventQueue<std::string>>(pIOS, MaximumQueueSize);
-}
+	PythonPortPublishEventCallFn(std::move(PublishEventCallFn)),
+	PythonPortPublishEventsCallFn(std::move(PublishEventsCallFn))
+{}
 
 // Load the module into the python interpreter before we initialise it.
 void ImportODCModule()
@@ -516,11 +658,15 @@ PythonWrapper::~PythonWrapper()
 
 		Py_XDECREF(pyFuncConfig);
 		Py_XDECREF(pyFuncEvent);
+		Py_XDECREF(pyFuncEvents);
 		Py_XDECREF(pyFuncOperational);
 		Py_XDECREF(pyFuncEnable);
 		Py_XDECREF(pyFuncDisable);
 		Py_XDECREF(pyTimerHandler);
 		Py_XDECREF(pyRestHandler);
+		for (auto& name : SenderNameCache)
+			Py_XDECREF(name.second);
+		SenderNameCache.clear();
 
 		RemoveWrapperMapping();
 		Py_XDECREF(pyInstance);
@@ -638,6 +784,8 @@ void PythonWrapper::Build(const std::string& modulename, const std::string& pyPa
 	pyFuncEnable = GetFunction(pyInstance, "Enable");
 	pyFuncDisable = GetFunction(pyInstance, "Disable");
 	pyFuncEvent = GetFunction(pyInstance, "EventHandler");
+	if (PyObject_HasAttrString(pyInstance, "EventsHandler"))
+		pyFuncEvents = GetFunction(pyInstance, "EventsHandler");
 	pyTimerHandler = GetFunction(pyInstance, "TimerHandler");
 	pyRestHandler = GetFunction(pyInstance, "RestRequestHandler");
 }
@@ -723,18 +871,31 @@ void PythonWrapper::Disable()
 	}
 }
 
-// these two methods are the only ones that touch the event queue. So to change the queue, do it here.
+// these methods are the only ones that touch the event queue. So to change the queue, do it here.
+// Called once from PyPort Build, before any events can be queued.
+void PythonWrapper::CreateEventQueue(size_t capacity, EventQueueOverflow overflow)
+{
+	EventQueue = std::make_unique<SpecialEventQueue<std::string>>(capacity, overflow);
+	LOGDEBUG("Event queue created with {} slots", EventQueue->Capacity());
+}
+
 // This is not synced with the strand when called. So the queue needs to be multi-producer capable
-void PythonWrapper::QueueEvent(const std::string& jsonevent)
+void PythonWrapper::QueueEvent(std::string jsonevent)
 {
-	bool result = EventQueue->async_push(jsonevent);
+	if (!EventQueue)
+	{
+		LOGERROR("Tried to queue an event, but there is no event queue");
+		return;
+	}
 
-	if (!result)
+	const uint64_t dropped = EventQueue->Dropped();
+	EventQueue->push(std::move(jsonevent));
+
+	if (EventQueue->Dropped() != dropped)
 	{
 		if (!QueuePushErrorLogged.test_and_set())
 		{
-			size_t qsize = EventQueue->Size();
-			LOGERROR("Failed to enqueue item into Event queue - insufficient memory or queue full. Queue Size {}", qsize);
+			LOGERROR("Event queue full, dropping events. Queue Size {}, Dropped so far {}", EventQueue->Size(), EventQueue->Dropped());
 		}
 	}
 	else
@@ -745,11 +906,12 @@ void PythonWrapper::QueueEvent(const std::string& jsonevent)
 
 bool PythonWrapper::DequeueEvent(std::string& eq)
 {
-	std::shared_ptr<std::string> data = EventQueue->pop();
-	if (data == nullptr)
-		return false;
-	eq = *data;
-	return true;
+	return EventQueue && EventQueue->pop(eq);
+}
+
+size_t PythonWrapper::DequeueEvents(std::vector<std::string>& events, size_t maxcount)
+{
+	return EventQueue ? EventQueue->pop(events, maxcount) : 0;
 }
 
 // When we get an event, we expect the Python code to act on it, and we get back a response straight away. PyPort will Post the result from us.
@@ -765,21 +927,7 @@ CommandStatus PythonWrapper::Event(const std::shared_ptr<const EventInfo>& odcev
 			LOGERROR("Error - Interpreter Closing Down in Event");
 			return CommandStatus::UNDEFINED;
 		}
-		auto pyArgs = PyTuple_New(6);
-		auto pyEventType = PyUnicode_FromString(odc::ToString(odcevent->GetEventType()).c_str()); // String Event Type
-		auto pyIndex = PyLong_FromSize_t(odcevent->GetIndex());
-		auto pyTime = PyLong_FromUnsignedLongLong(odcevent->GetTimestamp());             // msSinceEpoch
-		auto pyQuality = PyUnicode_FromString(ToString(odcevent->GetQuality()).c_str()); // String quality flags
-		auto pyPayload = PyUnicode_FromString(odcevent->GetPayloadString().c_str());
-		auto pySender = PyUnicode_FromString(SenderName.c_str());
-
-		// The py values above are stolen into the pyArgs structure - so only need to release pyArgs
-		PyTuple_SetItem(pyArgs, 0, pyEventType);
-		PyTuple_SetItem(pyArgs, 1, pyIndex);
-		PyTuple_SetItem(pyArgs, 2, pyTime);
-		PyTuple_SetItem(pyArgs, 3, pyQuality);
-		PyTuple_SetItem(pyArgs, 4, pyPayload);
-		PyTuple_SetItem(pyArgs, 5, pySender);
+		auto pyArgs = MakeEventArgs(odcevent, SenderName);
 
 		//	PostPyCall(pyFuncEvent, pyArgs, pStatusCallback); // Callback will be called when done...
 		PyObject* pyResult = PyCall(pyFuncEvent, pyArgs); // No passed variables
@@ -802,6 +950,147 @@ CommandStatus PythonWrapper::Event(const std::shared_ptr<const EventInfo>& odcev
 	return CommandStatus::UNDEFINED;
 }
 
+// Batched version of Event, one GIL acquisition and one Python call for the whole batch. The Python EventsHandler gets a list of
+// tuples of the same arguments EventHandler gets, and returns a list of True/False - one per event, in the same order.
+// This method is synced with the asio strand in PyPort
+void PythonWrapper::Events(const std::vector<PyBatchedEvent>& BatchedEvents, std::vector<CommandStatus>& Results)
+{
+	Results.assign(BatchedEvents.size(), CommandStatus::UNDEFINED);
+	try
+	{
+		GetPythonGIL g;
+		if (!g.OkToContinue())
+		{
+			LOGERROR("Error - Interpreter Closing Down in Events");
+			return;
+		}
+		auto pyList = PyList_New(static_cast<Py_ssize_t>(BatchedEvents.size()));
+		for (size_t i = 0; i < BatchedEvents.size(); i++)
+			PyList_SET_ITEM(pyList, static_cast<Py_ssize_t>(i), MakeEventArgs(BatchedEvents[i].odcevent, BatchedEvents[i].SenderName));
+
+		// The list is stolen into the pyArgs structure - so only need to release pyArgs
+		auto pyArgs = PyTuple_New(1);
+		PyTuple_SetItem(pyArgs, 0, pyList);
+
+		PyObject* pyResult = PyCall(pyFuncEvents, pyArgs);
+
+		Py_DECREF(pyArgs);
+
+		if (pyResult) // Non nullptr is a result
+		{
+			PyObject* pySeq = PySequence_Fast(pyResult, "EventsHandler must return a list");
+			if (pySeq && (PySequence_Fast_GET_SIZE(pySeq) == static_cast<Py_ssize_t>(BatchedEvents.size())))
+			{
+				PyObject** pyItems = PySequence_Fast_ITEMS(pySeq);
+				for (size_t i = 0; i < BatchedEvents.size(); i++)
+					Results[i] = (PyObject_IsTrue(pyItems[i]) == 1) ? CommandStatus::SUCCESS : CommandStatus::UNDEFINED;
+			}
+			else
+			{
+				LOGERROR("EventsHandler did not return a list of {} results", BatchedEvents.size());
+			}
+			PyErrOutput();
+			Py_XDECREF(pySeq);
+			Py_DECREF(pyResult);
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOGERROR("Exception Caught calling pyFuncEvents() - {}", e.what());
+	}
+}
+
+// The EventHandler arguments for an event, as a new 6 tuple - strings, or binary if BinaryEventMarshalling is set.
+// Must be called holding the GIL
+PyObject* PythonWrapper::MakeEventArgs(const std::shared_ptr<const EventInfo>& odcevent, const std::string& SenderName)
+{
+	auto pyArgs = PyTuple_New(6);
+	if (BinaryEventMarshalling)
+	{
+		SetBinaryEventArgs(pyArgs, odcevent, SenderName);
+		return pyArgs;
+	}
+	auto pyEventType = PyUnicode_FromString(odc::ToString(odcevent->GetEventType()).c_str()); // String Event Type
+	auto pyIndex = PyLong_FromSize_t(odcevent->GetIndex());
+	auto pyTime = PyLong_FromUnsignedLongLong(odcevent->GetTimestamp());             // msSinceEpoch
+	auto pyQuality = PyUnicode_FromString(ToString(odcevent->GetQuality()).c_str()); // String quality flags
+	auto pyPayload = PyUnicode_FromString(odcevent->GetPayloadString().c_str());
+	auto pySender = PyUnicode_FromString(SenderName.c_str());
+
+	// The py values above are stolen into the pyArgs structure - so only need to release pyArgs
+	PyTuple_SetItem(pyArgs, 0, pyEventType);
+	PyTuple_SetItem(pyArgs, 1, pyIndex);
+	PyTuple_SetItem(pyArgs, 2, pyTime);
+	PyTuple_SetItem(pyArgs, 3, pyQuality);
+	PyTuple_SetItem(pyArgs, 4, pyPayload);
+	PyTuple_SetItem(pyArgs, 5, pySender);
+	return pyArgs;
+}
+
+// Returns a new reference to the interned Python string for the sender name, creating it the first time we see the name.
+// Must be called holding the GIL
+PyObject* PythonWrapper::GetSenderNameObject(const std::string& SenderName)
+{
+	auto it = SenderNameCache.find(SenderName);
+	if (it == SenderNameCache.end())
+		it = SenderNameCache.emplace(SenderName, PyUnicode_InternFromString(SenderName.c_str())).first;
+	Py_XINCREF(it->second);
+	return it->second;
+}
+
+// The binary version of the Event arguments. Event type and quality are the integer enum values (the odc.Binary, odc.ONLINE etc. constants),
+// the payload is a native bool/float/int where there is one, and the sender name is a cached string.
+// The event type, quality and binary values are objects Python already shares, so no strings are built or parsed per event.
+// Must be called holding the GIL
+void PythonWrapper::SetBinaryEventArgs(PyObject* pyArgs, const std::shared_ptr<const EventInfo>& odcevent, const std::string& SenderName)
+{
+	PyObject* pyPayload = nullptr;
+	try
+	{
+		switch (odcevent->GetEventType())
+		{
+			case EventType::Binary:
+				pyPayload = PyBool_FromLong(odcevent->GetPayload<EventType::Binary>());
+				break;
+			case EventType::BinaryOutputStatus:
+				pyPayload = PyBool_FromLong(odcevent->GetPayload<EventType::BinaryOutputStatus>());
+				break;
+			case EventType::Analog:
+				pyPayload = PyFloat_FromDouble(odcevent->GetPayload<EventType::Analog>());
+				break;
+			case EventType::AnalogOutputStatus:
+				pyPayload = PyFloat_FromDouble(odcevent->GetPayload<EventType::AnalogOutputStatus>());
+				break;
+			case EventType::Counter:
+				pyPayload = PyLong_FromUnsignedLong(odcevent->GetPayload<EventType::Counter>());
+				break;
+			case EventType::FrozenCounter:
+				pyPayload = PyLong_FromUnsignedLong(odcevent->GetPayload<EventType::FrozenCounter>());
+				break;
+			case EventType::ConnectState:
+				pyPayload = PyLong_FromLong(static_cast<long>(odcevent->GetPayload<EventType::ConnectState>()));
+				break;
+			default:
+				// No native form (ControlRelayOutputBlock etc), so the same string as the string mode
+				pyPayload = PyUnicode_FromString(odcevent->GetPayloadString().c_str());
+				break;
+		}
+	}
+	catch (const std::exception&)
+	{
+		// Uninitialised payload, so leave it to the string version
+		pyPayload = PyUnicode_FromString(odcevent->GetPayloadString().c_str());
+	}
+
+	// The py values are stolen into the pyArgs structure - so only need to release pyArgs
+	PyTuple_SET_ITEM(pyArgs, 0, PyLong_FromLong(static_cast<long>(odcevent->GetEventType())));
+	PyTuple_SET_ITEM(pyArgs, 1, PyLong_FromSize_t(odcevent->GetIndex()));
+	PyTuple_SET_ITEM(pyArgs, 2, PyLong_FromUnsignedLongLong(odcevent->GetTimestamp())); // msSinceEpoch
+	PyTuple_SET_ITEM(pyArgs, 3, PyLong_FromLong(static_cast<long>(odcevent->GetQuality())));
+	PyTuple_SET_ITEM(pyArgs, 4, pyPayload);
+	PyTuple_SET_ITEM(pyArgs, 5, GetSenderNameObject(SenderName));
+}
+
 // We have to call this from the PyPort as an asyncwait on the strand. We just pass in the ID, as the delay will have been used.
 void PythonWrapper::CallTimerHandler(uint32_t id)
 {
@@ -31,9 +31,12 @@
 #include "SpecialEventQueue.h"
 #include <opendatacon/util.h>
 #include <opendatacon/DataPort.h>
+#include <chrono>
 #include <mutex>
 #include <shared_mutex>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 
 using namespace odc;
@@ -41,6 +44,26 @@ using namespace odc;
 typedef std::function<void (uint32_t, uint32_t)> SetTimerFnType;
 typedef std::function<void ( const char*, uint32_t, const char*, const char*)> PublishEventCallFnType;
 
+// Compact typed form of an event, as passed from Python to odc.PublishEvents. Turned straight into an EventInfo, no string parsing.
+struct PyTypedEvent
+{
+	EventType Type;
+	uint32_t ODCIndex;
+	QualityFlags Quality;
+	double Value;
+};
+typedef std::function<void (const std::vector<PyTypedEvent>&)> PublishEventsCallFnType;
+
+// An event waiting in a PyPort batch for the Python EventsHandler. The wrapper only uses the event and sender name,
+// the callback and arrival time are for the PyPort to resolve the status and latency once the batch returns.
+struct PyBatchedEvent
+{
+	std::shared_ptr<const EventInfo> odcevent;
+	std::string SenderName;
+	SharedStatusCallback_t pStatusCallback;
+	std::chrono::steady_clock::time_point Arrived;
+};
+
 // Class to store the evnt as a stringified version, mainly so that when Python is retreving these records, it does minimal processing.
 /*class EventQueueType
 {
@@ -89,7 +112,7 @@ class PythonWrapper
 {
 
 public:
-	PythonWrapper(const std::string& aName, std::shared_ptr<odc::asio_service> _pIOS, SetTimerFnType SetTimerFn, PublishEventCallFnType PublishEventCallFn);
+	PythonWrapper(const std::string& aName, std::shared_ptr<odc::asio_service> _pIOS, SetTimerFnType SetTimerFn, PublishEventCallFnType PublishEventCallFn, PublishEventsCallFnType PublishEventsCallFn);
 	~PythonWrapper();
 	void Build(const std::string& modulename, const std::string& pyPathName, const std::string& pyLoadModuleName, const std::string& pyClassName, const std::string& PortName, bool GlobalUseSystemPython);
 	void Config(const std::string& JSONMain, const std::string& JSONOverride);
@@ -98,12 +121,26 @@ public:
 	void Disable();
 
 	CommandStatus Event(const std::shared_ptr<const EventInfo>& odcevent, const std::string& SenderName);
-	void QueueEvent(const std::string& jsonevent);
+	void Events(const std::vector<PyBatchedEvent>& BatchedEvents, std::vector<CommandStatus>& Results);
+	bool HasEventsHandler() { return pyFuncEvents != nullptr; }
+	// Pass events to Python as integer enums and native payload values instead of strings
+	void SetBinaryEventMarshalling(bool binary) { BinaryEventMarshalling = binary; }
+	void CreateEventQueue(size_t capacity, EventQueueOverflow overflow);
+	void QueueEvent(std::string jsonevent);
 
 	bool DequeueEvent(std::string& eq);
+	size_t DequeueEvents(std::vector<std::string>& events, size_t maxcount);
 	size_t GetEventQueueSize()
 	{
-		return EventQueue->Size();
+		return EventQueue ? EventQueue->Size() : 0;
+	}
+	size_t GetEventQueueCapacity()
+	{
+		return EventQueue ? EventQueue->Capacity() : 0;
+	}
+	uint64_t GetEventQueueDropped()
+	{
+		return EventQueue ? EventQueue->Dropped() : 0;
 	}
 
 	void CallTimerHandler(uint32_t id);
@@ -111,6 +148,7 @@ public:
 
 	SetTimerFnType GetPythonPortSetTimerFn() { return PythonPortSetTimerFn; };                         // Protect set access, only allow get.
 	PublishEventCallFnType GetPythonPortPublishEventCallFn() { return PythonPortPublishEventCallFn; }; // Protect set access, only allow get.
+	PublishEventsCallFnType GetPythonPortPublishEventsCallFn() { return PythonPortPublishEventsCallFn; }; // Protect set access, only allow get.
 
 	static void PyErrOutput();
 	static void DumpStackTrace();
@@ -155,10 +193,8 @@ private:
 	std::shared_ptr<PythonInitWrapper> PyMgr;
 	std::shared_ptr<odc::asio_service> pIOS;
 
-	// We need a hard limit for the number of queued events, after which we start dumping elements. Better than running out of memory?
-	const size_t MaximumQueueSize = 1000000; // 1 million
-
-	std::shared_ptr<SpecialEventQueue<std::string>> EventQueue;
+	// Only created if the PyPort queues events. Fixed size, what happens when it is full is up to the overflow setting.
+	std::unique_ptr<SpecialEventQueue<std::string>> EventQueue;
 
 	// Keep pointers to the methods in out Python code that we want to be able to call.
 	PyObject* pyModule = nullptr;
@@ -168,12 +204,21 @@ private:
 	PyObject* pyFuncEnable = nullptr;
 	PyObject* pyFuncDisable = nullptr;
 	PyObject* pyFuncEvent = nullptr;
+	PyObject* pyFuncEvents = nullptr; // Optional
 	PyObject* pyTimerHandler = nullptr;
 	PyObject* pyRestHandler = nullptr;
 
 	SetTimerFnType PythonPortSetTimerFn;
 	PublishEventCallFnType PythonPortPublishEventCallFn;
+	PublishEventsCallFnType PythonPortPublishEventsCallFn;
 	std::atomic_flag QueuePushErrorLogged = ATOMIC_FLAG_INIT;
+
+	bool BinaryEventMarshalling = false;
+	// Interned Python strings for the sender names, so we only create them once. Only touched while holding the GIL.
+	std::unordered_map<std::string, PyObject*> SenderNameCache;
+	PyObject* GetSenderNameObject(const std::string& SenderName);
+	PyObject* MakeEventArgs(const std::shared_ptr<const EventInfo>& odcevent, const std::string& SenderName);
+	void SetBinaryEventArgs(PyObject* pyArgs, const std::shared_ptr<const EventInfo>& odcevent, const std::string& SenderName);
 };
 
 #endif /* PYWRAPPER_H_ */
@@ -28,109 +28,192 @@
 #define SPECIALEVENTQUEUE_H_
 
 #include <atomic>
-#include <opendatacon/asio.h>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
 
-// This is a unique, multi producer with strand protection on the production queue - with a single thread consumer.
-// It does not try to "fully" empty the queue, as it is based on the fact that there will be a continuous
-// stream of data. As a result of this, the worst case is that it there might be an item in "limbo" but only
-// until the next new item is pushed.
-// Also the fullness of the queue is a bit flexible, but should never be achived under normal operation.
+// What a push does when the queue is full
+enum class EventQueueOverflow
+{
+	DropNewest, // The push fails, the new item is lost
+	DropOldest, // The oldest item is thrown away to make room
+	Block       // Wait for the consumer to make room. Only if the consumer can't be waiting on the producer!
+};
+
+// A bounded lock free ring buffer (after Dmitry Vyukov's bounded MPMC queue). The slots are allocated once at construction,
+// and each has a sequence number that says whether it is ready to be written or read on the current lap of the ring,
+// so producers and consumers only ever CAS the enqueue/dequeue positions - no locks, strands or per item allocation.
+// Items are moved in and out of the slots. Safe for multiple producers and consumers (DropOldest makes the producers consumers too).
+// The size is the difference of the two positions, so O(1), but only a snapshot when there are pushes or pops in progress.
 template <class T>
 class SpecialEventQueue
 {
 private:
-	class node
+	struct Slot
 	{
-public:
-		std::shared_ptr<node> next; // Points "up" the queue from tail to head
-		std::shared_ptr<T> data;
-		node(std::shared_ptr<T> _data): next(nullptr), data(_data)
-		{}
+		std::atomic<size_t> sequence;
+		T data;
 	};
 
-	std::shared_ptr<node> head;
-	std::shared_ptr<node> tail;
+	const size_t capacity; // Always a power of 2, so we can mask instead of mod
+	const size_t mask;
+	std::unique_ptr<Slot[]> slots;
+	const EventQueueOverflow overflow;
 
-	std::atomic<size_t> size;
-	size_t maxsize;
-	std::shared_ptr<odc::asio_service> pIOS;
-	std::unique_ptr<asio::io_context::strand> internal_queue_strand;
+	// Separate cache lines, so producers and consumers don't fight over them.
+	alignas(64) std::atomic<size_t> enqueue_pos;
+	alignas(64) std::atomic<size_t> dequeue_pos;
+	alignas(64) std::atomic<uint64_t> dropped;
 
-public:
-	SpecialEventQueue(std::shared_ptr<odc::asio_service> _pIOS, size_t _maxsize)
-		: head(nullptr),
-		tail(nullptr),
-		size(0),
-		maxsize(_maxsize),
-		pIOS(_pIOS),
-		internal_queue_strand(pIOS->make_strand())
-	{}
-
-	size_t Size() { return size.load(); }
+	static size_t RoundUpPowerOf2(size_t n)
+	{
+		size_t p = 2;
+		while (p < n)
+			p <<= 1;
+		return p;
+	}
 
-	// Will return false if the queue is likely full - bit fuzzy due to threadedness, but should not happen during normal operation
-	// and if we get close enough to trigger a failed push - it should be flagged as an error anyway.
-	// The push is a threadsafe multi producer using ASIO strand protection.
-	bool async_push(const T& _value)
+	bool try_push(T& value)
 	{
-		// The queue could grow to a few more than maxsize in size.
-		if (size.load() >= maxsize)
+		size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+		for (;;)
 		{
-			return false;
+			Slot& slot = slots[pos & mask];
+			size_t seq = slot.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+			if (diff == 0)
+			{
+				if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					slot.data = std::move(value);
+					slot.sequence.store(pos + 1, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false; // Full - the slot still has last lap's item in it
+			}
+			else
+			{
+				pos = enqueue_pos.load(std::memory_order_relaxed);
+			}
 		}
+	}
 
-		// Do the memory allocation for the copy of the data and the node, so if it fails we can catch it.
-		try
-		{
-			auto data = std::make_shared<T>(_value);
-			auto nodeptr = std::make_shared<node>(data);
+public:
+	SpecialEventQueue(size_t _capacity, EventQueueOverflow _overflow = EventQueueOverflow::DropNewest)
+		: capacity(RoundUpPowerOf2(_capacity)),
+		mask(capacity - 1),
+		slots(new Slot[capacity]),
+		overflow(_overflow),
+		enqueue_pos(0),
+		dequeue_pos(0),
+		dropped(0)
+	{
+		for (size_t i = 0; i < capacity; i++)
+			slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
 
-			// Dispatch will execute now - if we can, otherwise results in a post.
-			internal_queue_strand->dispatch([this, nodeptr]()
-				{
-					// This is only called from within the internal_queue_strand, so we are safe.
-					// Always add here, we have already checked
-					size++;
-					if (head == nullptr)
-					{
-					      head = nodeptr;
-					      tail = head;
-					}
-					else
-					{
-					      head->next = nodeptr;
-					      head = nodeptr;
-					}
-				});
-		}
-		catch (const std::exception&)
+	size_t Size() const
+	{
+		size_t d = dequeue_pos.load(std::memory_order_relaxed);
+		size_t e = enqueue_pos.load(std::memory_order_relaxed);
+		return (e > d) ? (e - d) : 0;
+	}
+	size_t Capacity() const { return capacity; }
+	uint64_t Dropped() const { return dropped.load(std::memory_order_relaxed); }
+
+	// Returns false if the new item was dropped because the queue was full (only with DropNewest).
+	// With DropOldest the push always succeeds, the Dropped count says how many old items it cost.
+	bool push(T value)
+	{
+		while (!try_push(value))
 		{
-			// Must be a memory allocation failure.
-			return false;
+			switch (overflow)
+			{
+				case EventQueueOverflow::DropNewest:
+					dropped++;
+					return false;
+				case EventQueueOverflow::DropOldest:
+				{
+					T oldest;
+					if (pop(oldest))
+						dropped++;
+					break;
+				}
+				case EventQueueOverflow::Block:
+					std::this_thread::yield();
+					break;
+			}
 		}
-
 		return true;
 	}
 
-	// This is a single thread consumer only method. Cannot be called from mutilple threads. Will cause problems for SURE!
-	std::shared_ptr<T> pop()
+	// Returns false if the queue is empty
+	bool pop(T& value)
 	{
-		if ((tail == nullptr) || (tail == head))
+		size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
 		{
-			// Dont try and change head and tail pointers at the same time - we have to be much more careful with thread safety if we do.
-			// We effectively leave one element in the queue - but we have a continuous stream of data, so not really a problem
-			// Comparing the pointers is threadsafe! Changing the head pointer here is not!
-			return nullptr;
+			Slot& slot = slots[pos & mask];
+			size_t seq = slot.sequence.load(std::memory_order_acquire);
+			auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+			if (diff == 0)
+			{
+				if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				{
+					value = std::move(slot.data);
+					slot.sequence.store(pos + capacity, std::memory_order_release);
+					return true;
+				}
+			}
+			else if (diff < 0)
+			{
+				return false; // Empty - the slot has not been written on this lap
+			}
+			else
+			{
+				pos = dequeue_pos.load(std::memory_order_relaxed);
+			}
 		}
-		else
+	}
+
+	// Batched version of pop. Claims the run of ready slots (up to maxcount) with a single CAS of the dequeue position,
+	// then moves them onto the end of out. Returns the number of items moved.
+	size_t pop(std::vector<T>& out, size_t maxcount)
+	{
+		if (maxcount == 0)
+			return 0;
+		size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+		for (;;)
 		{
-			std::shared_ptr<T> data = tail->data;
-			tail = tail->next;
+			size_t count = 0;
+			while ((count < maxcount) && (count < capacity)
+			       && (slots[(pos + count) & mask].sequence.load(std::memory_order_acquire) == pos + count + 1))
+				count++;
+
+			if (count == 0)
+			{
+				size_t seq = slots[pos & mask].sequence.load(std::memory_order_acquire);
+				if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0)
+					return 0; // Empty
+				pos = dequeue_pos.load(std::memory_order_relaxed); // Someone else got there first
+				continue;
+			}
 
-			// Only variable we need to be thread safe between producer and consumer in this implementation is the size.
-			// It is only used to limit total size of the queue.
-			size--;
-			return data;
+			out.reserve(out.size() + count); // Can't fail once we own the slots
+			if (dequeue_pos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+			{
+				for (size_t i = 0; i < count; i++)
+				{
+					Slot& slot = slots[(pos + i) & mask];
+					out.push_back(std::move(slot.data));
+					slot.sequence.store(pos + i + capacity, std::memory_order_release);
+				}
+				return count;
+			}
 		}
 	}
 };
@@ -290,7 +290,7 @@ bool SimPort::UILoad(const std::string& type, const std::string& index, const st
 				std::unique_lock<std::shared_timed_mutex> lck(ConfMutex);
 				pSimConf->BinaryForcedStates[idx] = true;
 			}
-			auto event = std::make_shared<EventInfo>(EventType::Binary,idx,Name,Q,ts);
+			auto event = std::make_shared<EventInfo>(EventType::Binary,idx,GetID(),Q,ts);
 			bool valb = (val >= 1);
 			event->SetPayload<EventType::Binary>(std::move(valb));
 			PostPublishEvent(event);
@@ -305,7 +305,7 @@ bool SimPort::UILoad(const std::string& type, const std::string& index, const st
 				std::unique_lock<std::shared_timed_mutex> lck(ConfMutex);
 				pSimConf->AnalogForcedStates[idx] = true;
 			}
-			auto event = std::make_shared<EventInfo>(EventType::Analog,idx,Name,Q,ts);
+			auto event = std::make_shared<EventInfo>(EventType::Analog,idx,GetID(),Q,ts);
 			event->SetPayload<EventType::Analog>(std::move(val));
 			PostPublishEvent(event);
 		}
@@ -477,7 +477,7 @@ void SimPort::PortUp()
 		//Check if we're configured to load this point from DB
 		if(DBStats.count("Analog"+std::to_string(index)))
 		{
-			auto event = std::make_shared<EventInfo>(EventType::Analog,index,Name);
+			auto event = std::make_shared<EventInfo>(EventType::Analog,index,GetID());
 			NextEventFromDB(event);
 			int64_t time_offset = 0;
 			if(!(TimestampHandling & TimestampMode::ABSOLUTE_T))
@@ -535,7 +535,7 @@ void SimPort::PortUp()
 			mean = pSimConf->AnalogStartVals.count(index) ? pSimConf->AnalogStartVals.at(index) : 0;
 			pSimConf->AnalogStartVals[index] = mean;
 		}
-		auto event = std::make_shared<EventInfo>(EventType::Analog,index,Name,QualityFlags::ONLINE);
+		auto event = std::make_shared<EventInfo>(EventType::Analog,index,GetID(),QualityFlags::ONLINE);
 		event->SetPayload<EventType::Analog>(std::move(mean));
 		PostPublishEvent(event);
 
@@ -570,7 +570,7 @@ void SimPort::PortUp()
 			val = pSimConf->BinaryStartVals.count(index) ? pSimConf->BinaryStartVals.at(index) : false;
 			pSimConf->BinaryStartVals[index] = val;
 		}
-		auto event = std::make_shared<EventInfo>(EventType::Binary,index,Name,QualityFlags::ONLINE);
+		auto event = std::make_shared<EventInfo>(EventType::Binary,index,GetID(),QualityFlags::ONLINE);
 		event->SetPayload<EventType::Binary>(std::move(val));
 		PostPublishEvent(event);
 
@@ -1202,9 +1202,9 @@ void SimPort::ProcessElements(const Json::Value& JSONRoot)
 							}
 						}
 
-						auto on = std::make_shared<EventInfo>(EventType::Binary, fb_index, Name, on_qual);
+						auto on = std::make_shared<EventInfo>(EventType::Binary, fb_index, GetID(), on_qual);
 						on->SetPayload<EventType::Binary>(std::move(on_val));
-						auto off = std::make_shared<EventInfo>(EventType::Binary, fb_index, Name, off_qual);
+						auto off = std::make_shared<EventInfo>(EventType::Binary, fb_index, GetID(), off_qual);
 						off->SetPayload<EventType::Binary>(std::move(off_val));
 
 						pSimConf->ControlFeedback[index].emplace_back(on, off, mode);
@@ -135,13 +135,13 @@ private:
 	}
 	inline void StartAnalogEvents(size_t index)
 	{
-		auto event = std::make_shared<EventInfo>(EventType::Analog,index,Name);
+		auto event = std::make_shared<EventInfo>(EventType::Analog,index,GetID());
 		RandomiseAnalog(event);
 		SpawnEvent(event);
 	}
 	inline void StartAnalogEvents(size_t index, double val)
 	{
-		auto event = std::make_shared<EventInfo>(EventType::Analog,index,Name);
+		auto event = std::make_shared<EventInfo>(EventType::Analog,index,GetID());
 		event->SetPayload<EventType::Analog>(std::move(val));
 		SpawnEvent(event);
 	}
@@ -153,7 +153,7 @@ private:
 	}
 	inline void StartBinaryEvents(size_t index, bool val)
 	{
-		auto event = std::make_shared<EventInfo>(EventType::Binary,index,Name);
+		auto event = std::make_shared<EventInfo>(EventType::Binary,index,GetID());
 		event->SetPayload<EventType::Binary>(std::move(val));
 		SpawnEvent(event);
 	}
@@ -28,6 +28,7 @@
 #define CONFIGPARSER_H_
 
 #include <unordered_map>
+#include <mutex>
 #include <json/json.h>
 
 class ConfigParser
@@ -40,6 +41,16 @@ public:
 	virtual void ProcessElements(const Json::Value& JSONRoot)=0;
 	const Json::Value GetConfiguration() const;
 
+	//Optional binary snapshot of all the parsed config files
+	//	files are only recalled from a snapshot if their size and content hash still match
+	//	LoadSnapshot returns the number of files recalled
+	//	SaveSnapshot only writes if something has been parsed since the last load/save
+	static size_t LoadSnapshot(const std::string& SnapshotFilename);
+	static bool SaveSnapshot(const std::string& SnapshotFilename);
+	//Forget everything parsed or recalled so far
+	//	only safe while no parsers are processing, because cached roots are used by pointer
+	static void ClearCache();
+
 protected:
 	const std::string ConfFilename;
 	const Json::Value ConfOverrides;
@@ -49,8 +60,19 @@ private:
 
 	static const Json::Value GetConfiguration(const std::string& FileName);
 	static void AddInherits(Json::Value& JSONRoot, const Json::Value& Inherits);
-	static Json::Value* RecallOrCreate(const std::string& FileName);
-	static std::unordered_map<std::string,Json::Value> JSONCache;
+	static const Json::Value* RecallOrCreate(const std::string& FileName);
+
+	struct CachedFile
+	{
+		Json::Value Root;
+		uint64_t Size;
+		uint64_t Hash;
+	};
+	//Ports are constructed in parallel, so the cache is synchronised
+	//	elements are never erased, so pointers to the cached roots stay valid
+	static std::unordered_map<std::string,CachedFile> JSONCache;
+	static std::mutex JSONCacheMtx;
+	static bool JSONCacheChanged;
 };
 
 #endif /* CONFIGPARSER_H_ */
@@ -55,6 +55,10 @@ public:
 	{
 		MuxConnectionEvents(state, SenderName);
 	}
+	void Event(ConnectState state, NameID_t SenderID) final
+	{
+		MuxConnectionEvents(state, SenderID);
+	}
 
 	virtual std::pair<std::string,std::shared_ptr<IUIResponder>> GetUIResponder()
 	{
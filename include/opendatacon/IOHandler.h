@@ -31,8 +31,11 @@
 #include <unordered_map>
 #include <map>
 #include <atomic>
+#include <mutex>
+#include <vector>
 #include <opendatacon/asio.h>
 #include <opendatacon/IOTypes.h>
+#include <opendatacon/NameRegistry.h>
 #include <opendatacon/util.h>
 
 namespace odc
@@ -47,9 +50,9 @@ class DemandMap
 {
 public:
 	bool InDemand();
-	bool MuxConnectionEvents(ConnectState state, const std::string& SenderName);
+	bool MuxConnectionEvents(ConnectState state, NameID_t SenderID);
 private:
-	std::map<std::string,bool> connection_demands;
+	std::unordered_map<NameID_t,bool> connection_demands;
 	std::mutex mtx;
 	//TODO: do it using asio
 	//asio::io_service::strand sync;
@@ -67,13 +70,27 @@ public:
 	//Event events
 	virtual void Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback) = 0;
 
+	//Versions taking the interned id of the sender - these are what PublishEvent calls
+	//	override them to avoid dealing with names, otherwise they forward to the name versions above
+	virtual void Event(ConnectState state, NameID_t SenderID)
+	{
+		Event(state, NameOf(SenderID));
+	}
+	virtual void Event(std::shared_ptr<const EventInfo> event, NameID_t SenderID, SharedStatusCallback_t pStatusCallback)
+	{
+		Event(event, NameOf(SenderID), pStatusCallback);
+	}
+
 	virtual void Enable() = 0;
 	virtual void Disable() = 0;
 
 	void Subscribe(IOHandler* pIOHandler, const std::string& aName);
 
 	inline const std::string& GetName(){return Name;}
+	inline NameID_t GetID() const {return ID;}
 	inline const bool Enabled(){return enabled;}
+	//When this IOHandler first published a CONNECTED state (zero if it hasn't yet)
+	inline msSinceEpoch_t GetFirstConnectTime() const {return FirstConnectTime;}
 	InitState_t InitState;
 	uint16_t EnableDelayms;
 
@@ -81,16 +98,20 @@ public:
 
 protected:
 	std::string Name;
+	const NameID_t ID;
 	const std::shared_ptr<odc::asio_service> pIOS;
 	std::atomic_bool enabled;
+	std::atomic<msSinceEpoch_t> FirstConnectTime;
 
 	inline bool InDemand(){ return mDemandMap.InDemand(); }
 	inline bool MuxConnectionEvents(ConnectState state, const std::string& SenderName)
-	{ return mDemandMap.MuxConnectionEvents(state, SenderName); }
+	{ return mDemandMap.MuxConnectionEvents(state, InternName(SenderName)); }
+	inline bool MuxConnectionEvents(ConnectState state, NameID_t SenderID)
+	{ return mDemandMap.MuxConnectionEvents(state, SenderID); }
 
 	inline void PublishEvent(ConnectState state)
 	{
-		auto event = std::make_shared<EventInfo>(EventType::ConnectState,0,Name);
+		auto event = std::make_shared<EventInfo>(EventType::ConnectState,0,ID);
 		event->SetPayload<EventType::ConnectState>(std::move(state));
 		PublishEvent(event);
 	}
@@ -101,30 +122,37 @@ protected:
 			pStatusCallback = std::make_shared<std::function<void (CommandStatus status)>>([] (CommandStatus status){});
 		if(event->GetEventType() == EventType::ConnectState)
 		{
+			if(event->GetPayload<EventType::ConnectState>() == ConnectState::CONNECTED)
+			{
+				msSinceEpoch_t never = 0;
+				FirstConnectTime.compare_exchange_strong(never, msSinceEpoch());
+			}
 			//call the special connection Event() function separately,
 			//	so it can keep track of upsteam demand
 			for(const auto& IOHandler_pair: Subscribers)
 			{
-				IOHandler_pair.second->Event(event->GetPayload<EventType::ConnectState>(), Name);
+				IOHandler_pair.second->Event(event->GetPayload<EventType::ConnectState>(), ID);
 			}
 		}
 		auto multi_callback = SyncMultiCallback(Subscribers.size(),pStatusCallback);
 		for(const auto& IOHandler_pair: Subscribers)
 		{
 			if(auto log = odc::spdlog_get("opendatacon"))
-				log->trace("{} {} Payload {} Event {} => {}", ToString(event->GetEventType()),event->GetIndex(), event->GetPayloadString(), Name, IOHandler_pair.first);
-			IOHandler_pair.second->Event(event, Name, multi_callback);
+				log->trace("{} {} Payload {} Event {} => {}", ToString(event->GetEventType()),event->GetIndex(), event->GetPayloadString(), Name, NameOf(IOHandler_pair.first));
+			IOHandler_pair.second->Event(event, ID, multi_callback);
 		}
 	}
 
 	SharedStatusCallback_t SyncMultiCallback (const size_t cb_number, SharedStatusCallback_t pStatusCallback);
 
 private:
-	std::unordered_map<std::string,IOHandler*> Subscribers;
+	//subscriber id and handler - a vector since it's iterated for every event, and rarely changes
+	std::vector<std::pair<NameID_t,IOHandler*>> Subscribers;
 	DemandMap mDemandMap;
 
 	// Important that this is private - for inter process memory management
 	static std::unordered_map<std::string, IOHandler*> IOHandlers;
+	static std::mutex IOHandlersMtx;
 };
 
 }
@@ -31,6 +31,7 @@
 #include <string>
 #include <tuple>
 #include <opendatacon/EnumClassFlags.h>
+#include <opendatacon/NameRegistry.h>
 #include <opendatacon/util.h>
 
 namespace odc
@@ -480,12 +481,17 @@ class EventInfo
 {
 public:
 	EventInfo(EventType tp, size_t ind = 0, const std::string& source = "",
+		QualityFlags qual = QualityFlags::ONLINE,
+		msSinceEpoch_t time = msSinceEpoch()):
+		EventInfo(tp, ind, InternName(source), qual, time)
+	{}
+	EventInfo(EventType tp, size_t ind, NameID_t source,
 		QualityFlags qual = QualityFlags::ONLINE,
 		msSinceEpoch_t time = msSinceEpoch()):
 		Index(ind),
 		Timestamp(time),
 		Quality(qual),
-		SourcePort(source),
+		SourceID(source),
 		Type(tp),
 		pPayload(nullptr)
 	{}
@@ -494,7 +500,7 @@ public:
 		Index(evt.Index),
 		Timestamp(evt.Timestamp),
 		Quality(evt.Quality),
-		SourcePort(evt.SourcePort),
+		SourceID(evt.SourceID),
 		Type(evt.Type),
 		pPayload(evt.pPayload)
 	{
@@ -621,7 +627,8 @@ public:
 	const size_t& GetIndex() const { return Index; }
 	const msSinceEpoch_t& GetTimestamp() const { return Timestamp; }
 	const QualityFlags& GetQuality() const { return Quality; }
-	const std::string& GetSourcePort() const { return SourcePort; }
+	const std::string& GetSourcePort() const { return NameOf(SourceID); }
+	NameID_t GetSourceID() const { return SourceID; }
 
 	template<EventType t>
 	const typename EventTypePayload<t>::type& GetPayload() const
@@ -678,7 +685,8 @@ public:
 	void SetIndex(size_t i){ Index = i; }
 	void SetTimestamp(msSinceEpoch_t tm = msSinceEpoch()){ Timestamp = tm; }
 	void SetQuality(QualityFlags q){ Quality = q; }
-	void SetSource(const std::string& s){ SourcePort = s; }
+	void SetSource(const std::string& s){ SourceID = InternName(s); }
+	void SetSource(NameID_t id){ SourceID = id; }
 
 	template<EventType t>
 	void SetPayload(typename EventTypePayload<t>::type&& p)
@@ -752,7 +760,7 @@ private:
 	size_t Index;
 	msSinceEpoch_t Timestamp;
 	QualityFlags Quality;
-	std::string SourcePort;
+	NameID_t SourceID;
 	const EventType Type;
 	void *pPayload;
 };
@@ -0,0 +1,48 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * NameRegistry.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef NAMEREGISTRY_H_
+#define NAMEREGISTRY_H_
+
+#include <cstdint>
+#include <string>
+
+namespace odc
+{
+
+//Compact id for an interned name (of an IOHandler, or the source of an event)
+//	ids are never re-used, and the empty name is always 0
+typedef uint32_t NameID_t;
+
+//Return the id for a name, adding it to the registry if it's new
+//	doesn't throw - if the registry is ever full, new names get the empty name's id
+NameID_t InternName(const std::string& name);
+//Resolve an id back to its name - doesn't lock, so it's cheap enough to use on every event
+//	unknown ids resolve to the empty name
+const std::string& NameOf(const NameID_t id);
+
+} //namespace odc
+
+#endif /* NAMEREGISTRY_H_ */
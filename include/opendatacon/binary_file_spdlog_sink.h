@@ -0,0 +1,167 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * binary_file_spdlog_sink.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef BINARY_FILE_SPDLOG_SINK_H
+#define BINARY_FILE_SPDLOG_SINK_H
+
+#include <opendatacon/spdlog.h>
+#include <spdlog/sinks/base_sink.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+
+namespace odc
+{
+/*
+  Compact binary log file, for affordable high rate (trace) logging.
+  Timestamps, levels and logger names aren't rendered to text - decode offline with scripts/decode_binlog.pl
+
+  Limitations:
+	The payload is the message text - the logger has already run fmt on the format string and args by the time a sink
+	sees it (spdlog doesn't hand the raw format and args to sinks), so only the pattern formatting is saved.
+	Messages reach the sink through the shared spdlog async queue, like every other sink. There is no per-port ring.
+
+  File layout (all integers little endian):
+	header:		"ODCBLOG1"
+	name record:	u8 0x01, u16 name id, u16 length, name bytes
+	msg record:	u8 0x02, i64 ns since epoch, u8 level, u16 name id, u64 thread id, u32 length, payload bytes
+
+  A name record is written the first time each logger name is seen in a file.
+  If max_size is non-zero, the file is rolled over to <filename>.1 when it exceeds max_size bytes.
+*/
+class binary_file_spdlog_sink: public spdlog::sinks::base_sink<std::mutex>
+{
+public:
+	binary_file_spdlog_sink(const std::string& filename, const size_t max_size = 0):
+		filename_(filename),
+		max_size_(max_size)
+	{
+		open_();
+	}
+
+protected:
+	void sink_it_(const spdlog::details::log_msg &msg) override
+	{
+		//take the name and (already formatted) payload straight from the message - no pattern formatting
+#if defined(SPDLOG_VERSION) && SPDLOG_VERSION >= 10400
+		const char* name_data = msg.logger_name.data();
+		const size_t name_size = msg.logger_name.size();
+		const char* payload_data = msg.payload.data();
+		const size_t payload_size = msg.payload.size();
+#else
+		const char* name_data = msg.logger_name->data();
+		const size_t name_size = msg.logger_name->size();
+		const char* payload_data = msg.raw.data();
+		const size_t payload_size = msg.raw.size();
+#endif
+		//messages tend to come from the same logger in runs, so check the last one before the map
+		if(!(last_id_ && last_name_.size() == name_size && last_name_.compare(0, name_size, name_data, name_size) == 0))
+		{
+			last_name_.assign(name_data, name_size);
+			auto id_it = name_ids_.find(last_name_);
+			if(id_it == name_ids_.end())
+			{
+				auto id = static_cast<uint16_t>(name_ids_.size());
+				id_it = name_ids_.emplace(last_name_,id).first;
+				write_name_(id_it->first,id);
+			}
+			last_id_ = &id_it->second;
+		}
+
+		const int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(msg.time.time_since_epoch()).count();
+		put_(uint8_t(0x02));
+		put_(ns);
+		put_(static_cast<uint8_t>(msg.level));
+		put_(*last_id_);
+		put_(static_cast<uint64_t>(msg.thread_id));
+		put_(static_cast<uint32_t>(payload_size));
+		file_.write(payload_data, static_cast<std::streamsize>(payload_size));
+		written_ += 1+8+1+2+8+4+payload_size;
+
+		if(max_size_ && written_ > max_size_)
+		{
+			file_.close();
+			const std::string rolled = filename_+".1";
+			std::remove(rolled.c_str());
+			std::rename(filename_.c_str(), rolled.c_str());
+			open_();
+		}
+	}
+
+	void flush_() override
+	{
+		file_.flush();
+	}
+
+private:
+	void open_()
+	{
+		file_.open(filename_, std::ios::binary | std::ios::trunc);
+		if(!file_.is_open())
+			throw spdlog::spdlog_ex("Failed to open binary log file '"+filename_+"'");
+		file_.write("ODCBLOG1", 8);
+		written_ = 8;
+		//names are defined per file, so the decoder can start from any file
+		for(const auto& name_id : name_ids_)
+			write_name_(name_id.first,name_id.second);
+	}
+
+	void write_name_(const std::string& name, const uint16_t id)
+	{
+		put_(uint8_t(0x01));
+		put_(id);
+		put_(static_cast<uint16_t>(name.size()));
+		file_.write(name.data(), static_cast<std::streamsize>(name.size()));
+		written_ += 1+2+2+name.size();
+	}
+
+	template<typename T>
+	void put_(T val)
+	{
+		char bytes[sizeof(T)];
+		auto u = static_cast<typename std::make_unsigned<T>::type>(val);
+		for(size_t i = 0; i < sizeof(T); i++)
+			bytes[i] = static_cast<char>((u >> (8*i)) & 0xFF);
+		file_.write(bytes, sizeof(T));
+	}
+
+	const std::string filename_;
+	const size_t max_size_;
+	//unordered_map elements don't move, so last_id_ stays valid
+	std::unordered_map<std::string,uint16_t> name_ids_;
+	std::string last_name_;
+	const uint16_t* last_id_ = nullptr;
+	std::ofstream file_;
+	size_t written_ = 0;
+};
+
+} // namespace odc
+
+#endif // BINARY_FILE_SPDLOG_SINK_H
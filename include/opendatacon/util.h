@@ -34,6 +34,9 @@ namespace odc
 
 void spdlog_init_thread_pool(size_t q_size, size_t thread_count);
 std::shared_ptr<spdlog::details::thread_pool> spdlog_thread_pool();
+//number of messages the async thread pool discarded because the queue was full
+//returns false if the spdlog version doesn't keep count
+bool spdlog_overrun_count(size_t& count);
 void spdlog_flush_all();
 void spdlog_apply_all(const std::function<void(std::shared_ptr<spdlog::logger>)> &fun);
 void spdlog_register_logger(std::shared_ptr<spdlog::logger> logger);
@@ -26,9 +26,12 @@
 
 #include "DataConcentrator.h"
 #include "NullPort.h"
+#include <algorithm>
+#include <chrono>
 #include <opendatacon/Version.h>
 #include <opendatacon/asio.h>
 #include <opendatacon/asio_syslog_spdlog_sink.h>
+#include <opendatacon/binary_file_spdlog_sink.h>
 #include <opendatacon/spdlog.h>
 #include <opendatacon/util.h>
 #include <spdlog/async.h>
@@ -36,49 +39,27 @@
 #include <spdlog/sinks/rotating_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 #include <thread>
+#include <unordered_set>
 
-/*
-   Whenever needed we will ask for all the Sinks present,
-   I don't like this personally, but due to the limitations with spdlogs,
-   we need to create sinks only once can't add on the fly.
- */
-inline std::vector<spdlog::sink_ptr> GetAllSinks(const std::unordered_map<std::string, spdlog::sink_ptr>& sinks)
-{
-	std::vector<spdlog::sink_ptr> sink_vec;
-	for (auto it = sinks.begin(); it != sinks.end(); ++it)
-		sink_vec.push_back(it->second);
-	return sink_vec;
-}
+//How long to wait for every port to connect before logging the startup timings anyway, and how often to check
+const uint32_t StartupTimingTimeoutms = 60000;
+const uint32_t StartupTimingPollms = 500;
 
-inline void AddLogger(const std::string& name, const std::unordered_map<std::string, spdlog::sink_ptr>& sinks)
+//Every logger has the one (distribution) sink, so sinks can be added and removed without touching the loggers
+inline void AddLogger(const std::string& name, const spdlog::sink_ptr& dist_sink, const spdlog::async_overflow_policy policy)
 {
-	const std::vector<spdlog::sink_ptr> sink_vec = GetAllSinks(sinks);
-	auto pLogger = std::make_shared<spdlog::async_logger>(name, sink_vec.begin(), sink_vec.end(),
-		odc::spdlog_thread_pool(), spdlog::async_overflow_policy::overrun_oldest);
+	auto pLogger = std::make_shared<spdlog::async_logger>(name, dist_sink, odc::spdlog_thread_pool(), policy);
 	pLogger->set_level(spdlog::level::trace);
 	odc::spdlog_register_logger(pLogger);
 }
 
-//Drop and reload all the loggers
-//This may cause some log messages to be lost...
-inline void ReloadLogSinks(const std::unordered_map<std::string, spdlog::sink_ptr>& sinks)
-{
-	std::vector<std::string> lognames;
-	odc::spdlog_apply_all([&lognames](std::shared_ptr<spdlog::logger> log)
-		{
-			lognames.push_back(log->name());
-		});
-	odc::spdlog_drop_all();
-	for(const auto& name : lognames)
-		AddLogger(name, sinks);
-}
-
-DataConcentrator::DataConcentrator(const std::string& FileName):
+DataConcentrator::DataConcentrator(const std::string& FileName, const std::string& SnapshotFileName):
 	ConfigParser(FileName),
 	pIOS(odc::asio_service::Get()),
 	ios_working(pIOS->make_work()),
 	shutting_down(false),
-	shut_down(false)
+	shut_down(false),
+	pLogDist(std::make_shared<LogDistSink>())
 {
 	// Enable loading of libraries
 	InitLibaryLoading();
@@ -90,10 +71,34 @@ DataConcentrator::DataConcentrator(const std::string& FileName):
 			result["version"] = ODC_VERSION_STRING;
 			return result;
 		},"Return the version information of opendatacon.");
+	this->AddCommand("StartupTiming", [this](const ParamCollection &params)
+		{
+			return GetStartupTimings();
+		},"Return the time each DataPort took to parse its config, build, enable and first connect.");
+	this->AddCommand("LogStats", [this](const ParamCollection &params)
+		{
+			return GetLogStats();
+		},"Return the async logging queue settings and message counters.");
+
+	//Recall any unchanged config files from a previous run
+	size_t snapshot_count = 0;
+	if(!SnapshotFileName.empty())
+		snapshot_count = ConfigParser::LoadSnapshot(SnapshotFileName);
 
 	//Parse the configs and create all user interfaces, ports and connections
 	ProcessFile();
 
+	if(!SnapshotFileName.empty())
+	{
+		auto saved = ConfigParser::SaveSnapshot(SnapshotFileName);
+		if(auto log = odc::spdlog_get("opendatacon"))
+		{
+			log->info("Recalled {} config files from snapshot '{}'", snapshot_count, SnapshotFileName);
+			if(saved)
+				log->info("Updated config snapshot '{}'", SnapshotFileName);
+		}
+	}
+
 	if(Interfaces.empty() && DataPorts.empty() && DataConnectors.empty())
 		throw std::runtime_error("No objects to manage");
 
@@ -127,11 +132,11 @@ DataConcentrator::DataConcentrator(const std::string& FileName):
 		interface.second->AddCommand("add_logsink",[this] (std::stringstream& ss)
 			{
 				this->AddLogSink(ss);
-			},"Add a log sink. WARNING: May cause missed log messages momentarily");
+			},"Add a log sink");
 		interface.second->AddCommand("del_logsink",[this] (std::stringstream& ss)
 			{
 				this->DeleteLogSink(ss);
-			},"Delete a log sink. WARNING: May cause missed log messages momentarily");
+			},"Delete a log sink");
 		interface.second->AddCommand("ls_logsink",[this] (std::stringstream& ss)
 			{
 				this->ListLogSinks();
@@ -177,12 +182,11 @@ DataConcentrator::~DataConcentrator()
 		if (!(sink_name == "file" || sink_name == "console"))
 		{
 			weak_sinks.push_back(LogSinks[sink_name]);
+			pLogDist->remove_sink(LogSinks[sink_name]);
 			LogSinks.erase(sink_name);
 		}
 	}
 
-	ReloadLogSinks(LogSinks);
-
 	// Wait for all the sinks to be destroyed
 	for (auto weak_sink : weak_sinks)
 		while (!weak_sink.expired())
@@ -204,6 +208,25 @@ inline void DataConcentrator::ListLogLevels()
 		std::cout << "\t" << spdlog::level::level_string_views[i].data() << std::endl;
 }
 
+const Json::Value DataConcentrator::GetLogStats()
+{
+	Json::Value result;
+	result["QueueSize"] = Json::UInt64(LogQueueSize);
+	result["ThreadCount"] = Json::UInt64(LogThreadCount);
+	result["OverflowPolicy"] = LogOverflowPolicy == spdlog::async_overflow_policy::block ? "Block" : "OverrunOldest";
+	result["Delivered"] = Json::UInt64(pLogDist->GetDelivered());
+
+	//messages discarded by the async queue - only available if spdlog keeps count
+	size_t overruns;
+	if(odc::spdlog_overrun_count(overruns))
+		result["Overruns"] = Json::UInt64(overruns);
+	else
+		result["Overruns"] = "Unavailable (needs spdlog 1.8 or later)";
+
+	for(const auto& sink : LogSinks)
+		result["Sinks"][sink.first] = spdlog::level::level_string_views[sink.second->level()].data();
+	return result;
+}
 
 void DataConcentrator::SetLogLevel(std::stringstream& ss)
 {
@@ -303,6 +326,30 @@ void DataConcentrator::AddLogSink(std::stringstream& ss)
 					std::cout << "Usage: add_logsink <sinkname> <level> TCP <host> <port> <client / server>" << std::endl;
 				}
 			}
+			else if(sinktype == "BINARY")
+			{
+				std::string filename;
+				size_t size_kb = 0;
+				if(ss>>filename)
+				{
+					ss>>size_kb;
+					try
+					{
+						auto binary_sink = std::make_shared<odc::binary_file_spdlog_sink>(filename, size_kb*1024);
+						binary_sink->set_level(spdlog::level::off);
+						LogSinks[sinkname] = binary_sink;
+					}
+					catch(const spdlog::spdlog_ex& e)
+					{
+						std::cout << e.what() << std::endl;
+						return;
+					}
+				}
+				else
+				{
+					std::cout << "Usage: add_logsink <sinkname> <level> BINARY <filename> [ <max file size kB> ]" << std::endl;
+				}
+			}
 			else if(sinktype == "FILE")
 			{
 				//TODO: implement
@@ -310,10 +357,12 @@ void DataConcentrator::AddLogSink(std::stringstream& ss)
 			}
 			else
 			{
-				std::cout << "Usage: add_logsink <sinkname> <level> <TCP|FILE|SYSLOG> ..." << std::endl;
+				std::cout << "Usage: add_logsink <sinkname> <level> <TCP|FILE|SYSLOG|BINARY> ..." << std::endl;
 				return;
 			}
 			SetLogLevel(level_params);
+			if(LogSinks.find(sinkname) != LogSinks.end())
+				pLogDist->add_sink(LogSinks[sinkname]);
 		}
 		else
 		{
@@ -324,10 +373,8 @@ void DataConcentrator::AddLogSink(std::stringstream& ss)
 	}
 	else
 	{
-		std::cout << "Usage: add_logsink <sinkname> <level> <TCP|FILE|SYSLOG> ..." << std::endl;
+		std::cout << "Usage: add_logsink <sinkname> <level> <TCP|FILE|SYSLOG|BINARY> ..." << std::endl;
 	}
-
-	ReloadLogSinks(LogSinks);
 }
 
 void DataConcentrator::DeleteLogSink(std::stringstream& ss)
@@ -337,6 +384,7 @@ void DataConcentrator::DeleteLogSink(std::stringstream& ss)
 	{
 		if(LogSinks.find(sinkname) != LogSinks.end())
 		{
+			pLogDist->remove_sink(LogSinks[sinkname]);
 			LogSinks.erase(sinkname);
 		}
 		else
@@ -350,8 +398,6 @@ void DataConcentrator::DeleteLogSink(std::stringstream& ss)
 	{
 		std::cout << "Usage: del_logsink <sinkname> <level> <TCP|FILE|SYSLOG> ..." << std::endl;
 	}
-
-	ReloadLogSinks(LogSinks);
 }
 
 void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
@@ -370,6 +416,16 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 	auto log_level_name = JSONRoot.isMember("LogLevel") ? JSONRoot["LogLevel"].asString() : "info";
 	auto console_level_name = JSONRoot.isMember("ConsoleLevel") ? JSONRoot["ConsoleLevel"].asString() : "err";
 
+	//async logging queue - messages beyond the queue size are either dropped (oldest first) or block the caller
+	LogQueueSize = JSONRoot.isMember("LogQueueSize") ? JSONRoot["LogQueueSize"].asUInt() : 4096;
+	LogThreadCount = JSONRoot.isMember("LogThreadCount") ? JSONRoot["LogThreadCount"].asUInt() : 3;
+	if(LogQueueSize == 0)
+		LogQueueSize = 4096;
+	if(LogThreadCount == 0)
+		LogThreadCount = 1;
+	if(JSONRoot.isMember("LogOverflowPolicy") && JSONRoot["LogOverflowPolicy"].asString() == "Block")
+		LogOverflowPolicy = spdlog::async_overflow_policy::block;
+
 	//these return level::off if no match
 	auto log_level = spdlog::level::from_str(log_level_name);
 	auto console_level = spdlog::level::from_str(console_level_name);
@@ -389,12 +445,13 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 
 		LogSinks["file"] = file;
 		LogSinks["console"] = console;
+		pLogDist->add_sink(file);
+		pLogDist->add_sink(console);
 
 		//TODO: document these config options
 		if(JSONRoot.isMember("SyslogLog"))
 		{
-			const std::vector<spdlog::sink_ptr> sink_vec = GetAllSinks(LogSinks);
-			auto temp_logger = std::make_shared<spdlog::logger>("init", begin(sink_vec), end(sink_vec));
+			auto temp_logger = std::make_shared<spdlog::logger>("init", pLogDist);
 
 			auto SyslogJSON = JSONRoot["SyslogLog"];
 			if(!SyslogJSON.isMember("Host"))
@@ -413,14 +470,14 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 					*pIOS,host,port,1,local_host,app,category);
 				syslog_sink->set_level(log_level);
 				LogSinks["syslog"] = syslog_sink;
+				pLogDist->add_sink(syslog_sink);
 			}
 		}
 
 		//TODO: document these config options
 		if(JSONRoot.isMember("TCPLog"))
 		{
-			const std::vector<spdlog::sink_ptr> sink_vec = GetAllSinks(LogSinks);
-			auto temp_logger = std::make_shared<spdlog::logger>("init", begin(sink_vec), end(sink_vec));
+			auto temp_logger = std::make_shared<spdlog::logger>("init", pLogDist);
 
 			auto TCPLogJSON = JSONRoot["TCPLog"];
 			if(!TCPLogJSON.isMember("IP") || !TCPLogJSON.isMember("Port") || !TCPLogJSON.isMember("TCPClientServer"))
@@ -446,10 +503,35 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 			auto tcp = std::make_shared<spdlog::sinks::ostream_sink_mt>(*pTCPostreams["tcp"], true);
 			tcp->set_level(log_level);
 			LogSinks["tcp"] = tcp;
+			pLogDist->add_sink(tcp);
 		}
 
-		odc::spdlog_init_thread_pool(4096,3);
-		AddLogger("opendatacon", LogSinks);
+		if(JSONRoot.isMember("BinaryLog"))
+		{
+			auto temp_logger = std::make_shared<spdlog::logger>("init", pLogDist);
+
+			auto BinaryLogJSON = JSONRoot["BinaryLog"];
+			if(!BinaryLogJSON.isMember("FileName"))
+			{
+				temp_logger->error("Invalid BinaryLog config: need at least 'FileName': \n'{}\n' : ignoring", BinaryLogJSON.toStyledString());
+			}
+			else
+			{
+				auto size_kb = BinaryLogJSON.isMember("FileSizekB") ? BinaryLogJSON["FileSizekB"].asUInt() : 0;
+				auto level_name = BinaryLogJSON.isMember("Level") ? BinaryLogJSON["Level"].asString() : "trace";
+				auto level = spdlog::level::from_str(level_name);
+				if(level == spdlog::level::off && level_name != "off")
+					level = spdlog::level::trace;
+
+				auto binary_sink = std::make_shared<odc::binary_file_spdlog_sink>(BinaryLogJSON["FileName"].asString(), size_t(size_kb)*1024);
+				binary_sink->set_level(level);
+				LogSinks["binary"] = binary_sink;
+				pLogDist->add_sink(binary_sink);
+			}
+		}
+
+		odc::spdlog_init_thread_pool(LogQueueSize,LogThreadCount);
+		AddLogger("opendatacon", pLogDist, LogOverflowPolicy);
 	}
 	catch (const spdlog::spdlog_ex& ex)
 	{
@@ -463,6 +545,8 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 	log->critical("This is opendatacon version '{}'", ODC_VERSION_STRING);
 	log->critical("Log level set to {}", spdlog::level::level_string_views[log_level]);
 	log->critical("Console level set to {}", spdlog::level::level_string_views[console_level]);
+	log->info("Async log queue size {} with {} threads, {} on overflow", LogQueueSize, LogThreadCount,
+		LogOverflowPolicy == spdlog::async_overflow_policy::block ? "blocking" : "dropping oldest");
 	log->info("Loading configuration... ");
 
 	//Configure the user interface
@@ -529,7 +613,7 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 			}
 			//Create a logger if we haven't already
 			if(!odc::spdlog_get(libname))
-				AddLogger(libname, LogSinks);
+				AddLogger(libname, pLogDist, LogOverflowPolicy);
 
 			auto plugin_cleanup = [=](IUI* plugin)
 						    {
@@ -546,6 +630,14 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 	{
 		const Json::Value Ports = JSONRoot["Ports"];
 
+		//Libraries and loggers are loaded serially below, but the ports themselves
+		//	(which parse their own, potentially large, config files) are constructed in parallel
+		typedef std::function<std::shared_ptr<DataPort>()> PortCreator_t;
+		std::vector<std::string> port_names;
+		std::vector<PortCreator_t> port_creators;
+		std::vector<std::function<void (IOHandler*)>> port_init_modes;
+		std::unordered_set<std::string> pending_names;
+
 		for(Json::Value::ArrayIndex n = 0; n < Ports.size(); ++n)
 		{
 			if(!Ports[n].isMember("Type") || !Ports[n].isMember("Name") || !Ports[n].isMember("ConfFilename"))
@@ -553,7 +645,7 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 				log->error("Invalid port config: need at least Type, Name, ConfFilename: \n'{}\n' : ignoring", Ports[n].toStyledString());
 				continue;
 			}
-			if(DataPorts.count(Ports[n]["Name"].asString()))
+			if(DataPorts.count(Ports[n]["Name"].asString()) || pending_names.count(Ports[n]["Name"].asString()))
 			{
 				log->error("Duplicate Port Name; ignoring:\n'{}\n'", Ports[n].toStyledString());
 				continue;
@@ -599,10 +691,21 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 				set_init_mode = [](IOHandler* aIOH){};
 			}
 
+			const auto PortName = Ports[n]["Name"].asString();
+			const auto PortConfFilename = Ports[n]["ConfFilename"].asString();
+			const auto PortConfOverrides = Ports[n]["ConfOverrides"];
+			auto null_creator = [=]() -> std::shared_ptr<DataPort>
+						  {
+							  return std::shared_ptr<DataPort>(new NullPort(PortName, PortConfFilename, PortConfOverrides));
+						  };
+			pending_names.insert(PortName);
+			port_names.push_back(PortName);
+			port_init_modes.push_back(set_init_mode);
+			StartupTimings[PortName].Library = "Null";
+
 			if(Ports[n]["Type"].asString() == "Null")
 			{
-				DataPorts.emplace(Ports[n]["Name"].asString(), std::unique_ptr<DataPort,void (*)(DataPort*)>(new NullPort(Ports[n]["Name"].asString(), Ports[n]["ConfFilename"].asString(), Ports[n]["ConfOverrides"]),[](DataPort* pDP){delete pDP;}));
-				set_init_mode(DataPorts.at(Ports[n]["Name"].asString()).get());
+				port_creators.push_back(null_creator);
 				continue;
 			}
 
@@ -625,15 +728,14 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 			if(portlib == nullptr)
 			{
 				log->error("{}",LastSystemError());
-				log->error("Failed to load library '{}' mapping {} to NullPort...", libfilename, Ports[n]["Name"].asString());
-				DataPorts.emplace(Ports[n]["Name"].asString(), std::unique_ptr<DataPort,void (*)(DataPort*)>(new NullPort(Ports[n]["Name"].asString(), Ports[n]["ConfFilename"].asString(), Ports[n]["ConfOverrides"]),[](DataPort* pDP){delete pDP;}));
-				set_init_mode(DataPorts.at(Ports[n]["Name"].asString()).get());
+				log->error("Failed to load library '{}' mapping {} to NullPort...", libfilename, PortName);
+				port_creators.push_back(null_creator);
 				continue;
 			}
 
 			//Create a logger if we haven't already
 			if(!odc::spdlog_get(libname))
-				AddLogger(libname, LogSinks);
+				AddLogger(libname, pLogDist, LogOverflowPolicy);
 
 			//Our API says the library should export a creation function: DataPort* new_<Type>Port(Name, Filename, Overrides)
 			//it should return a pointer to a heap allocated instance of a descendant of DataPort
@@ -644,15 +746,14 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 			auto delete_port_func = reinterpret_cast<void (*)(DataPort*)>(LoadSymbol(portlib, delete_funcname));
 
 			if(new_port_func == nullptr)
-				log->info("{} : Failed to load symbol '{}' from library '{}' - {}", Ports[n]["Name"].asString(), new_funcname, libfilename, LastSystemError());
+				log->info("{} : Failed to load symbol '{}' from library '{}' - {}", PortName, new_funcname, libfilename, LastSystemError());
 			if(delete_port_func == nullptr)
-				log->info("{} : Failed to load symbol '{}' from library '{}' - {}", Ports[n]["Name"].asString(), delete_funcname, libfilename, LastSystemError());
+				log->info("{} : Failed to load symbol '{}' from library '{}' - {}", PortName, delete_funcname, libfilename, LastSystemError());
 
 			if(new_port_func == nullptr || delete_port_func == nullptr)
 			{
-				log->error("{} : Failed to load port, mapping to NullPort...", Ports[n]["Name"].asString());
-				DataPorts.emplace(Ports[n]["Name"].asString(), std::unique_ptr<DataPort,void (*)(DataPort*)>(new NullPort(Ports[n]["Name"].asString(), Ports[n]["ConfFilename"].asString(), Ports[n]["ConfOverrides"]),[](DataPort* pDP){delete pDP;}));
-				set_init_mode(DataPorts.at(Ports[n]["Name"].asString()).get());
+				log->error("{} : Failed to load port, mapping to NullPort...", PortName);
+				port_creators.push_back(null_creator);
 				continue;
 			}
 
@@ -662,9 +763,41 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 							  UnLoadModule(portlib);
 						  };
 
+			StartupTimings[PortName].Library = libname;
+
 			//call the creation function and wrap the returned pointer to a new port
-			DataPorts.emplace(Ports[n]["Name"].asString(), std::unique_ptr<DataPort,decltype(port_cleanup)>(new_port_func(Ports[n]["Name"].asString(), Ports[n]["ConfFilename"].asString(), Ports[n]["ConfOverrides"]), port_cleanup));
-			set_init_mode(DataPorts.at(Ports[n]["Name"].asString()).get());
+			port_creators.push_back([=]() -> std::shared_ptr<DataPort>
+				{
+					return std::shared_ptr<DataPort>(new_port_func(PortName, PortConfFilename, PortConfOverrides), port_cleanup);
+				});
+		}
+
+		log->info("Constructing {} DataPorts...", port_creators.size());
+		std::vector<std::shared_ptr<DataPort>> new_ports(port_creators.size());
+		std::vector<double> parse_times(port_creators.size());
+		//Ports from the same library can share static state (channels, connections etc.)
+		//	so construct those one after the other, but construct different libraries concurrently
+		std::unordered_map<std::string, std::vector<size_t>> library_groups;
+		for(size_t i = 0; i < port_creators.size(); i++)
+			library_groups[StartupTimings[port_names[i]].Library].push_back(i);
+		std::vector<std::function<void()>> jobs;
+		for(const auto& group : library_groups)
+			jobs.push_back([&new_ports,&parse_times,&port_creators,&group]()
+				{
+					for(auto i : group.second)
+					{
+						auto start = std::chrono::steady_clock::now();
+						new_ports[i] = port_creators[i]();
+						parse_times[i] = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+					}
+				});
+		ParallelExecute(jobs);
+
+		for(size_t i = 0; i < new_ports.size(); i++)
+		{
+			port_init_modes[i](new_ports[i].get());
+			StartupTimings[port_names[i]].Parsems = parse_times[i];
+			DataPorts.emplace(port_names[i], std::move(new_ports[i]));
 		}
 	}
 
@@ -673,7 +806,7 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 		const Json::Value Connectors = JSONRoot["Connectors"];
 
 		//make a logger for use by Connectors
-		AddLogger("Connectors", LogSinks);
+		AddLogger("Connectors", pLogDist, LogOverflowPolicy);
 
 		for(Json::Value::ArrayIndex n = 0; n < Connectors.size(); ++n)
 		{
@@ -717,6 +850,43 @@ void DataConcentrator::ProcessElements(const Json::Value& JSONRoot)
 	}
 }
 
+void DataConcentrator::ParallelExecute(const std::vector<std::function<void()>>& jobs)
+{
+	//Use a private pool of threads, not the io_service
+	//	so nothing else that's been posted gets run before Run() starts the worker threads
+	std::atomic<size_t> next_job(0);
+	std::exception_ptr first_exception = nullptr;
+	std::mutex exception_mtx;
+
+	auto worker = [&jobs,&next_job,&first_exception,&exception_mtx]()
+			  {
+				  for(size_t i = next_job++; i < jobs.size(); i = next_job++)
+				  {
+					  try
+					  {
+						  jobs[i]();
+					  }
+					  catch(...)
+					  {
+						  std::lock_guard<std::mutex> lck(exception_mtx);
+						  if(!first_exception)
+							  first_exception = std::current_exception();
+					  }
+				  }
+			  };
+
+	std::vector<std::thread> helpers;
+	const size_t num_threads = std::min<size_t>(jobs.size(), std::thread::hardware_concurrency());
+	for(size_t i = 1; i < num_threads; i++)
+		helpers.emplace_back(worker);
+	worker();
+	for(auto& helper : helpers)
+		helper.join();
+
+	if(first_exception)
+		std::rethrow_exception(first_exception);
+}
+
 void DataConcentrator::Build()
 {
 	if(auto log = odc::spdlog_get("opendatacon"))
@@ -727,10 +897,29 @@ void DataConcentrator::Build()
 	}
 	if(auto log = odc::spdlog_get("opendatacon"))
 		log->info("Initialising DataPorts...");
+	//Ports from the same library can share static state (channels, connections etc.)
+	//	so build those one after the other, but build different libraries concurrently
+	std::unordered_map<std::string, std::vector<std::shared_ptr<DataPort>>> library_groups;
 	for(auto& Name_n_Port : DataPorts)
 	{
-		Name_n_Port.second->Build();
+		library_groups[StartupTimings[Name_n_Port.first].Library].push_back(Name_n_Port.second);
 	}
+	std::vector<std::function<void()>> jobs;
+	for(const auto& group : library_groups)
+	{
+		jobs.push_back([this,&group]()
+			{
+				for(const auto& port : group.second)
+				{
+					auto start = std::chrono::steady_clock::now();
+					port->Build();
+					auto build_ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+					std::lock_guard<std::mutex> lck(StartupTimingsMtx);
+					StartupTimings[port->GetName()].Buildms = build_ms;
+				}
+			});
+	}
+	ParallelExecute(jobs);
 	if(auto log = odc::spdlog_get("opendatacon"))
 		log->info("Initialising DataConnectors...");
 	for(auto& Name_n_Conn : DataConnectors)
@@ -739,6 +928,103 @@ void DataConcentrator::Build()
 	}
 }
 
+void DataConcentrator::TimedEnable(const std::shared_ptr<DataPort>& port)
+{
+	{
+		std::lock_guard<std::mutex> lck(StartupTimingsMtx);
+		StartupTimings[port->GetName()].EnableTime = odc::msSinceEpoch();
+	}
+	auto start = std::chrono::steady_clock::now();
+	port->Enable();
+	auto enable_ms = std::chrono::duration<double,std::milli>(std::chrono::steady_clock::now()-start).count();
+	std::lock_guard<std::mutex> lck(StartupTimingsMtx);
+	StartupTimings[port->GetName()].Enablems = enable_ms;
+}
+
+const Json::Value DataConcentrator::GetStartupTimings()
+{
+	Json::Value result;
+	std::lock_guard<std::mutex> lck(StartupTimingsMtx);
+	for(const auto& Name_n_Timing : StartupTimings)
+	{
+		const auto& timing = Name_n_Timing.second;
+		auto& port_result = result[Name_n_Timing.first];
+		port_result["Library"] = timing.Library;
+		port_result["Parsems"] = timing.Parsems;
+		port_result["Buildms"] = timing.Buildms;
+		port_result["Enablems"] = timing.Enablems;
+
+		//time from starting to enable, to the port reporting it's connected
+		auto port = DataPorts.find(Name_n_Timing.first);
+		if(port != DataPorts.end() && timing.EnableTime != 0 && port->second->GetFirstConnectTime() >= timing.EnableTime)
+			port_result["FirstConnectms"] = Json::UInt64(port->second->GetFirstConnectTime() - timing.EnableTime);
+		else
+			port_result["FirstConnectms"] = Json::Value::nullSingleton();
+	}
+	return result;
+}
+
+void DataConcentrator::LogStartupTimings()
+{
+	auto log = odc::spdlog_get("opendatacon");
+	if(!log)
+		return;
+
+	auto timings = GetStartupTimings();
+	//slowest first
+	std::vector<std::string> names = timings.getMemberNames();
+	auto total = [&timings](const std::string& name)
+			 {
+				 return timings[name]["Parsems"].asDouble() + timings[name]["Buildms"].asDouble() + timings[name]["Enablems"].asDouble();
+			 };
+	std::sort(names.begin(), names.end(), [&total](const std::string& a, const std::string& b)
+		{
+			return total(a) > total(b);
+		});
+
+	log->info("DataPort startup timing (slowest first):");
+	for(const auto& name : names)
+	{
+		const auto& timing = timings[name];
+		log->info("{} ({}): parse {:.1f}ms, build {:.1f}ms, enable {:.1f}ms, first connect {}", name, timing["Library"].asString(),
+			timing["Parsems"].asDouble(), timing["Buildms"].asDouble(), timing["Enablems"].asDouble(),
+			timing["FirstConnectms"].isNull() ? "pending" : timing["FirstConnectms"].asString()+"ms");
+	}
+}
+
+bool DataConcentrator::AllPortsConnected()
+{
+	std::lock_guard<std::mutex> lck(StartupTimingsMtx);
+	for(const auto& Name_n_Timing : StartupTimings)
+	{
+		//ports that haven't been enabled (disabled or still delayed) aren't expected to connect
+		if(Name_n_Timing.second.EnableTime == 0)
+			continue;
+		auto port = DataPorts.find(Name_n_Timing.first);
+		if(port != DataPorts.end() && port->second->GetFirstConnectTime() < Name_n_Timing.second.EnableTime)
+			return false;
+	}
+	return true;
+}
+
+void DataConcentrator::LogStartupTimingsOnConnect(std::shared_ptr<asio::steady_timer> pTimer, odc::msSinceEpoch_t deadline)
+{
+	if(shutting_down)
+		return;
+	if(AllPortsConnected() || odc::msSinceEpoch() >= deadline)
+	{
+		LogStartupTimings();
+		return;
+	}
+	pTimer->expires_from_now(std::chrono::milliseconds(StartupTimingPollms));
+	pTimer->async_wait([this,pTimer,deadline](asio::error_code err_code)
+		{
+			if(err_code)
+				return;
+			LogStartupTimingsOnConnect(pTimer,deadline);
+		});
+}
+
 void DataConcentrator::Run()
 {
 	if (auto log = odc::spdlog_get("opendatacon"))
@@ -795,7 +1081,7 @@ void DataConcentrator::Run()
 		{
 			pIOS->post([this,Name_n_Port]()
 				{
-					Name_n_Port.second->Enable();
+					TimedEnable(Name_n_Port.second);
 					starting_element_count--;
 				});
 		}
@@ -806,7 +1092,7 @@ void DataConcentrator::Run()
 			pTimer->async_wait([this,pTimer,Name_n_Port](asio::error_code err_code)
 				{
 					//FIXME: check err_code?
-					Name_n_Port.second->Enable();
+					TimedEnable(Name_n_Port.second);
 					starting_element_count--;
 				});
 		}
@@ -832,6 +1118,7 @@ void DataConcentrator::Run()
 
 		if(auto log = odc::spdlog_get("opendatacon"))
 			log->info("Up and running.");
+		LogStartupTimingsOnConnect(pIOS->make_steady_timer(), odc::msSinceEpoch()+StartupTimingTimeoutms);
 
 		pIOS->run();
 	}
@@ -28,6 +28,7 @@
 #define DATACONCENTRATOR_H_
 #include "DataConnector.h"
 #include "DataConnectorCollection.h"
+#include "LogDistSink.h"
 #include "DataConnector.h"
 #include <opendatacon/DataPort.h>
 #include <opendatacon/DataPortCollection.h>
@@ -45,7 +46,7 @@
 class DataConcentrator: public ConfigParser, public IUIResponder
 {
 public:
-	DataConcentrator(const std::string& FileName);
+	DataConcentrator(const std::string& FileName, const std::string& SnapshotFileName = "");
 	~DataConcentrator() override;
 
 	void ProcessElements(const Json::Value& JSONRoot) override;
@@ -71,7 +72,13 @@ private:
 	std::unordered_map<std::string, TCPstringbuf> TCPbufs;
 	std::unordered_map<std::string, std::unique_ptr<std::ostream>> pTCPostreams;
 
+	//all loggers write to pLogDist, which forwards to the sinks in LogSinks
+	std::shared_ptr<LogDistSink> pLogDist;
 	std::unordered_map<std::string, spdlog::sink_ptr> LogSinks;
+	size_t LogQueueSize = 4096;
+	size_t LogThreadCount = 3;
+	spdlog::async_overflow_policy LogOverflowPolicy = spdlog::async_overflow_policy::overrun_oldest;
+	const Json::Value GetLogStats();
 	inline void ListLogSinks();
 	inline void ListLogLevels();
 	void SetLogLevel(std::stringstream& ss);
@@ -79,6 +86,27 @@ private:
 	void DeleteLogSink(std::stringstream& ss);
 
 	std::vector<std::thread> threads;
+
+	//Run independent jobs concurrently on temporary threads, and wait for them all to finish
+	void ParallelExecute(const std::vector<std::function<void()>>& jobs);
+
+	//Per port startup timing, to see what dominates (re)start time
+	struct StartupTiming
+	{
+		std::string Library;
+		double Parsems = 0;
+		double Buildms = 0;
+		double Enablems = 0;
+		odc::msSinceEpoch_t EnableTime = 0;
+	};
+	std::unordered_map<std::string, StartupTiming> StartupTimings;
+	std::mutex StartupTimingsMtx;
+	void TimedEnable(const std::shared_ptr<DataPort>& port);
+	const Json::Value GetStartupTimings();
+	void LogStartupTimings();
+	//Log the timings once every enabled port has connected, or after a timeout if some never do
+	bool AllPortsConnected();
+	void LogStartupTimingsOnConnect(std::shared_ptr<asio::steady_timer> pTimer, odc::msSinceEpoch_t deadline);
 };
 
 #endif /* DATACONCENTRATOR_H_ */
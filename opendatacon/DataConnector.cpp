@@ -80,8 +80,8 @@ void DataConnector::ProcessElements(const Json::Value& JSONRoot)
 				GetIOHandlers()[ConPort1]->Subscribe(this, this->Name);
 				GetIOHandlers()[ConPort2]->Subscribe(this, this->Name);
 				//Add to the lookup table
-				SenderConnectionsLookup.insert(std::make_pair(ConPort1, ConName));
-				SenderConnectionsLookup.insert(std::make_pair(ConPort2, ConName));
+				SenderConnectionsLookup[InternName(ConPort1)].push_back(Connections[ConName].second);
+				SenderConnectionsLookup[InternName(ConPort2)].push_back(Connections[ConName].first);
 			}
 			catch (std::exception& e)
 			{
@@ -109,32 +109,32 @@ void DataConnector::ProcessElements(const Json::Value& JSONRoot)
 
 				if(Transforms[n]["Type"].asString() == "IndexOffset")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new IndexOffsetTransform(Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new IndexOffsetTransform(Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 				if(Transforms[n]["Type"].asString() == "IndexMap")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new IndexMapTransform(Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new IndexMapTransform(Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 				if(Transforms[n]["Type"].asString() == "Threshold")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new ThresholdTransform(Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new ThresholdTransform(Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 				if(Transforms[n]["Type"].asString() == "Rand")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new RandTransform(Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new RandTransform(Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 				if(Transforms[n]["Type"].asString() == "RateLimit")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new RateLimitTransform(Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new RateLimitTransform(Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 				if(Transforms[n]["Type"].asString() == "LogicInv")
 				{
-					ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new LogicInvTransform    (Transforms[n]["Parameters"]), normal_delete));
+					ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, void (*)(Transform*)>(new LogicInvTransform    (Transforms[n]["Parameters"]), normal_delete));
 					continue;
 				}
 
@@ -206,7 +206,7 @@ void DataConnector::ProcessElements(const Json::Value& JSONRoot)
 							};
 
 				//call the creation function and wrap the returned pointer
-				ConnectionTransforms[Transforms[n]["Sender"].asString()].push_back(std::unique_ptr<Transform, decltype(tx_cleanup)>(new_tx_func(Transforms[n]["Params"].asString()),tx_cleanup));
+				ConnectionTransforms[InternName(Transforms[n]["Sender"].asString())].push_back(std::unique_ptr<Transform, decltype(tx_cleanup)>(new_tx_func(Transforms[n]["Params"].asString()),tx_cleanup));
 			}
 			catch (std::exception& e)
 			{
@@ -219,24 +219,27 @@ void DataConnector::ProcessElements(const Json::Value& JSONRoot)
 
 void DataConnector::Event(ConnectState state, const std::string& SenderName)
 {
-	if(MuxConnectionEvents(state, SenderName))
-	{
-		auto bounds = SenderConnectionsLookup.equal_range(SenderName);
-		for(auto aMatch_it = bounds.first; aMatch_it != bounds.second; aMatch_it++)
-		{
-			//guess which one is the sendee
-			IOHandler* pSendee = Connections[aMatch_it->second].second;
-
-			//check if we were right and correct if need be
-			if(pSendee->GetName() == SenderName)
-				pSendee = Connections[aMatch_it->second].first;
+	Event(state, InternName(SenderName));
+}
 
-			pSendee->Event(state, Name);
-		}
+void DataConnector::Event(ConnectState state, NameID_t SenderID)
+{
+	if(MuxConnectionEvents(state, SenderID))
+	{
+		auto sendees_it = SenderConnectionsLookup.find(SenderID);
+		if(sendees_it == SenderConnectionsLookup.end())
+			return;
+		for(auto pSendee : sendees_it->second)
+			pSendee->Event(state, ID);
 	}
 }
 
 void DataConnector::Event(std::shared_ptr<const EventInfo> event, const std::string& SenderName, SharedStatusCallback_t pStatusCallback)
+{
+	Event(event, InternName(SenderName), pStatusCallback);
+}
+
+void DataConnector::Event(std::shared_ptr<const EventInfo> event, NameID_t SenderID, SharedStatusCallback_t pStatusCallback)
 {
 	if(!enabled)
 	{
@@ -244,14 +247,16 @@ void DataConnector::Event(std::shared_ptr<const EventInfo> event, const std::str
 		return;
 	}
 
-	auto connection_count = SenderConnectionsLookup.count(SenderName);
+	auto sendees_it = SenderConnectionsLookup.find(SenderID);
 	//Do we have a connection for this sender?
-	if(connection_count > 0)
+	if(sendees_it != SenderConnectionsLookup.end())
 	{
+		const auto& sendees = sendees_it->second;
 		auto new_event_obj = std::make_shared<EventInfo>(*event);
-		if(ConnectionTransforms.count(SenderName))
+		auto transforms_it = ConnectionTransforms.find(SenderID);
+		if(transforms_it != ConnectionTransforms.end())
 		{
-			for(auto& Transform : ConnectionTransforms[SenderName])
+			for(auto& Transform : transforms_it->second)
 			{
 				if(!Transform->Event(new_event_obj))
 				{
@@ -268,27 +273,19 @@ void DataConnector::Event(std::shared_ptr<const EventInfo> event, const std::str
 			}
 		}
 
-		auto multi_callback = SyncMultiCallback(connection_count,pStatusCallback);
-		auto bounds = SenderConnectionsLookup.equal_range(SenderName);
-		for(auto aMatch_it = bounds.first; aMatch_it != bounds.second; aMatch_it++)
+		auto multi_callback = SyncMultiCallback(sendees.size(),pStatusCallback);
+		for(auto pSendee : sendees)
 		{
-			//guess which one is the sendee
-			IOHandler* pSendee = Connections[aMatch_it->second].second;
-
-			//check if we were right and correct if need be
-			if(pSendee->GetName() == SenderName)
-				pSendee = Connections[aMatch_it->second].first;
-
 			if(auto log = odc::spdlog_get("opendatacon"))
 				log->trace("{} {} Payload {} Event {} => {}", ToString(new_event_obj->GetEventType()),new_event_obj->GetIndex(), new_event_obj->GetPayloadString(), Name, pSendee->GetName());
 
-			pSendee->Event(new_event_obj, this->Name, multi_callback);
+			pSendee->Event(new_event_obj, ID, multi_callback);
 		}
 		return;
 	}
 	//no connection for sender if we get here
 	if(auto log = odc::spdlog_get("Connectors"))
-		log->warn("{}: discarding event from '", Name+SenderName+"' (No connection defined)");
+		log->warn("{}: discarding event from '", Name+NameOf(SenderID)+"' (No connection defined)");
 
 	(*pStatusCallback)(CommandStatus::UNDEFINED);
 }
@@ -43,6 +43,10 @@ public:
 
 	void Event(ConnectState state, const std::string& SenderName) override;
 
+	//the routing is all done by sender id - the name versions above just look up the id
+	void Event(std::shared_ptr<const EventInfo> event, NameID_t SenderID, SharedStatusCallback_t pStatusCallback) override;
+	void Event(ConnectState state, NameID_t SenderID) override;
+
 	virtual const Json::Value GetStatistics() const
 	{
 		return Json::Value();
@@ -61,8 +65,9 @@ protected:
 	void ProcessElements(const Json::Value& JSONRoot) override;
 
 	std::unordered_map<std::string,std::pair<IOHandler*,IOHandler*> > Connections;
-	std::multimap<std::string,std::string> SenderConnectionsLookup;
-	std::unordered_map<std::string,std::vector<std::unique_ptr<Transform, std::function<void(Transform*)>> > > ConnectionTransforms;
+	//where to send events from each sender - one entry per connection the sender is part of
+	std::unordered_map<NameID_t,std::vector<IOHandler*>> SenderConnectionsLookup;
+	std::unordered_map<NameID_t,std::vector<std::unique_ptr<Transform, std::function<void(Transform*)>> > > ConnectionTransforms;
 };
 
 #endif /* DATACONNECTOR_H_ */
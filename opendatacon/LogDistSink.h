@@ -0,0 +1,58 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * LogDistSink.h
+ *
+ *  Created on: 19/10/2026
+ */
+
+#ifndef LOGDISTSINK_H_
+#define LOGDISTSINK_H_
+
+#include <opendatacon/spdlog.h>
+#include <spdlog/sinks/dist_sink.h>
+#include <atomic>
+#include <cstdint>
+
+/*
+  The single sink every logger writes to. The real sinks hang off this one,
+  so they can be added and removed on the fly without re-creating (and dropping) the loggers.
+  Counts what makes it out of the async queue, for comparison with what was logged.
+*/
+class LogDistSink: public spdlog::sinks::dist_sink_mt
+{
+public:
+	uint64_t GetDelivered() const
+	{
+		return Delivered;
+	}
+
+protected:
+	void sink_it_(const spdlog::details::log_msg &msg) override
+	{
+		Delivered++;
+		spdlog::sinks::dist_sink_mt::sink_it_(msg);
+	}
+
+private:
+	std::atomic<uint64_t> Delivered = 0;
+};
+
+#endif /* LOGDISTSINK_H_ */
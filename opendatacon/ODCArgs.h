@@ -31,7 +31,8 @@ struct ODCArgs
 		DaemonInstallArg("i", "daemon_install", "Switch to install opendatacon as a background service (not required / ignored for POSIX platforms)"),
 		DaemonArg("d", "daemon", "Switch to run opendatacon in the background"),
 		PIDFileArg("f", "pidfile", "Optional file path to write a pid file in daemon mode. Eg. /var/run/opendatacon.pid", false, "", "string"),
-		DaemonRemoveArg("r", "daemon_remove", "Switch to uninstall opendatacon as a background service (not required / ignored for POSIX platforms)")
+		DaemonRemoveArg("r", "daemon_remove", "Switch to uninstall opendatacon as a background service (not required / ignored for POSIX platforms)"),
+		ConfigSnapshotArg("s", "config_snapshot", "Optional file path for a binary snapshot of the parsed configuration files. Unchanged files are recalled from it instead of being re-parsed on startup.", false, "", "string")
 	{
 		cmd.add(ConfigFileArg);
 		cmd.add(PathArg);
@@ -39,6 +40,7 @@ struct ODCArgs
 		cmd.add(DaemonArg);
 		cmd.add(PIDFileArg);
 		cmd.add(DaemonRemoveArg);
+		cmd.add(ConfigSnapshotArg);
 		cmd.parse(argc, argv);
 	}
 	TCLAP::CmdLine cmd;
@@ -48,6 +50,7 @@ struct ODCArgs
 	TCLAP::SwitchArg DaemonArg;
 	TCLAP::ValueArg<std::string> PIDFileArg;
 	TCLAP::SwitchArg DaemonRemoveArg;
+	TCLAP::ValueArg<std::string> ConfigSnapshotArg;
 
 	std::string toString()
 	{
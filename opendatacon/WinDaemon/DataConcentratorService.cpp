@@ -84,7 +84,7 @@ void DataConcentratorService::OnStart(DWORD dwArgc, LPWSTR *lpszArgv)
 
 	try
 	{
-		TheDataConcentrator.reset(new DataConcentrator(Args.ConfigFileArg.getValue()));
+		TheDataConcentrator.reset(new DataConcentrator(Args.ConfigFileArg.getValue(), Args.ConfigSnapshotArg.getValue()));
 		TheDataConcentrator->Build();
 		// Queue the main service function for execution in a worker thread.
 		std::thread([&](){ServiceWorkerThread(); }).detach();
@@ -99,7 +99,7 @@ int main(int argc, char* argv[])
 
 		// Construct and build opendatacon object
 		//	static shared ptr to use in signal handler
-		static auto TheDataConcentrator = std::make_shared<DataConcentrator>(Args.ConfigFileArg.getValue());
+		static auto TheDataConcentrator = std::make_shared<DataConcentrator>(Args.ConfigFileArg.getValue(), Args.ConfigSnapshotArg.getValue());
 
 		TheDataConcentrator->Build();
 
@@ -0,0 +1,55 @@
+#!/usr/bin/perl
+#
+# Decode opendatacon binary log files (BinaryLog config, or add_logsink ... BINARY) to text
+# Usage: decode_binlog.pl <file> [ <file> ... ]
+#
+# Record layout is documented in include/opendatacon/binary_file_spdlog_sink.h
+#
+use strict;
+use warnings;
+use POSIX qw(strftime);
+
+my @levels = ('trace','debug','info','warning','error','critical','off');
+
+die "Usage: $0 <binary log file> [ <binary log file> ... ]\n" unless @ARGV;
+
+foreach my $filename (@ARGV)
+{
+	open(my $fh, '<:raw', $filename) or die "Failed to open '$filename': $!\n";
+
+	my $magic;
+	read($fh, $magic, 8) == 8 && $magic eq 'ODCBLOG1' or die "'$filename' is not an opendatacon binary log\n";
+
+	my %names;
+	my $buf;
+	while(read($fh, $buf, 1) == 1)
+	{
+		my $type = unpack('C', $buf);
+		if($type == 0x01)
+		{
+			last unless read($fh, $buf, 4) == 4;
+			my ($id, $len) = unpack('v v', $buf);
+			last unless read($fh, $buf, $len) == $len;
+			$names{$id} = $buf;
+		}
+		elsif($type == 0x02)
+		{
+			last unless read($fh, $buf, 23) == 23;
+			my ($ns, $level, $id, $thread, $len) = unpack('q< C v Q< V', $buf);
+			my $payload = '';
+			last unless $len == 0 || read($fh, $payload, $len) == $len;
+
+			my $secs = int($ns / 1000000000);
+			my $ms = int(($ns % 1000000000) / 1000000);
+			my $name = exists $names{$id} ? $names{$id} : "#$id";
+			my $level_name = $level < @levels ? $levels[$level] : $level;
+			printf("[%s.%03d] [%s] [%s] [%d] %s\n",
+				strftime('%Y-%m-%d %H:%M:%S', localtime($secs)), $ms, $name, $level_name, $thread, $payload);
+		}
+		else
+		{
+			die sprintf("'%s': unknown record type 0x%02x at offset %d\n", $filename, $type, tell($fh)-1);
+		}
+	}
+	close($fh);
+}
@@ -18,9 +18,40 @@
  *	limitations under the License.
  */
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <new>
 #include <opendatacon/Platform.h>
 
+// Count every heap allocation in the process, for the allocations per frame figures in the benchmarks.
+// Replacing the global operator new in the executable also replaces it for the port library, except on Windows where each DLL has its own.
+static std::atomic<uint64_t> Allocations(0);
+static uint64_t GetAllocationCount()
+{
+	return Allocations.load();
+}
+void* operator new(std::size_t size)
+{
+	Allocations++;
+	if (void* p = std::malloc(size ? size : 1))
+		return p;
+	throw std::bad_alloc();
+}
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+void operator delete(void* p) noexcept
+{
+	std::free(p);
+}
+void operator delete[](void* p) noexcept
+{
+	std::free(p);
+}
+
 int main( int argc, char* argv[] )
 {
 	std::string libname = "MD3Port";
@@ -40,5 +71,8 @@ int main( int argc, char* argv[] )
 		std::cout << "Info: failed to load run_tests symbol from '" << libfilename << "' "<< std::endl;
 		return 1;
 	}
+	if (auto set_allocation_counter = reinterpret_cast<void (*)(uint64_t (*)())>(LoadSymbol(pluginlib, "set_allocation_counter")))
+		set_allocation_counter(&GetAllocationCount);
+
 	return run_tests( argc, argv );
 }
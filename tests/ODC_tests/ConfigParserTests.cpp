@@ -0,0 +1,132 @@
+/*	opendatacon
+ *
+ *	Copyright (c) 2014:
+ *
+ *		DCrip3fJguWgVCLrZFfA7sIGgvx1Ou3fHfCxnrz4svAi
+ *		yxeOtDhDCXf1Z4ApgXvX5ahqQmzRfJ2DoX8S05SqHA==
+ *
+ *	Licensed under the Apache License, Version 2.0 (the "License");
+ *	you may not use this file except in compliance with the License.
+ *	You may obtain a copy of the License at
+ *
+ *		http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *	Unless required by applicable law or agreed to in writing, software
+ *	distributed under the License is distributed on an "AS IS" BASIS,
+ *	WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *	See the License for the specific language governing permissions and
+ *	limitations under the License.
+ */
+/*
+ * ConfigParserTests.cpp
+ *
+ *  Created on: 19/10/2026
+ */
+#include <catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <opendatacon/ConfigParser.h>
+
+#define SUITE(name) "ConfigParserTestSuite - " name
+
+class CountingParser: public ConfigParser
+{
+public:
+	CountingParser(const std::string& aConfFilename):
+		ConfigParser(aConfFilename)
+	{
+		ProcessFile();
+	}
+	void ProcessElements(const Json::Value& JSONRoot) override
+	{
+		if(JSONRoot.isMember("Points"))
+			PointCount += JSONRoot["Points"].size();
+	}
+	size_t PointCount = 0;
+};
+
+TEST_CASE(SUITE("ParallelParse"))
+{
+	//many parsers of the same inherited files at once should all see the same config
+	{
+		std::ofstream base("ConfigParserTest_base.conf");
+		base << R"({"Points" : [0,1,2,3,4,5,6,7,8,9]})";
+		std::ofstream top("ConfigParserTest_top.conf");
+		top << R"({"Inherits" : ["ConfigParserTest_base.conf"], "Points" : [10,11]})";
+	}
+
+	std::vector<size_t> counts(16,0);
+	std::vector<std::thread> threads;
+	for(size_t i = 0; i < counts.size(); i++)
+		threads.emplace_back([&counts,i]()
+			{
+				CountingParser parser("ConfigParserTest_top.conf");
+				counts[i] = parser.PointCount;
+			});
+	for(auto& thread : threads)
+		thread.join();
+
+	for(auto count : counts)
+		REQUIRE(count == 12);
+
+	std::remove("ConfigParserTest_base.conf");
+	std::remove("ConfigParserTest_top.conf");
+}
+
+TEST_CASE(SUITE("Snapshot"))
+{
+	{
+		std::ofstream conf("ConfigParserTest_snap.conf");
+		conf << R"({"Points" : [0,-1,2.5,"three",true,null,{"four" : 4}]})";
+	}
+	//so the snapshot only has this file in it
+	ConfigParser::ClearCache();
+	CountingParser parser("ConfigParserTest_snap.conf");
+	REQUIRE(parser.PointCount == 7);
+
+	//something new has been parsed, so it should write, but only the first time
+	REQUIRE(ConfigParser::SaveSnapshot("ConfigParserTest.snap"));
+	REQUIRE_FALSE(ConfigParser::SaveSnapshot("ConfigParserTest.snap"));
+
+	//everything is already cached, so nothing new to recall
+	REQUIRE(ConfigParser::LoadSnapshot("ConfigParserTest.snap") == 0);
+
+	//start from an empty cache again, so the file really comes back from the snapshot
+	ConfigParser::ClearCache();
+	REQUIRE(ConfigParser::LoadSnapshot("ConfigParserTest.snap") == 1);
+	CountingParser recalled("ConfigParserTest_snap.conf");
+	REQUIRE(recalled.PointCount == 7);
+
+	Json::Value original;
+	{
+		std::ifstream conf("ConfigParserTest_snap.conf");
+		Json::CharReaderBuilder JSONReader;
+		std::string err_str;
+		REQUIRE(Json::parseFromStream(JSONReader, conf, &original, &err_str));
+	}
+	REQUIRE(recalled.GetConfiguration()["ConfigParserTest_snap.conf"] == original);
+
+	//an edit that keeps the size (and probably the mtime second) must still make the snapshot stale
+	{
+		std::ofstream conf("ConfigParserTest_snap.conf", std::ios::trunc);
+		conf << R"({"Points" : [0,-1,2.5,"three",true,null,{"five" : 5}]})";
+	}
+	ConfigParser::ClearCache();
+	REQUIRE(ConfigParser::LoadSnapshot("ConfigParserTest.snap") == 0);
+	CountingParser edited("ConfigParserTest_snap.conf");
+	REQUIRE(edited.GetConfiguration()["ConfigParserTest_snap.conf"]["Points"][6].isMember("five"));
+
+	//garbage should be ignored
+	{
+		std::ofstream garbage("ConfigParserTest_garbage.snap");
+		garbage << "not a snapshot";
+	}
+	REQUIRE(ConfigParser::LoadSnapshot("ConfigParserTest_garbage.snap") == 0);
+	REQUIRE(ConfigParser::LoadSnapshot("ConfigParserTest_missing.snap") == 0);
+
+	std::remove("ConfigParserTest_snap.conf");
+	std::remove("ConfigParserTest.snap");
+	std::remove("ConfigParserTest_garbage.snap");
+}
@@ -26,7 +26,9 @@
 #include "../opendatacon/DataConnector.h"
 #include "TestPorts.h"
 #include <catch.hpp>
+#include <limits>
 #include <opendatacon/IOTypes.h>
+#include <thread>
 
 using namespace odc;
 
@@ -121,3 +123,46 @@ TEST_CASE(SUITE("StatusCallback"))
 			REQUIRE(cb_status == CommandStatus::UNDEFINED);
 	}
 }
+
+TEST_CASE(SUITE("InternedNames"))
+{
+	REQUIRE(InternName("") == 0);
+	REQUIRE(NameOf(0) == "");
+
+	NullPort NamedPort("InternedNamesPort","",Json::Value::nullSingleton());
+	REQUIRE(NamedPort.GetID() != 0);
+	REQUIRE(NamedPort.GetID() == InternName("InternedNamesPort"));
+	REQUIRE(NameOf(NamedPort.GetID()) == "InternedNamesPort");
+
+	//events carry the source as an id, but still present it as a name
+	EventInfo event(EventType::Binary,0,"InternedNamesPort");
+	REQUIRE(event.GetSourceID() == NamedPort.GetID());
+	REQUIRE(event.GetSourcePort() == "InternedNamesPort");
+	EventInfo event_copy(event);
+	REQUIRE(event_copy.GetSourceID() == NamedPort.GetID());
+	event_copy.SetSource(0);
+	REQUIRE(event_copy.GetSourcePort() == "");
+	event_copy.SetSource(std::string(""));
+	REQUIRE(event_copy.GetSourceID() == 0);
+	EventInfo unsourced(EventType::Binary);
+	REQUIRE(unsourced.GetSourceID() == 0);
+
+	//interning from many threads at once should agree on every id
+	std::vector<std::vector<NameID_t>> ids(4);
+	std::vector<std::thread> threads;
+	for(auto& thread_ids : ids)
+		threads.emplace_back([&thread_ids]()
+			{
+				for(int i = 0; i < 1000; i++)
+					thread_ids.push_back(InternName("InternedName"+std::to_string(i)));
+			});
+	for(auto& t : threads)
+		t.join();
+	for(auto& thread_ids : ids)
+		REQUIRE(thread_ids == ids[0]);
+	for(int i = 0; i < 1000; i++)
+		REQUIRE(NameOf(ids[0][i]) == "InternedName"+std::to_string(i));
+
+	//unknown ids resolve to the empty name
+	REQUIRE(NameOf(std::numeric_limits<NameID_t>::max()) == "");
+}